@@ -10,7 +10,8 @@ getTheActorStatistics <- function(data, effects) {
                  setup$pData, setup$pModel, setup$myeffects,
                  parallelrun = TRUE,
                  returnActorStatistics = TRUE,
-                 returnStaticChangeContributions = FALSE)
+                 returnStaticChangeContributions = FALSE,
+                 threads = 1L)
     ans
 }
 
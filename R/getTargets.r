@@ -10,7 +10,8 @@ getTargets <- function(data, effects) {
                  setup$pData, setup$pModel, setup$myeffects,
                  parallelrun = FALSE,
                  returnActorStatistics = FALSE,
-                 returnStaticChangeContributions = FALSE)
+                 returnStaticChangeContributions = FALSE,
+                 threads = 1L)
     ans
 }
 
@@ -67,7 +68,8 @@ actorTargets <- function(data, effects, behaviorName, wave,
                      setup$pData, setup$pModel, setup$myeffects,
                      parallelrun = FALSE,
                      returnActorStatistics = FALSE,
-                     returnStaticChangeContributions = FALSE)
+                     returnStaticChangeContributions = FALSE,
+                     threads = 1L)
         ans2[j,] <- ans[,w]
     }
 
@@ -812,11 +812,18 @@ initializeFRAN <- function(z, x, data, effects, prevAns=NULL, initC,
 		pData, pModel, MAXDEGREE, UNIVERSALOFFSET, CONDVAR, CONDTARGET,
 		profileData, z$parallelTesting, MODELTYPE, BEHMODELTYPE,
 		z$simpleRates, x$normSetRates)
+	## hidden option: draw the alters of two-mode networks from a tree of
+	## receiver weights where the effects allow it
+	if (isTRUE(x$sparseTwoMode))
+	{
+		.Call(C_setSparseTwoMode, PACKAGE=pkgname, pModel, TRUE)
+	}
 	if (!initC)
 	{
+		threads <- if (is.null(x$nativeThreads)) 1L else as.integer(x$nativeThreads)
 		ans <- .Call(C_getTargets, PACKAGE=pkgname, pData, pModel, myeffects,
 			z$parallelTesting, returnActorStatistics=FALSE,
-			returnStaticChangeContributions=FALSE)
+			returnStaticChangeContributions=FALSE, threads=threads)
 		##stop("done")
 		## create a grid of periods with group names in case want to
 		## parallelize using this or to access chains easily
@@ -932,7 +939,7 @@ initializeFRAN <- function(z, x, data, effects, prevAns=NULL, initC,
 				x$minimumPermutationLength,
 				x$maximumPermutationLength,
 				x$initialPermutationLength,
-				z$localML)
+				z$localML, isTRUE(x$binaryChains))
 			f$minimalChain <- ans[[1]]
 			f$chain <- ans[[2]]
 		}
@@ -947,6 +954,13 @@ initializeFRAN <- function(z, x, data, effects, prevAns=NULL, initC,
 				z$localML)
 			f$chain <- ff$chain
 		}
+
+		## memory budget for the stored chains, in megabytes
+		if (!is.null(x$chainStoreBudget))
+		{
+			.Call(C_setChainStoreBudget, PACKAGE=pkgname, pModel,
+				as.double(x$chainStoreBudget))
+		}
 	}
 
 	f$simpleRates <- simpleRates
@@ -976,7 +990,9 @@ initializeFRAN <- function(z, x, data, effects, prevAns=NULL, initC,
 		z$periodNos <- attr(data, "periodNos")
 		z$f$myeffects <- NULL
 		z$f$myCompleteEffects <- NULL
-		if (!returnDeps && !any(z$f$types == "continuous"))
+		## the observed data are kept for sienaGOF with auxiliary statistics
+		if (!returnDeps && !any(z$f$types == "continuous") &&
+			is.null(x$auxiliaryStatistics))
 		{
 			z$f[1:nGroup] <- NULL
 		}
@@ -10,7 +10,9 @@
 ## * finite differencing is going OK. If not, alters epsilon and forces a
 ## * restart. Phase 1.2 does the rest of the iterations and then calculates
 ## * the derivative estimate. Both call doPhase1or3iterations which does a block
-## * of iterations, to save copying large objects around.
+## * of iterations, to save copying large objects around. With a single
+## * process, finite differences can be computed in C++ by
+## * nativeFiniteDifferences, requested by x$nativeFinDiff = TRUE.
 ## ****************************************************************************/
 ##args: x model object (readonly), z control object
 ##
@@ -573,6 +575,44 @@ FiniteDifferences <- function(z, x, fra, fra2)
 	}
 	z
 }
+##@useNativeFiniteDifferences siena07 Can finite differences run inside C++
+useNativeFiniteDifferences <- function(z, x)
+{
+	z$int == 1 && z$FinDiff.method && !x$maxlike && !z$gmm &&
+		identical(x$FRANname, "simstats0c") &&
+		is.null(FRANstore()$randomseed2) && !isTRUE(x$lrt) &&
+		!isTRUE(z$returnDeps) && !isTRUE(z$returnChains) &&
+		!isTRUE(z$returnActorStatistics) &&
+		!isTRUE(z$returnChangeContributions) && is.null(z$auxiliary) &&
+		isTRUE(x$nativeFinDiff)
+}
+##@nativeFiniteDifferences siena07 Simulation and finite differences in C++
+## with common random numbers per period; returns a FRAN-like result
+## with the derivatives added
+nativeFiniteDifferences <- function(z, x, zsmall)
+{
+	f <- FRANstore()
+	threads <- if (is.null(x$nativeThreads)) 1L else as.integer(x$nativeThreads)
+	ans <- .Call(C_finiteDifferences, PACKAGE=pkgname, f$pData, f$pModel,
+		f$myeffects, as.double(zsmall$theta), as.double(z$epsilon),
+		as.logical(z$Phase == 3 | !z$fixed), threads)
+	list(fra=ans$fra, ntim0=ans$ntim, sc=NULL, sims=NULL, OK=TRUE,
+		feasible=TRUE, sdf=ans$sdf, sdf2=ans$sdf2)
+}
+##@storeNativeFiniteDifferences siena07 Store derivatives found in C++
+storeNativeFiniteDifferences <- function(z, zz)
+{
+	if (z$Phase == 1 && z$nit <= 10)
+	{
+		z$npos <- z$npos + ifelse(abs(diag(zz$sdf) * z$epsilon) > 1e-6, 1, 0)
+	}
+	z$sdf0 <- array(zz$sdf, dim=c(1, z$pp, z$pp))
+	if (z$byWave)
+	{
+		z$sdf02 <- array(zz$sdf2, dim=c(1, dim(zz$sdf2)))
+	}
+	z
+}
 ##@derivativeFromScoresAndDeviations siena07 create dfra from scores and deviations
 derivativeFromScoresAndDeviations <- function(scores, deviations, sumdfra,
 	sumscores, sumdeviations, byIterations, nIter)
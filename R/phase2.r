@@ -7,13 +7,15 @@
 ## *
 ## * Description: This module contains the functions phase2.1, proc2subphase
 ## * and doIterations which together perform a robbins-monro stochastic
-## * approximation algorithm.
+## * approximation algorithm. For single-process simulation in batch mode,
+## * doIterationsNative can run the iterations of a subphase inside C++.
 ## * phase2.1 and proc2subphase are called from robmon in robmon.r.
 ## ****************************************************************************/
 ## args: z: internal control object
 ##       x: model object (readonly as not returned)
 ## Hidden options exist that are activated 
-## if the algorithm object x has a component x$moreUpdates or x$phase2imp
+## if the algorithm object x has a component x$moreUpdates or x$phase2imp;
+## x$nativePhase2 = TRUE runs the iterations of phase 2 inside C++
 
 ##@storeinFRANstore siena07 Used to avoid Namespace problems with multiple processes
 storeinFRANstore <- function(...)
@@ -239,6 +241,10 @@ doIterations<- function(z, x, subphase,...)
 	zsmall <- makeZsmall(z)
 	z$returnDeps <- FALSE
 	sumfra <- 0.0
+	if (useNativePhase2(z, x))
+	{
+		return(doIterationsNative(z, x, subphase))
+	}
 	if (z$returnThetas)
 	{
 		thetas <- NULL
@@ -256,21 +262,7 @@ doIterations<- function(z, x, subphase,...)
 			z$time1 <- proc.time()[[3]]
 		if (subphase == 1 && z$nit == 11)
 		{
-			time1 <- proc.time()[[3]] - z$time1
-			if (time1 > 1e-5)
-			{
-				z$writefreq <- max(1, round(20.0 / time1))
-			}
-			else
-			{
-				z$writefreq <- 20
-			}
-			z$writefreq <- roundfreq(z$writefreq)
-			if (is.batch())
-			{
-				z$writefreq <-  z$writefreq * 10 ##compensation for it
-				## running faster with no tcl/tk
-			}
+			z <- calibrateWritefreq(z)
 		}
 		zsmall$nit <- z$nit
 		if (x$dolby) {zsmall$Deriv <- TRUE} ## include scores in FRAN
@@ -519,42 +511,7 @@ doIterations<- function(z, x, subphase,...)
 #Report(paste("thavs: ", round(z$thavn), "\n"), cf)
 #PrtOutMat(as.matrix(z$thav), cf)
 		
-		if (any(!z$fixed))
-		{
-			if (max(abs(z$theta[!z$fixed])) > z$thetaBound)
-			{
-				cat("The update steps have led to a parameter with maximum absolute value", 
-						max(abs(z$theta[!z$fixed])), 
-						",\nwhich is larger than thetaBound =", z$thetaBound, ".\n")
-				larger <- rep("", length(z$theta))
-				larger[((!z$fixed)&(abs(z$theta > z$thetaBound)))] <- " *****"
-				print(cbind(z$requestedEffects$effectName, round(z$theta, 4), larger), quote=FALSE)
-				if (interactive())
-				{
-					cat("If you wish to continue estimation in this session,")
-					cat("\ngive a higher value for thetaBound.\n")
-					thetaBound0 <- z$thetaBound
-					z$thetaBound <- as.numeric(readline(prompt="Give a number: "))
-					if (is.na(z$thetaBound)) 
-					{
-						stop("You gave no numeric answer, therefore the estimation stops.")
-					}
-					if (z$thetaBound > thetaBound0)
-					{
-						cat("OK, estimation continues.\n")
-						flush.console()
-					}
-					else
-					{
-						stop("You gave a lower number, therefore the estimation stops.")
-					}
-				}
-				else
-				{
-					stop("thetaBound should be set higher.")
-				}
-			}
-		}
+		z <- checkThetaBound(z)
 
 # This is a hidden option: 
 # it is activated if the algorithm object x has a component x$moreUpdates
@@ -606,3 +563,168 @@ doIterations<- function(z, x, subphase,...)
 	z
 }
 
+##@calibrateWritefreq siena07 Set the interval between progress reports
+calibrateWritefreq <- function(z)
+{
+	time1 <- proc.time()[[3]] - z$time1
+	if (time1 > 1e-5)
+	{
+		z$writefreq <- max(1, round(20.0 / time1))
+	}
+	else
+	{
+		z$writefreq <- 20
+	}
+	z$writefreq <- roundfreq(z$writefreq)
+	if (is.batch())
+	{
+		z$writefreq <-  z$writefreq * 10 ##compensation for it
+		## running faster with no tcl/tk
+	}
+	z
+}
+
+##@checkThetaBound siena07 Stop if an updated parameter exceeds thetaBound
+checkThetaBound <- function(z)
+{
+	if (any(!z$fixed))
+	{
+		if (max(abs(z$theta[!z$fixed])) > z$thetaBound)
+		{
+			cat("The update steps have led to a parameter with maximum absolute value", 
+					max(abs(z$theta[!z$fixed])), 
+					",\nwhich is larger than thetaBound =", z$thetaBound, ".\n")
+			larger <- rep("", length(z$theta))
+			larger[((!z$fixed)&(abs(z$theta > z$thetaBound)))] <- " *****"
+			print(cbind(z$requestedEffects$effectName, round(z$theta, 4), larger), quote=FALSE)
+			if (interactive())
+			{
+				cat("If you wish to continue estimation in this session,")
+				cat("\ngive a higher value for thetaBound.\n")
+				thetaBound0 <- z$thetaBound
+				z$thetaBound <- as.numeric(readline(prompt="Give a number: "))
+				if (is.na(z$thetaBound)) 
+				{
+					stop("You gave no numeric answer, therefore the estimation stops.")
+				}
+				if (z$thetaBound > thetaBound0)
+				{
+					cat("OK, estimation continues.\n")
+					flush.console()
+				}
+				else
+				{
+					stop("You gave a lower number, therefore the estimation stops.")
+				}
+			}
+			else
+			{
+				stop("thetaBound should be set higher.")
+			}
+		}
+	}
+	z
+}
+
+##@useNativePhase2 siena07 Can the iterations of phase 2 run inside C++
+useNativePhase2 <- function(z, x)
+{
+	is.batch() && z$int == 1 && !x$maxlike && !z$gmm &&
+		identical(x$FRANname, "simstats0c") &&
+		is.null(FRANstore()$randomseed2) &&
+		!isTRUE(x$phase2imp) && isTRUE(x$nativePhase2)
+}
+
+##@doIterationsNative siena07 Do all iterations for 1 repeat of 1 subphase of phase 2 in C++
+doIterationsNative <- function(z, x, subphase)
+{
+	f <- FRANstore()
+	state <- list(theta=z$theta, thav=z$thav, prod0=z$prod0, prod1=z$prod1,
+		sumfra=rep(0, z$pp), prevfra=rep(0, z$pp), truncated=z$truncated,
+		positivized=z$positivized, thavn=z$thavn, nit=0,
+		maxacor=z$maxacor, minacor=z$minacor)
+	if (sum(z$fixed) < z$pp && !x$diagg)
+	{
+		sfinvcov <- z$sf.invcov
+	}
+	else
+	{
+		sfinvcov <- matrix(0, 0, 0)
+	}
+	control <- list(targets=as.double(z$targets), fixed=as.logical(z$fixed),
+		posj=as.logical(z$posj), sd=as.double(z$sd),
+		dinvv=as.matrix(z$dinvv) + 0.0,
+		standardization=as.double(z$standardization),
+		sfinvcov=as.matrix(sfinvcov) + 0.0,
+		dfradiag=as.double(diag(as.matrix(z$dfra))),
+		regrCoef=as.double(if (x$dolby) z$regrCoef else rep(0, z$pp)),
+		gain=z$gain, truncation=x$truncation, thetaBound=z$thetaBound,
+		diagg=x$diagg, standardizeVar=x$standardizeVar,
+		standardizeWithTruncation=x$standardizeWithTruncation,
+		doubleAveraging=(subphase > x$doubleAveraging), dolby=x$dolby,
+		canRepeat=(z$repeatsubphase < z$maxrepeatsubphase),
+		n2min=z$n2min, n2max=z$n2max, subphase=subphase, lastIteration=0L)
+	repeat
+	{
+		## return after the first and the tenth iteration, as doIterations
+		## times these to set writefreq, and then every writefreq iterations
+		## to report progress
+		previous <- state$nit
+		if (previous < 1)
+		{
+			control$lastIteration <- 1L
+		}
+		else if (previous < 10)
+		{
+			control$lastIteration <- 10L
+		}
+		else
+		{
+			control$lastIteration <-
+				as.integer((previous %/% z$writefreq + 1) * z$writefreq)
+		}
+		state <- .Call(C_phase2Subphase, PACKAGE=pkgname, f$pData, f$pModel,
+			f$myeffects, state, control)
+		z$n <- z$n + nrow(state$thetas)
+		z$nit <- state$nit
+		z$theta <- state$theta
+		z$thav <- state$thav
+		z$thavn <- state$thavn
+		z$prod0 <- state$prod0
+		z$prod1 <- state$prod1
+		z$ac <- state$ac
+		z$maxacor <- state$maxacor
+		z$minacor <- state$minacor
+		z$truncated <- state$truncated
+		z$positivized <- state$positivized
+		if (z$returnThetas)
+		{
+			z$thetas <- rbind(z$thetas, state$thetas)
+			z$sfs <- rbind(z$sfs, state$fras)
+		}
+		if (subphase == 1 && previous < 1 && z$nit >= 1)
+		{
+			z$time1 <- proc.time()[[3]]
+		}
+		if (subphase == 1 && previous < 10 && z$nit == 10)
+		{
+			z <- calibrateWritefreq(z)
+		}
+		val <- getProgressBar(z$pb)
+		Report(paste('Phase ', z$Phase, ' Subphase ', subphase,
+				' Iteration ', z$nit,' Progress: ',
+				round((z$nit - previous + val) / z$pb$pbmax * 100),
+				'%\n', sep = ''))
+		z$pb <- setProgressBar(z$pb, val + z$nit - previous)
+		if (state$boundExceeded)
+		{
+			z <- checkThetaBound(z)
+			control$thetaBound <- z$thetaBound
+		}
+		if (state$finished)
+		{
+			break
+		}
+	}
+	z
+}
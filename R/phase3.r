@@ -8,7 +8,11 @@
 # * Description: This module contains the function phase3 which runs final
 # * iterations
 # * with constant theta for estimating rate parameter, derivative matrix and
-# * covariance matrix
+# * covariance matrix. For single-process simulation in batch mode,
+# * doPhase3Native can run the iterations inside C++, on x$nativeThreads
+# * threads (default 1), requested by x$nativePhase3 = TRUE.
+# * x$auxiliaryStatistics requests auxiliary statistics for sienaGOF,
+# * calculated in C++ at the end of each simulated period of phase 3.
 # *****************************************************************************/
 ##args: x model object, z control object
 ##@phase3 siena07 Does phase 3
@@ -84,8 +88,21 @@ phase3 <- function(z, x, ...)
     {
         z$writefreq <- 20
     }
-	z <- doPhase1or3Iterations(3, z, x, zsmall, xsmall, nits, 0, nits11,
-							   writefreq)
+	z <- setupAuxiliaryStatistics(z, x)
+	if (useNativePhase3(z, x))
+	{
+		z <- doPhase3Native(z, x, endNit)
+	}
+	else
+	{
+		z <- doPhase1or3Iterations(3, z, x, zsmall, xsmall, nits, 0, nits11,
+								   writefreq)
+	}
+	if (!is.null(z$auxiliary))
+	{
+		.Call(C_setAuxiliaryStatistics, PACKAGE=pkgname, f$pData, f$pModel,
+			list())
+	}
     z <- phase3.2(z,x)
     z
 }
@@ -629,6 +646,119 @@ PotentialNR <-function(z,x,MakeStep=FALSE)
 	z
 }
 
+##@setupAuxiliaryStatistics siena07 Request auxiliary statistics for sienaGOF
+## x$auxiliaryStatistics is a list of specifications list(type, varName,
+## levls, cumulative), where type is the name of one of the auxiliary
+## functions OutdegreeDistribution, IndegreeDistribution,
+## BehaviorDistribution, TriadCensus, egoAlterCombi (without trafo), or
+## GeodesicDistribution of the sienaGOF documentation, and levls and
+## cumulative default as in these functions. The values of phase 3 are
+## stored in z$auxiliary as iterations x periods x levels arrays.
+setupAuxiliaryStatistics <- function(z, x)
+{
+	z$auxiliary <- NULL
+	z$auxiliarySpecifications <- NULL
+	if (is.null(x$auxiliaryStatistics) || z$int > 1 || x$maxlike)
+	{
+		return(z)
+	}
+	specifications <- lapply(x$auxiliaryStatistics, function(spec)
+	{
+		varName <- as.character(spec$varName)
+		levls <- spec$levls
+		if (is.null(levls))
+		{
+			levls <- auxiliaryDefaultLevels(spec$type, z$f, varName)
+		}
+		list(type=spec$type, varName=varName, levls=as.double(levls),
+			cumulative=is.null(spec$cumulative) || isTRUE(spec$cumulative))
+	})
+	f <- FRANstore()
+	.Call(C_setAuxiliaryStatistics, PACKAGE=pkgname, f$pData, f$pModel,
+		lapply(specifications, function(spec) unname(spec)))
+	nWaves <- z$observations - 1
+	z$auxiliary <- lapply(specifications, function(spec)
+		array(0, dim=c(z$n3, nWaves, length(spec$levls))))
+	z$auxiliarySpecifications <- specifications
+	z
+}
+
+##@useNativePhase3 siena07 Can the iterations of phase 3 run inside C++
+useNativePhase3 <- function(z, x)
+{
+	is.batch() && z$int == 1 && !x$maxlike && !z$gmm && !z$FinDiff.method &&
+		identical(x$FRANname, "simstats0c") &&
+		is.null(FRANstore()$randomseed2) && !isTRUE(x$lrt) &&
+		!isTRUE(z$returnDeps) && !isTRUE(z$returnChains) &&
+		!isTRUE(z$returnActorStatistics) &&
+		!isTRUE(z$returnChangeContributions) && !z$thetaFromFile &&
+		isTRUE(x$nativePhase3)
+}
+
+##@doPhase3Native siena07 Do the iterations of phase 3 in C++
+doPhase3Native <- function(z, x, nIterations)
+{
+	f <- FRANstore()
+	threads <- if (is.null(x$nativeThreads)) 1L else as.integer(x$nativeThreads)
+	nWaves <- z$observations - 1
+	## each call does a few replications per thread, so that progress is
+	## reported and interrupts are checked for regularly
+	chunk <- 10 * threads
+	nit <- 0
+	while (nit < nIterations)
+	{
+		k <- min(chunk, nIterations - nit)
+		ans <- .Call(C_simulateReplications, PACKAGE=pkgname, f$pData,
+			f$pModel, f$myeffects, z$theta, as.integer(k), z$Deriv, threads)
+		its <- nit + (1:k)
+		z$sf[its, ] <- sweep(ans$statistics, 2, z$targets)
+		if (z$sf2.byIteration)
+		{
+			z$sf2[its, , ] <- ans$fra
+			if (z$Deriv)
+			{
+				z$ssc[its, , ] <- ans$sc
+			}
+		}
+		else
+		{
+			## accumulate replication by replication, in the order of the
+			## R loop, so that the sums are the same
+			for (i in 1:k)
+			{
+				fra <- matrix(ans$fra[i, , ], nWaves)
+				z$sf2s <- z$sf2s + fra
+				if (z$Deriv)
+				{
+					sc <- matrix(ans$sc[i, , ], nWaves)
+					z$sscs <- z$sscs + sc
+					z$scores[nit + i, ] <- colSums(sc)
+					for (j in 1:nWaves)
+					{
+						z$dfras <- z$dfras + outer(sc[j, ], fra[j, ])
+					}
+				}
+			}
+		}
+		if (z$cconditional)
+		{
+			z$ntim[its, ] <- ans$ntim
+		}
+		for (j in seq_along(z$auxiliary))
+		{
+			z$auxiliary[[j]][its, , ] <- ans$auxiliary[[j]]
+		}
+		nit <- nit + k
+		z$n <- z$n + k
+		z$nit <- nit
+		val <- getProgressBar(z$pb) + k
+		z$pb <- setProgressBar(z$pb, val)
+		Report(c("Phase ", z$Phase, " Iteration ", nit, " Progress ",
+				round(val / z$pb$pbmax * 100), "%\n"), sep='')
+	}
+	z
+}
+
 doPhase1or3Iterations <- function(phase, z, x, zsmall, xsmall, nits, nits6=0,
 	nits11=0, writefreq)
 {
@@ -754,7 +884,14 @@ doPhase1or3Iterations <- function(phase, z, x, zsmall, xsmall, nits, nits6=0,
 			}
 			if (!x$lrt)
 			{
-				zz <- x$FRAN(zsmall, xsmall)
+				if (useNativeFiniteDifferences(z, x))
+				{
+					zz <- nativeFiniteDifferences(z, x, zsmall)
+				}
+				else
+				{
+					zz <- x$FRAN(zsmall, xsmall)
+				}
 			} else {
 				zz <- x$FRAN(zsmall, xsmall, returnLoglik=TRUE, returnChains=TRUE)
 				z$myloglik <- c(z$myloglik, sum(zz$loglik))
@@ -802,6 +939,10 @@ doPhase1or3Iterations <- function(phase, z, x, zsmall, xsmall, nits, nits6=0,
 				z$sf2s <- z$sf2s + zz$fra
 			}
 			z$sims[[z$nit]] <- zz$sims
+			for (j in seq_along(zz$auxiliary))
+			{
+				z$auxiliary[[j]][z$nit, , ] <- zz$auxiliary[[j]]
+			}
 			z$chain[[z$nit]] <- zz$chain
 			z$changeContributions[[z$nit]] <- zz$changeContributions
 
@@ -854,7 +995,14 @@ doPhase1or3Iterations <- function(phase, z, x, zsmall, xsmall, nits, nits6=0,
 		}
 		else if (z$FinDiff.method)
 		{
-			z <- FiniteDifferences(z, x, fra, fra2)
+			if (!is.null(zz$sdf))
+			{
+				z <- storeNativeFiniteDifferences(z, zz)
+			}
+			else
+			{
+				z <- FiniteDifferences(z, x, fra, fra2)
+			}
 			for (i in 0:(z$int - 1))
 			{
 				z$sdf[[z$nit + i]] <- z$sdf0[i + 1, , ]
@@ -1023,6 +1171,8 @@ doPhase1or3Iterations <- function(phase, z, x, zsmall, xsmall, nits, nits6=0,
 							z$sdf2 <- z$sdf2[1:nit]
 						}
 						z$sims <-z$sims[1:nit]
+						z$auxiliary <- lapply(z$auxiliary,
+							function(a) a[1:nit, , , drop=FALSE])
 						z$Phase3nits <- nit
 						z$n3 <- nit
 						break
@@ -58,7 +58,18 @@ sienaGOF <- function(
 		stop(
 	"sienaGOF can only operate on results from Method of Moments estimation.")
 	}
-	if (! sFO$returnDeps)
+# This should be captured for possible later use
+# (when it will have been used the name is no longer available):
+	auxfu <- deparse(substitute(auxiliaryFunction))
+# The simulated values may have been calculated during phase 3,
+# if requested by x$auxiliaryStatistics in siena07.
+	nativeIndex <- 0
+	if (!fitList && !missing(varName) && !missing(auxiliaryFunction))
+	{
+		nativeIndex <- nativeAuxiliaryIndex(sFO, auxiliaryFunction, varName,
+			list(...))
+	}
+	if ((! sFO$returnDeps) && (nativeIndex == 0))
 	{
 		stop("You must instruct siena07 to return the simulated networks")
 	}
@@ -69,13 +80,21 @@ sienaGOF <- function(
         	stop("sienaGOF needs sf2 by iterations (use lessMem=FALSE)")
     	}
 	}
+	if (nativeIndex > 0)
+	{
+		nSimulations <- dim(sFO$auxiliary[[nativeIndex]])[1]
+	}
+	else
+	{
+		nSimulations <- length(sFO$sims)
+	}
 	if (is.null(iterations))
 	{
-		iterations <- length(sFO$sims)
+		iterations <- nSimulations
 	}
 	else
 	{
-		iterations <- min(iterations, length(sFO$sims))
+		iterations <- min(iterations, nSimulations)
 	}
 	if (iterations < 1)
 	{
@@ -89,9 +108,6 @@ sienaGOF <- function(
 	{
 		stop("You need to supply the parameter <<auxiliaryFunction>>.")
 	}
-# This should be captured for possible later use
-# (when it will have been used the name is no longer available):
-	auxfu <- deparse(substitute(auxiliaryFunction))
 # There might be more than one varName:
 	if (is.null(sFO$f[[groupName]]$depvars[[varName[1]]]))
 	{
@@ -205,7 +221,20 @@ sienaGOF <- function(
 			cat("Calculating auxiliary statistics for periods ", period, ".\n")
 		}
 	}
-	if (!is.null(cluster))
+	if (nativeIndex > 0)
+	{
+		groupIndex <- match(groupName, sFO$f$groupNames)
+		periodOffset <- sum(vapply(seq_len(groupIndex - 1), function(g)
+			{attr(sFO$f[[g]]$depvars[[1]], "netdims")[3] - 1}, FUN.VALUE=0))
+		ttcSimulation <- system.time(simStatsByPeriod <-
+			lapply(period, function (j) {
+				simStatsByPeriod <- matrix(sFO$auxiliary[[nativeIndex]][
+						1:iterations, periodOffset + j, ], nrow=iterations)
+				dimnames(simStatsByPeriod) <- list(1:iterations, plotKey)
+				simStatsByPeriod
+				}))
+	}
+	else if (!is.null(cluster))
 	{
 		ttcSimulation <- system.time(simStatsByPeriod <-
 			lapply(period, function (j) {
@@ -1347,6 +1376,63 @@ IndegreeDistribution <- function (i, obsData, sims, period, groupName, varName,
   iddi
 }
 
+##@auxiliaryDefaultLevels sienaGOF Default levels of the auxiliary
+## statistics that can be calculated during phase 3 (x$auxiliaryStatistics)
+auxiliaryDefaultLevels <- function(type, obsData, varName)
+{
+	behaviorLevels <- function(name)
+	{
+		range <- attr(obsData[[1]]$depvars[[name]], "behRange")
+		range[1]:range[2]
+	}
+	switch(type,
+		OutdegreeDistribution=, IndegreeDistribution=0:8,
+		BehaviorDistribution=behaviorLevels(varName[1]),
+		TriadCensus=1:16,
+		GeodesicDistribution=c(1:5, Inf),
+		egoAlterCombi={
+			brange <- behaviorLevels(varName[2])
+			sort(unique(as.vector(outer(10 * brange, brange, '+'))))
+		},
+		stop("Unknown auxiliary statistic ", type))
+}
+
+##@nativeAuxiliaryIndex sienaGOF Position of the auxiliary statistic among
+## those calculated during phase 3, or 0 if it was not calculated there.
+## Only the functions of RSiena itself are recognized, by identity; a
+## function of the user with the same name may calculate something else.
+nativeAuxiliaryIndex <- function(sFO, auxiliaryFunction, varName, dots)
+{
+	if (!is.function(auxiliaryFunction) ||
+		!all(names(dots) %in% c("levls", "cumulative")))
+	{
+		return(0)
+	}
+	for (k in seq_along(sFO$auxiliarySpecifications))
+	{
+		spec <- sFO$auxiliarySpecifications[[k]]
+		packageFunction <- get0(spec$type, envir=asNamespace(pkgname),
+			inherits=FALSE)
+		if (!identical(auxiliaryFunction, packageFunction) ||
+			!identical(spec$varName, as.character(varName)))
+		{
+			next
+		}
+		levls <- dots$levls
+		if (is.null(levls))
+		{
+			levls <- auxiliaryDefaultLevels(spec$type, sFO$f, varName)
+		}
+		cumulative <- is.null(dots$cumulative) || isTRUE(dots$cumulative)
+		if (identical(spec$levls, as.double(levls)) &&
+			identical(spec$cumulative, cumulative))
+		{
+			return(k)
+		}
+	}
+	0
+}
+
 ##@BehaviorDistribution sienaGOF Calculates behavior distribution
 BehaviorDistribution <- function (i, obsData, sims, period, groupName, varName,
 							levls=NULL, cumulative=TRUE){
@@ -0,0 +1,37 @@
+#/******************************************************************************
+# * SIENA: Simulation Investigation for Empirical Network Analysis
+# *
+# * Web: https://www.stats.ox.ac.uk/~snijders/siena
+# *
+# * File: sienaProfile.r
+# *
+# * Description: This module contains the function controlling the
+# * instrumentation of the C++ simulation code and returning its counters.
+# *****************************************************************************/
+
+##@sienaProfile Profiling switch and counters of the simulation code
+sienaProfile <- function(enable=NULL, reset=isTRUE(enable))
+{
+	if (!is.null(enable))
+	{
+		.Call(C_setInstrumentation, PACKAGE=pkgname,
+			as.logical(enable), as.logical(reset))
+	}
+	else if (reset)
+	{
+		stop("reset requires enable to be TRUE or FALSE")
+	}
+	counters <- .Call(C_getInstrumentation, PACKAGE=pkgname)
+	profile <- data.frame(counters, stringsAsFactors=FALSE)
+	profile$mean <- profile$seconds / profile$calls
+	profile <- profile[order(profile$category, -profile$seconds), ]
+	rownames(profile) <- NULL
+	if (is.null(enable))
+	{
+		profile
+	}
+	else
+	{
+		invisible(profile)
+	}
+}
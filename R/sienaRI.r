@@ -42,9 +42,12 @@ sienaRI <- function(data, ans=NULL, theta=NULL, effects=NULL,
 		if (any(ans$effects$shortName %in% c("unspInt", "behUnspInt", "contUnspInt"))){
 			stop("interpret_size does not work for models containing interaction effects")
 		}
+		threads <- if (is.null(ans$x$nativeThreads)) 1L else
+			as.integer(ans$x$nativeThreads)
 		contributions <- getChangeContributions(data = data,
-			effects = ans$effects)
-		# contributions[[1]] is periods by effects by actors by actors
+			effects = ans$effects, threads = threads)
+		# contributions[[1]] is periods by dependent variables, each an array
+		# of choices by actors by effects
 		RI <- expectedRelativeImportance(conts = contributions,
 			effects = ans$effects, theta =ans$theta, thedata=data,
 			getChangeStatistics=getChangeStats)
@@ -117,7 +120,7 @@ interpret_size.sienaFit <- function(x, data, getChangeStats=FALSE, ...)
 }
 
 ##@getChangeContributions. Use as RSiena:::getChangeContributions
-getChangeContributions <- function(data, effects)
+getChangeContributions <- function(data, effects, threads = 1L)
 {
 	# How to check for settings without algorithm? Is it relevant?
     setup <- sienaSetupForCpp(data, effects,
@@ -131,7 +134,8 @@ getChangeContributions <- function(data, effects)
                  setup$pData, setup$pModel, setup$myeffects,
                  parallelrun = FALSE,
                  returnActorStatistics = FALSE,
-                 returnStaticChangeContributions = TRUE)
+                 returnStaticChangeContributions = TRUE,
+                 threads = threads)
     ans
 }
 
@@ -160,7 +164,7 @@ expectedRelativeImportance <- function(conts, effects, theta, thedata=NULL,
 		if(networkNames[eff] != currentDepName)
 		{
 			currentDepName <- networkNames[eff]
-			actors <- length(conts[[1]][[1]][[1]])
+			actors <- dim(conts[[1]][[1]][[currentDepName]])[2]
 			depNumber <- depNumber + 1
 			currentDepEffs <- effects$name == currentDepName
 			effNumber <- sum(currentDepEffs)
@@ -240,24 +244,14 @@ expectedRelativeImportance <- function(conts, effects, theta, thedata=NULL,
 			}
 			for(w in 1:periods)
 			{
-				currentDepEffectContributions <- conts[[1]][[w]][currentDepEffs]
+				# conts[[1]][[w]][[currentDepName]] is choices by actors (egos)
+				# by effects
+				cdec <- aperm(conts[[1]][[w]][[currentDepName]], c(3, 1, 2))
 				if (networkTypes[eff] == "bipartite")
 				{
-					currentDepEffectContributions <- lapply(
-							currentDepEffectContributions,
-							function(x){lapply(x,function(xx){xx[1:choices]})})
+					cdec <- cdec[, 1:choices, , drop=FALSE]
 				}
-				# conts[[1]] is periods by effects by actors by actors
-				currentDepEffectContributions <-
-					sapply(lapply(currentDepEffectContributions, unlist),
-						matrix, nrow=actors, ncol=choices, byrow=TRUE,
-						simplify="array")
-				cdec <- apply(currentDepEffectContributions, c(2,1), as.matrix)
 				# cdec is effects by actors (alters) by actors (egos)
-				if (dim(currentDepEffectContributions)[3] <= 1) # only one effect
-				{
-					cdec <- array(cdec, dim=c(1,dim(cdec)))
-				}
 				rownames(cdec) <- effectNa[currentDepEffs]
 				if (getChangeStatistics)
 				{
@@ -145,6 +145,15 @@ simstats0c <- function(z, x, data=NULL, effects=NULL, fromFiniteDiff=FALSE,
 	{
 		actorStatistics <- NULL
 	}
+	## auxiliary statistics for sienaGOF as periods x levels matrices
+	if (length(ans[[11]]) > 0)
+	{
+		auxiliary <- lapply(ans[[11]], function(a) matrix(a, dim(a)[2], dim(a)[3]))
+	}
+	else
+	{
+		auxiliary <- NULL
+	}
     if (returnDeps)
     {
         ## attach the names
@@ -164,7 +173,8 @@ simstats0c <- function(z, x, data=NULL, effects=NULL, fromFiniteDiff=FALSE,
 		 ## browser()
     list(sc = sc, fra = fra, ntim0 = ntim, feasible = TRUE, OK = TRUE,
          sims=sims, f$seeds, chain=chain, loglik=loglik,
-		 actorStatistics = actorStatistics, changeContributions = changeContributions)
+		 actorStatistics = actorStatistics, changeContributions = changeContributions,
+		 auxiliary = auxiliary)
 }
 
 ##@clearData siena07 Finalizer to clear Data object in C++
@@ -27,19 +27,14 @@ ChangingCovariate::ChangingCovariate(std::string name,
 	const ActorSet * pActorSet,
 	int observationCount) : Covariate(name, pActorSet)
 {
-	this->lvalues = new double * [pActorSet->n()];
-	this->lmissing = new bool * [pActorSet->n()];
+	this->ln = pActorSet->n();
+	this->lvalues = new double[observationCount * this->ln];
+	this->lmissing = new bool[observationCount * this->ln];
 	
-	for (int i = 0; i < pActorSet->n(); i++)
+	for (int k = 0; k < observationCount * this->ln; k++)
 	{
-		this->lvalues[i] = new double[observationCount];
-		this->lmissing[i] = new bool[observationCount];
-		
-		for (int j = 0; j < observationCount; j++)
-		{
-			this->lvalues[i][j] = 0;
-			this->lmissing[i][j] = false;
-		}
+		this->lvalues[k] = 0;
+		this->lmissing[k] = false;
 	}
 	this->lmin = numeric_limits<double>::max();
 	this->lmax = numeric_limits<double>::min();
@@ -51,12 +46,6 @@ ChangingCovariate::ChangingCovariate(std::string name,
  */
 ChangingCovariate::~ChangingCovariate()
 {
-	for (int i = 0; i < this->pActorSet()->n(); i++)
-	{
-		delete[] this->lvalues[i];
-		delete[] this->lmissing[i];
-	}
-	
 	delete[] this->lvalues;
 	delete[] this->lmissing;
 	this->lvalues = 0;
@@ -64,47 +53,47 @@ ChangingCovariate::~ChangingCovariate()
 }
 
 
-/**
- * Returns the value of this covariate for actor <i>i</i> at the given
- * observation.
- */
-double ChangingCovariate::value(int i, int observation) const
-{
-	return this->lvalues[i][observation];
-}
-
-
 /**
  * Stores the value of this covariate for actor <i>i</i> at the given
  * observations.
  */
 void ChangingCovariate::value(int i, int observation, double value)
 {
-	this->lvalues[i][observation] = value;
+	this->lvalues[observation * this->ln + i] = value;
 	this->lmin = std::min(this->lmin, value);
 	this->lmax = std::max(this->lmax, value);
 }
 
 
 /**
- * Returns if the value of the covariate is missing for the given
+ * Stores if the value of the covariate is missing for the given
  * actor at the specified observation.
  */
-bool ChangingCovariate::missing(int i, int observation) const
+void ChangingCovariate::missing(int i,
+	int observation,
+	bool missing)
+{
+	this->lmissing[observation * this->ln + i] = missing;
+}
+
+
+/**
+ * Returns the values of all actors at the given observation, indexed by
+ * actor.
+ */
+const double * ChangingCovariate::values(int observation) const
 {
-	return this->lmissing[i][observation];
+	return this->lvalues + observation * this->ln;
 }
 
 
 /**
- * Stores if the value of the covariate is missing for the given
- * actor at the specified observation.
+ * Returns the missingness indicators of all actors at the given
+ * observation, indexed by actor.
  */
-void ChangingCovariate::missing(int i,
-	int observation,
-	bool missing)
+const bool * ChangingCovariate::missingValues(int observation) const
 {
-	this->lmissing[i][observation] = missing;
+	return this->lmissing + observation * this->ln;
 }
 
 /**
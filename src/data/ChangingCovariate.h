@@ -28,23 +28,53 @@ public:
 		int observationCount);
 	virtual ~ChangingCovariate();
 	
-	double value(int i, int observation) const;
+	inline double value(int i, int observation) const;
 	void value(int i, int observation, double value);
-	bool missing(int i, int observation) const;
+	inline bool missing(int i, int observation) const;
 	void missing(int i, int observation, bool missing);
+	const double * values(int observation) const;
+	const bool * missingValues(int observation) const;
 	double min() const;
 	double max() const;
 
 private:
-	// The values of the covariate per each actor and observation
-	double ** lvalues {};
+	// The number of actors
+	int ln {};
+
+	// The values of the covariate, stored by observation, so that the
+	// values of all actors at an observation are contiguous
+	double * lvalues {};
 	double lmin {};
 	double lmax {};
 	
-	// Missingness indicators
-	bool ** lmissing {};
+	// Missingness indicators, stored like the values
+	bool * lmissing {};
 };
 
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns the value of this covariate for actor <i>i</i> at the given
+ * observation.
+ */
+double ChangingCovariate::value(int i, int observation) const
+{
+	return this->lvalues[observation * this->ln + i];
+}
+
+
+/**
+ * Returns if the value of the covariate is missing for the given
+ * actor at the specified observation.
+ */
+bool ChangingCovariate::missing(int i, int observation) const
+{
+	return this->lmissing[observation * this->ln + i];
+}
+
 }
 
 #endif /*CHANGINGCOVARIATE_H_*/
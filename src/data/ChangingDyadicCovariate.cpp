@@ -12,6 +12,7 @@
 #include <R_ext/Print.h>
 #include "ChangingDyadicCovariate.h"
 #include "data/ActorSet.h"
+#include "data/DyadicCovariateMatrix.h"
 #include "data/DyadicCovariateValueIterator.h"
 
 using namespace std;
@@ -33,19 +34,13 @@ ChangingDyadicCovariate::ChangingDyadicCovariate(string name,
 		DyadicCovariate(name, pFirstActorSet, pSecondActorSet)
 {
 	this->lobservationCount = observationCount;
-	this->lpRowValues = new map<int, double> * [observationCount];
-	this->lpColumnValues = new map<int, double> * [observationCount];
-	this->lpRowMissings = new set<int> * [observationCount];
-	this->lpColumnMissings = new set<int> * [observationCount];
+	this->lpValues = new DyadicCovariateMatrix * [observationCount];
 
 	for (int k = 0; k < observationCount; k++)
 	{
-		this->lpRowValues[k] = new map<int, double>[pFirstActorSet->n()];
-		this->lpColumnValues[k] = new map<int, double>[pSecondActorSet->n()];
-		this->lpRowMissings[k] = new set<int>[pFirstActorSet->n()];
-		this->lpColumnMissings[k] = new set<int>[pSecondActorSet->n()];
+		this->lpValues[k] = new DyadicCovariateMatrix(pFirstActorSet->n(),
+			pSecondActorSet->n());
 	}
-	this->lpEmptySet = new set<int>;
 }
 
 
@@ -56,22 +51,11 @@ ChangingDyadicCovariate::~ChangingDyadicCovariate()
 {
 	for (int k = 0; k < this->lobservationCount; k++)
 	{
-		delete[] this->lpRowValues[k];
-		delete[] this->lpColumnValues[k];
-		delete[] this->lpRowMissings[k];
-		delete[] this->lpColumnMissings[k];
+		delete this->lpValues[k];
 	}
 
-	delete[] this->lpRowValues;
-	delete[] this->lpColumnValues;
-	delete[] this->lpRowMissings;
-	delete[] this->lpColumnMissings;
-	this->lpRowValues = 0;
-	this->lpColumnValues = 0;
-	this->lpRowMissings = 0;
-	this->lpColumnMissings = 0;
-	delete this->lpEmptySet;
-	this->lpEmptySet = 0;
+	delete[] this->lpValues;
+	this->lpValues = 0;
 }
 
 
@@ -87,16 +71,7 @@ void ChangingDyadicCovariate::value(int i,
 	int observation,
 	double value)
 {
-	if (value)
-	{
-		this->lpRowValues[observation][i][j] = value;
-		this->lpColumnValues[observation][j][i] = value;
-	}
-	else
-	{
-		this->lpRowValues[observation][i].erase(j);
-		this->lpColumnValues[observation][j].erase(i);
-	}
+	this->lpValues[observation]->value(i, j, value);
 }
 
 
@@ -106,16 +81,7 @@ void ChangingDyadicCovariate::value(int i,
  */
 double ChangingDyadicCovariate::value(int i, int j, int observation) const
 {
-	map<int, double>::const_iterator iter =
-		this->lpRowValues[observation][i].find(j);
-	double value = 0;
-
-	if (iter != this->lpRowValues[observation][i].end())
-	{
-		value = iter->second;
-	}
-
-	return value;
+	return this->lpValues[observation]->value(i, j);
 }
 
 
@@ -132,16 +98,7 @@ void ChangingDyadicCovariate::missing(int i,
 	int observation,
 	bool flag)
 {
-	if (flag)
-	{
-		this->lpRowMissings[observation][i].insert(j);
-		this->lpColumnMissings[observation][j].insert(i);
-	}
-	else
-	{
-		this->lpRowMissings[observation][i].erase(j);
-		this->lpColumnMissings[observation][j].erase(i);
-	}
+	this->lpValues[observation]->missing(i, j, flag);
 }
 
 
@@ -151,8 +108,32 @@ void ChangingDyadicCovariate::missing(int i,
  */
 bool ChangingDyadicCovariate::missing(int i, int j, int observation) const
 {
-	return this->lpRowMissings[observation][i].find(j) !=
-		this->lpRowMissings[observation][i].end();
+	return this->lpValues[observation]->missing(i, j);
+}
+
+
+/**
+ * Chooses between dense and sparse storage of the values at each
+ * observation, depending on the number of non-zero values. This is called
+ * when all values have been stored.
+ */
+void ChangingDyadicCovariate::selectStorage()
+{
+	for (int k = 0; k < this->lobservationCount; k++)
+	{
+		this->lpValues[k]->selectStorage();
+	}
+}
+
+
+/**
+ * Returns the stored values and missing value indicators at the given
+ * observation, giving access to contiguous rows of the covariate.
+ */
+const DyadicCovariateMatrix * ChangingDyadicCovariate::pValues(
+	int observation) const
+{
+	return this->lpValues[observation];
 }
 
 
@@ -166,15 +147,7 @@ DyadicCovariateValueIterator ChangingDyadicCovariate::rowValues(int i,
 	int observation,
 	bool excludeMissings) const
 {
-	set<int> * excludedActorSet = this->lpEmptySet;
-
-    if (excludeMissings)
-    {
-        excludedActorSet = &(this->lpRowMissings[observation][i]);
-    }
-
-    return DyadicCovariateValueIterator(this->lpRowValues[observation][i],
-        *excludedActorSet);
+	return this->lpValues[observation]->rowValues(i, excludeMissings);
 }
 
 
@@ -188,26 +161,7 @@ DyadicCovariateValueIterator ChangingDyadicCovariate::columnValues(int j,
 	int observation,
 	bool excludeMissings) const
 {
-	set<int> * excludedActorSet = this->lpEmptySet;
-//	Rprintf("%d exclude\n", excludeMissings);
-
-    if (excludeMissings)
-    {
-		//	Rprintf("exclude\n");
-        excludedActorSet = &(this->lpColumnMissings[observation][j]);
-    }
-
-    return DyadicCovariateValueIterator(this->lpColumnValues[observation][j],
-        *excludedActorSet);
-}
-/**
- * Returns a map containing over non-zero non-missing values of the given row
- * for the given observation
- */
-const map <int, double> & ChangingDyadicCovariate::rRowValues(int i,
-	int observation) const
-{
-	return this->lpRowValues[observation][i];
+	return this->lpValues[observation]->columnValues(j, excludeMissings);
 }
 
 }
@@ -12,8 +12,6 @@
 #ifndef CHANGINGDYADICCOVARIATE_H_
 #define CHANGINGDYADICCOVARIATE_H_
 
-#include <map>
-#include <set>
 #include "DyadicCovariate.h"
 
 namespace siena
@@ -23,6 +21,7 @@ namespace siena
 // Section: Forward declarations
 // ----------------------------------------------------------------------------
 
+class DyadicCovariateMatrix;
 class DyadicCovariateValueIterator;
 
 
@@ -46,42 +45,21 @@ public:
 	void value(int i, int j, int observation, double value);
 	bool missing(int i, int j, int observation) const;
 	void missing(int i, int j, int observation, bool flag);
+	void selectStorage();
+	const DyadicCovariateMatrix * pValues(int observation) const;
 	DyadicCovariateValueIterator rowValues(int i, int observation,
 		bool excludeMissings) const;
 	DyadicCovariateValueIterator columnValues(int j, int observation,
 		bool excludeMissings) const;
-	const std::map <int, double> & rRowValues(int i, int observation) const;
 
 private:
-	// A row based representation of non-zero values of the covariate.
-	// The value at observation k for a pair (i,j) is stored in
-	// lpRowValues[k][i][j].
+	// The values and missing value indicators of the covariate,
+	// one matrix per observation
 
-	std::map<int, double> ** lpRowValues;
-
-	// A column based representation of non-zero values of the covariate.
-	// The value at observation k for a pair (i,j) is stored in
-	// lpColumnValues[k][j][i].
-
-	std::map<int, double> ** lpColumnValues;
-
-	// A row based representation of missing values. Actor j belongs to
-	// lpRowMissings[k][i] if and only if the covariate value for the pair
-	// (i,j) is missing at observation k.
-
-	std::set<int> ** lpRowMissings;
-
-	// A column based representation of missing values. Actor i belongs to
-	// lpColumnMissings[k][j] if and only if the covariate value for the pair
-	// (i,j) is missing at observation k.
-
-	std::set<int> ** lpColumnMissings;
+	DyadicCovariateMatrix ** lpValues;
 
 	// The number of observations
 	int lobservationCount;
-
-	// empty set
-	std::set <int> * lpEmptySet;
 };
 
 }
@@ -46,40 +46,40 @@ ConstantCovariate::~ConstantCovariate()
 
 
 /**
- * Returns the value of this covariate for actor <i>i</i>.
+ * Stores the value of this covariate for actor <i>i</i>.
  */
-double ConstantCovariate::value(int i) const
+void ConstantCovariate::value(int i, double value)
 {
-	return this->lvalues[i];
+	this->lvalues[i] = value;
+	this->lmin = std::min(this->lmin, value);
+	this->lmax = std::max(this->lmax, value);
 }
 
 
 /**
- * Stores the value of this covariate for actor <i>i</i>.
+ * Stores if the value of the covariate is missing for the given actor.
  */
-void ConstantCovariate::value(int i, double value)
+void ConstantCovariate::missing(int i, bool missing)
 {
-	this->lvalues[i] = value;
-	this->lmin = std::min(this->lmin, value);
-	this->lmax = std::max(this->lmax, value);
+	this->lmissing[i] = missing;
 }
 
 
 /**
- * Returns if the value of the covariate is missing for the given actor.
+ * Returns the values of all actors, indexed by actor.
  */
-bool ConstantCovariate::missing(int i) const
+const double * ConstantCovariate::values() const
 {
-	return this->lmissing[i];
+	return this->lvalues;
 }
 
 
 /**
- * Stores if the value of the covariate is missing for the given actor.
+ * Returns the missingness indicators of all actors, indexed by actor.
  */
-void ConstantCovariate::missing(int i, bool missing)
+const bool * ConstantCovariate::missingValues() const
 {
-	this->lmissing[i] = missing;
+	return this->lmissing;
 }
 
 /**
@@ -27,10 +27,12 @@ public:
 	ConstantCovariate(std::string name, const ActorSet * pActorSet);
 	virtual ~ConstantCovariate();
 	
-	double value(int i) const;
+	inline double value(int i) const;
 	void value(int i, double value);
-	bool missing(int i) const;
+	inline bool missing(int i) const;
 	void missing(int i, bool missing);
+	const double * values() const;
+	const bool * missingValues() const;
 	double min() const;
 	double max() const;
 
@@ -44,6 +46,28 @@ private:
 	bool * lmissing {};
 };
 
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns the value of this covariate for actor <i>i</i>.
+ */
+double ConstantCovariate::value(int i) const
+{
+	return this->lvalues[i];
+}
+
+
+/**
+ * Returns if the value of the covariate is missing for the given actor.
+ */
+bool ConstantCovariate::missing(int i) const
+{
+	return this->lmissing[i];
+}
+
 }
 
 #endif /*CONSTANTCOVARIATE_H_*/
@@ -11,6 +11,7 @@
 
 #include "ConstantDyadicCovariate.h"
 #include "data/ActorSet.h"
+#include "data/DyadicCovariateMatrix.h"
 #include "data/DyadicCovariateValueIterator.h"
 
 using namespace std;
@@ -29,10 +30,8 @@ ConstantDyadicCovariate::ConstantDyadicCovariate(std::string name,
 	const ActorSet * pSecondActorSet) :
 		DyadicCovariate(name, pFirstActorSet, pSecondActorSet)
 {
-	this->lpRowValues = new map<int, double>[pFirstActorSet->n()];
-	this->lpRowMissings = new set<int>[pFirstActorSet->n()];
-	this->lpColumnValues = new map<int, double>[pSecondActorSet->n()];
-	this->lpColumnMissings = new set<int>[pSecondActorSet->n()];
+	this->lpValues =
+		new DyadicCovariateMatrix(pFirstActorSet->n(), pSecondActorSet->n());
 }
 
 
@@ -41,14 +40,8 @@ ConstantDyadicCovariate::ConstantDyadicCovariate(std::string name,
  */
 ConstantDyadicCovariate::~ConstantDyadicCovariate()
 {
-	delete[] this->lpRowValues;
-	delete[] this->lpRowMissings;
-	delete[] this->lpColumnValues;
-	delete[] this->lpColumnMissings;
-	this->lpRowValues = 0;
-	this->lpRowMissings = 0;
-	this->lpColumnValues = 0;
-	this->lpColumnMissings = 0;
+	delete this->lpValues;
+	this->lpValues = 0;
 }
 
 
@@ -60,16 +53,7 @@ ConstantDyadicCovariate::~ConstantDyadicCovariate()
  */
 void ConstantDyadicCovariate::value(int i, int j, double value)
 {
-	if (value)
-	{
-		this->lpRowValues[i][j] = value;
-		this->lpColumnValues[j][i] = value;
-	}
-	else
-	{
-		this->lpRowValues[i].erase(j);
-		this->lpColumnValues[j].erase(i);
-	}
+	this->lpValues->value(i, j, value);
 }
 
 
@@ -78,15 +62,7 @@ void ConstantDyadicCovariate::value(int i, int j, double value)
  */
 double ConstantDyadicCovariate::value(int i, int j) const
 {
-	map<int, double>::const_iterator iter = this->lpRowValues[i].find(j);
-	double value = 0;
-
-	if (iter != this->lpRowValues[i].end())
-	{
-		value = iter->second;
-	}
-
-	return value;
+	return this->lpValues->value(i, j);
 }
 
 
@@ -98,16 +74,7 @@ double ConstantDyadicCovariate::value(int i, int j) const
  */
 void ConstantDyadicCovariate::missing(int i, int j, bool flag)
 {
-	if (flag)
-	{
-		this->lpRowMissings[i].insert(j);
-		this->lpColumnMissings[j].insert(i);
-	}
-	else
-	{
-		this->lpRowMissings[i].erase(j);
-		this->lpColumnMissings[j].erase(i);
-	}
+	this->lpValues->missing(i, j, flag);
 }
 
 
@@ -116,37 +83,48 @@ void ConstantDyadicCovariate::missing(int i, int j, bool flag)
  */
 bool ConstantDyadicCovariate::missing(int i, int j) const
 {
-	return this->lpRowMissings[i].find(j) != this->lpRowMissings[i].end();
+	return this->lpValues->missing(i, j);
 }
 
 
 /**
- * Returns an iterator over non-zero non-missing values of the given row.
+ * Chooses between dense and sparse storage of the values, depending on
+ * the number of non-zero values. This is called when all values have
+ * been stored.
  */
-DyadicCovariateValueIterator ConstantDyadicCovariate::rowValues(int i)
-	const
+void ConstantDyadicCovariate::selectStorage()
 {
-	return DyadicCovariateValueIterator(this->lpRowValues[i],
-		this->lpRowMissings[i]);
+	this->lpValues->selectStorage();
 }
 
 
 /**
- * Returns an iterator over non-zero non-missing values of the given column.
+ * Returns the stored values and missing value indicators, giving
+ * access to contiguous rows of the covariate.
  */
-DyadicCovariateValueIterator ConstantDyadicCovariate::columnValues(int j)
+const DyadicCovariateMatrix * ConstantDyadicCovariate::pValues() const
+{
+	return this->lpValues;
+}
+
+
+/**
+ * Returns an iterator over non-zero non-missing values of the given row.
+ */
+DyadicCovariateValueIterator ConstantDyadicCovariate::rowValues(int i)
 	const
 {
-	return DyadicCovariateValueIterator(this->lpColumnValues[j],
-		this->lpColumnMissings[j]);
+	return this->lpValues->rowValues(i, true);
 }
 
+
 /**
- * Returns a map containing over non-zero non-missing values of the given row.
+ * Returns an iterator over non-zero non-missing values of the given column.
  */
-const map <int, double> & ConstantDyadicCovariate::rRowValues(int i)
+DyadicCovariateValueIterator ConstantDyadicCovariate::columnValues(int j)
 	const
 {
-	return this->lpRowValues[i];
+	return this->lpValues->columnValues(j, true);
 }
+
 }
@@ -12,8 +12,6 @@
 #ifndef CONSTANTDYADICCOVARIATE_H_
 #define CONSTANTDYADICCOVARIATE_H_
 
-#include <map>
-#include <set>
 #include "DyadicCovariate.h"
 
 namespace siena
@@ -23,6 +21,7 @@ namespace siena
 // Section: Forward declarations
 // ----------------------------------------------------------------------------
 
+class DyadicCovariateMatrix;
 class DyadicCovariateValueIterator;
 
 
@@ -45,32 +44,14 @@ public:
 	void value(int i, int j, double value);
 	bool missing(int i, int j) const;
 	void missing(int i, int j, bool flag);
+	void selectStorage();
+	const DyadicCovariateMatrix * pValues() const;
 	DyadicCovariateValueIterator rowValues(int i) const;
 	DyadicCovariateValueIterator columnValues(int j) const;
-	const std::map <int, double> & rRowValues(int i) const;
 
 private:
-	// A row based representation of non-zero values of the covariate.
-	// The value for a pair (i,j) is stored in lpRowValues[i][j].
-
-	std::map<int, double> * lpRowValues;
-
-	// A column based representation of non-zero values of the covariate.
-	// The value for a pair (i,j) is stored in lpColumnValues[j][i].
-
-	std::map<int, double> * lpColumnValues;
-
-	// A row based representation of missing values. Actor j belongs to
-	// lpRowMissings[i] if and only if the covariate value for the pair
-	// (i,j) is missing.
-
-	std::set<int> * lpRowMissings;
-
-	// A column based representation of missing values. Actor i belongs to
-	// lpColumnMissings[j] if and only if the covariate value for the pair
-	// (i,j) is missing.
-
-	std::set<int> * lpColumnMissings;
+	// The values and missing value indicators of the covariate
+	DyadicCovariateMatrix * lpValues;
 };
 
 }
@@ -0,0 +1,412 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: DyadicCovariateMatrix.cpp
+ *
+ * Description: This file contains the implementation of the
+ * DyadicCovariateMatrix class.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+#include "DyadicCovariateMatrix.h"
+#include "data/DyadicCovariateValueIterator.h"
+
+using namespace std;
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Local declarations
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// The covariate is stored as a dense array if at least this fraction of
+// its values is non-zero. A dense array of doubles takes less space than
+// the row and column arrays from a density of about one third; below that
+// the faster lookups still outweigh the extra memory.
+
+const double DENSE_STORAGE_DENSITY = 0.25;
+
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Construction and storage selection
+// ----------------------------------------------------------------------------
+
+/**
+ * Creates an empty matrix with the given number of rows and columns.
+ */
+DyadicCovariateMatrix::DyadicCovariateMatrix(int n, int m)
+{
+	this->ln = n;
+	this->lm = m;
+	this->lselected = false;
+	this->lstagedValues.resize(n);
+	this->lstagedMissings.resize(n);
+}
+
+
+/**
+ * Stores the value for the given pair of actors.
+ */
+void DyadicCovariateMatrix::value(int i, int j, double value)
+{
+	this->restoreStaging();
+
+	if (value)
+	{
+		this->lstagedValues[i][j] = value;
+	}
+	else
+	{
+		this->lstagedValues[i].erase(j);
+	}
+}
+
+
+/**
+ * Stores if the value for the given pair of actors is missing.
+ */
+void DyadicCovariateMatrix::missing(int i, int j, bool flag)
+{
+	this->restoreStaging();
+
+	if (flag)
+	{
+		this->lstagedMissings[i].insert(j);
+	}
+	else
+	{
+		this->lstagedMissings[i].erase(j);
+	}
+}
+
+
+/**
+ * Converts the values stored so far to the compressed row and column
+ * arrays, and to a dense array if the covariate is dense enough.
+ * The maps used while reading the data are released.
+ */
+void DyadicCovariateMatrix::selectStorage()
+{
+	if (this->lselected)
+	{
+		return;
+	}
+
+	this->lrowStart.assign(this->ln + 1, 0);
+	this->lcolumnStart.assign(this->lm + 1, 0);
+	this->lmissingRowStart.assign(this->ln + 1, 0);
+	this->lmissingColumnStart.assign(this->lm + 1, 0);
+
+	// Count the entries per row and column
+
+	for (int i = 0; i < this->ln; i++)
+	{
+		this->lrowStart[i + 1] =
+			this->lrowStart[i] + this->lstagedValues[i].size();
+		this->lmissingRowStart[i + 1] =
+			this->lmissingRowStart[i] + this->lstagedMissings[i].size();
+
+		for (map<int, double>::const_iterator iter =
+				this->lstagedValues[i].begin();
+			iter != this->lstagedValues[i].end();
+			iter++)
+		{
+			this->lcolumnStart[iter->first + 1]++;
+		}
+
+		for (set<int>::const_iterator iter = this->lstagedMissings[i].begin();
+			iter != this->lstagedMissings[i].end();
+			iter++)
+		{
+			this->lmissingColumnStart[*iter + 1]++;
+		}
+	}
+
+	for (int j = 0; j < this->lm; j++)
+	{
+		this->lcolumnStart[j + 1] += this->lcolumnStart[j];
+		this->lmissingColumnStart[j + 1] += this->lmissingColumnStart[j];
+	}
+
+	int valueCount = this->lrowStart[this->ln];
+	int missingCount = this->lmissingRowStart[this->ln];
+
+	this->lrowActors.resize(valueCount);
+	this->lrowValues.resize(valueCount);
+	this->lcolumnActors.resize(valueCount);
+	this->lcolumnValues.resize(valueCount);
+	this->lmissingRowActors.resize(missingCount);
+	this->lmissingColumnActors.resize(missingCount);
+
+	// Fill the arrays. Rows are visited in increasing order, so the
+	// row indices within each column are increasing as well.
+
+	vector<int> columnPosition(this->lcolumnStart.begin(),
+		this->lcolumnStart.end() - 1);
+	vector<int> missingColumnPosition(this->lmissingColumnStart.begin(),
+		this->lmissingColumnStart.end() - 1);
+
+	for (int i = 0; i < this->ln; i++)
+	{
+		int position = this->lrowStart[i];
+
+		for (map<int, double>::const_iterator iter =
+				this->lstagedValues[i].begin();
+			iter != this->lstagedValues[i].end();
+			iter++)
+		{
+			this->lrowActors[position] = iter->first;
+			this->lrowValues[position] = iter->second;
+			position++;
+
+			int & rColumnPosition = columnPosition[iter->first];
+			this->lcolumnActors[rColumnPosition] = i;
+			this->lcolumnValues[rColumnPosition] = iter->second;
+			rColumnPosition++;
+		}
+
+		position = this->lmissingRowStart[i];
+
+		for (set<int>::const_iterator iter = this->lstagedMissings[i].begin();
+			iter != this->lstagedMissings[i].end();
+			iter++)
+		{
+			this->lmissingRowActors[position++] = *iter;
+			this->lmissingColumnActors[missingColumnPosition[*iter]++] = i;
+		}
+	}
+
+	// Add the dense array for dense covariates
+
+	this->ldenseValues.clear();
+
+	if (this->ln > 0 && this->lm > 0 &&
+		valueCount >= DENSE_STORAGE_DENSITY * this->ln * this->lm)
+	{
+		this->ldenseValues.assign((size_t) this->ln * this->lm, 0);
+
+		for (int i = 0; i < this->ln; i++)
+		{
+			for (int k = this->lrowStart[i]; k < this->lrowStart[i + 1]; k++)
+			{
+				this->ldenseValues[(size_t) i * this->lm + this->lrowActors[k]] =
+					this->lrowValues[k];
+			}
+		}
+	}
+
+	vector<map<int, double> >().swap(this->lstagedValues);
+	vector<set<int> >().swap(this->lstagedMissings);
+	this->lselected = true;
+}
+
+
+/**
+ * Converts the stored values back to maps, so that they can be changed.
+ * Does nothing if the storage has not been selected yet.
+ */
+void DyadicCovariateMatrix::restoreStaging()
+{
+	if (!this->lselected)
+	{
+		return;
+	}
+
+	this->lstagedValues.resize(this->ln);
+	this->lstagedMissings.resize(this->ln);
+
+	for (int i = 0; i < this->ln; i++)
+	{
+		for (int k = this->lrowStart[i]; k < this->lrowStart[i + 1]; k++)
+		{
+			this->lstagedValues[i][this->lrowActors[k]] = this->lrowValues[k];
+		}
+
+		for (int k = this->lmissingRowStart[i];
+			k < this->lmissingRowStart[i + 1];
+			k++)
+		{
+			this->lstagedMissings[i].insert(this->lmissingRowActors[k]);
+		}
+	}
+
+	this->lrowStart.clear();
+	this->lrowActors.clear();
+	this->lrowValues.clear();
+	this->lcolumnStart.clear();
+	this->lcolumnActors.clear();
+	this->lcolumnValues.clear();
+	this->lmissingRowStart.clear();
+	this->lmissingRowActors.clear();
+	this->lmissingColumnStart.clear();
+	this->lmissingColumnActors.clear();
+	this->ldenseValues.clear();
+	this->lselected = false;
+}
+
+
+/**
+ * Throws an exception if the storage has not been selected yet.
+ */
+void DyadicCovariateMatrix::requireStorage() const
+{
+	if (!this->lselected)
+	{
+		throw logic_error(
+			"The storage of the dyadic covariate has not been selected.");
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Accessors
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns if the values are stored in a dense array.
+ */
+bool DyadicCovariateMatrix::dense() const
+{
+	return !this->ldenseValues.empty();
+}
+
+
+/**
+ * Returns the value for the given pair of actors if the covariate is not
+ * stored in a dense array.
+ */
+double DyadicCovariateMatrix::sparseValue(int i, int j) const
+{
+	if (!this->lselected)
+	{
+		map<int, double>::const_iterator iter =
+			this->lstagedValues[i].find(j);
+
+		if (iter == this->lstagedValues[i].end())
+		{
+			return 0;
+		}
+
+		return iter->second;
+	}
+
+	const int * pBegin = this->lrowActors.data() + this->lrowStart[i];
+	const int * pEnd = this->lrowActors.data() + this->lrowStart[i + 1];
+	const int * pActor = lower_bound(pBegin, pEnd, j);
+
+	if (pActor == pEnd || *pActor != j)
+	{
+		return 0;
+	}
+
+	return this->lrowValues[pActor - this->lrowActors.data()];
+}
+
+
+/**
+ * Returns if the value for the given pair of actors is missing, looking
+ * it up in the missing values of row i.
+ */
+bool DyadicCovariateMatrix::sparseMissing(int i, int j) const
+{
+	if (!this->lselected)
+	{
+		return this->lstagedMissings[i].find(j) !=
+			this->lstagedMissings[i].end();
+	}
+
+	return binary_search(
+		this->lmissingRowActors.data() + this->lmissingRowStart[i],
+		this->lmissingRowActors.data() + this->lmissingRowStart[i + 1],
+		j);
+}
+
+
+/**
+ * Returns the increasing column indices of the non-zero values of the given
+ * row as a contiguous array of rowSize(i) elements. Missing values are
+ * included.
+ */
+const int * DyadicCovariateMatrix::rowActors(int i) const
+{
+	this->requireStorage();
+	return this->lrowActors.data() + this->lrowStart[i];
+}
+
+
+/**
+ * Returns the number of non-zero values of the given row, including
+ * missing values.
+ */
+int DyadicCovariateMatrix::rowSize(int i) const
+{
+	this->requireStorage();
+	return this->lrowStart[i + 1] - this->lrowStart[i];
+}
+
+
+/**
+ * Returns an iterator over non-zero values of the given row.
+ * @param[in] excludeMissings indicates if missing values should be
+ * excluded from the iteration
+ */
+DyadicCovariateValueIterator DyadicCovariateMatrix::rowValues(int i,
+	bool excludeMissings) const
+{
+	this->requireStorage();
+	const int * pMissings =
+		this->lmissingRowActors.data() + this->lmissingRowStart[i];
+	const int * pMissingsEnd = pMissings;
+
+	if (excludeMissings)
+	{
+		pMissingsEnd =
+			this->lmissingRowActors.data() + this->lmissingRowStart[i + 1];
+	}
+
+	return DyadicCovariateValueIterator(
+		this->lrowActors.data() + this->lrowStart[i],
+		this->lrowActors.data() + this->lrowStart[i + 1],
+		this->lrowValues.data() + this->lrowStart[i],
+		pMissings,
+		pMissingsEnd);
+}
+
+
+/**
+ * Returns an iterator over non-zero values of the given column.
+ * @param[in] excludeMissings indicates if missing values should be
+ * excluded from the iteration
+ */
+DyadicCovariateValueIterator DyadicCovariateMatrix::columnValues(int j,
+	bool excludeMissings) const
+{
+	this->requireStorage();
+	const int * pMissings =
+		this->lmissingColumnActors.data() + this->lmissingColumnStart[j];
+	const int * pMissingsEnd = pMissings;
+
+	if (excludeMissings)
+	{
+		pMissingsEnd = this->lmissingColumnActors.data() +
+			this->lmissingColumnStart[j + 1];
+	}
+
+	return DyadicCovariateValueIterator(
+		this->lcolumnActors.data() + this->lcolumnStart[j],
+		this->lcolumnActors.data() + this->lcolumnStart[j + 1],
+		this->lcolumnValues.data() + this->lcolumnStart[j],
+		pMissings,
+		pMissingsEnd);
+}
+
+}
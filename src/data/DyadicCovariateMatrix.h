@@ -0,0 +1,157 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: DyadicCovariateMatrix.h
+ *
+ * Description: This file contains the definition of the
+ * DyadicCovariateMatrix class.
+ *****************************************************************************/
+
+#ifndef DYADICCOVARIATEMATRIX_H_
+#define DYADICCOVARIATEMATRIX_H_
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Forward declarations
+// ----------------------------------------------------------------------------
+
+class DyadicCovariateValueIterator;
+
+
+// ----------------------------------------------------------------------------
+// Section: DyadicCovariateMatrix class
+// ----------------------------------------------------------------------------
+
+/**
+ * This class stores the values and missing value indicators of a dyadic
+ * covariate at one observation. The values are first collected in maps
+ * while the data are read. The method selectStorage then converts them
+ * to compressed row and column arrays (CSR), and if the covariate is dense
+ * enough, additionally to a row-major n x m array for constant time lookups.
+ * All accessors except value(i,j) and missing(i,j) require the storage to be
+ * selected.
+ */
+class DyadicCovariateMatrix
+{
+public:
+	DyadicCovariateMatrix(int n, int m);
+
+	void value(int i, int j, double value);
+	void missing(int i, int j, bool flag);
+	void selectStorage();
+
+	inline double value(int i, int j) const;
+	inline bool missing(int i, int j) const;
+	inline const double * denseRow(int i) const;
+	bool dense() const;
+
+	const int * rowActors(int i) const;
+	int rowSize(int i) const;
+	DyadicCovariateValueIterator rowValues(int i, bool excludeMissings) const;
+	DyadicCovariateValueIterator columnValues(int j,
+		bool excludeMissings) const;
+
+private:
+	double sparseValue(int i, int j) const;
+	bool sparseMissing(int i, int j) const;
+	void requireStorage() const;
+	void restoreStaging();
+
+	// The number of rows and columns
+	int ln {};
+	int lm {};
+
+	// Indicates if the values have been converted by selectStorage
+	bool lselected {};
+
+	// The values and missing indicators per row, collected while the
+	// data are read and released by selectStorage
+
+	std::vector<std::map<int, double> > lstagedValues;
+	std::vector<std::set<int> > lstagedMissings;
+
+	// The non-zero values in compressed row form: the values of row i
+	// are stored at the positions lrowStart[i] to lrowStart[i + 1] - 1 of
+	// lrowActors (the column indices, increasing) and lrowValues.
+
+	std::vector<int> lrowStart;
+	std::vector<int> lrowActors;
+	std::vector<double> lrowValues;
+
+	// The non-zero values in compressed column form, analogously
+
+	std::vector<int> lcolumnStart;
+	std::vector<int> lcolumnActors;
+	std::vector<double> lcolumnValues;
+
+	// The missing values in compressed row and column form
+
+	std::vector<int> lmissingRowStart;
+	std::vector<int> lmissingRowActors;
+	std::vector<int> lmissingColumnStart;
+	std::vector<int> lmissingColumnActors;
+
+	// The row-major n x m array of all values, or empty if the covariate
+	// is stored sparsely
+	std::vector<double> ldenseValues;
+};
+
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns the value for the given pair of actors.
+ */
+double DyadicCovariateMatrix::value(int i, int j) const
+{
+	if (!this->ldenseValues.empty())
+	{
+		return this->ldenseValues[(size_t) i * this->lm + j];
+	}
+
+	return this->sparseValue(i, j);
+}
+
+
+/**
+ * Returns if the value for the given pair of actors is missing.
+ */
+bool DyadicCovariateMatrix::missing(int i, int j) const
+{
+	if (this->lselected &&
+		this->lmissingRowStart[i] == this->lmissingRowStart[i + 1])
+	{
+		return false;
+	}
+
+	return this->sparseMissing(i, j);
+}
+
+
+/**
+ * Returns the values of the given row as a contiguous array of m values,
+ * or 0 if the covariate is stored sparsely.
+ */
+const double * DyadicCovariateMatrix::denseRow(int i) const
+{
+	if (this->ldenseValues.empty())
+	{
+		return 0;
+	}
+
+	return this->ldenseValues.data() + (size_t) i * this->lm;
+}
+
+}
+
+#endif /*DYADICCOVARIATEMATRIX_H_*/
@@ -19,17 +19,25 @@ namespace siena
 
 /**
  * Constructor.
- * @param[in] rValues the map storing the non-zero values w_{ij} for each j
- * @param[in] rMissings a set of actors for which the values w_{ij} are missing
+ * @param[in] pActors the increasing actors j with non-zero values w_{ij}
+ * @param[in] pActorsEnd the end of the array of actors
+ * @param[in] pValues the values w_{ij} in the order of the actors
+ * @param[in] pMissings the increasing actors j for which the values w_{ij}
+ * are missing
+ * @param[in] pMissingsEnd the end of the array of missing actors
  */
 DyadicCovariateValueIterator::DyadicCovariateValueIterator(
-	map<int, double> & rValues,
-	set<int> & rMissings)
+	const int * pActors,
+	const int * pActorsEnd,
+	const double * pValues,
+	const int * pMissings,
+	const int * pMissingsEnd)
 {
-	this->lcurrent = rValues.begin();
-	this->lend = rValues.end();
-	this->lmissingCurrent = rMissings.begin();
-	this->lmissingEnd = rMissings.end();
+	this->lcurrent = pActors;
+	this->lend = pActorsEnd;
+	this->lcurrentValue = pValues;
+	this->lmissingCurrent = pMissings;
+	this->lmissingEnd = pMissingsEnd;
 
 	this->skipMissings();
 }
@@ -46,7 +54,7 @@ int DyadicCovariateValueIterator::actor() const
 		throw InvalidIteratorException();
 	}
 
-	return this->lcurrent->first;
+	return *this->lcurrent;
 }
 
 
@@ -60,7 +68,7 @@ double DyadicCovariateValueIterator::value() const
 		throw InvalidIteratorException();
 	}
 
-	return this->lcurrent->second;
+	return *this->lcurrentValue;
 }
 
 
@@ -81,6 +89,7 @@ bool DyadicCovariateValueIterator::valid() const
 void DyadicCovariateValueIterator::next()
 {
 	this->lcurrent++;
+	this->lcurrentValue++;
 	this->skipMissings();
 }
 
@@ -93,14 +102,15 @@ void DyadicCovariateValueIterator::skipMissings()
 {
 	while (this->lmissingCurrent != this->lmissingEnd &&
 		this->lcurrent != this->lend &&
-		(*this->lmissingCurrent) <= this->lcurrent->first)
+		(*this->lmissingCurrent) <= *this->lcurrent)
 	{
-		if ((*this->lmissingCurrent) == this->lcurrent->first)
+		if ((*this->lmissingCurrent) == *this->lcurrent)
 		{
 			// The current iterator points to a non-zero value,
 			// but it is missing, so we skip it.
 
 			this->lcurrent++;
+			this->lcurrentValue++;
 		}
 
 		this->lmissingCurrent++;
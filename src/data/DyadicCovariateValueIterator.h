@@ -12,9 +12,6 @@
 #ifndef DYADICCOVARIATEVALUEITERATOR_H_
 #define DYADICCOVARIATEVALUEITERATOR_H_
 
-#include <map>
-#include <set>
-
 namespace siena
 {
 
@@ -24,10 +21,9 @@ namespace siena
  */
 class DyadicCovariateValueIterator
 {
-	// These classes needs access to the private constructor.
+	// This class needs access to the private constructor.
 
-	friend class ConstantDyadicCovariate;
-	friend class ChangingDyadicCovariate;
+	friend class DyadicCovariateMatrix;
 
 public:
 	int actor() const;
@@ -36,21 +32,29 @@ public:
 	void next();
 
 private:
-	DyadicCovariateValueIterator(std::map<int, double> & rValues,
-		std::set<int> & rMissings);
+	DyadicCovariateValueIterator(const int * pActors,
+		const int * pActorsEnd,
+		const double * pValues,
+		const int * pMissings,
+		const int * pMissingsEnd);
 	void skipMissings();
 
-	// Points to the current element in the map of values
-	std::map<int, double>::const_iterator lcurrent;
+	// Points to the current element in the array of actors with
+	// non-zero values
+	const int * lcurrent {};
+
+	// Points to the end of the array of actors
+	const int * lend {};
 
-	// Points to the end of the map of values
-	std::map<int, double>::const_iterator lend;
+	// Points to the value of the current actor
+	const double * lcurrentValue {};
 
-	// Points to the current element in the set of missing values
-	std::set<int>::const_iterator lmissingCurrent;
+	// Points to the current element in the array of actors with
+	// missing values
+	const int * lmissingCurrent {};
 
-	// Points to the end of the set of missing values
-	std::set<int>::const_iterator lmissingEnd;
+	// Points to the end of the array of missing values
+	const int * lmissingEnd {};
 };
 
 }
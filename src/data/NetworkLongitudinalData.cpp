@@ -55,25 +55,18 @@ NetworkLongitudinalData::NetworkLongitudinalData(int id,
 	this->luniversalOffset = 0;
 	this->ldensity = new double[observationCount];
 	this->loneMode = oneMode;
+	this->lpEmptyNetwork = this->createNetwork();
+
+	// The indicator networks are created when they are first needed, and
+	// the networks less missings by calculateProperties.
 
 	for (int i = 0; i < observationCount; i++)
 	{
-		if (oneMode)
-		{
-			this->lnetworks[i] = new OneModeNetwork(pSenders->n(), false);
-			this->lstructuralTieNetworks[i] =
-				new OneModeNetwork(pSenders->n(), false);
-			this->lmissingTieNetworks[i] =
-				new OneModeNetwork(pSenders->n(), false);
-		}
-		else
-		{
-			this->lnetworks[i] = new Network(pSenders->n(), pReceivers->n());
-			this->lstructuralTieNetworks[i] =
-				new Network(pSenders->n(), pReceivers->n());
-			this->lmissingTieNetworks[i] =
-				new Network(pSenders->n(), pReceivers->n());
-		}
+		this->lnetworks[i] = this->createNetwork();
+		this->lstructuralTieNetworks[i] = 0;
+		this->lmissingTieNetworks[i] = 0;
+		this->lnetworksLessMissings[i] = 0;
+		this->lnetworksLessMissingStarts[i] = 0;
 	}
 }
 
@@ -83,15 +76,16 @@ NetworkLongitudinalData::NetworkLongitudinalData(int id,
  */
 NetworkLongitudinalData::~NetworkLongitudinalData()
 {
+	this->clearDerivedNetworks();
+
 	for (int i = 0; i < this->observationCount(); i++)
 	{
 		delete this->lnetworks[i];
 		delete this->lstructuralTieNetworks[i];
 		delete this->lmissingTieNetworks[i];
-		delete this->lnetworksLessMissings[i];
-		delete this->lnetworksLessMissingStarts[i];
 	}
 
+	delete this->lpEmptyNetwork;
 	delete[] this->lnetworks;
 	delete[] this->lstructuralTieNetworks;
 	delete[] this->lmissingTieNetworks;
@@ -102,12 +96,96 @@ NetworkLongitudinalData::~NetworkLongitudinalData()
 	this->lnetworks = 0;
 	this->lstructuralTieNetworks = 0;
 	this->lmissingTieNetworks = 0;
+	this->lpEmptyNetwork = 0;
 	this->ldensity = 0;
 	this->lnetworksLessMissings = 0;
 	this->lnetworksLessMissingStarts = 0;
 }
 
 
+/**
+ * Creates an empty network between the senders and receivers of this
+ * data object.
+ */
+Network * NetworkLongitudinalData::createNetwork() const
+{
+	if (this->loneMode)
+	{
+		return new OneModeNetwork(this->pActorSet()->n(), false);
+	}
+
+	return new Network(this->pActorSet()->n(), this->lpReceivers->n());
+}
+
+
+/**
+ * Deletes the stored networks less missings, which are recreated from the
+ * current data when they are needed again. Entries sharing the observed
+ * network are not owned and only reset.
+ */
+void NetworkLongitudinalData::clearDerivedNetworks()
+{
+	for (int i = 0; i < this->observationCount(); i++)
+	{
+		if (this->lnetworksLessMissings[i] != this->lnetworks[i])
+		{
+			delete this->lnetworksLessMissings[i];
+		}
+
+		if (this->lnetworksLessMissingStarts[i] != this->lnetworks[i])
+		{
+			delete this->lnetworksLessMissingStarts[i];
+		}
+
+		this->lnetworksLessMissings[i] = 0;
+		this->lnetworksLessMissingStarts[i] = 0;
+	}
+}
+
+
+/**
+ * Derives the networks less missings of all observations from the current
+ * data. A derived network shares the observed network if there is nothing
+ * to subtract from it.
+ */
+void NetworkLongitudinalData::deriveNetworks()
+{
+	for (int i = 0; i < this->observationCount(); i++)
+	{
+		const Network * pMissingNext = this->lpEmptyNetwork;
+
+		if (i + 1 < this->observationCount())
+		{
+			pMissingNext = this->pMissingTieNetwork(i + 1);
+		}
+
+		if (this->pMissingTieNetwork(i)->tieCount() == 0)
+		{
+			this->lnetworksLessMissingStarts[i] = this->lnetworks[i];
+		}
+		else
+		{
+			Network * pNetwork = this->lnetworks[i]->clone();
+			subtractNetwork(pNetwork, this->pMissingTieNetwork(i));
+			this->lnetworksLessMissingStarts[i] = pNetwork;
+		}
+
+		if (this->pMissingTieNetwork(i)->tieCount() == 0 &&
+			pMissingNext->tieCount() == 0)
+		{
+			this->lnetworksLessMissings[i] = this->lnetworks[i];
+		}
+		else
+		{
+			Network * pNetwork = this->lnetworks[i]->clone();
+			subtractNetwork(pNetwork, this->pMissingTieNetwork(i));
+			subtractNetwork(pNetwork, pMissingNext);
+			this->lnetworksLessMissings[i] = pNetwork;
+		}
+	}
+}
+
+
 // ----------------------------------------------------------------------------
 // Section: Preprocessing
 // ----------------------------------------------------------------------------
@@ -132,7 +210,8 @@ void NetworkLongitudinalData::calculateProperties()
 		observation++)
 	{
 		Network * pNetwork = this->lnetworks[observation];
-		Network * pMissingNetwork = this->lmissingTieNetworks[observation];
+		const Network * pMissingNetwork =
+			this->pMissingTieNetwork(observation);
 
 		for (int i = 0; i < this->lpReceivers->n(); i++)
 		{
@@ -201,22 +280,10 @@ void NetworkLongitudinalData::calculateProperties()
 	this->laverageReciprocalDegree /=
 		this->pActorSet()->n() * this->observationCount();
 
-	// data-less-missing-values is used in calculating statistics. Since it
-	// does not change we store it, hoping we have enough space!
-	for (int i = 0; i < this->observationCount(); i++)
-	{
-		this->lnetworksLessMissings[i] = this->pNetwork(i)->clone();
-		this->lnetworksLessMissingStarts[i] = this->pNetwork(i)->clone();
-		subtractNetwork(this->lnetworksLessMissings[i],
-			this->pMissingTieNetwork(i));
-		subtractNetwork(this->lnetworksLessMissingStarts[i],
-			this->pMissingTieNetwork(i));
-	}
-	for (int i = 1; i < this->observationCount(); i++)
-	{
-		subtractNetwork(this->lnetworksLessMissings[i - 1],
-			this->pMissingTieNetwork(i));
-	}
+	// The data-less-missing-values used in calculating statistics are
+	// derived from the current data.
+	this->clearDerivedNetworks();
+	this->deriveNetworks();
 }
 
 
@@ -258,6 +325,11 @@ const Network * NetworkLongitudinalData::pNetwork(int observation) const
 const Network * NetworkLongitudinalData::pStructuralTieNetwork(int observation)
 	const
 {
+	if (!this->lstructuralTieNetworks[observation])
+	{
+		return this->lpEmptyNetwork;
+	}
+
 	return this->lstructuralTieNetworks[observation];
 }
 
@@ -269,12 +341,17 @@ const Network * NetworkLongitudinalData::pStructuralTieNetwork(int observation)
 const Network * NetworkLongitudinalData::pMissingTieNetwork(int observation)
 	const
 {
+	if (!this->lmissingTieNetworks[observation])
+	{
+		return this->lpEmptyNetwork;
+	}
+
 	return this->lmissingTieNetworks[observation];
 }
 
 /**
  * Returns the network with missing values start or end zeroed, for the given
- * observation.
+ * observation. If no values are missing, this is the observed network itself.
  */
 const Network * NetworkLongitudinalData::pNetworkLessMissing(int observation)
 	const
@@ -323,7 +400,7 @@ void NetworkLongitudinalData::tieValue(int i,
  */
 bool NetworkLongitudinalData::missing(int i, int j, int observation) const
 {
-	return this->lmissingTieNetworks[observation]->tieValue(i, j);
+	return this->pMissingTieNetwork(observation)->tieValue(i, j);
 }
 
 
@@ -335,9 +412,14 @@ void NetworkLongitudinalData::missing(int i, int j, int observation, bool flag)
 {
 	if (flag)
 	{
+		if (!this->lmissingTieNetworks[observation])
+		{
+			this->lmissingTieNetworks[observation] = this->createNetwork();
+		}
+
 		this->lmissingTieNetworks[observation]->setTieValue(i, j, 1);
 	}
-	else
+	else if (this->lmissingTieNetworks[observation])
 	{
 		this->lmissingTieNetworks[observation]->setTieValue(i, j, 0);
 	}
@@ -350,7 +432,7 @@ void NetworkLongitudinalData::missing(int i, int j, int observation, bool flag)
  */
 bool NetworkLongitudinalData::structural(int i, int j, int observation) const
 {
-	return this->lstructuralTieNetworks[observation]->tieValue(i, j);
+	return this->pStructuralTieNetwork(observation)->tieValue(i, j);
 }
 
 
@@ -365,9 +447,14 @@ void NetworkLongitudinalData::structural(int i,
 {
 	if (flag)
 	{
+		if (!this->lstructuralTieNetworks[observation])
+		{
+			this->lstructuralTieNetworks[observation] = this->createNetwork();
+		}
+
 		this->lstructuralTieNetworks[observation]->setTieValue(i, j, 1);
 	}
-	else
+	else if (this->lstructuralTieNetworks[observation])
 	{
 		this->lstructuralTieNetworks[observation]->setTieValue(i, j, 0);
 	}
@@ -381,7 +468,7 @@ void NetworkLongitudinalData::structural(int i,
 int NetworkLongitudinalData::structuralTieCount(int actor, int observation)
 	const
 {
-	return this->lstructuralTieNetworks[observation]->outDegree(actor);
+	return this->pStructuralTieNetwork(observation)->outDegree(actor);
 }
 
 /**
@@ -31,6 +31,10 @@ class Network;
 
 /**
 * This class stores one or more observations of a network variable.
+* The networks less missings are derived from the observations by
+* calculateProperties, which must be called again whenever the observations
+* change. After that the accessors do not change the object, so it can be
+* shared by several threads.
 */
 class NetworkLongitudinalData : public LongitudinalData
 {
@@ -99,19 +103,28 @@ const ActorSet * lpReceivers;
 Network ** lnetworks;
 
 // Structural tie indicators per each observation stored as
-// binary networks for efficiency
+// binary networks for efficiency. A network is only allocated when
+// the first indicator of its observation is set; until then the entry
+// is 0 and lpEmptyNetwork stands in for it.
 
 Network ** lstructuralTieNetworks;
 
-// Missing tie indicators per each observation stored as
-// binary networks for efficiency
+// Missing tie indicators per each observation, allocated on demand
+// like the structural tie indicators
 
 Network ** lmissingTieNetworks;
 
-// A collection of networks, one per each observation
+// An empty network shared by all observations without any structural
+// or missing ties
+Network * lpEmptyNetwork;
+
+// The observed networks less the ties missing at the observation or
+// at the next one, derived by calculateProperties. If no ties are
+// missing, the entry is the observed network itself rather than a copy.
 Network ** lnetworksLessMissings;
 
-// A collection of networks, one per each observation
+// The observed networks less the ties missing at the observation,
+// derived and shared like lnetworksLessMissings
 Network ** lnetworksLessMissingStarts;
 
 // The maximum permitted out-degree of an actor. Infinity by default.
@@ -143,6 +156,10 @@ bool loneMode {};
 
 // vector of setting names for this network
 std::vector<SettingInfo> lsettingNames;
+
+Network * createNetwork() const;
+void clearDerivedNetworks();
+void deriveNetworks();
 };
 
 }
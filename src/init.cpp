@@ -33,16 +33,24 @@ static const R_CallMethodDef CallEntries[] = {
    CALLDEF(DyadicCovariates, 2),
    CALLDEF(effects, 2),
    CALLDEF(ExogEvent, 2),
+   CALLDEF(finiteDifferences, 7),
    CALLDEF(forwardModel, 17),
    CALLDEF(getChainProbabilities, 8),
-   CALLDEF(getTargets, 6),
+   CALLDEF(getInstrumentation, 0),
+   CALLDEF(getTargets, 7),
    CALLDEF(interactionEffects, 2),
    CALLDEF(mlInitializeSubProcesses, 10),
-   CALLDEF(mlMakeChains, 9),
+   CALLDEF(mlMakeChains, 10),
    CALLDEF(mlPeriod, 14),
    CALLDEF(OneMode, 2),
+   CALLDEF(phase2Subphase, 5),
+   CALLDEF(setAuxiliaryStatistics, 3),
+   CALLDEF(setChainStoreBudget, 2),
+   CALLDEF(setInstrumentation, 2),
+   CALLDEF(setSparseTwoMode, 2),
    CALLDEF(setupData, 2),
    CALLDEF(setupModelOptions, 12),
+   CALLDEF(simulateReplications, 7),
     {NULL, NULL, 0}
 };
 
@@ -19,6 +19,7 @@
 #include "EpochSimulation.h"
 #include "utils/Random.h"
 #include "utils/Utils.h"
+#include "utils/Instrumentation.h"
 #include "data/ActorSet.h"
 #include "data/ExogenousEvent.h"
 #include "data/LongitudinalData.h"
@@ -316,6 +317,7 @@ void EpochSimulation::initialize(int period) {
 
 	// Reset the time
 	this->ltime = 0;
+	this->lstepCount = 0;
 
 	// Exogenous events
 	this->lpEvents = this->lpData->pEventSet(period);
@@ -350,25 +352,15 @@ void EpochSimulation::runEpoch(int period) {
 					>= this->ltargetChange) {
 				break;
 			} else if (nIter > 1000000) {
-#ifdef STANDALONE
-				exit(1);
-#endif
-#ifndef STANDALONE
-				Rf_error("%s %s", "Unlikely to terminate this epoch:",
+				engineError("%s %s", "Unlikely to terminate this epoch:",
 						" more than 1000000 steps");
-#endif
 			}
 		} else {
 			if (this->ltime >= 1) {
 				break;
 			} else if (nIter > 1000000) {
-#ifdef STANDALONE
-				exit(1);
-#endif
-#ifndef STANDALONE
-				Rf_error("%s %s", "Unlikely to terminate this epoch:",
+				engineError("%s %s", "Unlikely to terminate this epoch:",
 						" more than 1000000 steps");
-#endif
 			}
 		}
 	}
@@ -385,6 +377,9 @@ void EpochSimulation::runEpoch(int period) {
  * Simulates a single step of the actor-oriented model.
  */
 void EpochSimulation::runStep() {
+	static const int slot = Instrumentation::slot(PHASE, "runStep");
+	InstrumentationTimer timer(slot);
+	this->lstepCount++;
 	this->calculateRates();
 	this->drawTimeIncrement();
 	double nextTime = this->ltime + this->ltau;
@@ -472,6 +467,8 @@ void EpochSimulation::runStep() {
  * the total rates of change for each variable summed over all actors.
  */
 void EpochSimulation::calculateRates() {
+	static const int slot = Instrumentation::slot(PHASE, "calculateRates");
+	InstrumentationTimer timer(slot);
 	this->lgrandTotalRate = 0;
 
 	for (unsigned i = 0; i < this->lvariables.size(); i++) {
@@ -487,18 +484,13 @@ void EpochSimulation::calculateRates() {
  */
 void EpochSimulation::drawTimeIncrement() {
 	// use QAD if parallel running as other one uses 2 random numbers
-	// also use QAD if STANDALONE (SienaProfile.cpp)
 	double tau;
 
-#ifndef STANDALONE
 	if (this->lpModel->parallelRun()) {
-#endif
 		tau = nextExponentialQAD(this->lgrandTotalRate);
-#ifndef STANDALONE
 	} else {
 		tau = nextExponential(this->lgrandTotalRate);
 	}
-#endif
 
 	this->ltau = tau;
 }
@@ -600,9 +592,14 @@ DependentVariable * EpochSimulation::chooseVariable() const {
 
 /**
  * Chooses a random actor with probabilities proportional to the rate of change
- * for the given variable.
+ * for the given variable. Symmetric networks of model type B keep their rates
+ * in a tree, from which the actor is drawn without summing all rates.
  */
 int EpochSimulation::chooseActor(const DependentVariable * pVariable) const {
+	if (pVariable->symmetric() && pVariable->networkModelTypeB()) {
+		return pVariable->randomActor();
+	}
+
 	for (int i = 0; i < pVariable->n(); i++) {
 		this->lcummulativeRates[i] = pVariable->rate(i);
 
@@ -644,14 +641,16 @@ void EpochSimulation::updateContinuousVariablesAndScores() {
 	// up to now only for one continuous variable
 	// function is never called if lcontVar's.size() == 0
 	if (this->lcontinuousVariables.size() > 1) {
-		Rf_error("EpochSimulation: Not more than one continuous variable.");
+		engineError("EpochSimulation: Not more than one continuous variable.");
 	}
 
 	ContinuousVariable * pVariable = this->lcontinuousVariables[0];
 	pVariable->calculateEffectContribution();
 	
-	vector<double> actorMeans(pVariable->n());
-	vector<double> actorErrors(pVariable->n());
+	vector<double> & actorMeans = this->lactorMeans;
+	vector<double> & actorErrors = this->lactorErrors;
+	actorMeans.resize(pVariable->n());
+	actorErrors.resize(pVariable->n());
 	
 	for (int actor = 0; actor < pVariable->n(); actor++) 
 	{
@@ -718,6 +717,16 @@ void EpochSimulation::pChain(Chain * pChain) {
 	this->lpChain = pChain;
 }
 
+/**
+ * Returns the chain of this object and leaves the object without a chain.
+ * The caller takes ownership of the chain.
+ */
+Chain * EpochSimulation::releaseChain() {
+	Chain * pChain = this->lpChain;
+	this->lpChain = 0;
+	return pChain;
+}
+
 /**
  * Clears the chain representing the events simulated by this object to the
  * given chain.
@@ -804,6 +813,14 @@ double EpochSimulation::time() const {
 	return this->ltime;
 }
 
+/**
+ * Returns the number of steps simulated since the start of the period,
+ * including the final step truncated at time 1.
+ */
+int EpochSimulation::stepCount() const {
+	return this->lstepCount;
+}
+
 /**
  * Returns the current score for the given effect. The scores are updated
  * in each ministep of the simulation.
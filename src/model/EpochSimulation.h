@@ -69,6 +69,7 @@ public:
 			const ActorSet * pOriginalActorSet) const;
 	int period() const;
 	double time() const;
+	int stepCount() const;
 	Cache * pCache() const;
 
 	// Scores
@@ -84,6 +85,7 @@ public:
 			double value);
 	Chain * pChain();
 	void  pChain(Chain * pChain);
+	Chain * releaseChain();
 	void clearChain();
 	void updateParameters(int period);
 	double calculateLikelihood() const;
@@ -154,6 +156,15 @@ private:
 	// The current increment of time of the simulation
 	double ltau {};
 
+	// The deterministic and random parts of the last change of the
+	// continuous variable per actor, kept between steps to avoid
+	// allocating them in each step
+	std::vector<double> lactorMeans;
+	std::vector<double> lactorErrors;
+
+	// The number of steps taken since the start of the period
+	int lstepCount {};
+
 	// A sorted set of exogenous events of composition change
 	const EventSet * lpEvents;
 
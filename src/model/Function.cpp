@@ -10,6 +10,7 @@
 
 #include "Function.h"
 #include "utils/Utils.h"
+#include "model/EffectInfo.h"
 #include "model/effects/Effect.h"
 
 
@@ -39,7 +40,34 @@ Function::~Function()
  */
 void Function::addEffect(Effect * pEffect)
 {
+	const EffectInfo * pEffectInfo = pEffect->pEffectInfo();
+	std::vector<int> interactingEffects;
+
+	if (pEffectInfo->pEffectInfo1())
+	{
+		const EffectInfo * interactingInfos[] = {pEffectInfo->pEffectInfo1(),
+			pEffectInfo->pEffectInfo2(),
+			pEffectInfo->pEffectInfo3()};
+
+		for (int k = 0; k < 3 && interactingInfos[k]; k++)
+		{
+			std::map<const EffectInfo *, int>::const_iterator iter =
+				this->leffectIndices.find(interactingInfos[k]);
+
+			if (iter == this->leffectIndices.end())
+			{
+				// Some interacting effect is not part of this function
+				interactingEffects.clear();
+				break;
+			}
+
+			interactingEffects.push_back(iter->second);
+		}
+	}
+
+	this->leffectIndices[pEffectInfo] = this->leffects.size();
 	this->leffects.push_back(pEffect);
+	this->linteractingEffects.push_back(interactingEffects);
 }
 
 
@@ -51,4 +79,33 @@ const std::vector<Effect *> & Function::rEffects() const
 	return this->leffects;
 }
 
+
+/**
+ * Returns the effect of this function with the given effect info, or 0 if
+ * there is no such effect.
+ */
+Effect * Function::pEffect(const EffectInfo * pEffectInfo) const
+{
+	std::map<const EffectInfo *, int>::const_iterator iter =
+		this->leffectIndices.find(pEffectInfo);
+
+	if (iter == this->leffectIndices.end())
+	{
+		return 0;
+	}
+
+	return this->leffects[iter->second];
+}
+
+
+/**
+ * Returns the indices of the effects interacting in the i-th effect of
+ * this function if it is a user-defined interaction of effects preceding
+ * it in this function, and an empty vector otherwise.
+ */
+const std::vector<int> & Function::rInteractingEffects(int i) const
+{
+	return this->linteractingEffects[i];
+}
+
 }
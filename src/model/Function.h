@@ -11,6 +11,7 @@
 #ifndef FUNCTION_H_
 #define FUNCTION_H_
 
+#include <map>
 #include <vector>
 
 namespace siena
@@ -21,6 +22,7 @@ namespace siena
 // ----------------------------------------------------------------------------
 
 class Effect;
+class EffectInfo;
 
 
 // ----------------------------------------------------------------------------
@@ -30,6 +32,11 @@ class Effect;
 /**
  * This class defines an evaluation or endowment function as a collection of
  * effects.
+ *
+ * The function also records which of its user-defined interaction effects
+ * interact effects of the same function, so that the contributions of such
+ * interactions can be derived from the contributions of the interacting
+ * effects instead of being calculated again.
  */
 class Function
 {
@@ -39,9 +46,20 @@ public:
 	void addEffect(Effect * pEffect);
 	const std::vector<Effect *> & rEffects() const;
 
+	Effect * pEffect(const EffectInfo * pEffectInfo) const;
+	const std::vector<int> & rInteractingEffects(int i) const;
+
 private:
 	// A list of effects defining this function
 	std::vector<Effect *> leffects;
+
+	// The index of each effect in leffects by its effect info
+	std::map<const EffectInfo *, int> leffectIndices;
+
+	// For each effect in leffects, the indices of the interacting effects
+	// if it is an interaction of preceding effects of this function, and
+	// an empty vector otherwise
+	std::vector<std::vector<int> > linteractingEffects;
 };
 
 }
@@ -19,6 +19,8 @@
 #include "model/variables/DependentVariable.h"
 #include "model/effects/AllEffects.h"
 #include "model/ml/Chain.h"
+#include "model/ml/ChainStore.h"
+#include "model/auxiliary/AuxiliaryStatistic.h"
 #include <Rinternals.h>
 
 using namespace std;
@@ -39,9 +41,11 @@ Model::Model()
 	this->lbasicScaleParameters = 0;
 	this->lGMMModel = false;
 	this->lneedChain = false;
+	this->lpChainStore = new ChainStore();
 	this->lneedScores = false;
 	this->lneedDerivatives = false;
 	this->lparallelRun = false;
+	this->lsparseTwoMode = false;
 	this->linsertDiagonalProbability = 0;
 	this->lcancelDiagonalProbability = 0;
 	this->lpermuteProbability = 0;
@@ -81,6 +85,7 @@ Model::~Model()
 		delete[] array;
 	}
 	deallocateVector(this->leffects);
+	deallocateVector(this->lauxiliaryStatistics);
 
 	// Delete the arrays of target changes
 
@@ -91,10 +96,7 @@ Model::~Model()
 		delete[] array;
 	}
 
-	for (unsigned i = 0; i < this->lchainStore.size(); i++)
-	{
-		deallocateVector(this->lchainStore[i]);
-	}
+	delete this->lpChainStore;
 	
 	// Delete the array of basic scale parameters
 	delete[] this->lbasicScaleParameters;
@@ -206,6 +208,24 @@ bool Model::parallelRun() const
 	return this->lparallelRun;
 }
 
+/**
+ * Stores if the alters of two-mode networks may be drawn from a tree of
+ * receiver weights (see NetworkVariable::chooseSparseTwoModeAlter)
+ */
+void Model::sparseTwoMode(bool flag)
+{
+	this->lsparseTwoMode = flag;
+}
+
+/**
+ * Returns if the alters of two-mode networks may be drawn from a tree of
+ * receiver weights
+ */
+bool Model::sparseTwoMode() const
+{
+	return this->lsparseTwoMode;
+}
+
 /**
  * Stores if change contribution are needed in the current simulation
  */
@@ -222,6 +242,32 @@ bool Model::needChangeContributions() const
 	return this->lneedChangeContributions2;
 }
 
+/**
+ * Adds an auxiliary statistic to be calculated at the end of each simulated
+ * period. The model takes the ownership of the statistic.
+ */
+void Model::addAuxiliaryStatistic(AuxiliaryStatistic * pStatistic)
+{
+	this->lauxiliaryStatistics.push_back(pStatistic);
+}
+
+/**
+ * Returns the auxiliary statistics to be calculated at the end of each
+ * simulated period.
+ */
+const vector<AuxiliaryStatistic *> & Model::rAuxiliaryStatistics() const
+{
+	return this->lauxiliaryStatistics;
+}
+
+/**
+ * Removes and deletes all auxiliary statistics.
+ */
+void Model::clearAuxiliaryStatistics()
+{
+	deallocateVector(this->lauxiliaryStatistics);
+}
+
 /**
  * Stores the number of ML steps
  */
@@ -377,7 +423,7 @@ double Model::basicRateParameter(LongitudinalData * pDependentVariableData,
 void Model::basicScaleParameter(int period, double value)
 {
 	if (period >= this->lnumberOfPeriods)
-		Rf_error("Array basicScaleParameter out of bounds\n");
+		engineError("Array basicScaleParameter out of bounds\n");
 		
 	if (!this->lbasicScaleParameters)
 	{
@@ -401,7 +447,7 @@ void Model::basicScaleParameter(int period, double value)
 double Model::basicScaleParameter(int period) const
 {
 	if (period >= this->lnumberOfPeriods)
-		Rf_error("Array basicScaleParameter out of bounds\n");
+		engineError("Array basicScaleParameter out of bounds\n");
 
 	return this->lbasicScaleParameters[period];
 }
@@ -736,25 +782,31 @@ int Model::targetChange(const Data * pData, int period) const
  */
 void Model::chainStore(const Chain& chain, int periodFromStart)
 {
-//	Rprintf(" %d %d\n", this->lchainStore.size(), periodFromStart);
-	if (this->lchainStore.size() == 0)
+	this->chainStore(chain.copyChain(), periodFromStart);
+}
+
+
+/**
+ * Stores the given chain for this period. The model takes ownership of the
+ * chain, which must not be changed afterwards.
+ */
+void Model::chainStore(Chain * pChain, int periodFromStart)
+{
+	if (this->lpChainStore->periods() == 0)
 	{
-//	Rprintf(" %d\n", this->lnumberOfPeriods);
 		this->setupChainStore(this->lnumberOfPeriods);
 	}
-	// make a copy of the chain
-	Chain * pChain = chain.copyChain();
 
-    this->lchainStore[periodFromStart].push_back(pChain);
+	this->lpChainStore->add(pChain, periodFromStart);
 }
 
 
 /**
- * Returns reference to the vector of stored chains for this period.
+ * Returns the store of chains of this model.
  */
-vector<Chain *> & Model::rChainStore(int periodFromStart)
+ChainStore * Model::pChainStore() const
 {
-	return this->lchainStore[periodFromStart];
+	return this->lpChainStore;
 }
 
 /**
@@ -762,29 +814,7 @@ vector<Chain *> & Model::rChainStore(int periodFromStart)
  */
 void Model::clearChainStore(int keep, int groupPeriod)
 {
-	int size = this->lchainStore[groupPeriod].size();
-	if (keep > 0)
-	{
-		vector<Chain *>::iterator iter = this->lchainStore[groupPeriod].begin();
-
-		for (int j = 0; j < size - keep; j++)
-		{
-			//delete the chain pointed to
-			delete this->lchainStore[groupPeriod][j];
-		}
-		this->lchainStore[groupPeriod].erase(iter, iter + size - keep);
-
-	}
-	else
-	{
-		for (int chain = 0; chain < size; chain++)
-		{
-			delete lchainStore[groupPeriod][chain];
-		}
-		this->lchainStore[groupPeriod].clear();
-
-	}
-
+	this->lpChainStore->clear(keep, groupPeriod);
 }
 
 /**
@@ -792,7 +822,7 @@ void Model::clearChainStore(int keep, int groupPeriod)
  */
 void Model::setupChainStore(int numberPeriods)
 {
-	this->lchainStore.resize(numberPeriods);
+	this->lpChainStore->periods(numberPeriods);
 }
 
 /**
@@ -800,8 +830,7 @@ void Model::setupChainStore(int numberPeriods)
  */
 void Model::deleteLastChainStore(int periodFromStart)
 {
-	delete this->lchainStore[periodFromStart].back();
-	this->lchainStore[periodFromStart].pop_back();
+	delete this->lpChainStore->removeLast(periodFromStart);
 }
 
 /**
@@ -29,6 +29,8 @@ class StructuralRateEffect;
 class Function;
 class EffectInfo;
 class Chain;
+class ChainStore;
+class AuxiliaryStatistic;
 
 
 // ----------------------------------------------------------------------------
@@ -93,7 +95,8 @@ public:
 	const std::vector<EffectInfo *> & rCreationEffects(std::string variableName) const;
 
 	void chainStore(const Chain& chain, int periodFromStart);
-	std::vector <Chain *> & rChainStore( int periodFromStart);
+	void chainStore(Chain * pChain, int periodFromStart);
+	ChainStore * pChainStore() const;
 	void clearChainStore(int keep, int periodFromStart);
 	void setupChainStore(int numberOfPeriods);
 	void deleteLastChainStore(int periodFromStart);
@@ -123,9 +126,18 @@ public:
 	void parallelRun(bool flag);
 	bool parallelRun() const;
 
+	void sparseTwoMode(bool flag);
+	bool sparseTwoMode() const;
+
 	void needChangeContributions(bool flag);
 	bool needChangeContributions() const;
 
+	// Auxiliary statistics for the goodness of fit
+
+	void addAuxiliaryStatistic(AuxiliaryStatistic * pStatistic);
+	const std::vector<AuxiliaryStatistic *> & rAuxiliaryStatistics() const;
+	void clearAuxiliaryStatistics();
+
 	// various stores for ML
 
 	void numberMLSteps(int value);
@@ -254,9 +266,17 @@ private:
 	// and score calculations
 	bool lparallelRun {};
 
+	// indicates whether the alters of two-mode networks may be drawn
+	// without evaluating every receiver, which changes the random draws
+	bool lsparseTwoMode {};
+
 	//indicates whether change contributions are needed
 	bool lneedChangeContributions2 {};
 
+	// The auxiliary statistics calculated at the end of each simulated
+	// period, owned by the model
+	std::vector<AuxiliaryStatistic *> lauxiliaryStatistics;
+
 	// number of steps in a run for ML
 	int lnumberMLSteps {};
 
@@ -289,10 +309,9 @@ private:
 	std::vector <double> lmissingNetworkProbability;
 	std::vector <double> lmissingBehaviorProbability;
 
-	// chain storage: vector of chains for each period for each set of samples
-	// lchainStore[i] is set of entries for periodFromStart <i>,
-	// which incorporates both the group and period.
-	std::vector <std::vector <Chain *> > lchainStore;
+	// chain storage: the chains for each period from start, which
+	// incorporates both the group and period.
+	ChainStore * lpChainStore {};
 
 	int lnumberOfPeriods {};
 	bool lnormalizeSettingsRates {};
@@ -24,6 +24,7 @@
 #include "model/effects/ContinuousEffect.h"
 #include "model/variables/ContinuousVariable.h"
 #include "utils/Random.h"
+#include "utils/Utils.h"
 #include <Rinternals.h>
 
 namespace siena
@@ -44,7 +45,7 @@ SdeSimulation::SdeSimulation(EpochSimulation * pSimulation)
 	
 	if (nContinuous > 1)
 	{
-		Rf_error("More than one continuous dependent variable: not implemented");
+		engineError("More than one continuous dependent variable: not implemented");
 	}
 	// for (unsigned i = 0; i < pSimulation->rcontinuousVariables.size(); i++) {
 
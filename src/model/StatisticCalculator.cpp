@@ -9,6 +9,7 @@
  * StatisticCalculator class.
  *****************************************************************************/
 
+#include <algorithm>
 #include <cstdlib>
 #include <stdexcept>
 #include <vector>
@@ -42,6 +43,8 @@
 #include "model/variables/NetworkVariable.h" // not used?
 #include "model/variables/BehaviorVariable.h" // not used?
 #include "model/tables/Cache.h"
+#include "utils/Instrumentation.h"
+#include "utils/ParallelFor.h"
 #include "network/IncidentTieIterator.h"
 #include "network/layers/DistanceTwoLayer.h"
 #include "network/iterators/UnionTieIterator.h"
@@ -78,6 +81,8 @@ StatisticCalculator::StatisticCalculator(const Data * pData,
 	this->lpStateLessMissingsEtc = new State();
 	this->lneedActorStatistics = 0;
 	this->lcountStaticChangeContributions = 0;
+	this->lownsStaticChangeContributions = true;
+	this->lthreads = 1;
 
 	this->calculateStatistics();
 }
@@ -102,6 +107,8 @@ StatisticCalculator::StatisticCalculator(const Data * pData,
 	this->lpStateLessMissingsEtc = new State();
 	this->lneedActorStatistics = returnActorStatistics;
 	this->lcountStaticChangeContributions = 0;
+	this->lownsStaticChangeContributions = true;
+	this->lthreads = 1;
 
 	this->calculateStatistics();
 }
@@ -127,16 +134,78 @@ StatisticCalculator::StatisticCalculator(const Data * pData,
 	this->lpStateLessMissingsEtc = new State();
 	this->lneedActorStatistics = returnActorStatistics;
 	this->lcountStaticChangeContributions = returnStaticChangeContributions;
+	this->lownsStaticChangeContributions = true;
+	this->lthreads = 1;
 
 	this->calculateStatistics();
 }
 
-template<typename T, typename A> // type and allocator
-static void clear_vector_of_array_pointers(vector<T*, A>& v)
+/**
+ * Constructor.
+ * @param[in] pData the observed data
+ * @param[in] pModel the model whose effect statistics are to be calculated
+ * @param[in] pState the current state of the dependent variables
+ * @param[in] period the period under consideration
+ * @param[in] returnActorStatistics whether individual actor statistics should be returned
+ * @param[in] returnStaticChangeContributions whether contributions of effects on possible next tie flips or behavior changes are needed
+ * @param[in] threads the number of threads evaluating the evaluation
+ * effects of each network variable; the data must not change meanwhile,
+ * and the instrumentation must be disabled if this is more than 1
+ */
+StatisticCalculator::StatisticCalculator(const Data * pData,
+		const Model * pModel, State * pState, int period,
+		bool returnActorStatistics, bool returnStaticChangeContributions,
+		int threads)
+{
+	this->lpData = pData;
+	this->lpModel = pModel;
+	this->lpState = pState;
+	this->lperiod = period;
+	this->lpPredictorState = new State();
+	this->lpStateLessMissingsEtc = new State();
+	this->lneedActorStatistics = returnActorStatistics;
+	this->lcountStaticChangeContributions = returnStaticChangeContributions;
+	this->lownsStaticChangeContributions = true;
+	this->lthreads = threads;
+
+	this->calculateStatistics();
+}
+
+/**
+ * Constructor for the static change contributions of the evaluation
+ * effects of network and behavior variables, which are stored in arrays
+ * provided by the caller. The array of an effect holds the contributions
+ * of the choices of each ego one after the other, where the choices are
+ * the alters up to the number of egos for a network variable and the
+ * downward change, no change and upward change for a behavior variable.
+ * Effects without an array are skipped.
+ * @param[in] pData the observed data
+ * @param[in] pModel the model whose effect statistics are to be calculated
+ * @param[in] pState the current state of the dependent variables
+ * @param[in] period the period under consideration
+ * @param[in] rStaticChangeContributions the array for each effect whose
+ * change contributions are needed
+ * @param[in] threads the number of threads, as in the constructor above;
+ * the egos of an effect are divided among them for the change contributions
+ */
+StatisticCalculator::StatisticCalculator(const Data * pData,
+		const Model * pModel, State * pState, int period,
+		const map<EffectInfo *, double *> & rStaticChangeContributions,
+		int threads)
 {
-	for (typename vector<T*, A>::iterator it = v.begin(); it != v.end(); ++it)
-		delete[] (*it);
-	v.clear();
+	this->lpData = pData;
+	this->lpModel = pModel;
+	this->lpState = pState;
+	this->lperiod = period;
+	this->lpPredictorState = new State();
+	this->lpStateLessMissingsEtc = new State();
+	this->lneedActorStatistics = 0;
+	this->lcountStaticChangeContributions = 1;
+	this->lstaticChangeContributions = rStaticChangeContributions;
+	this->lownsStaticChangeContributions = false;
+	this->lthreads = threads;
+
+	this->calculateStatistics();
 }
 
 template <typename K, typename T>
@@ -158,6 +227,15 @@ static void for_each_map_value(map<K, T>& m, void (*fn)(T&))
  * Deallocates this model.
  */
 StatisticCalculator::~StatisticCalculator()
+{
+	this->release();
+}
+
+/**
+ * Deallocates the objects owned by this calculator. The arrays of static
+ * change contributions provided by the caller are left to the caller.
+ */
+void StatisticCalculator::release()
 {
 	clear_map_value_array_pointers(this->ldistances);
 	clear_map_value_array_pointers(this->lcontinuousDistances);
@@ -173,8 +251,10 @@ StatisticCalculator::~StatisticCalculator()
 	delete this->lpPredictorState;
 	this->lpPredictorState = 0;
 
-	for_each_map_value(this->lstaticChangeContributions,
-			&clear_vector_of_array_pointers);
+	if (this->lownsStaticChangeContributions)
+	{
+		clear_map_value_array_pointers(this->lstaticChangeContributions);
+	}
 	this->lstaticChangeContributions.clear();
 
 	clear_map_value_array_pointers(this->lactorStatistics);
@@ -203,10 +283,12 @@ double StatisticCalculator::statistic(EffectInfo * pEffect) const
 
 /**
  * Returns the tie flip contributions or the behavior change contributions of the given effect.
+ * The contributions of the choices of each ego follow one after the other, with as many
+ * choices per ego as there are egos for networks and 3 for behavior.
  */
-vector<double *> StatisticCalculator::staticChangeContributions(EffectInfo * pEffect) const
+const double * StatisticCalculator::staticChangeContributions(EffectInfo * pEffect) const
 {
-	map<EffectInfo *, vector<double *> >::const_iterator iter =
+	map<EffectInfo *, double *>::const_iterator iter =
 		this->lstaticChangeContributions.find(pEffect);
 	if (iter == this->lstaticChangeContributions.end())
 	{
@@ -346,13 +428,35 @@ void StatisticCalculator::calculateStatisticsInitNetwork(NetworkLongitudinalData
 			// delete pNetwork;
 }
 
+/**
+ * Calculates the statistics for all effects of the given model, releasing
+ * the objects owned by this calculator if an error of the engine is thrown,
+ * as the destructor does not run for a constructor that throws.
+ */
+void StatisticCalculator::calculateStatistics()
+{
+	try
+	{
+		this->calculatePeriodStatistics();
+	}
+	catch (...)
+	{
+		this->release();
+		throw;
+	}
+}
+
 /**
  * Calculates the statistics for all effects of the given model. Note that
  * this->lperiod relates to the current period when simulating, but the
  * previous when calculating targets.
  */
-void StatisticCalculator::calculateStatistics()
+void StatisticCalculator::calculatePeriodStatistics()
 {
+	static const int slot =
+		Instrumentation::slot(PHASE, "calculateStatistics");
+	InstrumentationTimer timer(slot);
+
 	const vector<LongitudinalData *> & rVariables = this->lpData->rDependentVariableData();
 
 	// set up the predictor and currentLessMissingsEtc states of these variables
@@ -475,6 +579,7 @@ void StatisticCalculator::calculateNetworkGMMStatistics(
 
 	for (unsigned i = 0; i < rEffects.size(); i++) {
 		EffectInfo * pInfo = rEffects[i];
+		InstrumentationTimer timer(STATISTIC, pInfo);
 		NetworkEffect * pEffect = (NetworkEffect *) factory.createEffect(pInfo);
 
 		// Initialize the effect to work with our data and state of variables.
@@ -512,6 +617,7 @@ void StatisticCalculator::calculateBehaviorGMMStatistics(
 	Cache cache;
 	for (unsigned i = 0; i < rEffects.size(); i++) {
 		EffectInfo * pInfo = rEffects[i];
+		InstrumentationTimer timer(STATISTIC, pInfo);
 		BehaviorEffect * pEffect = (BehaviorEffect *) factory.createEffect(
 				pInfo);
 		// Initialize the effect to work with our data and state of variables.
@@ -530,39 +636,8 @@ void StatisticCalculator::calculateBehaviorGMMStatistics(
 		}
 		if (this->lcountStaticChangeContributions)
 		{
-			int choices = 3;
-			vector<double *> egosMap(pBehaviorData->n());
-			this->lstaticChangeContributions.insert(make_pair(pInfo, egosMap));
-			for (int e = 0; e < pBehaviorData->n(); e++) {
-				cache.initialize(e);
-				//			pEffect->initialize(this->lpData, this->lpPredictorState,
-				//					this->lperiod, &cache);
-				pEffect->initialize(this->lpData, this->lpPredictorState, this->lpState,
-						this->lperiod, &cache);
-				double * contributions = new double[choices];
-				this->lstaticChangeContributions[pInfo].at(e) = contributions;
-				pEffect->preprocessEgo(e);
-				// no change gives no contribution
-				this->lstaticChangeContributions[pInfo].at(e)[1] = 0;
-				// calculate the contribution of downward change
-				if ((currentState[e] > pBehaviorData->min())  // was currentValues
-						&& (!pBehaviorData->upOnly(this->lperiod)))
-				{
-					this->lstaticChangeContributions[pInfo].at(e)[0] =
-						pEffect->calculateChangeContribution(e, -1);
-				} else {
-					this->lstaticChangeContributions[pInfo].at(e)[0] = R_NaN;
-				}
-				// calculate the contribution of upward change
-				if ((currentState[e] < pBehaviorData->max())  // was currentValues
-						&& (!pBehaviorData->downOnly(this->lperiod)))
-				{
-					this->lstaticChangeContributions[pInfo].at(e)[2] =
-						pEffect->calculateChangeContribution(e, 1);
-				} else {
-					this->lstaticChangeContributions[pInfo].at(e)[2] = R_NaN;
-				}
-			}
+			this->calculateBehaviorChangeContributions(pInfo, pBehaviorData,
+				currentState, true);
 		}
 		delete pEffect;
 	}
@@ -602,12 +677,18 @@ void StatisticCalculator::calculateNetworkEvaluationStatistics(
 	const vector<EffectInfo *> & rEffects =
 		this->lpModel->rEvaluationEffects(pNetworkData->name());
 
-	EffectFactory factory(this->lpData);
-	Cache cache;
+	// The effects are independent of each other, each with a cache of its
+	// own, and may be evaluated on several threads.
 
-	for (unsigned i = 0; i < rEffects.size(); i++)
+	vector<double> statistics(rEffects.size());
+	vector<double *> actorStatistics(rEffects.size());
+
+	parallelFor(rEffects.size(), this->lthreads, [&](int i)
 	{
 		EffectInfo * pInfo = rEffects[i];
+		InstrumentationTimer timer(STATISTIC, pInfo);
+		EffectFactory factory(this->lpData);
+		Cache cache;
 		NetworkEffect * pEffect = (NetworkEffect *) factory.createEffect(pInfo);
 
 		// Initialize the effect to work with our data and state of variables.
@@ -626,75 +707,39 @@ void StatisticCalculator::calculateNetworkEvaluationStatistics(
 		if(this->lneedActorStatistics)
 		{
 			pair<double, double * > p = pEffect->evaluationStatistic(this->lneedActorStatistics);
-			this->lstatistics[pInfo] = p.first;
-			this->lactorStatistics[pInfo] = p.second;
+			statistics[i] = p.first;
+			actorStatistics[i] = p.second;
 		}
 		else
 		{
-			this->lstatistics[pInfo] = pEffect->evaluationStatistic();
+			statistics[i] = pEffect->evaluationStatistic();
 		}
 
-// I think the following is used only for sienaRI; note the "static", this is used for observations only.
-		if (this->lcountStaticChangeContributions)
+		delete pEffect;
+	});
+
+	for (unsigned i = 0; i < rEffects.size(); i++)
+	{
+		this->lstatistics[rEffects[i]] = statistics[i];
+
+		if (this->lneedActorStatistics)
 		{
-//	Rprintf(" this->lcountStaticChangeContributions in calculateNetworkEvaluationStatistics \n");
-			int egos = pCurrentLessMissingsEtc->n();
-			int alters = pCurrentLessMissingsEtc->m();
-			vector<double *> egosMap(egos);
-			this->lstaticChangeContributions.insert(make_pair(pInfo,egosMap));
-			for (int e = 0; e < egos ; e++)
-			{
-				cache.initialize(e);
-				if (pNetworkData->networkModelTypeContemp())
-				{
-					pEffect->initialize(this->lpData, this->lpStateLessMissingsEtc,
-						this->lperiod, &cache);
-				}
-				else
-				{
-					pEffect->initialize(this->lpData, this->lpPredictorState,
-						this->lperiod, &cache);
-				}
-				double * contributions = new double[egos];
-					this->lstaticChangeContributions[pInfo].at(e) = contributions;
-					pEffect->preprocessEgo(e);
-					// TODO determine permissible changes
-					// (see: NetworkVariable::calculatePermissibleChanges())
-					// TODO allow also bipartite; this requires knowledge of number of alters.
-//earlier:					for (int a = 0; a < alters ; a++)
-					for (int a = 0; a < egos ; a++)
-					{
-						if ((a == e) && (pNetworkData->oneModeNetwork()))
-						{
-							this->lstaticChangeContributions[pInfo].at(e)[a] = 0;
-						}
-						else if (a == alters)
-						{
-							this->lstaticChangeContributions[pInfo].at(e)[a] = 0;
-						}
-						else if (a > alters)
-						{
-							this->lstaticChangeContributions[pInfo].at(e)[a] = R_NaN;
-						}
-						else
-						{
-						// Tie withdrawal contributes the opposite of tie creating
-							if (pCurrentLessMissingsEtc->tieValue(e,a))
-							{
-								this->lstaticChangeContributions[pInfo].at(e)[a] =
-									-pEffect->calculateContribution(a);
-							}
-							else
-							{
-								this->lstaticChangeContributions[pInfo].at(e)[a] =
-									pEffect->calculateContribution(a);
-							}
-						}
-					}
-			}
+			this->lactorStatistics[rEffects[i]] = actorStatistics[i];
 		}
-		delete pEffect;
 	}
+
+	// The static change contributions are used only for sienaRI, for
+	// observations only.
+
+	if (this->lcountStaticChangeContributions)
+	{
+		for (unsigned i = 0; i < rEffects.size(); i++)
+		{
+			this->calculateNetworkChangeContributions(rEffects[i],
+				pNetworkData, pCurrentLessMissingsEtc);
+		}
+	}
+
 	// Restore the predictor network
 	this->lpPredictorState->pNetwork(name, pPredictorNetwork);
 }
@@ -763,6 +808,7 @@ void StatisticCalculator::calculateNetworkEndowmentStatistics(
 		for (unsigned i = 0; i < rEffects.size(); i++)
 		{
 			EffectInfo * pInfo = rEffects[i];
+			InstrumentationTimer timer(STATISTIC, pInfo);
 			NetworkEffect * pEffect =
 				(NetworkEffect *) factory.createEffect(pInfo);
 
@@ -842,6 +888,7 @@ void StatisticCalculator::calculateNetworkCreationStatistics(
 		for (unsigned i = 0; i < rEffects.size(); i++)
 		{
 			EffectInfo * pInfo = rEffects[i];
+			InstrumentationTimer timer(STATISTIC, pInfo);
 			NetworkEffect * pEffect =
 				(NetworkEffect *) factory.createEffect(pInfo);
 
@@ -927,6 +974,7 @@ void StatisticCalculator::calculateBehaviorStatistics(
 	for (unsigned i = 0; i < rEvaluationEffects.size(); i++)
 	{
 		EffectInfo * pInfo = rEvaluationEffects[i];
+		InstrumentationTimer timer(STATISTIC, pInfo);
 		BehaviorEffect * pEffect =
 			(BehaviorEffect *) factory.createEffect(pInfo);
 
@@ -949,43 +997,10 @@ void StatisticCalculator::calculateBehaviorStatistics(
 			this->lstatistics[pInfo] =
 				pEffect->evaluationStatistic(currentValues);
 		}
-		if(this->lcountStaticChangeContributions)
+		if (this->lcountStaticChangeContributions)
 		{
-			int  choices = 3;
-			vector<double *> egosMap(pBehaviorData->n());
-			this->lstaticChangeContributions.insert(make_pair(pInfo,egosMap));
-			for (int e = 0; e < pBehaviorData->n(); e++)
-			{
-				cache.initialize(e);
-				pEffect->initialize(this->lpData, this->lpPredictorState, this->lperiod, &cache);
-				double * contributions = new double[choices];
-				this->lstaticChangeContributions[pInfo].at(e) = contributions;
-				pEffect->preprocessEgo(e);
-				// no change gives no contribution
-				this->lstaticChangeContributions[pInfo].at(e)[1] = 0;
-				// calculate the contribution of downward change
-				if ((currentState[e] > pBehaviorData->min())  // was currentValues
-						&& (!pBehaviorData->upOnly(this->lperiod)))
-				{
-					this->lstaticChangeContributions[pInfo].at(e)[0] =
-						pEffect->calculateChangeContribution(e,-1);
-				}
-				else
-				{
-					this->lstaticChangeContributions[pInfo].at(e)[0] = R_NaN;
-				}
-				// calculate the contribution of upward change
-				if ((currentState[e] < pBehaviorData->max())  // was currentValues
-						&& (!pBehaviorData->downOnly(this->lperiod)))
-				{
-					this->lstaticChangeContributions[pInfo].at(e)[2] =
-						pEffect->calculateChangeContribution(e,1);
-				}
-				else
-				{
-					this->lstaticChangeContributions[pInfo].at(e)[2] = R_NaN;
-				}
-			}
+			this->calculateBehaviorChangeContributions(pInfo, pBehaviorData,
+				currentState, false);
 		}
 
 		delete pEffect;
@@ -1000,6 +1015,7 @@ void StatisticCalculator::calculateBehaviorStatistics(
 	for (unsigned i = 0; i < rEndowmentEffects.size(); i++)
 	{
 		EffectInfo * pInfo = rEndowmentEffects[i];
+		InstrumentationTimer timer(STATISTIC, pInfo);
 		BehaviorEffect * pEffect =
 			(BehaviorEffect *) factory.createEffect(pInfo);
 
@@ -1034,6 +1050,7 @@ void StatisticCalculator::calculateBehaviorStatistics(
 	for (unsigned i = 0; i < rCreationEffects.size(); i++)
 	{
 		EffectInfo * pInfo = rCreationEffects[i];
+		InstrumentationTimer timer(STATISTIC, pInfo);
 		BehaviorEffect * pEffect =
 			(BehaviorEffect *) factory.createEffect(pInfo);
 
@@ -1099,6 +1116,7 @@ void StatisticCalculator::calculateContinuousStatistics(
 	for (unsigned i = 0; i < rEffects.size(); i++)
 	{
 		EffectInfo * pInfo = rEffects[i];
+		InstrumentationTimer timer(STATISTIC, pInfo);
 		ContinuousEffect * pEffect =
 			(ContinuousEffect *) factory.createEffect(pInfo);
 
@@ -1757,6 +1775,188 @@ void StatisticCalculator::calculateContinuousRateStatistics(
 	delete[] currentValues;
 }
 
+/**
+ * Returns the array for the static change contributions of the given
+ * effect. If the calculator owns the arrays, an array of the given size
+ * is allocated for the effect; otherwise the array provided by the caller
+ * is returned, or 0 if there is none.
+ */
+double * StatisticCalculator::pStaticChangeContributions(EffectInfo * pInfo,
+	int size)
+{
+	map<EffectInfo *, double *>::iterator iter =
+		this->lstaticChangeContributions.find(pInfo);
+
+	if (iter != this->lstaticChangeContributions.end())
+	{
+		return iter->second;
+	}
+
+	if (!this->lownsStaticChangeContributions)
+	{
+		return 0;
+	}
+
+	double * contributions = new double[size];
+	this->lstaticChangeContributions[pInfo] = contributions;
+	return contributions;
+}
+
+/**
+ * Calculates the tie flip contributions of the given evaluation effect of
+ * the given network variable for each ego. The egos are divided into
+ * contiguous blocks, one per thread. Each block has an effect and a cache
+ * of its own, and the effect is initialized once per block; the cache
+ * and the preprocessing of the effect follow the ego, as in a simulation.
+ */
+void StatisticCalculator::calculateNetworkChangeContributions(
+	EffectInfo * pInfo,
+	NetworkLongitudinalData * pNetworkData,
+	const Network * pCurrentLessMissingsEtc)
+{
+	int egos = pCurrentLessMissingsEtc->n();
+	int alters = pCurrentLessMissingsEtc->m();
+	double * contributions =
+		this->pStaticChangeContributions(pInfo, egos * egos);
+
+	if (!contributions || egos == 0)
+	{
+		return;
+	}
+
+	InstrumentationTimer timer(STATISTIC, pInfo);
+	State * pState = this->lpPredictorState;
+
+	if (pNetworkData->networkModelTypeContemp())
+	{
+		pState = this->lpStateLessMissingsEtc;
+	}
+
+	int blocks = max(1, min(this->lthreads, egos));
+
+	parallelFor(blocks, blocks, [&](int block)
+	{
+		EffectFactory factory(this->lpData);
+		Cache cache;
+		NetworkEffect * pEffect = (NetworkEffect *) factory.createEffect(pInfo);
+		pEffect->initialize(this->lpData, pState, this->lperiod, &cache);
+
+		for (int e = egos * block / blocks; e < egos * (block + 1) / blocks; e++)
+		{
+			double * egoContributions = contributions + (size_t) e * egos;
+			cache.initialize(e);
+			pEffect->preprocessEgo(e);
+
+			// TODO determine permissible changes
+			// (see: NetworkVariable::calculatePermissibleChanges())
+			// For bipartite networks there are as many choices as egos,
+			// the first alters of which are used.
+
+			for (int a = 0; a < egos; a++)
+			{
+				if ((a == e) && (pNetworkData->oneModeNetwork()))
+				{
+					egoContributions[a] = 0;
+				}
+				else if (a == alters)
+				{
+					egoContributions[a] = 0;
+				}
+				else if (a > alters)
+				{
+					egoContributions[a] = R_NaN;
+				}
+				else if (pCurrentLessMissingsEtc->tieValue(e, a))
+				{
+					// Tie withdrawal contributes the opposite of tie creating
+					egoContributions[a] = -pEffect->calculateContribution(a);
+				}
+				else
+				{
+					egoContributions[a] = pEffect->calculateContribution(a);
+				}
+			}
+		}
+
+		delete pEffect;
+	});
+}
+
+/**
+ * Calculates the contributions of the downward change, no change and
+ * upward change of each ego for the given evaluation or GMM effect of the
+ * given behavior variable, dividing the egos among the threads as for
+ * network variables. Changes that are not permitted get NaN.
+ */
+void StatisticCalculator::calculateBehaviorChangeContributions(
+	EffectInfo * pInfo,
+	BehaviorLongitudinalData * pBehaviorData,
+	const int * currentState,
+	bool gmm)
+{
+	int egos = pBehaviorData->n();
+	double * contributions =
+		this->pStaticChangeContributions(pInfo, egos * 3);
+
+	if (!contributions || egos == 0)
+	{
+		return;
+	}
+
+	bool down = !pBehaviorData->upOnly(this->lperiod);
+	bool up = !pBehaviorData->downOnly(this->lperiod);
+	int blocks = max(1, min(this->lthreads, egos));
+
+	parallelFor(blocks, blocks, [&](int block)
+	{
+		EffectFactory factory(this->lpData);
+		Cache cache;
+		BehaviorEffect * pEffect =
+			(BehaviorEffect *) factory.createEffect(pInfo);
+
+		if (gmm)
+		{
+			pEffect->initialize(this->lpData, this->lpPredictorState,
+				this->lpState, this->lperiod, &cache);
+		}
+		else
+		{
+			pEffect->initialize(this->lpData, this->lpPredictorState,
+				this->lperiod, &cache);
+		}
+
+		for (int e = egos * block / blocks; e < egos * (block + 1) / blocks; e++)
+		{
+			double * egoContributions = contributions + (size_t) e * 3;
+			cache.initialize(e);
+			pEffect->preprocessEgo(e);
+
+			// no change gives no contribution
+			egoContributions[1] = 0;
+
+			if (down && currentState[e] > pBehaviorData->min())
+			{
+				egoContributions[0] = pEffect->calculateChangeContribution(e, -1);
+			}
+			else
+			{
+				egoContributions[0] = R_NaN;
+			}
+
+			if (up && currentState[e] < pBehaviorData->max())
+			{
+				egoContributions[2] = pEffect->calculateChangeContribution(e, 1);
+			}
+			else
+			{
+				egoContributions[2] = R_NaN;
+			}
+		}
+
+		delete pEffect;
+	});
+}
+
 void StatisticCalculator::calcDifferences(
 		NetworkLongitudinalData * const pNetworkData,
 		const Network* const pDifference)
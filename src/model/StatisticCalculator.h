@@ -63,10 +63,19 @@ public:
 	StatisticCalculator(const Data * pData,
 		const Model * pModel, State * pState,
 		int period, bool returnActorStatistics, bool returnStaticChangeContributions);
+	StatisticCalculator(const Data * pData,
+		const Model * pModel, State * pState,
+		int period, bool returnActorStatistics, bool returnStaticChangeContributions,
+		int threads);
+	StatisticCalculator(const Data * pData,
+		const Model * pModel, State * pState,
+		int period,
+		const std::map<EffectInfo *, double *> & rStaticChangeContributions,
+		int threads);
 	virtual ~StatisticCalculator();
 
 	double statistic(EffectInfo * pEffectInfo) const;
-	std::vector<double *> staticChangeContributions(EffectInfo * pEffect) const;
+	const double * staticChangeContributions(EffectInfo * pEffect) const;
 	double * actorStatistics(EffectInfo * pEffect) const;
 	int distance(LongitudinalData * pData, int period) const;
 	double distance(ContinuousLongitudinalData * pData, int period) const;
@@ -77,6 +86,8 @@ public:
 private:
 	void calculateStatisticsInitNetwork(NetworkLongitudinalData * pNetwork);
 	void calculateStatistics();
+	void calculatePeriodStatistics();
+	void release();
 	void calculateNetworkRateStatistics(
 		NetworkLongitudinalData * pNetworkData);
 	void calculateNetworkGMMStatistics(NetworkLongitudinalData * pNetworkData);
@@ -92,6 +103,14 @@ private:
 	void calculateBehaviorRateStatistics(BehaviorLongitudinalData * pBehaviorData);
 	void calculateContinuousStatistics(ContinuousLongitudinalData * pContinuousData);
 	void calculateContinuousRateStatistics(ContinuousLongitudinalData * pContinuousData);
+	double * pStaticChangeContributions(EffectInfo * pInfo, int size);
+	void calculateNetworkChangeContributions(EffectInfo * pInfo,
+		NetworkLongitudinalData * pNetworkData,
+		const Network * pCurrentLessMissingsEtc);
+	void calculateBehaviorChangeContributions(EffectInfo * pInfo,
+		BehaviorLongitudinalData * pBehaviorData,
+		const int * currentState,
+		bool gmm);
 
 	// The data to be used for calculating the statistics
 	const Data * lpData;
@@ -111,14 +130,23 @@ private:
 	// indicates whether change contributions are needed
 	bool lcountStaticChangeContributions {};
 
+	// The number of threads evaluating the effects of a network, or the
+	// egos of an effect for the change contributions
+	int lthreads {};
+
 	// The resulting map of statistic values
 	std::map<EffectInfo *, double> lstatistics;
 
 	// The resulting map of actor statistic values
 	std::map<EffectInfo *, double * > lactorStatistics;
 
-	// The change contributions of all effects
-	std::map<EffectInfo *, std::vector<double *> > lstaticChangeContributions;
+	// The change contributions of all effects, one array per effect with
+	// the contributions of the choices of each ego one after the other
+	std::map<EffectInfo *, double *> lstaticChangeContributions;
+
+	// indicates whether the arrays of change contributions are owned by
+	// the calculator rather than provided by the caller
+	bool lownsStaticChangeContributions {};
 
 	// Array of simulated distances per variable
 	std::map<LongitudinalData *, int *> ldistances;
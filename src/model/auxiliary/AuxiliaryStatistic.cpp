@@ -0,0 +1,316 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: AuxiliaryStatistic.cpp
+ *
+ * Description: This file contains the implementation of the
+ * AuxiliaryStatistic class.
+ *****************************************************************************/
+
+#include <stdexcept>
+#include "AuxiliaryStatistic.h"
+#include "DegreeDistribution.h"
+#include "BehaviorDistribution.h"
+#include "TriadCensus.h"
+#include "GeodesicDistribution.h"
+#include "EgoAlterCombinations.h"
+#include "data/Data.h"
+#include "data/NetworkLongitudinalData.h"
+#include "data/BehaviorLongitudinalData.h"
+#include "model/State.h"
+#include "network/Network.h"
+#include "network/TieIterator.h"
+#include "network/IncidentTieIterator.h"
+
+using namespace std;
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Construction
+// ----------------------------------------------------------------------------
+
+/**
+ * Creates the auxiliary statistic of the given type, named as the
+ * corresponding auxiliary function of sienaGOF, for the given dependent
+ * variables. Returns 0 if the type is unknown or the number of variables
+ * does not fit the type; egoAlterCombi needs a network and a behavior
+ * variable, the other types a single variable.
+ */
+AuxiliaryStatistic * AuxiliaryStatistic::create(const string & type,
+	const vector<string> & rVariableNames,
+	const vector<double> & rLevels,
+	bool cumulative)
+{
+	if (type == "egoAlterCombi")
+	{
+		if (rVariableNames.size() != 2)
+		{
+			return 0;
+		}
+
+		return new EgoAlterCombinations(rVariableNames[0], rVariableNames[1],
+			rLevels);
+	}
+
+	if (rVariableNames.size() != 1)
+	{
+		return 0;
+	}
+
+	const string & name = rVariableNames[0];
+
+	if (type == "OutdegreeDistribution")
+	{
+		return new DegreeDistribution(name, rLevels, cumulative, false);
+	}
+	else if (type == "IndegreeDistribution")
+	{
+		return new DegreeDistribution(name, rLevels, cumulative, true);
+	}
+	else if (type == "BehaviorDistribution")
+	{
+		return new BehaviorDistribution(name, rLevels, cumulative);
+	}
+	else if (type == "TriadCensus")
+	{
+		return new TriadCensus(name, rLevels);
+	}
+	else if (type == "GeodesicDistribution")
+	{
+		return new GeodesicDistribution(name, rLevels, cumulative);
+	}
+
+	return 0;
+}
+
+
+/**
+ * Creates an auxiliary statistic for the given variable with the given
+ * levels.
+ */
+AuxiliaryStatistic::AuxiliaryStatistic(const string & variableName,
+	const vector<double> & rLevels,
+	bool cumulative)
+{
+	this->lvariableName = variableName;
+	this->llevels = rLevels;
+	this->lcumulative = cumulative;
+}
+
+
+/**
+ * Deallocates this auxiliary statistic.
+ */
+AuxiliaryStatistic::~AuxiliaryStatistic()
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Accessors
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns the name of the dependent variable of this statistic.
+ */
+const string & AuxiliaryStatistic::variableName() const
+{
+	return this->lvariableName;
+}
+
+
+/**
+ * Returns the number of values of this statistic, by default the number
+ * of levels.
+ */
+int AuxiliaryStatistic::size() const
+{
+	return this->llevels.size();
+}
+
+
+/**
+ * Returns the levels of this statistic.
+ */
+const vector<double> & AuxiliaryStatistic::rLevels() const
+{
+	return this->llevels;
+}
+
+
+/**
+ * Returns if the distributions of this statistic are cumulative.
+ */
+bool AuxiliaryStatistic::cumulative() const
+{
+	return this->lcumulative;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Helpers for derived classes
+// ----------------------------------------------------------------------------
+
+/**
+ * Stores the distribution of the given observations over the levels in
+ * values: the number of observations equal to each level, or up to each
+ * level if the statistic is cumulative.
+ */
+void AuxiliaryStatistic::distribution(const vector<double> & rObservations,
+	double * values) const
+{
+	for (unsigned level = 0; level < this->llevels.size(); level++)
+	{
+		double bound = this->llevels[level];
+		int count = 0;
+
+		for (unsigned k = 0; k < rObservations.size(); k++)
+		{
+			if (this->lcumulative ? rObservations[k] <= bound :
+				rObservations[k] == bound)
+			{
+				count++;
+			}
+		}
+
+		values[level] = count;
+	}
+}
+
+
+/**
+ * Returns a copy of the simulated network with the given name, as
+ * extracted by sparseMatrixExtraction of sienaGOF: tie variables that are
+ * structurally determined at the end but not at the start of the period
+ * take their observed value at the end, and tie variables missing at the
+ * start or the end of the period are 0. The caller owns the copy.
+ */
+Network * AuxiliaryStatistic::extractNetwork(const Data * pData,
+	const State * pState,
+	const string & name,
+	int period) const
+{
+	const NetworkLongitudinalData * pNetworkData = pData->pNetworkData(name);
+	const Network * pSimulated = pState->pNetwork(name);
+
+	if (!pNetworkData || !pSimulated)
+	{
+		throw invalid_argument("No network variable named " + name + ".");
+	}
+
+	Network * pNetwork = pSimulated->clone();
+	const Network * pStructuralBefore =
+		pNetworkData->pStructuralTieNetwork(period);
+	const Network * pObservedAfter = pNetworkData->pNetwork(period + 1);
+
+	for (TieIterator iter =
+			pNetworkData->pStructuralTieNetwork(period + 1)->ties();
+		iter.valid();
+		iter.next())
+	{
+		if (!pStructuralBefore->tieValue(iter.ego(), iter.alter()))
+		{
+			pNetwork->setTieValue(iter.ego(), iter.alter(),
+				pObservedAfter->tieValue(iter.ego(), iter.alter()));
+		}
+	}
+
+	for (int observation = period; observation <= period + 1; observation++)
+	{
+		for (TieIterator iter =
+				pNetworkData->pMissingTieNetwork(observation)->ties();
+			iter.valid();
+			iter.next())
+		{
+			pNetwork->setTieValue(iter.ego(), iter.alter(), 0);
+		}
+	}
+
+	return pNetwork;
+}
+
+
+/**
+ * Stores the simulated values of the behavior variable with the given
+ * name, and flags the actors with a missing value at the start or the end
+ * of the period, as behaviorExtraction of sienaGOF.
+ */
+void AuxiliaryStatistic::extractBehavior(const Data * pData,
+	const State * pState,
+	const string & name,
+	int period,
+	vector<int> * pValues,
+	vector<bool> * pMissing) const
+{
+	const BehaviorLongitudinalData * pBehaviorData =
+		pData->pBehaviorData(name);
+	const int * values = pState->behaviorValues(name);
+
+	if (!pBehaviorData || !values)
+	{
+		throw invalid_argument("No behavior variable named " + name + ".");
+	}
+
+	int n = pBehaviorData->n();
+	pValues->assign(values, values + n);
+	pMissing->assign(n, false);
+
+	for (int i = 0; i < n; i++)
+	{
+		(*pMissing)[i] = pBehaviorData->missing(period, i) ||
+			pBehaviorData->missing(period + 1, i);
+	}
+}
+
+
+
+/**
+ * Stores the actors tied to each actor of the given one-mode network in
+ * either direction, in increasing order, as for the symmetrized network.
+ */
+void AuxiliaryStatistic::neighbors(const Network * pNetwork,
+	vector<vector<int> > * pNeighbors) const
+{
+	int n = pNetwork->n();
+	pNeighbors->assign(n, vector<int>());
+
+	for (int i = 0; i < n; i++)
+	{
+		vector<int> & rNeighbors = (*pNeighbors)[i];
+		IncidentTieIterator outIter = pNetwork->outTies(i);
+		IncidentTieIterator inIter = pNetwork->inTies(i);
+
+		// Merge the sorted out-neighbors and in-neighbors
+
+		while (outIter.valid() || inIter.valid())
+		{
+			int j;
+
+			if (!inIter.valid() ||
+				(outIter.valid() && outIter.actor() < inIter.actor()))
+			{
+				j = outIter.actor();
+				outIter.next();
+			}
+			else if (!outIter.valid() || inIter.actor() < outIter.actor())
+			{
+				j = inIter.actor();
+				inIter.next();
+			}
+			else
+			{
+				j = outIter.actor();
+				outIter.next();
+				inIter.next();
+			}
+
+			rNeighbors.push_back(j);
+		}
+	}
+}
+
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: AuxiliaryStatistic.h
+ *
+ * Description: This file contains the definition of the
+ * AuxiliaryStatistic class.
+ *****************************************************************************/
+
+#ifndef AUXILIARYSTATISTIC_H_
+#define AUXILIARYSTATISTIC_H_
+
+#include <string>
+#include <vector>
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Forward declarations
+// ----------------------------------------------------------------------------
+
+class Data;
+class State;
+class Network;
+
+
+// ----------------------------------------------------------------------------
+// Section: Class definition
+// ----------------------------------------------------------------------------
+
+/**
+ * The base class of the auxiliary statistics used for assessing the goodness
+ * of fit. An auxiliary statistic is a vector of values calculated from the
+ * simulated state at the end of a period, such as a degree distribution or
+ * the triad census, and corresponds to an auxiliary function of sienaGOF.
+ * Calculating it within the simulation avoids returning the simulated
+ * networks to R.
+ *
+ * The simulated values are treated as by the extraction functions of
+ * sienaGOF: tie variables and actors with a missing value at the start or
+ * the end of the period are left out, and tie variables that become
+ * structurally determined at the end of the period take their structural
+ * value.
+ */
+class AuxiliaryStatistic
+{
+public:
+	static AuxiliaryStatistic * create(const std::string & type,
+		const std::vector<std::string> & rVariableNames,
+		const std::vector<double> & rLevels,
+		bool cumulative);
+
+	AuxiliaryStatistic(const std::string & variableName,
+		const std::vector<double> & rLevels,
+		bool cumulative);
+	virtual ~AuxiliaryStatistic();
+
+	const std::string & variableName() const;
+	virtual int size() const;
+
+	/**
+	 * Stores the size() values of this statistic for the given state at
+	 * the end of the given period in the array values.
+	 */
+	virtual void calculate(const Data * pData,
+		const State * pState,
+		int period,
+		double * values) const = 0;
+
+protected:
+	const std::vector<double> & rLevels() const;
+	bool cumulative() const;
+
+	void distribution(const std::vector<double> & rObservations,
+		double * values) const;
+	Network * extractNetwork(const Data * pData,
+		const State * pState,
+		const std::string & name,
+		int period) const;
+	void extractBehavior(const Data * pData,
+		const State * pState,
+		const std::string & name,
+		int period,
+		std::vector<int> * pValues,
+		std::vector<bool> * pMissing) const;
+	void neighbors(const Network * pNetwork,
+		std::vector<std::vector<int> > * pNeighbors) const;
+
+private:
+	// The name of the dependent variable the statistic is calculated for
+	std::string lvariableName;
+
+	// The levels of the statistic, such as the degrees counted by a degree
+	// distribution
+	std::vector<double> llevels;
+
+	// Indicates if the distributions count the observations up to each
+	// level rather than at each level
+	bool lcumulative {};
+};
+
+}
+
+#endif /* AUXILIARYSTATISTIC_H_ */
@@ -0,0 +1,56 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: BehaviorDistribution.cpp
+ *
+ * Description: This file contains the implementation of the
+ * BehaviorDistribution class.
+ *****************************************************************************/
+
+#include "BehaviorDistribution.h"
+
+using namespace std;
+
+namespace siena
+{
+
+/**
+ * Creates the distribution of the given behavior variable.
+ */
+BehaviorDistribution::BehaviorDistribution(const string & variableName,
+	const vector<double> & rLevels,
+	bool cumulative) :
+		AuxiliaryStatistic(variableName, rLevels, cumulative)
+{
+}
+
+
+/**
+ * Stores the number of actors with each value, or with at most each value
+ * if the distribution is cumulative.
+ */
+void BehaviorDistribution::calculate(const Data * pData,
+	const State * pState,
+	int period,
+	double * values) const
+{
+	vector<int> behavior;
+	vector<bool> missing;
+	this->extractBehavior(pData, pState, this->variableName(), period,
+		&behavior, &missing);
+	vector<double> observations;
+
+	for (unsigned i = 0; i < behavior.size(); i++)
+	{
+		if (!missing[i])
+		{
+			observations.push_back(behavior[i]);
+		}
+	}
+
+	this->distribution(observations, values);
+}
+
+}
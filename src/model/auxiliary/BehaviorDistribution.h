@@ -0,0 +1,44 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: BehaviorDistribution.h
+ *
+ * Description: This file contains the definition of the
+ * BehaviorDistribution class.
+ *****************************************************************************/
+
+#ifndef BEHAVIORDISTRIBUTION_H_
+#define BEHAVIORDISTRIBUTION_H_
+
+#include "AuxiliaryStatistic.h"
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Class definition
+// ----------------------------------------------------------------------------
+
+/**
+ * The distribution of the values of a behavior variable, as the auxiliary
+ * function BehaviorDistribution of sienaGOF. The levels are the values
+ * counted; actors with missing values are left out.
+ */
+class BehaviorDistribution : public AuxiliaryStatistic
+{
+public:
+	BehaviorDistribution(const std::string & variableName,
+		const std::vector<double> & rLevels,
+		bool cumulative);
+
+	virtual void calculate(const Data * pData,
+		const State * pState,
+		int period,
+		double * values) const;
+};
+
+}
+
+#endif /* BEHAVIORDISTRIBUTION_H_ */
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: DegreeDistribution.cpp
+ *
+ * Description: This file contains the implementation of the
+ * DegreeDistribution class.
+ *****************************************************************************/
+
+#include "DegreeDistribution.h"
+#include "network/Network.h"
+
+using namespace std;
+
+namespace siena
+{
+
+/**
+ * Creates the distribution of the in-degrees, if inDegrees is true, or of
+ * the out-degrees of the given network variable.
+ */
+DegreeDistribution::DegreeDistribution(const string & variableName,
+	const vector<double> & rLevels,
+	bool cumulative,
+	bool inDegrees) :
+		AuxiliaryStatistic(variableName, rLevels, cumulative)
+{
+	this->linDegrees = inDegrees;
+}
+
+
+/**
+ * Stores the number of actors with each degree, or with at most each
+ * degree if the distribution is cumulative.
+ */
+void DegreeDistribution::calculate(const Data * pData,
+	const State * pState,
+	int period,
+	double * values) const
+{
+	Network * pNetwork =
+		this->extractNetwork(pData, pState, this->variableName(), period);
+	int actors = this->linDegrees ? pNetwork->m() : pNetwork->n();
+	vector<double> degrees(actors);
+
+	for (int i = 0; i < actors; i++)
+	{
+		degrees[i] = this->linDegrees ?
+			pNetwork->inDegree(i) : pNetwork->outDegree(i);
+	}
+
+	delete pNetwork;
+	this->distribution(degrees, values);
+}
+
+}
@@ -0,0 +1,49 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: DegreeDistribution.h
+ *
+ * Description: This file contains the definition of the
+ * DegreeDistribution class.
+ *****************************************************************************/
+
+#ifndef DEGREEDISTRIBUTION_H_
+#define DEGREEDISTRIBUTION_H_
+
+#include "AuxiliaryStatistic.h"
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Class definition
+// ----------------------------------------------------------------------------
+
+/**
+ * The distribution of the out-degrees or in-degrees of a network, as the
+ * auxiliary functions OutdegreeDistribution and IndegreeDistribution of
+ * sienaGOF. The levels are the degrees counted.
+ */
+class DegreeDistribution : public AuxiliaryStatistic
+{
+public:
+	DegreeDistribution(const std::string & variableName,
+		const std::vector<double> & rLevels,
+		bool cumulative,
+		bool inDegrees);
+
+	virtual void calculate(const Data * pData,
+		const State * pState,
+		int period,
+		double * values) const;
+
+private:
+	// Indicates if the in-degrees are counted rather than the out-degrees
+	bool linDegrees {};
+};
+
+}
+
+#endif /* DEGREEDISTRIBUTION_H_ */
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: EgoAlterCombinations.cpp
+ *
+ * Description: This file contains the implementation of the
+ * EgoAlterCombinations class.
+ *****************************************************************************/
+
+#include "EgoAlterCombinations.h"
+#include "network/Network.h"
+#include "network/TieIterator.h"
+
+using namespace std;
+
+namespace siena
+{
+
+/**
+ * Creates the ego-alter combinations of the given behavior variable for
+ * the ties of the given network variable.
+ */
+EgoAlterCombinations::EgoAlterCombinations(const string & networkName,
+	const string & behaviorName,
+	const vector<double> & rLevels) :
+		AuxiliaryStatistic(networkName, rLevels, false)
+{
+	this->lbehaviorName = behaviorName;
+}
+
+
+/**
+ * Stores the number of ties for each of the requested combinations.
+ */
+void EgoAlterCombinations::calculate(const Data * pData,
+	const State * pState,
+	int period,
+	double * values) const
+{
+	vector<int> behavior;
+	vector<bool> missing;
+	this->extractBehavior(pData, pState, this->lbehaviorName, period,
+		&behavior, &missing);
+	Network * pNetwork =
+		this->extractNetwork(pData, pState, this->variableName(), period);
+	const vector<double> & rLevels = this->rLevels();
+
+	for (unsigned level = 0; level < rLevels.size(); level++)
+	{
+		values[level] = 0;
+	}
+
+	for (TieIterator iter = pNetwork->ties(); iter.valid(); iter.next())
+	{
+		int ego = iter.ego();
+		int alter = iter.alter();
+
+		if (ego >= (int) behavior.size() || alter >= (int) behavior.size() ||
+			missing[ego] || missing[alter])
+		{
+			continue;
+		}
+
+		double code = 10 * behavior[ego] + behavior[alter];
+
+		for (unsigned level = 0; level < rLevels.size(); level++)
+		{
+			if (rLevels[level] == code)
+			{
+				values[level]++;
+				break;
+			}
+		}
+	}
+
+	delete pNetwork;
+}
+
+}
@@ -0,0 +1,51 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: EgoAlterCombinations.h
+ *
+ * Description: This file contains the definition of the
+ * EgoAlterCombinations class.
+ *****************************************************************************/
+
+#ifndef EGOALTERCOMBINATIONS_H_
+#define EGOALTERCOMBINATIONS_H_
+
+#include "AuxiliaryStatistic.h"
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Class definition
+// ----------------------------------------------------------------------------
+
+/**
+ * The number of ties of a one-mode network for each combination of the
+ * values of a behavior variable of ego and alter, as the auxiliary function
+ * egoAlterCombi of sienaGOF without transformation. A combination is coded
+ * as 10 times the value of ego plus the value of alter, and the levels are
+ * the codes counted. Ties of actors with a missing behavior value are left
+ * out.
+ */
+class EgoAlterCombinations : public AuxiliaryStatistic
+{
+public:
+	EgoAlterCombinations(const std::string & networkName,
+		const std::string & behaviorName,
+		const std::vector<double> & rLevels);
+
+	virtual void calculate(const Data * pData,
+		const State * pState,
+		int period,
+		double * values) const;
+
+private:
+	// The name of the behavior variable
+	std::string lbehaviorName;
+};
+
+}
+
+#endif /* EGOALTERCOMBINATIONS_H_ */
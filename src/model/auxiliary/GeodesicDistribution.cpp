@@ -0,0 +1,121 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: GeodesicDistribution.cpp
+ *
+ * Description: This file contains the implementation of the
+ * GeodesicDistribution class.
+ *****************************************************************************/
+
+#include <cmath>
+#include <stdexcept>
+#include "GeodesicDistribution.h"
+#include "network/Network.h"
+
+using namespace std;
+
+namespace siena
+{
+
+/**
+ * Creates the geodesic distribution of the given network variable.
+ */
+GeodesicDistribution::GeodesicDistribution(const string & variableName,
+	const vector<double> & rLevels,
+	bool cumulative) :
+		AuxiliaryStatistic(variableName, rLevels, cumulative)
+{
+}
+
+
+/**
+ * Stores the number of ordered pairs at each distance, or at most at each
+ * distance if the distribution is cumulative. The distances are found by
+ * a breadth first search from every actor.
+ */
+void GeodesicDistribution::calculate(const Data * pData,
+	const State * pState,
+	int period,
+	double * values) const
+{
+	Network * pNetwork =
+		this->extractNetwork(pData, pState, this->variableName(), period);
+
+	if (!pNetwork->isOneMode())
+	{
+		delete pNetwork;
+		throw invalid_argument(
+			"The geodesic distribution needs a one-mode network.");
+	}
+
+	int n = pNetwork->n();
+	vector<vector<int> > neighbors;
+	this->neighbors(pNetwork, &neighbors);
+	delete pNetwork;
+
+	// counts[d] is the number of ordered pairs at distance d
+
+	vector<double> counts(n, 0);
+	double unconnected = 0;
+	vector<int> distances(n);
+	vector<int> queue(n);
+
+	for (int source = 0; source < n; source++)
+	{
+		distances.assign(n, -1);
+		distances[source] = 0;
+		queue[0] = source;
+		int head = 0;
+		int tail = 1;
+
+		while (head < tail)
+		{
+			int i = queue[head++];
+			counts[distances[i]]++;
+
+			for (unsigned k = 0; k < neighbors[i].size(); k++)
+			{
+				int j = neighbors[i][k];
+
+				if (distances[j] < 0)
+				{
+					distances[j] = distances[i] + 1;
+					queue[tail++] = j;
+				}
+			}
+		}
+
+		unconnected += n - tail;
+	}
+
+	for (unsigned level = 0; level < this->rLevels().size(); level++)
+	{
+		double bound = this->rLevels()[level];
+		double count = 0;
+
+		if (std::isinf(bound))
+		{
+			if (bound > 0)
+			{
+				count = this->cumulative() ? (double) n * n : unconnected;
+			}
+		}
+		else if (this->cumulative())
+		{
+			for (int d = 0; d < n && d <= bound; d++)
+			{
+				count += counts[d];
+			}
+		}
+		else if (bound >= 0 && bound < n && bound == floor(bound))
+		{
+			count = counts[(int) bound];
+		}
+
+		values[level] = count;
+	}
+}
+
+}
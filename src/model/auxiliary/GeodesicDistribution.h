@@ -0,0 +1,46 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: GeodesicDistribution.h
+ *
+ * Description: This file contains the definition of the
+ * GeodesicDistribution class.
+ *****************************************************************************/
+
+#ifndef GEODESICDISTRIBUTION_H_
+#define GEODESICDISTRIBUTION_H_
+
+#include "AuxiliaryStatistic.h"
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Class definition
+// ----------------------------------------------------------------------------
+
+/**
+ * The distribution of the geodesic distances in the symmetrized version of
+ * a one-mode network, as the GeodesicDistribution example of the sienaGOF
+ * documentation. All ordered pairs of actors are counted, including the
+ * pairs of an actor with itself at distance 0; the distance of unconnected
+ * actors is infinite, so that a level Inf counts them.
+ */
+class GeodesicDistribution : public AuxiliaryStatistic
+{
+public:
+	GeodesicDistribution(const std::string & variableName,
+		const std::vector<double> & rLevels,
+		bool cumulative);
+
+	virtual void calculate(const Data * pData,
+		const State * pState,
+		int period,
+		double * values) const;
+};
+
+}
+
+#endif /* GEODESICDISTRIBUTION_H_ */
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: TriadCensus.cpp
+ *
+ * Description: This file contains the implementation of the
+ * TriadCensus class.
+ *****************************************************************************/
+
+#include <stdexcept>
+#include "TriadCensus.h"
+#include "network/Network.h"
+
+using namespace std;
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Local declarations
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+const int TRIAD_TYPES = 16;
+
+// The triad type, numbered from 1, of each of the 64 configurations of the
+// six possible arcs of a triad, coded as by the function tricode below.
+
+const int TRICODES[64] = {1, 2, 2, 3, 2, 4, 6, 8, 2, 6, 5, 7, 3, 8, 7, 11,
+	2, 6, 4, 8, 5, 9, 9, 13, 6, 10, 9, 14, 7, 14, 12, 15,
+	2, 5, 6, 7, 6, 9, 10, 14, 4, 9, 9, 12, 8, 13, 14, 15,
+	3, 7, 8, 11, 7, 12, 14, 15, 8, 14, 13, 15, 11, 15, 15, 16};
+
+/**
+ * Returns the code of the arcs among the actors v, u, and w.
+ */
+int tricode(const Network * pNetwork, int v, int u, int w)
+{
+	return (pNetwork->tieValue(v, u) ? 1 : 0) +
+		(pNetwork->tieValue(u, v) ? 2 : 0) +
+		(pNetwork->tieValue(v, w) ? 4 : 0) +
+		(pNetwork->tieValue(w, v) ? 8 : 0) +
+		(pNetwork->tieValue(u, w) ? 16 : 0) +
+		(pNetwork->tieValue(w, u) ? 32 : 0);
+}
+
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Public interface
+// ----------------------------------------------------------------------------
+
+/**
+ * Creates the triad census of the given network variable, restricted to
+ * the types given as levels.
+ */
+TriadCensus::TriadCensus(const string & variableName,
+	const vector<double> & rLevels) :
+		AuxiliaryStatistic(variableName, rLevels, false)
+{
+}
+
+
+/**
+ * Stores the number of triads of each of the requested types.
+ */
+void TriadCensus::calculate(const Data * pData,
+	const State * pState,
+	int period,
+	double * values) const
+{
+	Network * pNetwork =
+		this->extractNetwork(pData, pState, this->variableName(), period);
+
+	if (!pNetwork->isOneMode())
+	{
+		delete pNetwork;
+		throw invalid_argument("The triad census needs a one-mode network.");
+	}
+
+	int n = pNetwork->n();
+	vector<vector<int> > neighbors;
+	this->neighbors(pNetwork, &neighbors);
+
+	double census[TRIAD_TYPES] = {};
+
+	// neighborOf[w] == v if w is a neighbor of v; seen[w] == pass if w has
+	// been counted for the current dyad
+
+	vector<int> neighborOf(n, -1);
+	vector<int> seen(n, -1);
+	int pass = 0;
+
+	for (int v = 0; v < n; v++)
+	{
+		const vector<int> & rVNeighbors = neighbors[v];
+
+		for (unsigned k = 0; k < rVNeighbors.size(); k++)
+		{
+			neighborOf[rVNeighbors[k]] = v;
+		}
+
+		for (unsigned k = 0; k < rVNeighbors.size(); k++)
+		{
+			int u = rVNeighbors[k];
+
+			if (u <= v)
+			{
+				continue;
+			}
+
+			// Visit the union of the neighbors of v and u, counting each
+			// connected triad once.
+
+			const vector<int> * lists[2] = {&rVNeighbors, &neighbors[u]};
+			int thirds = 0;
+			pass++;
+
+			for (int list = 0; list < 2; list++)
+			{
+				for (unsigned l = 0; l < lists[list]->size(); l++)
+				{
+					int w = (*lists[list])[l];
+
+					if (w == u || w == v || seen[w] == pass)
+					{
+						continue;
+					}
+
+					seen[w] = pass;
+					thirds++;
+
+					if (u < w || (v < w && w < u && neighborOf[w] != v))
+					{
+						census[TRICODES[tricode(pNetwork, v, u, w)] - 1]++;
+					}
+				}
+			}
+
+			// The triads of v, u and an actor tied to neither of them
+
+			bool mutual = pNetwork->tieValue(v, u) && pNetwork->tieValue(u, v);
+			census[mutual ? 2 : 1] += n - thirds - 2;
+		}
+	}
+
+	delete pNetwork;
+
+	double connected = 0;
+
+	for (int type = 1; type < TRIAD_TYPES; type++)
+	{
+		connected += census[type];
+	}
+
+	census[0] = (double) n * (n - 1) * (n - 2) / 6 - connected;
+
+	for (unsigned level = 0; level < this->rLevels().size(); level++)
+	{
+		int type = (int) this->rLevels()[level];
+
+		if (type < 1 || type > TRIAD_TYPES)
+		{
+			throw invalid_argument("Triad types are numbered 1 to 16.");
+		}
+
+		values[level] = census[type - 1];
+	}
+}
+
+}
@@ -0,0 +1,49 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: TriadCensus.h
+ *
+ * Description: This file contains the definition of the
+ * TriadCensus class.
+ *****************************************************************************/
+
+#ifndef TRIADCENSUS_H_
+#define TRIADCENSUS_H_
+
+#include "AuxiliaryStatistic.h"
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Class definition
+// ----------------------------------------------------------------------------
+
+/**
+ * The triad census of a one-mode network, as the auxiliary function
+ * TriadCensus of sienaGOF. The 16 triad types are numbered 1 to 16 in the
+ * order 003, 012, 102, 021D, 021U, 021C, 111D, 111U, 030T, 030C, 201,
+ * 120D, 120U, 120C, 210, 300, and the levels are the numbers of the types
+ * counted.
+ *
+ * The census is found with the algorithm of Batagelj and Mrvar (Social
+ * Networks, 2001), which only visits the triads with at least one tie, in
+ * time proportional to the number of ties times the degrees.
+ */
+class TriadCensus : public AuxiliaryStatistic
+{
+public:
+	TriadCensus(const std::string & variableName,
+		const std::vector<double> & rLevels);
+
+	virtual void calculate(const Data * pData,
+		const State * pState,
+		int period,
+		double * values) const;
+};
+
+}
+
+#endif /* TRIADCENSUS_H_ */
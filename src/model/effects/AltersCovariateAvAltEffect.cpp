@@ -48,7 +48,7 @@ AltersCovariateAvAltEffect::AltersCovariateAvAltEffect(
  */
 void AltersCovariateAvAltEffect::preprocessEgo(int ego)
 {
-// do not repeat all this:	CovariateAndNetworkBehaviorEffect::preprocessEgo(ego);
+	CovariateAndNetworkBehaviorEffect::preprocessEgo(ego);
     this->lTotalAlterValue = 0;
 	const Network * pNetwork = this->pNetwork();
 
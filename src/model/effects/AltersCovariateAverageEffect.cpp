@@ -51,7 +51,7 @@ AltersCovariateAverageEffect::AltersCovariateAverageEffect(
  */
 void AltersCovariateAverageEffect::preprocessEgo(int ego)
 {
-// do not repeat all this:	CovariateAndNetworkBehaviorEffect::preprocessEgo(ego);
+	CovariateAndNetworkBehaviorEffect::preprocessEgo(ego);
     this->lTotalAlterValue = 0;
 	const Network * pNetwork = this->pNetwork();	
 	int neighborCount = 0;
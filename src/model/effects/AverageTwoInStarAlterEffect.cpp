@@ -74,8 +74,12 @@ double AverageTwoInStarAlterEffect::calculateChangeContribution(int actor,
 
 		double sumAlterValue = 0;
 		// double denom = 0;
-		for (int h = 0; h < this->n(); h++) //inefficient?
+		// Only actors sharing an in-star with the actor contribute.
+		const std::vector<int> & alters =
+			this->pInStarTable()->nonZeroActors();
+		for (unsigned k = 0; k < alters.size(); k++)
 		{
+			int h = alters[k];
 			if (h != actor)
 			{
 				// int instars = pNetwork->inTwoStarCount(actor, j);
@@ -26,7 +26,10 @@ public:
 	BehaviorInteractionEffect(const EffectInfo * pEffectInfo,
 		BehaviorEffect * pEffect1,
 		BehaviorEffect * pEffect2,
-		BehaviorEffect * pEffect3);
+		BehaviorEffect * pEffect3,
+		bool shared1 = false,
+		bool shared2 = false,
+		bool shared3 = false);
 	virtual ~BehaviorInteractionEffect();
 
 	virtual void initialize(const Data * pData,
@@ -49,6 +52,13 @@ private:
 	BehaviorEffect * lpEffect1;
 	BehaviorEffect * lpEffect2;
 	BehaviorEffect * lpEffect3;
+
+	// Indicates if the respective interacting effect is shared with the
+	// function owning this effect, which then initializes, preprocesses,
+	// and deallocates it
+	bool lshared1 {};
+	bool lshared2 {};
+	bool lshared3 {};
 };
 
 }
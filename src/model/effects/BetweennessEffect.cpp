@@ -78,7 +78,7 @@ double BetweennessEffect::tieStatistic(int alter)
 
 	// The actor j itself doesn't count
 
-	if (this->lmark[j] >= this->lbaseMark)
+	if (this->lmarks.marked(j))
 	{
 		statistic--;
 	}
@@ -101,11 +101,11 @@ double BetweennessEffect::tieStatistic(int alter)
 	{
 		int h = iterH.actor();
 
-		if (this->lmark[h] >= this->lbaseMark &&
-			this->lmark[h] < this->lcurrentMark)
+		if (this->lmarks.marked(h) &&
+			this->lmarks.count(h) < this->lcurrentMark)
 		{
 			statistic--;
-			this->lmark[h] = this->lcurrentMark;
+			this->lmarks.count(h, this->lcurrentMark);
 		}
 	}
 
@@ -117,11 +117,11 @@ double BetweennessEffect::tieStatistic(int alter)
 	{
 		int h = iterH.actor();
 
-		if (this->lmark[h] >= this->lbaseMark &&
-			this->lmark[h] < this->lcurrentMark)
+		if (this->lmarks.marked(h) &&
+			this->lmarks.count(h) < this->lcurrentMark)
 		{
 			statistic--;
-			this->lmark[h] = this->lcurrentMark;
+			this->lmarks.count(h, this->lcurrentMark);
 		}
 	}
 
@@ -133,11 +133,11 @@ double BetweennessEffect::tieStatistic(int alter)
 	{
 		int h = iterH.actor();
 
-		if (this->lmark[h] >= this->lbaseMark &&
-			this->lmark[h] < this->lcurrentMark)
+		if (this->lmarks.marked(h) &&
+			this->lmarks.count(h) < this->lcurrentMark)
 		{
 			statistic--;
-			this->lmark[h] = this->lcurrentMark;
+			this->lmarks.count(h, this->lcurrentMark);
 		}
 	}
 
@@ -145,34 +145,6 @@ double BetweennessEffect::tieStatistic(int alter)
 }
 
 
-/**
- * This method is called at the start of the calculation of the statistic.
- */
-void BetweennessEffect::initializeStatisticCalculation()
-{
-	int n = this->pNetwork()->n();
-
-	// A helper array of marks
-
-	this->lmark = new int[n];
-	this->lcurrentMark = 0;
-
-	for (int i = 0; i < n; i++)
-	{
-		this->lmark[i] = 0;
-	}
-}
-
-
-/**
- * This method is called at the end of the calculation of the statistic.
- */
-void BetweennessEffect::cleanupStatisticCalculation()
-{
-	delete[] this->lmark;
-}
-
-
 /**
  * This method is called right before summing up the contributions of the
  * outgoing ties of the given ego in the calculation of the statistic.
@@ -181,22 +153,18 @@ void BetweennessEffect::onNextEgo(int ego)
 {
 	const Network * pNetwork = this->pNetwork();
 
-	// Mark the in-neighbors of the ego i by ensuring the following assertion:
-	// mark[h] >= currentMark <==> the tie (h,i) exists
+	// Mark the in-neighbors of the ego i, such that h is marked if and only
+	// if there's a tie from h to i.
 
-	this->lcurrentMark++;
+	this->lmarks.reset(pNetwork->n());
+	this->lcurrentMark = 1;
 
 	for (IncidentTieIterator iter = pNetwork->inTies(ego);
 		iter.valid();
 		iter.next())
 	{
-		this->lmark[iter.actor()] = this->lcurrentMark;
+		this->lmarks.mark(iter.actor());
 	}
-
-	// Remember the current mark such that mark[h] >= baseMark if and only
-	// if there's a tie from h to i.
-
-	this->lbaseMark = this->lcurrentMark;
 }
 
 }
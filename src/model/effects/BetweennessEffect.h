@@ -13,6 +13,7 @@
 #define BETWEENNESSEFFECT_H_
 
 #include "NetworkEffect.h"
+#include "utils/MarkArray.h"
 
 namespace siena
 {
@@ -28,17 +29,16 @@ public:
 	virtual double calculateContribution(int alter) const;
 
 protected:
-	virtual void initializeStatisticCalculation();
 	virtual void onNextEgo(int ego);
 	virtual double tieStatistic(int alter);
-	virtual void cleanupStatisticCalculation();
 
 private:
-	// Helper array of marks for statistic calculations
+	// Marks the in-neighbors of the current ego for statistic calculations;
+	// the counter of an in-neighbor is raised to the current mark once the
+	// in-neighbor has been discounted for the current alter.
 
-	int * lmark {};
+	MarkArray lmarks;
 	int lcurrentMark {};
-	int lbaseMark {};
 };
 
 }
@@ -97,4 +97,15 @@ double CovariateAlterEffect::tieStatistic(int alter)
 	return statistic;
 }
 
+
+/**
+ * Returns if the contribution of a new tie depends on the alter only,
+ * which holds unless the covariate is a dependent behavior variable
+ * changing during the simulation.
+ */
+bool CovariateAlterEffect::alterNewTieContribution() const
+{
+	return !this->pBehaviorData() && !this->pContinuousData();
+}
+
 }
@@ -27,6 +27,7 @@ public:
 							const bool rightThresholded, const bool squared);
 
 	virtual double calculateContribution(int alter) const;
+	virtual bool alterNewTieContribution() const;
 
 protected:
 	virtual double tieStatistic(int alter);
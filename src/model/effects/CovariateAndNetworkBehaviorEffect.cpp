@@ -9,6 +9,7 @@
  * CovariateAndNetworkBehaviorEffect class.
  *****************************************************************************/
 
+#include <climits>
 #include <stdexcept>
 //#include "R_ext/Print.h"
 
@@ -54,6 +55,8 @@ CovariateAndNetworkBehaviorEffect::~CovariateAndNetworkBehaviorEffect()
 	delete [] this->ltotalInAlterValues;
 	delete [] this->laverageAlterMissing;
 	delete [] this->laverageInAlterMissing;
+	delete [] this->lalterValueStamps;
+	delete [] this->linAlterValueStamps;
 }
 
 /**
@@ -119,6 +122,7 @@ void CovariateAndNetworkBehaviorEffect::initialize(const Data * pData,
 	this->ltotalInAlterValues = new double[this->lpNetwork->m()];
 	this->laverageAlterMissing = new bool[this->lpNetwork->n()];
 	this->laverageInAlterMissing = new bool[this->lpNetwork->m()];
+	this->initializeStamps();
 }
 
 /**
@@ -127,6 +131,7 @@ void CovariateAndNetworkBehaviorEffect::initialize(const Data * pData,
  */
 bool CovariateAndNetworkBehaviorEffect::missingDummy(int i) const
 {
+	this->updateAlterValues(i);
 	return this->laverageAlterMissing[i];
 }
 
@@ -136,6 +141,7 @@ bool CovariateAndNetworkBehaviorEffect::missingDummy(int i) const
  */
 bool CovariateAndNetworkBehaviorEffect::missingInDummy(int i) const
 {
+	this->updateInAlterValues(i);
 	return this->laverageInAlterMissing[i];
 }
 
@@ -144,6 +150,7 @@ bool CovariateAndNetworkBehaviorEffect::missingInDummy(int i) const
  */
 double CovariateAndNetworkBehaviorEffect::averageAlterValue(int i) const
 {
+	this->updateAlterValues(i);
 	return this->laverageAlterValues[i];
 }
 
@@ -152,6 +159,7 @@ double CovariateAndNetworkBehaviorEffect::averageAlterValue(int i) const
  */
 	double CovariateAndNetworkBehaviorEffect::minimumAlterValue(int i) const
 	{
+		this->updateAlterValues(i);
 		return this->lminimumAlterValues[i];
 	}
 
@@ -160,6 +168,7 @@ double CovariateAndNetworkBehaviorEffect::averageAlterValue(int i) const
  */
 	double CovariateAndNetworkBehaviorEffect::maximumAlterValue(int i) const
 	{
+		this->updateAlterValues(i);
 		return this->lmaximumAlterValues[i];
 	}
 
@@ -168,6 +177,7 @@ double CovariateAndNetworkBehaviorEffect::averageAlterValue(int i) const
  */
 double CovariateAndNetworkBehaviorEffect::totalAlterValue(int i) const
 {
+	this->updateAlterValues(i);
 	return this->ltotalAlterValues[i];
 }
 /**
@@ -175,6 +185,7 @@ double CovariateAndNetworkBehaviorEffect::totalAlterValue(int i) const
  */
 double CovariateAndNetworkBehaviorEffect::averageInAlterValue(int i) const
 {
+	this->updateInAlterValues(i);
 	return this->laverageInAlterValues[i];
 }
 
@@ -183,6 +194,7 @@ double CovariateAndNetworkBehaviorEffect::averageInAlterValue(int i) const
  */
 double CovariateAndNetworkBehaviorEffect::totalInAlterValue(int i) const
 {
+	this->updateInAlterValues(i);
 	return this->ltotalInAlterValues[i];
 }
 
@@ -195,103 +207,152 @@ void CovariateAndNetworkBehaviorEffect::preprocessEgo(int ego)
 {
 	//CovariateDependentBehaviorEffect::preprocessEgo(ego);
 
-	// set up the covariate based on current values of the network
-	const Network * pNetwork = this->pNetwork();
+	// The alter values of an actor are recalculated from the current network
+	// the first time they are queried after this call.
 
-	for (int i = 0; i < pNetwork->n(); i++)
+	if (this->lstamp == INT_MAX)
 	{
-		this->laverageAlterMissing[i] = false;
-		this->ltotalAlterValues[i] = 0;
+		this->initializeStamps();
+	}
+
+	this->lstamp++;
+}
+
+
+/**
+ * Marks the alter values of all actors as out of date.
+ */
+void CovariateAndNetworkBehaviorEffect::initializeStamps()
+{
+	delete [] this->lalterValueStamps;
+	delete [] this->linAlterValueStamps;
+	this->lalterValueStamps = new int[this->lpNetwork->n()];
+	this->linAlterValueStamps = new int[this->lpNetwork->m()];
+
+	for (int i = 0; i < this->lpNetwork->n(); i++)
+	{
+		this->lalterValueStamps[i] = 0;
+	}
+
+	for (int i = 0; i < this->lpNetwork->m(); i++)
+	{
+		this->linAlterValueStamps[i] = 0;
+	}
 
-		int counter = 1;
-		if (pNetwork->outDegree(i) > 0)
+	this->lstamp = 1;
+}
+
+
+/**
+ * Calculates the average, minimum, maximum, and total alter covariate
+ * values of the given actor, unless they are up to date since the last
+ * call to preprocessEgo.
+ */
+void CovariateAndNetworkBehaviorEffect::updateAlterValues(int i) const
+{
+	if (this->lalterValueStamps[i] == this->lstamp)
+	{
+		return;
+	}
+
+	this->lalterValueStamps[i] = this->lstamp;
+	const Network * pNetwork = this->pNetwork();
+	this->laverageAlterMissing[i] = false;
+	this->ltotalAlterValues[i] = 0;
+
+	int counter = 1;
+	if (pNetwork->outDegree(i) > 0)
+	{
+		for (IncidentTieIterator iter = pNetwork->outTies(i);
+			 iter.valid();
+			 iter.next())
 		{
-			for (IncidentTieIterator iter = pNetwork->outTies(i);
-				 iter.valid();
-				 iter.next())
-			{
-				int j = iter.actor();
+			int j = iter.actor();
 
-				if (!this->missingCovariate(j, this->period()))
+			if (!this->missingCovariate(j, this->period()))
+			{
+				if (counter == 1)
 				{
-					if (counter == 1)
+					this->lminimumAlterValues[i] = this->covariateValue(j);
+					this->lmaximumAlterValues[i] = this->covariateValue(j);
+					counter++;
+				}
+				else
+				{
+					if (this->lminimumAlterValues[i] > this->covariateValue(j))
 					{
 						this->lminimumAlterValues[i] = this->covariateValue(j);
-						this->lmaximumAlterValues[i] = this->covariateValue(j);
-						counter++;
 					}
-					else
+					if (this->lmaximumAlterValues[i] < this->covariateValue(j))
 					{
-						if (this->lminimumAlterValues[i] > this->covariateValue(j))
-						{
-							this->lminimumAlterValues[i] = this->covariateValue(j);
-						}
-						if (this->lmaximumAlterValues[i] < this->covariateValue(j))
-						{
-							this->lmaximumAlterValues[i] = this->covariateValue(j);
-				}
+						this->lmaximumAlterValues[i] = this->covariateValue(j);
 					}
 				}
-				this->ltotalAlterValues[i] += this->covariateValue(j);
-// 				Rprintf("%d %f %d %d %d %d\n",
-// 					j,
-// 					this->covariateValue(j),
-// 					this->period(),
-// 					this->missingCovariate(j, this->period()),
-// 					numberNonMissing, i);
 			}
-
-			if(counter == 1)
-			{
-				this->lminimumAlterValues[i] = this->covariateMean();
-				this->lmaximumAlterValues[i] = this->covariateMean();
-				this->laverageAlterMissing[i] = true;
-			}
-
-			this->laverageAlterValues[i] =
-					(this->ltotalAlterValues[i] / pNetwork->outDegree(i));
+			this->ltotalAlterValues[i] += this->covariateValue(j);
 		}
-		else
+
+		if(counter == 1)
 		{
-			this->laverageAlterValues[i] = this->covariateMean();
 			this->lminimumAlterValues[i] = this->covariateMean();
 			this->lmaximumAlterValues[i] = this->covariateMean();
-			this->ltotalAlterValues[i] = 0;
+			this->laverageAlterMissing[i] = true;
 		}
-//		Rprintf("%d %f\n", i,this->laverageAlterValues[i]);
+
+		this->laverageAlterValues[i] =
+				(this->ltotalAlterValues[i] / pNetwork->outDegree(i));
+	}
+	else
+	{
+		this->laverageAlterValues[i] = this->covariateMean();
+		this->lminimumAlterValues[i] = this->covariateMean();
+		this->lmaximumAlterValues[i] = this->covariateMean();
+		this->ltotalAlterValues[i] = 0;
+	}
+}
+
+
+/**
+ * Calculates the average and total in-alter covariate values of the given
+ * actor, unless they are up to date since the last call to preprocessEgo.
+ */
+void CovariateAndNetworkBehaviorEffect::updateInAlterValues(int i) const
+{
+	if (this->linAlterValueStamps[i] == this->lstamp)
+	{
+		return;
 	}
 
-	for (int i = 0; i < pNetwork->m(); i++)
+	this->linAlterValueStamps[i] = this->lstamp;
+	const Network * pNetwork = this->pNetwork();
+	this->laverageInAlterMissing[i] = false;
+	int numberNonMissing = 0;
+	this->ltotalInAlterValues[i] = 0;
+	if (pNetwork->inDegree(i) > 0)
 	{
-		this->laverageInAlterMissing[i] = false;
-		int numberNonMissing = 0;
-		this->ltotalInAlterValues[i] = 0;
-		if (pNetwork->inDegree(i) > 0)
+		for (IncidentTieIterator iter = pNetwork->inTies(i);
+			 iter.valid();
+			 iter.next())
 		{
-			for (IncidentTieIterator iter = pNetwork->inTies(i);
-				 iter.valid();
-				 iter.next())
+			int j = iter.actor();
+			this->ltotalInAlterValues[i] += this->covariateValue(j);
+			if (!this->missingCovariate(j, this->period()))
 			{
-				int j = iter.actor();
-				this->ltotalInAlterValues[i] += this->covariateValue(j);
-				if (!this->missingCovariate(j, this->period()))
-				{
-					numberNonMissing++;
-				}
-			}
-			this->laverageInAlterValues[i] =
-					(this->ltotalInAlterValues[i] / pNetwork->inDegree(i));
-			if (numberNonMissing == 0)
-			{
-				this->laverageInAlterMissing[i] = true;
+				numberNonMissing++;
 			}
 		}
-		else
+		this->laverageInAlterValues[i] =
+				(this->ltotalInAlterValues[i] / pNetwork->inDegree(i));
+		if (numberNonMissing == 0)
 		{
-			this->laverageInAlterValues[i] = this->covariateMean();
-			this->ltotalInAlterValues[i] = 0;
+			this->laverageInAlterMissing[i] = true;
 		}
 	}
+	else
+	{
+		this->laverageInAlterValues[i] = this->covariateMean();
+		this->ltotalInAlterValues[i] = 0;
+	}
 }
 
 }
@@ -58,6 +58,10 @@ protected:
 	inline const Network * pNetwork() const;
 
 private:
+	void initializeStamps();
+	void updateAlterValues(int i) const;
+	void updateInAlterValues(int i) const;
+
 	// The network this effect is interacting with
 	const Network * lpNetwork;
 	double * laverageAlterValues {};
@@ -68,6 +72,12 @@ private:
 	double * ltotalInAlterValues {};
 	bool * laverageAlterMissing {};
 	bool * laverageInAlterMissing {};
+	// The value of lstamp when the out- and in-alter values of each actor
+	// were last calculated
+	int * lalterValueStamps {};
+	int * linAlterValueStamps {};
+	// Incremented by each call to preprocessEgo
+	int lstamp {};
 };
 
 // ----------------------------------------------------------------------------
@@ -66,6 +66,33 @@ void CovariateDependentBehaviorEffect::initialize(const Data * pData,
 			name +
 			"' expected.");
 	}
+
+	this->resolveValues(period);
+}
+
+
+/**
+ * Looks up the values of the covariate at the given period, or the mean to
+ * be subtracted from the values of the behavior variable, so that
+ * covariateValue() need not find them again for each actor.
+ */
+void CovariateDependentBehaviorEffect::resolveValues(int period)
+{
+	this->lcovariateValues = 0;
+	this->linteractionMean = 0;
+
+	if (this->lpConstantCovariate)
+	{
+		this->lcovariateValues = this->lpConstantCovariate->values();
+	}
+	else if (this->lpChangingCovariate)
+	{
+		this->lcovariateValues = this->lpChangingCovariate->values(period);
+	}
+	else
+	{
+		this->linteractionMean = this->lpBehaviorData->overallMean();
+	}
 }
 
 
@@ -98,18 +125,13 @@ double CovariateDependentBehaviorEffect::covariateValue(int i) const
 {
 	double value = 0;
 
-	if (this->lpConstantCovariate)
-	{
-		value = this->lpConstantCovariate->value(i);
-	}
-	else if (this->lpChangingCovariate)
+	if (this->lcovariateValues)
 	{
-		value = this->lpChangingCovariate->value(i, this->period());
+		value = this->lcovariateValues[i];
 	}
 	else
 	{
-		value = this->linteractionValues[i] -
-			this->lpBehaviorData->overallMean();
+		value = this->linteractionValues[i] - this->linteractionMean;
 	}
 
 	return value;
@@ -52,6 +52,8 @@ protected:
 	bool missingCovariateEitherEnd(int i, int observation) const;
 
 private:
+	void resolveValues(int period);
+
 	ConstantCovariate * lpConstantCovariate;
 	ChangingCovariate * lpChangingCovariate;
 	BehaviorLongitudinalData * lpBehaviorData;
@@ -61,6 +63,13 @@ private:
 	// This array is 0 for covariate-based effects.
 
 	const int * linteractionValues {};
+
+	// The values of a covariate in the current period per each actor,
+	// or 0 for an interacting behavior variable
+	const double * lcovariateValues {};
+
+	// The overall mean of an interacting behavior variable
+	double linteractionMean {};
 };
 
 }
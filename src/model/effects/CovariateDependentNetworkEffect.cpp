@@ -93,6 +93,8 @@ void CovariateDependentNetworkEffect::initialize(const Data * pData,
 		throw logic_error("Covariate or dependent behavior variable '" +
 			name + "' expected.");
 	}
+
+	this->resolveValues(period);
 }
 
 
@@ -131,6 +133,8 @@ void CovariateDependentNetworkEffect::initialize(const Data* pData,
 		throw logic_error(
 				"Covariate or dependent behavior variable '" + name + "' expected.");
 	}
+
+	this->resolveValues(period);
 }
 
 /**
@@ -142,21 +146,17 @@ double CovariateDependentNetworkEffect::value(const int i) const
 {
     double value = 0;
     
-    if (this->lpConstantCovariate)
+    if (this->lcovariateValues)
     {
-		value = this->lpConstantCovariate->value(i);
-	}
-	else if (this->lpChangingCovariate)
-    {
-		value = this->lpChangingCovariate->value(i, this->period() + lSimulatedOffset);
+		value = this->lcovariateValues[i];
 	}
     else if (this->lpBehaviorData)
     {
-        value = this->lvalues[i] - this->lpBehaviorData->overallMean();
+        value = this->lvalues[i] - this->lmean;
     }
     else
     {
-        value = this->lcontinuousValues[i] - this->lpContinuousData->overallMean();
+        value = this->lcontinuousValues[i] - this->lmean;
     }
     
     return value;
@@ -170,13 +170,9 @@ bool CovariateDependentNetworkEffect::missing(int i) const
 {
     bool missing = false;
 
-    if (this->lpConstantCovariate)
-    {
-		missing = this->lpConstantCovariate->missing(i);
-	}
-	else if (this->lpChangingCovariate)
+    if (this->lcovariateMissing)
     {
-		missing = this->lpChangingCovariate->missing(i, this->period() + lSimulatedOffset);
+		missing = this->lcovariateMissing[i];
 	}
     else if (this->lpBehaviorData)
     {
@@ -260,6 +256,41 @@ double CovariateDependentNetworkEffect::covariateMaximum() const
 }
 
 
+/**
+ * Looks up the values and missingness indicators of a covariate at the
+ * observation used in the given period, or the mean to be subtracted from
+ * the values of a dependent variable, so that value() and missing() need
+ * not find them again for each actor.
+ */
+void CovariateDependentNetworkEffect::resolveValues(int period)
+{
+	this->lcovariateValues = 0;
+	this->lcovariateMissing = 0;
+	this->lmean = 0;
+
+	if (this->lpConstantCovariate)
+	{
+		this->lcovariateValues = this->lpConstantCovariate->values();
+		this->lcovariateMissing = this->lpConstantCovariate->missingValues();
+	}
+	else if (this->lpChangingCovariate)
+	{
+		int observation = period + this->lSimulatedOffset;
+		this->lcovariateValues = this->lpChangingCovariate->values(observation);
+		this->lcovariateMissing =
+			this->lpChangingCovariate->missingValues(observation);
+	}
+	else if (this->lpBehaviorData)
+	{
+		this->lmean = this->lpBehaviorData->overallMean();
+	}
+	else
+	{
+		this->lmean = this->lpContinuousData->overallMean();
+	}
+}
+
+
 /**
  * Returns the centered similarity of the given actors.
  */
@@ -61,6 +61,8 @@ protected:
     ContinuousLongitudinalData * pContinuousData() const;
 
 private:
+	void resolveValues(int period);
+
 	//! If `1` value(), missing() and actor_similarity() returns the simulated value
 	//! (if the covariate is a behavior) or the observed value at the end of the
 	//! period.
@@ -77,6 +79,16 @@ private:
 
 	const int * lvalues {};
     const double * lcontinuousValues {};
+
+	// The values and missingness indicators of a covariate at the
+	// observation of this period, indexed by actor; 0 for dependent
+	// variables.
+
+	const double * lcovariateValues {};
+	const bool * lcovariateMissing {};
+
+	// The overall mean subtracted from the values of a dependent variable
+	double lmean {};
 };
 
 }
@@ -122,4 +122,14 @@ bool CovariateEgoEffect::egoEffect() const
 	return true;
 }
 
+
+/**
+ * Returns true, as the contribution depends on the covariate of the ego
+ * only.
+ */
+bool CovariateEgoEffect::constantNewTieContribution() const
+{
+	return true;
+}
+
 }
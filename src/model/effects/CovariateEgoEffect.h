@@ -30,6 +30,7 @@ public:
 					const bool simulatedState);
 
 	virtual double calculateContribution(int alter) const;
+	virtual bool constantNewTieContribution() const;
 	virtual bool egoEffect() const;
 
 protected:
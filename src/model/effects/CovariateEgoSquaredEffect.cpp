@@ -62,4 +62,13 @@ bool CovariateEgoSquaredEffect::egoEffect() const
 	return true;
 }
 
+
+/**
+ * Returns true, as the contribution is the squared covariate of the ego.
+ */
+bool CovariateEgoSquaredEffect::constantNewTieContribution() const
+{
+	return true;
+}
+
 }
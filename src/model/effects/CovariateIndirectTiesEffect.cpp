@@ -15,7 +15,9 @@
 #include "data/NetworkLongitudinalData.h"
 #include "network/IncidentTieIterator.h"
 #include "model/variables/NetworkVariable.h"
+#include "model/tables/Cache.h"
 #include "model/tables/ConfigurationTable.h"
+#include "utils/MarkArray.h"
 
 using namespace std;
 
@@ -84,34 +86,6 @@ double CovariateIndirectTiesEffect::calculateContribution(int alter)
 }
 
 
-/**
- * This method is called at the start of the calculation of the statistic.
- */
-void CovariateIndirectTiesEffect::initializeStatisticCalculation()
-{
-	const Network * pNetwork = this->pNetwork();
-	int n = pNetwork->n();
-
-	// A helper array of marks
-
-	this->lmark = new int[n];
-
-	for (int i = 0; i < n; i++)
-	{
-		this->lmark[i] = -1;
-	}
-}
-
-
-/**
- * This method is called at the end of the calculation of the statistic.
- */
-void CovariateIndirectTiesEffect::cleanupStatisticCalculation()
-{
-	delete[] this->lmark;
-}
-
-
 /**
  * Calculates the statistic corresponding to the given ego. The parameter
  * pNetwork is always the current network as there are no endowment effects
@@ -128,8 +102,10 @@ double CovariateIndirectTiesEffect::egoStatistic(int ego,
 		this->pData()->pMissingTieNetwork(this->period() + 1);
 
 	int i = ego;
+	MarkArray * pMarks = this->pCache()->pMarkArray();
+	pMarks->reset(pNetwork->n());
 
-	// Invariant: mark[h] = i if and only if a two-path from i
+	// Invariant: h is marked if and only if a two-path from i
 	// to h has been found.
 
 	// Traverse all two-paths from i
@@ -146,11 +122,11 @@ double CovariateIndirectTiesEffect::egoStatistic(int ego,
 		{
 			int h = iterJ.actor();
 
-			if (this->lmark[h] < i)
+			if (!pMarks->marked(h))
 			{
 				// The first two-path from i to h is found.
 
-				this->lmark[h] = i;
+				pMarks->mark(h);
 				statistic += this->value(h);
 			}
 		}
@@ -166,9 +142,9 @@ double CovariateIndirectTiesEffect::egoStatistic(int ego,
 	{
 		int h = iter.actor();
 
-		if (this->lmark[h] == i)
+		if (pMarks->marked(h))
 		{
-			this->lmark[h] = -1;
+			pMarks->unmark(h);
 			statistic -= this->value(h);
 		}
 	}
@@ -182,9 +158,9 @@ double CovariateIndirectTiesEffect::egoStatistic(int ego,
 	{
 		int h = iter.actor();
 
-		if (this->lmark[h] == i)
+		if (pMarks->marked(h))
 		{
-			this->lmark[h] = -1;
+			pMarks->unmark(h);
 			statistic -= this->value(h);
 		}
 	}
@@ -195,16 +171,16 @@ double CovariateIndirectTiesEffect::egoStatistic(int ego,
 	{
 		int h = iter.actor();
 
-		if (this->lmark[h] == i)
+		if (pMarks->marked(h))
 		{
-			this->lmark[h] = -1;
+			pMarks->unmark(h);
 			statistic -= this->value(h);
 		}
 	}
 
 	// Ignore the trivial pair <i,i>.
 
-	if (this->lmark[i] == i)
+	if (pMarks->marked(i))
 	{
 		statistic -= this->value(i);
 	}
@@ -29,14 +29,8 @@ public:
 	virtual double endowmentStatistic(Network * pLostTieNetwork);
 
 protected:
-	virtual void initializeStatisticCalculation();
 	virtual double egoStatistic(int ego,
 		const Network * pSummationTieNetwork);
-	virtual void cleanupStatisticCalculation();
-
-private:
-	// A helper array of marks for statistic calculation
-	int * lmark {};
 };
 
 }
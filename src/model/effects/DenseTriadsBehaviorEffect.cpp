@@ -29,8 +29,6 @@ DenseTriadsBehaviorEffect::DenseTriadsBehaviorEffect(
 		NetworkDependentBehaviorEffect(pEffectInfo)
 {
 	this->ldensity = (int) pEffectInfo->internalEffectParameter();
-	this->lmark = 0;
-	this->lbaseMark = 0;
 
 	if (this->ldensity != 5 && this->ldensity != 6)
 	{
@@ -39,39 +37,6 @@ DenseTriadsBehaviorEffect::DenseTriadsBehaviorEffect(
 }
 
 
-/**
- * Destructor.
- */
-DenseTriadsBehaviorEffect::~DenseTriadsBehaviorEffect()
-{
-	delete[] this->lmark;
-}
-
-
-/**
- * Initializes this effect.
- * @param[in] pData the observed data
- * @param[in] pState the current state of the dependent variables
- * @param[in] period the period of interest
- * @param[in] pCache the cache object to be used to speed up calculations
- */
-void DenseTriadsBehaviorEffect::initialize(const Data * pData,
-	State * pState,
-	int period,
-	Cache * pCache)
-{
-	NetworkDependentBehaviorEffect::initialize(pData, pState, period, pCache);
-	delete[] this->lmark;
-	int n = this->pNetwork()->n();
-	this->lmark = new int[n];
-	this->lbaseMark = 0;
-
-	for (int i = 0; i < n; i++)
-	{
-		this->lmark[i] = 0;
-	}
-}
-
 /**
  * Calculates the change in the statistic corresponding to this effect if
  * the given actor would change his behavior by the given amount.
@@ -106,33 +71,23 @@ int DenseTriadsBehaviorEffect::denseTriadCount(int i)
 			"One-mode network expected in DenseTriadsBehaviorEffect");
 	}
 
-	this->lbaseMark += 2;
+	this->lmarks.reset(pNetwork->n());
 
 	// Count for each actor h the number of ties between i and h
-	// (0, 1, or 2). We represent these number as:
-	// mark[h] = baseMark + 2 if there are mutual ties between i and h,
-	// mark[h] = baseMark + 1 if only one of the mutual ties is present,
-	// mark[h] <= baseMark otherwise.
+	// (0, 1, or 2).
 
 	for (IncidentTieIterator iter = pNetwork->inTies(i);
 		iter.valid();
 		iter.next())
 	{
-		this->lmark[iter.actor()] = this->lbaseMark + 1;
+		this->lmarks.mark(iter.actor());
 	}
 
 	for (IncidentTieIterator iter = pNetwork->outTies(i);
 		iter.valid();
 		iter.next())
 	{
-		if (this->lmark[iter.actor()] <= this->lbaseMark)
-		{
-			this->lmark[iter.actor()] = this->lbaseMark + 1;
-		}
-		else
-		{
-			this->lmark[iter.actor()]++;
-		}
+		this->lmarks.increment(iter.actor());
 	}
 
 	// Now count the number of dense triads
@@ -153,7 +108,7 @@ int DenseTriadsBehaviorEffect::denseTriadCount(int i)
 			{
 				int h = iterJ.actor();
 
-				if (this->lmark[h] == this->lbaseMark + 2)
+				if (this->lmarks.count(h) == 2)
 				{
 					count++;
 				}
@@ -182,7 +137,7 @@ int DenseTriadsBehaviorEffect::denseTriadCount(int i)
 
 				int h = outIter.actor();
 				bool reciprocatedJH = inIter.valid() && inIter.actor() == h;
-				int tieCountBetweenIH = this->lmark[h] - this->lbaseMark;
+				int tieCountBetweenIH = this->lmarks.count(h);
 
 				if (reciprocatedJH)
 				{
@@ -13,6 +13,7 @@
 #define DENSETRIADSBEHAVIOREFFECT_H_
 
 #include "NetworkDependentBehaviorEffect.h"
+#include "utils/MarkArray.h"
 
 namespace siena
 {
@@ -24,12 +25,7 @@ class DenseTriadsBehaviorEffect : public NetworkDependentBehaviorEffect
 {
 public:
 	DenseTriadsBehaviorEffect(const EffectInfo * pEffectInfo);
-	virtual ~DenseTriadsBehaviorEffect();
 
-	virtual void initialize(const Data * pData,
-		State * pState,
-		int period,
-		Cache * pCache);
 	virtual double calculateChangeContribution(int actor,
 		int difference);
 	virtual double egoStatistic(int ego, double * currentValues);
@@ -39,15 +35,9 @@ private:
 
 	int ldensity {};
 
-	// A helper array of marks for counting dense triads
-	int * lmark {};
-
-	// Given an ego i
-	// mark[h] = baseMark + 2 if there are mutual ties between i and h,
-	// mark[h] = baseMark + 1 if only one of the mutual ties is present,
-	// mark[h] <= baseMark otherwise.
-
-	int lbaseMark {};
+	// Given an ego i, the count of an actor h is the number of ties
+	// between i and h (0, 1, or 2).
+	MarkArray lmarks;
 };
 
 }
@@ -128,8 +128,8 @@ double DenseTriadsEffect::tieStatistic(int j)
 
 	// Get the number of dense triads involving the tie (i,j).
 
-	if ((this->ldensity == 6 && this->lmark[j] == this->lbaseMark + 2) ||
-		(this->ldensity == 5 && this->lmark[j] == this->lbaseMark + 1))
+	if ((this->ldensity == 6 && this->lmarks.count(j) == 2) ||
+		(this->ldensity == 5 && this->lmarks.count(j) == 1))
 	{
 		// We need complete dyads (j,h) and (i,h) to have
 		// a dense triad.
@@ -145,7 +145,7 @@ double DenseTriadsEffect::tieStatistic(int j)
 
 			// Test if the dyad (i,h) is complete
 
-			if (this->lmark[h] == this->lbaseMark + 2)
+			if (this->lmarks.count(h) == 2)
 			{
 				statistic++;
 			}
@@ -184,7 +184,7 @@ double DenseTriadsEffect::tieStatistic(int j)
 				// The dyad (j,h1) is complete, so we need just
 				// one tie between i and h1.
 
-				if (this->lmark[h1] > this->lbaseMark)
+				if (this->lmarks.count(h1) > 0)
 				{
 					statistic++;
 				}
@@ -197,7 +197,7 @@ double DenseTriadsEffect::tieStatistic(int j)
 				// The dyad (j,h1) has only one tie, so we need
 				// a complete dyad (i,h1).
 
-				if (this->lmark[h1] == this->lbaseMark + 2)
+				if (this->lmarks.count(h1) == 2)
 				{
 					statistic++;
 				}
@@ -209,7 +209,7 @@ double DenseTriadsEffect::tieStatistic(int j)
 				// The dyad (j,h2) has only one tie, so we need
 				// a complete dyad (i,h2).
 
-				if (this->lmark[h2] == this->lbaseMark + 2)
+				if (this->lmarks.count(h2) == 2)
 				{
 					statistic++;
 				}
@@ -223,34 +223,6 @@ double DenseTriadsEffect::tieStatistic(int j)
 }
 
 
-/**
- * This method is called at the start of the calculation of the statistic.
- */
-void DenseTriadsEffect::initializeStatisticCalculation()
-{
-	const Network * pNetwork = this->pNetwork();
-	int n = pNetwork->n();
-
-	// Allocate the helper array of marks
-
-	this->lmark = new int[n];
-
-	for (int i = 0; i < n; i++)
-	{
-		this->lmark[i] = 0;
-	}
-}
-
-
-/**
- * This method is called at the end of the calculation of the statistic.
- */
-void DenseTriadsEffect::cleanupStatisticCalculation()
-{
-	delete[] this->lmark;
-}
-
-
 /**
  * This method is called right before summing up the contributions of the
  * outgoing ties of the given ego in the calculation of the statistic.
@@ -258,33 +230,23 @@ void DenseTriadsEffect::cleanupStatisticCalculation()
 void DenseTriadsEffect::onNextEgo(int i)
 {
 	const Network * pNetwork = this->pNetwork();
-	this->lbaseMark = 2 * i;
+	this->lmarks.reset(pNetwork->n());
 
 	// Count for each actor h the number of ties between i and h
-	// (0, 1, or 2). We represent these number as:
-	// mark[h] = baseMark + 2 if there are mutual ties between i and h,
-	// mark[h] = baseMark + 1 if only one of the mutual ties is present,
-	// mark[h] <= baseMark otherwise.
+	// (0, 1, or 2).
 
 	for (IncidentTieIterator iter = pNetwork->inTies(i);
 		iter.valid();
 		iter.next())
 	{
-		this->lmark[iter.actor()] = this->lbaseMark + 1;
+		this->lmarks.mark(iter.actor());
 	}
 
 	for (IncidentTieIterator iter = pNetwork->outTies(i);
 		iter.valid();
 		iter.next())
 	{
-		if (this->lmark[iter.actor()] <= this->lbaseMark)
-		{
-			this->lmark[iter.actor()] = this->lbaseMark + 1;
-		}
-		else
-		{
-			this->lmark[iter.actor()]++;
-		}
+		this->lmarks.increment(iter.actor());
 	}
 }
 
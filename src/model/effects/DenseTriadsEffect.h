@@ -13,6 +13,7 @@
 #define DENSETRIADSEFFECT_H_
 
 #include "NetworkEffect.h"
+#include "utils/MarkArray.h"
 
 namespace siena
 {
@@ -29,23 +30,15 @@ public:
 	virtual double calculateContribution(int alter) const;
 
 protected:
-	virtual void initializeStatisticCalculation();
 	virtual void onNextEgo(int ego);
 	virtual double tieStatistic(int alter);
-	virtual void cleanupStatisticCalculation();
 
 private:
 	int ldensity {};
 
-	// A helper array of marks for statistic calculations
-	int * lmark {};
-
-	// Given an ego i
-	// mark[h] = baseMark + 2 if there are mutual ties between i and h,
-	// mark[h] = baseMark + 1 if only one of the mutual ties is present,
-	// mark[h] <= baseMark otherwise.
-
-	int lbaseMark {};
+	// Given an ego i, the count of an actor h is the number of ties
+	// between i and h (0, 1, or 2).
+	MarkArray lmarks;
 };
 
 }
@@ -13,6 +13,7 @@
 #define DENSETRIADSSIMILARITYEFFECT_H_
 
 #include "NetworkDependentBehaviorEffect.h"
+#include "utils/MarkArray.h"
 
 namespace siena
 {
@@ -27,12 +28,7 @@ class DenseTriadsSimilarityEffect : public NetworkDependentBehaviorEffect
 {
 public:
 	DenseTriadsSimilarityEffect(const EffectInfo * pEffectInfo);
-	virtual ~DenseTriadsSimilarityEffect();
 
-	virtual void initialize(const Data * pData,
-		State * pState,
-		int period,
-		Cache * pCache);
 	virtual double calculateChangeContribution(int actor,
 		int difference);
 	virtual double egoStatistic(int ego, double * currentValues);
@@ -42,15 +38,9 @@ private:
 
 	int ldensity {};
 
-	// A helper array of marks
-	int * lmark {};
-
-	// Given an ego i
-	// mark[h] = baseMark + 2 if there are mutual ties between i and h,
-	// mark[h] = baseMark + 1 if only one of the mutual ties is present,
-	// mark[h] <= baseMark otherwise.
-
-	int lbaseMark {};
+	// Given an ego i, the count of an actor h is the number of ties
+	// between i and h (0, 1, or 2).
+	MarkArray lmarks;
 };
 
 }
@@ -68,4 +68,13 @@ bool DensityEffect::egoEffect() const
 	return true;
 }
 
+
+/**
+ * Returns true, as every new tie contributes 1.
+ */
+bool DensityEffect::constantNewTieContribution() const
+{
+	return true;
+}
+
 }
@@ -25,6 +25,7 @@ public:
 	DensityEffect(const EffectInfo * pEffectInfo);
 
 	virtual double calculateContribution(int alter) const;
+	virtual bool constantNewTieContribution() const;
 	virtual bool egoEffect() const;
 
 protected:
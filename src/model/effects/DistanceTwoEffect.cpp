@@ -16,7 +16,9 @@
 #include "network/IncidentTieIterator.h"
 #include "data/OneModeNetworkLongitudinalData.h"
 #include "model/variables/NetworkVariable.h"
+#include "model/tables/Cache.h"
 #include "model/tables/ConfigurationTable.h"
+#include "utils/MarkArray.h"
 
 using namespace std;
 
@@ -84,34 +86,6 @@ double DistanceTwoEffect::calculateContribution(int alter) const
 }
 
 
-/**
- * This method is called at the start of the calculation of the statistic.
- */
-void DistanceTwoEffect::initializeStatisticCalculation()
-{
-	const Network * pNetwork = this->pNetwork();
-	int n = pNetwork->n();
-
-	// A helper array of marks
-
-	this->lmark = new int[n];
-
-	for (int i = 0; i < n; i++)
-	{
-		this->lmark[i] = 0;
-	}
-}
-
-
-/**
- * This method is called at the end of the calculation of the statistic.
- */
-void DistanceTwoEffect::cleanupStatisticCalculation()
-{
-	delete[] this->lmark;
-}
-
-
 /**
  * Calculates the statistic corresponding to the given ego. The parameter
  * pNetwork is always the current network as there are no endowment effects
@@ -121,7 +95,6 @@ double DistanceTwoEffect::egoStatistic(int ego,
 	const Network * pNetwork)
 {
 	double statistic = 0;
-	int n = pNetwork->n();
 
 	const Network * pStartMissingNetwork =
 		this->pData()->pMissingTieNetwork(this->period());
@@ -129,13 +102,11 @@ double DistanceTwoEffect::egoStatistic(int ego,
 		this->pData()->pMissingTieNetwork(this->period() + 1);
 
 	int i = ego;
+	MarkArray * pMarks = this->pCache()->pMarkArray();
+	pMarks->reset(pNetwork->n());
 
-	// Invariant: mark[h] <= baseMark for all h.
-	int baseMark = n * i;
-
-	// Count the number of two-paths from i to each h by setting
-	// mark[h] = baseMark + <number of two-paths from i to h>.
-	// If there are no two-paths from i to h, we leave mark[h] <= baseMark.
+	// Count the number of two-paths from i to each h in the counter of h.
+	// Actors without two-paths from i keep the count 0.
 
 	for (IncidentTieIterator iterI = pNetwork->outTies(i);
 		iterI.valid();
@@ -149,18 +120,9 @@ double DistanceTwoEffect::egoStatistic(int ego,
 		{
 			int h = iterJ.actor();
 
-			if (this->lmark[h] <= baseMark)
-			{
-				// We have encountered this actor for the first time.
-				this->lmark[h] = baseMark + 1;
-			}
-			else
-			{
-				// We've found yet another two-path from i to h.
-				this->lmark[h]++;
-			}
+			// We've found yet another two-path from i to h.
 
-			if (this->lmark[h] == baseMark + this->lrequiredTwoPathCount)
+			if (pMarks->increment(h) == this->lrequiredTwoPathCount)
 			{
 				// We've reached the necessary minimum of two-paths, hence
 				// a new candidate for a distance-two pair is found.
@@ -181,9 +143,9 @@ double DistanceTwoEffect::egoStatistic(int ego,
 	{
 		int h = iter.actor();
 
-		if (this->lmark[h] >= baseMark + this->lrequiredTwoPathCount)
+		if (pMarks->count(h) >= this->lrequiredTwoPathCount)
 		{
-			this->lmark[h] = 0;
+			pMarks->unmark(h);
 			statistic--;
 		}
 	}
@@ -197,9 +159,9 @@ double DistanceTwoEffect::egoStatistic(int ego,
 	{
 		int h = iter.actor();
 
-		if (this->lmark[h] >= baseMark + this->lrequiredTwoPathCount)
+		if (pMarks->count(h) >= this->lrequiredTwoPathCount)
 		{
-			this->lmark[h] = 0;
+			pMarks->unmark(h);
 			statistic--;
 		}
 	}
@@ -210,16 +172,16 @@ double DistanceTwoEffect::egoStatistic(int ego,
 	{
 		int h = iter.actor();
 
-		if (this->lmark[h] >= baseMark + this->lrequiredTwoPathCount)
+		if (pMarks->count(h) >= this->lrequiredTwoPathCount)
 		{
-			this->lmark[h] = 0;
+			pMarks->unmark(h);
 			statistic--;
 		}
 	}
 
 	// Ignore the trivial pair <i,i>.
 
-	if (this->lmark[i] >= baseMark + this->lrequiredTwoPathCount)
+	if (pMarks->count(i) >= this->lrequiredTwoPathCount)
 	{
 		statistic--;
 	}
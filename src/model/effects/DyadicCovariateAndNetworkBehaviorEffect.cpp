@@ -17,6 +17,7 @@
 #include "model/variables/BehaviorVariable.h"
 #include "data/ConstantDyadicCovariate.h"
 #include "data/ChangingDyadicCovariate.h"
+#include "data/DyadicCovariateMatrix.h"
 #include "data/DyadicCovariateValueIterator.h"
 #include "model/State.h"
 #include "model/EffectInfo.h"
@@ -60,7 +61,18 @@ void DyadicCovariateAndNetworkBehaviorEffect::initialize(const Data * pData,
 	this->lpBehaviorData = pData->pBehaviorData(name1);
 	this->lexcludeMissings = false;
 
-	if (!this->lpConstantDyadicCovariate && !this->lpChangingDyadicCovariate)
+	if (this->lpConstantDyadicCovariate)
+	{
+		this->lpDyadicValues = this->lpConstantDyadicCovariate->pValues();
+		this->ldyadicMean = this->lpConstantDyadicCovariate->mean();
+	}
+	else if (this->lpChangingDyadicCovariate)
+	{
+		this->lpDyadicValues =
+			this->lpChangingDyadicCovariate->pValues(period);
+		this->ldyadicMean = this->lpChangingDyadicCovariate->mean();
+	}
+	else
 	{
 		throw logic_error(
 			"Dyadic covariate variable '" + name2 + "' expected.");
@@ -72,20 +84,7 @@ void DyadicCovariateAndNetworkBehaviorEffect::initialize(const Data * pData,
  */
 double DyadicCovariateAndNetworkBehaviorEffect::dycoValue(int i, int j) const
 {
-	double value = 0;
-
-	if (this->lpConstantDyadicCovariate)
-	{
-		value = this->lpConstantDyadicCovariate->value(i, j) -
-			this->lpConstantDyadicCovariate->mean();
-	}
-	else
-	{
-		value = this->lpChangingDyadicCovariate->value(i, j, this->period()) -
-			this->lpChangingDyadicCovariate->mean();
-	}
-
-	return value;
+	return this->lpDyadicValues->value(i, j) - this->ldyadicMean;
 }
 
 
@@ -94,18 +93,7 @@ double DyadicCovariateAndNetworkBehaviorEffect::dycoValue(int i, int j) const
  */
 bool DyadicCovariateAndNetworkBehaviorEffect::missingDyCo(int i, int j) const
 {
-	bool missing = false;
-
-	if (this->lpConstantDyadicCovariate)
-	{
-		missing = this->lpConstantDyadicCovariate->missing(i, j);
-	}
-	else
-	{
-		missing = this->lpChangingDyadicCovariate->missing(i, j, this->period());
-	}
-
-	return missing;
+	return this->lpDyadicValues->missing(i, j);
 }
 
 
@@ -28,6 +28,7 @@ namespace siena
 class BehaviorLongitudinalData;
 class ConstantDyadicCovariate;
 class ChangingDyadicCovariate;
+class DyadicCovariateMatrix;
 class DyadicCovariateValueIterator;
 
 
@@ -65,6 +66,12 @@ private:
 	// effect depends on a constant covariate.
 	ChangingDyadicCovariate * lpChangingDyadicCovariate;
 
+	// The values of the covariate in the period of this effect
+	const DyadicCovariateMatrix * lpDyadicValues {};
+
+	// The mean of the covariate
+	double ldyadicMean {};
+
 	BehaviorLongitudinalData * lpBehaviorData;
 	
 	// flag to control exclusion of missing values	
@@ -14,6 +14,7 @@
 #include "DyadicCovariateDependentNetworkEffect.h"
 #include "data/ConstantDyadicCovariate.h"
 #include "data/ChangingDyadicCovariate.h"
+#include "data/DyadicCovariateMatrix.h"
 #include "data/DyadicCovariateValueIterator.h"
 #include "model/State.h"
 #include "model/EffectInfo.h"
@@ -55,7 +56,17 @@ void DyadicCovariateDependentNetworkEffect::initialize(const Data * pData,
 
 	this->lexcludeMissings = false;
 
-	if (!this->lpConstantCovariate && !this->lpChangingCovariate)
+	if (this->lpConstantCovariate)
+	{
+		this->lpValues = this->lpConstantCovariate->pValues();
+		this->lmean = this->lpConstantCovariate->mean();
+	}
+	else if (this->lpChangingCovariate)
+	{
+		this->lpValues = this->lpChangingCovariate->pValues(period);
+		this->lmean = this->lpChangingCovariate->mean();
+	}
+	else
 	{
 		throw logic_error(
 			"Dyadic covariate variable '" + name + "' expected.");
@@ -68,13 +79,7 @@ void DyadicCovariateDependentNetworkEffect::initialize(const Data * pData,
  */
 double DyadicCovariateDependentNetworkEffect::value(int i, int j) const
 {
-	if (this->lpConstantCovariate)
-	{
-		return this->lpConstantCovariate->value(i, j) -
-			this->lpConstantCovariate->mean();
-	}
-	return this->lpChangingCovariate->value(i, j, this->period()) -
-		this->lpChangingCovariate->mean();
+	return this->lpValues->value(i, j) - this->lmean;
 }
 
 
@@ -83,18 +88,7 @@ double DyadicCovariateDependentNetworkEffect::value(int i, int j) const
  */
 bool DyadicCovariateDependentNetworkEffect::missing(int i, int j) const
 {
-	bool missing = false;
-
-	if (this->lpConstantCovariate)
-	{
-		missing = this->lpConstantCovariate->missing(i, j);
-	}
-	else
-	{
-		missing = this->lpChangingCovariate->missing(i, j, this->period());
-	}
-
-	return missing;
+	return this->lpValues->missing(i, j);
 }
 
 /**
@@ -23,6 +23,7 @@ namespace siena
 
 class ConstantDyadicCovariate;
 class ChangingDyadicCovariate;
+class DyadicCovariateMatrix;
 class DyadicCovariateValueIterator;
 
 
@@ -63,6 +64,12 @@ private:
 
 	ChangingDyadicCovariate * lpChangingCovariate;
 
+	// The values of the covariate in the period of this effect
+	const DyadicCovariateMatrix * lpValues {};
+
+	// The mean of the covariate
+	double lmean {};
+
 	// flag to control exclusion of missing values
 	
 	bool lexcludeMissings {};
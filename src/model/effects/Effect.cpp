@@ -10,6 +10,7 @@
 
 #include "Effect.h"
 #include "model/EffectInfo.h"
+#include "utils/Instrumentation.h"
 
 namespace siena
 {
@@ -50,6 +51,22 @@ const EffectInfo * Effect::pEffectInfo() const
 }
 
 
+/**
+ * Returns the instrumentation counter for the change contributions of this
+ * effect.
+ */
+int Effect::instrumentationSlot()
+{
+	if (this->linstrumentationSlot < 0)
+	{
+		this->linstrumentationSlot =
+			Instrumentation::effectSlot(EFFECT, this->lpEffectInfo);
+	}
+
+	return this->linstrumentationSlot;
+}
+
+
 // ----------------------------------------------------------------------------
 // Section: Initialization
 // ----------------------------------------------------------------------------
@@ -48,6 +48,7 @@ public:
 	inline Cache * pCache() const;
 
 	const EffectInfo * pEffectInfo() const;
+	int instrumentationSlot();
 
 	virtual void initialize(const Data * pData,
 		State * pState,
@@ -65,6 +66,10 @@ private:
 	int lperiod {};
 
 	Cache * lpCache;
+
+	// The instrumentation counter of the change contributions of this
+	// effect, or -1 if not looked up yet
+	int linstrumentationSlot {-1};
 };
 
 
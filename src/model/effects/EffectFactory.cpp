@@ -14,6 +14,7 @@
 
 #include "EffectFactory.h"
 #include "data/Data.h"
+#include "model/Function.h"
 #include "data/NetworkLongitudinalData.h"
 #include "data/ContinuousLongitudinalData.h"
 #include "model/EffectInfo.h"
@@ -156,9 +157,14 @@ EffectFactory::EffectFactory(const Data * pData)
 
 /**
  * Creates and returns a concrete effect of the Effect class hierarchy
- * corresponding to the given generic effect descriptor.
+ * corresponding to the given generic effect descriptor. If a function is
+ * given, the effects interacting in a network or behavior interaction
+ * effect are taken from this function where possible, instead of creating
+ * private instances; the function must then own the interaction effect
+ * as well.
  */
-Effect * EffectFactory::createEffect(const EffectInfo * pEffectInfo) const
+Effect * EffectFactory::createEffect(const EffectInfo * pEffectInfo,
+	const Function * pFunction) const
 {
 	Effect * pEffect = 0;
 	string effectName = pEffectInfo->effectName();
@@ -175,13 +181,24 @@ Effect * EffectFactory::createEffect(const EffectInfo * pEffectInfo) const
 	{
 		// The info object of the first interacting effect is defined,
 		// which means that we have a user-defined interaction effect.
+		// Interacting effects that are part of the given function are
+		// shared with it rather than created again.
 
-		Effect *pEffect1 = this->createEffect(pEffectInfo->pEffectInfo1());
-		Effect *pEffect2 = this->createEffect(pEffectInfo->pEffectInfo2());
+		bool shared1 = false;
+		bool shared2 = false;
+		bool shared3 = false;
+		Effect *pEffect1 = this->interactingEffect(pEffectInfo->pEffectInfo1(),
+			pFunction,
+			shared1);
+		Effect *pEffect2 = this->interactingEffect(pEffectInfo->pEffectInfo2(),
+			pFunction,
+			shared2);
 		Effect *pEffect3 = 0;
 		if (pEffectInfo->pEffectInfo3())
 		{
-			pEffect3 = this->createEffect(pEffectInfo->pEffectInfo3());
+			pEffect3 = this->interactingEffect(pEffectInfo->pEffectInfo3(),
+				pFunction,
+				shared3);
 		}
 
 
@@ -204,7 +221,10 @@ Effect * EffectFactory::createEffect(const EffectInfo * pEffectInfo) const
 			pEffect = new NetworkInteractionEffect(pEffectInfo,
 				pNetworkEffect1,
 				pNetworkEffect2,
-				pNetworkEffect3);
+				pNetworkEffect3,
+				shared1,
+				shared2,
+				shared3);
 		}
 		else if (pBehaviorEffect1)
 		{
@@ -219,7 +239,10 @@ Effect * EffectFactory::createEffect(const EffectInfo * pEffectInfo) const
 			pEffect = new BehaviorInteractionEffect(pEffectInfo,
 				pBehaviorEffect1,
 				pBehaviorEffect2,
-				pBehaviorEffect3);
+				pBehaviorEffect3,
+				shared1,
+				shared2,
+				shared3);
 		}
         else
         {
@@ -3069,4 +3092,33 @@ Effect * EffectFactory::createEffect(const EffectInfo * pEffectInfo) const
 	return pEffect;
 }
 
+
+/**
+ * Returns the effect with the given info for use in an interaction effect.
+ * This is the effect of the given function with this info if there is one,
+ * and a newly created effect otherwise.
+ * @param[out] shared indicates if the returned effect belongs to the
+ * function
+ */
+Effect * EffectFactory::interactingEffect(const EffectInfo * pEffectInfo,
+	const Function * pFunction,
+	bool & shared) const
+{
+	Effect * pEffect = 0;
+
+	if (pFunction)
+	{
+		pEffect = pFunction->pEffect(pEffectInfo);
+	}
+
+	shared = pEffect != 0;
+
+	if (!pEffect)
+	{
+		pEffect = this->createEffect(pEffectInfo);
+	}
+
+	return pEffect;
+}
+
 }
@@ -26,6 +26,7 @@ namespace siena
 class Data;
 class Effect;
 class EffectInfo;
+class Function;
 
 
 // ----------------------------------------------------------------------------
@@ -43,9 +44,14 @@ public:
 
 	EffectFactory(const Data * pData);
 
-	Effect * createEffect(const EffectInfo * pEffectInfo) const;
+	Effect * createEffect(const EffectInfo * pEffectInfo,
+		const Function * pFunction = 0) const;
 
 private:
+	Effect * interactingEffect(const EffectInfo * pEffectInfo,
+		const Function * pFunction,
+		bool & shared) const;
+
 	const Data * lpData;
 	static const std::map<const std::string, const std::string> GMM_GROUPS;
 	static std::map<const std::string, const std::string> init_groups();
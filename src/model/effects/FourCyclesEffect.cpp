@@ -132,10 +132,9 @@ void FourCyclesEffect::preprocessEgo(int ego)
  */
 void FourCyclesEffect::countThreePaths(int i,
 	const Network * pNetwork,
-	long int * counters) const
+	long int * counters)
 {
 
-
 	// Initialize
 
 	int nm = pNetwork->n();
@@ -149,38 +148,56 @@ void FourCyclesEffect::countThreePaths(int i,
 		counters[j] = 0;
 	}
 
-	// Enumerate all three-paths i -> h <- k -> j and update the counters.
-	// The (average) time complexity is obviously O(d^3), where d is the
-	// average degree.
+	// Count the two-paths i -> h <- k per each k != i first, so that the
+	// outgoing ties of each such k are traversed only once, however many
+	// two-paths lead to k.
+
+	this->lmarks.reset(pNetwork->n());
+	this->lsenders.clear();
 
 	for (IncidentTieIterator iterI = pNetwork->outTies(i);
 		iterI.valid();
 		iterI.next())
 	{
-		int h = iterI.actor();
-
-		for (IncidentTieIterator iterH = pNetwork->inTies(h);
+		for (IncidentTieIterator iterH = pNetwork->inTies(iterI.actor());
 			iterH.valid();
 			iterH.next())
 		{
 			int k = iterH.actor();
 
-			if (i != k)
+			if (i != k && this->lmarks.increment(k) == 1)
 			{
-				for (IncidentTieIterator iterK = pNetwork->outTies(k);
-					iterK.valid();
-					iterK.next())
-				{
-					int j = iterK.actor();
-
-					if (j != h)
-					{
-						counters[j]++;
-					}
-				}
+				this->lsenders.push_back(k);
 			}
 		}
 	}
+
+	// Each two-path i -> h <- k extends to a three-path i -> h <- k -> j
+	// for each outgoing tie of k other than the tie to h.
+
+	for (unsigned index = 0; index < this->lsenders.size(); index++)
+	{
+		int k = this->lsenders[index];
+		int twoPathCount = this->lmarks.count(k);
+
+		for (IncidentTieIterator iterK = pNetwork->outTies(k);
+			iterK.valid();
+			iterK.next())
+		{
+			counters[iterK.actor()] += twoPathCount;
+		}
+	}
+
+	// Remove the walks i -> h <- k -> h, one for each k != i with a tie
+	// to h.
+
+	for (IncidentTieIterator iterI = pNetwork->outTies(i);
+		iterI.valid();
+		iterI.next())
+	{
+		int h = iterI.actor();
+		counters[h] -= pNetwork->inDegree(h) - 1;
+	}
 }
 
 
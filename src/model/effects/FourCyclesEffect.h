@@ -12,7 +12,9 @@
 #ifndef FOURCYCLESEFFECT_H_
 #define FOURCYCLESEFFECT_H_
 
+#include <vector>
 #include "NetworkEffect.h"
+#include "utils/MarkArray.h"
 
 namespace siena
 {
@@ -52,14 +54,18 @@ private:
 	// Indicates if the effect is used for a two-mode or one-mode network
 	bool lTwoMode {};
 
-	void countThreePaths(int i, const Network * pNetwork, long int * counters)
-		const;
+	void countThreePaths(int i, const Network * pNetwork, long int * counters);
 
 	// For a fixed i, this variable stores the number of three-paths
 	// i -> h <- k -> j per each j.
 
 	long int * lcounters {};
 
+	// For a fixed i, the number of two-paths i -> h <- k per each k, and
+	// the actors k with at least one such two-path
+	MarkArray lmarks;
+	std::vector<int> lsenders;
+
 	// Indicates if the square root of the number of four-cycles has to
 	// be taken.
 
@@ -104,4 +104,31 @@ double IndegreePopularityEffect::tieStatistic(int alter)
 	return statistic;
 }
 
+
+/**
+ * Returns true, as the contribution of a new tie depends on the
+ * indegree of the alter only.
+ */
+bool IndegreePopularityEffect::alterNewTieContribution() const
+{
+	return true;
+}
+
+
+/**
+ * Returns the contribution of a new tie to the given alter from an ego
+ * without a tie to the alter.
+ */
+double IndegreePopularityEffect::newTieContribution(int alter) const
+{
+	int degree = this->pNetwork()->inDegree(alter) + 1;
+
+	if (this->lroot)
+	{
+		return this->lsqrtTable->sqrt(degree);
+	}
+
+	return degree - this->lcentering;
+}
+
 }
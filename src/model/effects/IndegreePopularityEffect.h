@@ -50,6 +50,8 @@ public:
 	virtual void initialize(const Data * pData, State * pState,	int period,
 			Cache * pCache);
 	virtual double calculateContribution(int alter) const;
+	virtual bool alterNewTieContribution() const;
+	virtual double newTieContribution(int alter) const;
 
 protected:
 	virtual double tieStatistic(int alter);
@@ -9,6 +9,7 @@
  * NetworkDependentBehaviorEffect class.
  *****************************************************************************/
 
+#include <climits>
 #include <stdexcept>
 //#include "R_ext/Print.h"
 #include "NetworkDependentBehaviorEffect.h"
@@ -44,7 +45,10 @@ NetworkDependentBehaviorEffect::NetworkDependentBehaviorEffect(
 	lnumberAlterEqual(0),
 	lnumberAlterHigherPop(0),
 	lnumberAlterLowerPop(0),
-	lnumberAlterEqualPop(0)
+	lnumberAlterEqualPop(0),
+	lalterValueStamps(0),
+	linAlterValueStamps(0),
+	lstamp(0)
 {
 	this->lpNetworkCache = 0;
 	this->lpTwoPathTable = 0;
@@ -77,7 +81,10 @@ NetworkDependentBehaviorEffect::NetworkDependentBehaviorEffect(
 	lnumberAlterEqual(0),
 	lnumberAlterHigherPop(0),
 	lnumberAlterLowerPop(0),
-	lnumberAlterEqualPop(0)
+	lnumberAlterEqualPop(0),
+	lalterValueStamps(0),
+	linAlterValueStamps(0),
+	lstamp(0)
 {
 	this->lpNetworkCache = 0;
 	this->lpTwoPathTable = 0;
@@ -105,6 +112,8 @@ NetworkDependentBehaviorEffect::~NetworkDependentBehaviorEffect()
 	delete [] this->lnumberAlterHigherPop;
 	delete [] this->lnumberAlterLowerPop;
 	delete [] this->lnumberAlterEqualPop;
+	delete [] this->lalterValueStamps;
+	delete [] this->linAlterValueStamps;
 }
 
 /**
@@ -145,6 +154,7 @@ void NetworkDependentBehaviorEffect::initialize(const Data * pData,
 	this->lnumberAlterHigherPop = new int[this->lpNetwork->n()];
 	this->lnumberAlterLowerPop  = new int[this->lpNetwork->n()];
 	this->lnumberAlterEqualPop  = new int[this->lpNetwork->n()];
+	this->initializeStamps();
 
 	this->lpNetworkCache = pCache->pNetworkCache(this->lpNetwork);
 
@@ -200,6 +210,7 @@ void NetworkDependentBehaviorEffect::initialize(const Data *pData,
 	this->lnumberAlterEqualPop  = new int[this->lpNetwork->n()];
 	this->lnumberAlterHigherPop = new int[this->lpNetwork->n()];
 	this->lnumberAlterLowerPop  = new int[this->lpNetwork->n()];
+	this->initializeStamps();
 }
 
 /**
@@ -207,6 +218,7 @@ void NetworkDependentBehaviorEffect::initialize(const Data *pData,
  */
 double NetworkDependentBehaviorEffect::totalAlterValue(int i) const
 {
+	this->updateAlterValues(i);
 	return this->ltotalAlterValues[i];
 }
 
@@ -216,6 +228,7 @@ double NetworkDependentBehaviorEffect::totalAlterValue(int i) const
  */
 double NetworkDependentBehaviorEffect::totalInAlterValue(int i) const
 {
+	this->updateInAlterValues(i);
 	return this->ltotalInAlterValues[i];
 }
 
@@ -225,6 +238,7 @@ double NetworkDependentBehaviorEffect::totalInAlterValue(int i) const
  */
 int NetworkDependentBehaviorEffect::numberAlterHigher(int i) const
 {
+	this->updateAlterValues(i);
 	return this->lnumberAlterHigher[i];
 }
 
@@ -233,6 +247,7 @@ int NetworkDependentBehaviorEffect::numberAlterHigher(int i) const
  */
 int NetworkDependentBehaviorEffect::numberAlterLower(int i) const
 {
+	this->updateAlterValues(i);
 	return this->lnumberAlterLower[i];
 }
 
@@ -242,6 +257,7 @@ int NetworkDependentBehaviorEffect::numberAlterLower(int i) const
  */
 int NetworkDependentBehaviorEffect::numberAlterEqual(int i) const
 {
+	this->updateAlterValues(i);
 	return this->lnumberAlterEqual[i];
 }
 
@@ -253,6 +269,7 @@ int NetworkDependentBehaviorEffect::numberAlterEqual(int i) const
  */
 int NetworkDependentBehaviorEffect::numberAlterHigherPop(int i) const
 {
+	this->updateAlterValues(i);
 	return this->lnumberAlterHigherPop[i];
 }
 
@@ -262,6 +279,7 @@ int NetworkDependentBehaviorEffect::numberAlterHigherPop(int i) const
  */
 int NetworkDependentBehaviorEffect::numberAlterLowerPop(int i) const
 {
+	this->updateAlterValues(i);
 	return this->lnumberAlterLowerPop[i];
 }
 
@@ -272,6 +290,7 @@ int NetworkDependentBehaviorEffect::numberAlterLowerPop(int i) const
  */
 int NetworkDependentBehaviorEffect::numberAlterEqualPop(int i) const
 {
+	this->updateAlterValues(i);
 	return this->lnumberAlterEqualPop[i];
 }
 
@@ -283,66 +302,116 @@ int NetworkDependentBehaviorEffect::numberAlterEqualPop(int i) const
 void NetworkDependentBehaviorEffect::preprocessEgo(int ego)
 {
 	BehaviorEffect::preprocessEgo(ego);
-	// set up the covariate based on current values of the network and behavior
-	const Network * pNetwork = this->pNetwork();
 
-	for (int i = 0; i < pNetwork->n(); i++)
+	// The alter values of an actor are recalculated from the current network
+	// and behavior the first time they are queried after this call. Most
+	// effects only query the ego and perhaps its neighbors, so there is no
+	// need to visit all ties of the network here.
+
+	if (this->lstamp == INT_MAX)
 	{
-		int vego = this->value(i); // non-centered
-		this->ltotalAlterValues[i] = 0;
-		this->lnumberAlterHigher[i] = 0;
-		this->lnumberAlterLower[i] = 0;
-		this->lnumberAlterEqual[i] = 0;
-		this->lnumberAlterHigherPop[i] = 0;
-		this->lnumberAlterLowerPop[i] = 0;
-		this->lnumberAlterEqualPop[i] = 0;
-		if (pNetwork->outDegree(i) > 0)
-		{
-			for (IncidentTieIterator iter = pNetwork->outTies(i);
-				 iter.valid();
-				 iter.next())
-			{
-				int j = iter.actor();
-				this->ltotalAlterValues[i] += this->centeredValue(j);
-				if (this->value(j) > vego)
-				{
-					lnumberAlterHigher[i]++;
-					lnumberAlterHigherPop[i] += pNetwork->inDegree(j);
-				}
-				else
-				{
-					if (this->value(j) < vego)
-					{
-						lnumberAlterLower[i]++;
-						lnumberAlterLowerPop[i] += pNetwork->inDegree(j);
-					}
-					else
-					{
-						lnumberAlterEqual[i]++;
-						lnumberAlterHigherPop[i] += pNetwork->inDegree(j);
-					}
-				}
-			}
-// 				Rprintf("%d %f %d %d %d %d\n",
-// 					j, this->centeredValue(j), this->period(),
-		}
-//		Rprintf("%d %f\n", i,this->ltotalAlterValues[i]);
+		this->initializeStamps();
 	}
 
-	for (int i = 0; i < pNetwork->m(); i++)
+	this->lstamp++;
+}
+
+
+/**
+ * Marks the alter values of all actors as out of date.
+ */
+void NetworkDependentBehaviorEffect::initializeStamps()
+{
+	delete [] this->lalterValueStamps;
+	delete [] this->linAlterValueStamps;
+	this->lalterValueStamps = new int[this->lpNetwork->n()];
+	this->linAlterValueStamps = new int[this->lpNetwork->m()];
+
+	for (int i = 0; i < this->lpNetwork->n(); i++)
+	{
+		this->lalterValueStamps[i] = 0;
+	}
+
+	for (int i = 0; i < this->lpNetwork->m(); i++)
 	{
-		this->ltotalInAlterValues[i] = 0;
-		if (pNetwork->inDegree(i) > 0)
+		this->linAlterValueStamps[i] = 0;
+	}
+
+	this->lstamp = 1;
+}
+
+
+/**
+ * Calculates the total, higher, lower, and equal out-alter values of the
+ * given actor, unless they are up to date since the last call to
+ * preprocessEgo.
+ */
+void NetworkDependentBehaviorEffect::updateAlterValues(int i) const
+{
+	if (this->lalterValueStamps[i] == this->lstamp)
+	{
+		return;
+	}
+
+	this->lalterValueStamps[i] = this->lstamp;
+	const Network * pNetwork = this->pNetwork();
+	int vego = this->value(i); // non-centered
+	this->ltotalAlterValues[i] = 0;
+	this->lnumberAlterHigher[i] = 0;
+	this->lnumberAlterLower[i] = 0;
+	this->lnumberAlterEqual[i] = 0;
+	this->lnumberAlterHigherPop[i] = 0;
+	this->lnumberAlterLowerPop[i] = 0;
+	this->lnumberAlterEqualPop[i] = 0;
+
+	for (IncidentTieIterator iter = pNetwork->outTies(i);
+		 iter.valid();
+		 iter.next())
+	{
+		int j = iter.actor();
+		this->ltotalAlterValues[i] += this->centeredValue(j);
+		if (this->value(j) > vego)
 		{
-			for (IncidentTieIterator iter = pNetwork->inTies(i);
-				 iter.valid();
-				 iter.next())
+			lnumberAlterHigher[i]++;
+			lnumberAlterHigherPop[i] += pNetwork->inDegree(j);
+		}
+		else
+		{
+			if (this->value(j) < vego)
 			{
-				int j = iter.actor();
-				this->ltotalInAlterValues[i] += this->centeredValue(j);
+				lnumberAlterLower[i]++;
+				lnumberAlterLowerPop[i] += pNetwork->inDegree(j);
+			}
+			else
+			{
+				lnumberAlterEqual[i]++;
+				lnumberAlterHigherPop[i] += pNetwork->inDegree(j);
 			}
 		}
 	}
 }
 
+
+/**
+ * Calculates the total in-alter value of the given actor, unless it is up
+ * to date since the last call to preprocessEgo.
+ */
+void NetworkDependentBehaviorEffect::updateInAlterValues(int i) const
+{
+	if (this->linAlterValueStamps[i] == this->lstamp)
+	{
+		return;
+	}
+
+	this->linAlterValueStamps[i] = this->lstamp;
+	this->ltotalInAlterValues[i] = 0;
+
+	for (IncidentTieIterator iter = this->pNetwork()->inTies(i);
+		 iter.valid();
+		 iter.next())
+	{
+		this->ltotalInAlterValues[i] += this->centeredValue(iter.actor());
+	}
+}
+
 }
@@ -70,6 +70,10 @@ protected:
 	inline ConfigurationTable * pBRTable() const;
 
 private:
+	void initializeStamps();
+	void updateAlterValues(int i) const;
+	void updateInAlterValues(int i) const;
+
 	//! If `1` value(), missing() and similarity() returns the simulated value
 	//! (if the covariate is a behavior) or the observed value at the end of the
 	//! period.
@@ -88,6 +92,12 @@ private:
 	int * lnumberAlterHigherPop {};
 	int * lnumberAlterLowerPop {};
 	int * lnumberAlterEqualPop {};
+	// the value of lstamp when the out- and in-alter values of each actor
+	// were last calculated
+	int * lalterValueStamps {};
+	int * linAlterValueStamps {};
+	// incremented by each call to preprocessEgo
+	int lstamp {};
 
 	NetworkCache * lpNetworkCache;
 
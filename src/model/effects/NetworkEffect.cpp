@@ -205,6 +205,40 @@ bool NetworkEffect::egoEffect() const
 }
 
 
+/**
+ * Returns if the contribution of a new tie from the ego is the same for
+ * all alters without a tie from the ego, so that it can be calculated
+ * once per ego. False by default.
+ */
+bool NetworkEffect::constantNewTieContribution() const
+{
+	return false;
+}
+
+
+/**
+ * Returns if the contribution of a new tie to an alter depends on the
+ * alter only, and not on the ego, as given by newTieContribution for any
+ * ego without a tie to the alter. False by default.
+ */
+bool NetworkEffect::alterNewTieContribution() const
+{
+	return false;
+}
+
+
+/**
+ * Returns the contribution of a new tie to the given alter from an ego
+ * without a tie to the alter, for effects with alterNewTieContribution().
+ * By default, this is the contribution for the current ego, which is
+ * correct for effects not depending on the tie of the ego to the alter.
+ */
+double NetworkEffect::newTieContribution(int alter) const
+{
+	return this->calculateContribution(alter);
+}
+
+
 /**
  * A convenience method for implementing statistics for both evaluation and
  * endowment function. It assumes that the statistic can be calculated by
@@ -74,6 +74,9 @@ public:
 	virtual std::pair<double, double * > creationStatistic(Network * pGainedTieNetwork, bool needActorStatistics);
 
 	virtual bool egoEffect() const;
+	virtual bool constantNewTieContribution() const;
+	virtual bool alterNewTieContribution() const;
+	virtual double newTieContribution(int alter) const;
 
 protected:
 	int n() const;
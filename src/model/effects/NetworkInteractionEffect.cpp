@@ -19,17 +19,25 @@ namespace siena
  * The parameter pEffect3 should be 0 for two-way interactions.
  * This effect takes the ownership of the given effects, which mean
  * that the given effects will be destroyed as soon as this
- * effect is destroyed.
+ * effect is destroyed. The exception are effects flagged as shared,
+ * which belong to the function owning this effect; these are initialized
+ * and preprocessed by that function as well.
  */
 NetworkInteractionEffect::NetworkInteractionEffect(
 	const EffectInfo * pEffectInfo,
 	NetworkEffect * pEffect1,
 	NetworkEffect * pEffect2,
-	NetworkEffect * pEffect3) : NetworkEffect(pEffectInfo)
+	NetworkEffect * pEffect3,
+	bool shared1,
+	bool shared2,
+	bool shared3) : NetworkEffect(pEffectInfo)
 {
 	this->lpEffect1 = pEffect1;
 	this->lpEffect2 = pEffect2;
 	this->lpEffect3 = pEffect3;
+	this->lshared1 = shared1;
+	this->lshared2 = shared2;
+	this->lshared3 = shared3;
 }
 
 
@@ -38,9 +46,20 @@ NetworkInteractionEffect::NetworkInteractionEffect(
  */
 NetworkInteractionEffect::~NetworkInteractionEffect()
 {
-	delete this->lpEffect1;
-	delete this->lpEffect2;
-	delete this->lpEffect3;
+	if (!this->lshared1)
+	{
+		delete this->lpEffect1;
+	}
+
+	if (!this->lshared2)
+	{
+		delete this->lpEffect2;
+	}
+
+	if (!this->lshared3)
+	{
+		delete this->lpEffect3;
+	}
 }
 
 
@@ -57,10 +76,18 @@ void NetworkInteractionEffect::initialize(const Data * pData,
 	Cache * pCache)
 {
 	NetworkEffect::initialize(pData, pState, period, pCache);
-	this->lpEffect1->initialize(pData, pState, period, pCache);
-	this->lpEffect2->initialize(pData, pState, period, pCache);
 
-	if (this->lpEffect3)
+	if (!this->lshared1)
+	{
+		this->lpEffect1->initialize(pData, pState, period, pCache);
+	}
+
+	if (!this->lshared2)
+	{
+		this->lpEffect2->initialize(pData, pState, period, pCache);
+	}
+
+	if (this->lpEffect3 && !this->lshared3)
 	{
 		this->lpEffect3->initialize(pData, pState, period, pCache);
 	}
@@ -76,10 +103,17 @@ void NetworkInteractionEffect::preprocessEgo(int ego)
 {
 	NetworkEffect::preprocessEgo(ego);
 
-	this->lpEffect1->preprocessEgo(ego);
-	this->lpEffect2->preprocessEgo(ego);
+	if (!this->lshared1)
+	{
+		this->lpEffect1->preprocessEgo(ego);
+	}
+
+	if (!this->lshared2)
+	{
+		this->lpEffect2->preprocessEgo(ego);
+	}
 
-	if (this->lpEffect3)
+	if (this->lpEffect3 && !this->lshared3)
 	{
 		this->lpEffect3->preprocessEgo(ego);
 	}
@@ -26,7 +26,10 @@ public:
 	NetworkInteractionEffect(const EffectInfo * pEffectInfo,
 		NetworkEffect * pEffect1,
 		NetworkEffect * pEffect2,
-		NetworkEffect * pEffect3);
+		NetworkEffect * pEffect3,
+		bool shared1 = false,
+		bool shared2 = false,
+		bool shared3 = false);
 	virtual ~NetworkInteractionEffect();
 
 	virtual void initialize(const Data * pData,
@@ -52,6 +55,13 @@ private:
 	NetworkEffect * lpEffect1;
 	NetworkEffect * lpEffect2;
 	NetworkEffect * lpEffect3;
+
+	// Indicates if the respective interacting effect is shared with the
+	// function owning this effect, which then initializes, preprocesses,
+	// and deallocates it
+	bool lshared1 {};
+	bool lshared2 {};
+	bool lshared3 {};
 };
 
 }
@@ -109,4 +109,14 @@ double OutdegreeActivityEffect::endowmentStatistic(Network * pLostTieNetwork)
 	return statistic;
 }
 
+
+/**
+ * Returns true, as the contribution of a new tie depends on the
+ * out-degree of the ego only.
+ */
+bool OutdegreeActivityEffect::constantNewTieContribution() const
+{
+	return true;
+}
+
 }
@@ -45,6 +45,7 @@ public:
 	virtual void initialize(const Data * pData, State * pState,	int period,
 			Cache * pCache);
 	virtual double calculateContribution(int alter) const;
+	virtual bool constantNewTieContribution() const;
 
 protected:
 	virtual double tieStatistic(int alter);
@@ -84,4 +84,14 @@ double OutdegreeActivitySqrtEffect::endowmentStatistic(Network * pLostTieNetwork
 	return statistic;
 }
 
+
+/**
+ * Returns true, as a new tie changes the statistic of the ego by the
+ * same amount whatever the alter.
+ */
+bool OutdegreeActivitySqrtEffect::constantNewTieContribution() const
+{
+	return true;
+}
+
 }
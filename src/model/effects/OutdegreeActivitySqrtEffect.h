@@ -41,6 +41,7 @@ public:
 	OutdegreeActivitySqrtEffect(const EffectInfo * pEffectInfo);
 
 	virtual double calculateContribution(int alter) const;
+	virtual bool constantNewTieContribution() const;
 
 protected:
 	virtual double tieStatistic(int alter);
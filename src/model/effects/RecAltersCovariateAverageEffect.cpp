@@ -48,7 +48,7 @@ RecAltersCovariateAverageEffect::RecAltersCovariateAverageEffect(
  */
 void RecAltersCovariateAverageEffect::preprocessEgo(int ego)
 {
-// do not repeat all this:	CovariateAndNetworkBehaviorEffect::preprocessEgo(ego);
+	CovariateAndNetworkBehaviorEffect::preprocessEgo(ego);
 	this->lTotalAlterValue = 0;
 	int neighborCount = 0;
 	const OneModeNetwork * pNetwork =
@@ -102,16 +102,18 @@ double TotalGwdspAlterNCEffect::calculateChangeContribution(int actor,
 
 		double sumAlterValue = 0;
 		// double denom = 0;
-		for (int j = 0; j < this->n(); j++) //inefficient?
+		// Actors without two-paths have weight 0, so only the non-zero
+		// entries of the table are visited.
+		const std::vector<int> & alters =
+			this->lpInitialisedTable->nonZeroActors();
+		for (unsigned k = 0; k < alters.size(); k++)
 		{
+			int j = alters[k];
 			double alterValue = 0;
 			int twoc = 0;
 			if (j != actor)
 			{
-				if (this->lforward)
-					twoc = this->lpInitialisedTable->get(j);
-				else 
-					twoc = this->lpInitialisedTable->get(j);
+				twoc = this->lpInitialisedTable->get(j);
 				alterValue = this->value(j) * this->lcumulativeWeight[twoc];
 				// int tieValue =  this->pNetwork()->tieValue(actor, j);
 				// if (((pNetwork->inDegree(j) - tieValue)> 0) && (this->ldivide2))
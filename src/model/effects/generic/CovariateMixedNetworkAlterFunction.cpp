@@ -78,22 +78,49 @@ void CovariateMixedNetworkAlterFunction::initialize(const Data * pData,
 		throw logic_error("Covariate or dependent behavior variable '" +
 				this->lcovariateName + "' expected.");
 	}
+
+	this->resolveValues(period);
 }
 
 /**
- * Returns the covariate value for the given actor.
+ * Looks up the values and missingness indicators of the covariate at the
+ * given period, or the mean to be subtracted from the values of the
+ * behavior variable, so that covvalue() and missing() need not find them
+ * again for each alter.
  */
-double CovariateMixedNetworkAlterFunction::covvalue(int alter)  const
+void CovariateMixedNetworkAlterFunction::resolveValues(int period)
 {
+	this->lcovariateValues = 0;
+	this->lcovariateMissing = 0;
+	this->lbehaviorMean = 0;
+
 	if (this->lpConstantCovariate)
 	{
-		return this->lpConstantCovariate->value(alter);
+		this->lcovariateValues = this->lpConstantCovariate->values();
+		this->lcovariateMissing = this->lpConstantCovariate->missingValues();
 	}
-	if (this->lpChangingCovariate)
+	else if (this->lpChangingCovariate)
 	{
-		return this->lpChangingCovariate->value(alter, this->lperiod);
+		this->lcovariateValues = this->lpChangingCovariate->values(period);
+		this->lcovariateMissing =
+			this->lpChangingCovariate->missingValues(period);
+	}
+	else
+	{
+		this->lbehaviorMean = this->lpBehaviorData->overallMean();
 	}
-	return this->lvalues[alter] - this->lpBehaviorData->overallMean();
+}
+
+/**
+ * Returns the covariate value for the given actor.
+ */
+double CovariateMixedNetworkAlterFunction::covvalue(int alter)  const
+{
+	if (this->lcovariateValues)
+	{
+		return this->lcovariateValues[alter];
+	}
+	return this->lvalues[alter] - this->lbehaviorMean;
 }
 
 /**
@@ -103,13 +130,9 @@ bool CovariateMixedNetworkAlterFunction::missing(int i) const
 {
 	bool missing = false;
 
-	if (this->lpConstantCovariate)
-	{
-		missing = this->lpConstantCovariate->missing(i);
-	}
-	else if (this->lpChangingCovariate)
+	if (this->lcovariateMissing)
 	{
-		missing = this->lpChangingCovariate->missing(i, this->lperiod);
+		missing = this->lcovariateMissing[i];
 	}
 	else
 	{
@@ -53,6 +53,8 @@ protected:
 	BehaviorLongitudinalData * pBehaviorData() const;
 
 private:
+	void resolveValues(int period);
+
 	std::string lcovariateName {};
 	int lperiod {};
 	ConstantCovariate * lpConstantCovariate;
@@ -62,6 +64,14 @@ private:
 	// The current value of a behavior variable per each actor.
 	// This array is 0 for covariate-based effects.
 	const int * lvalues {};
+
+	// The values and missingness indicators of a covariate in the current
+	// period per each actor, or 0 for a behavior variable.
+	const double * lcovariateValues {};
+	const bool * lcovariateMissing {};
+
+	// The overall mean of a behavior variable
+	double lbehaviorMean {};
 };
 
 
@@ -79,6 +79,37 @@ void CovariateNetworkAlterFunction::initialize(const Data * pData,
 			this->lcovariateName +
 			"' expected.");
 	}
+
+	this->resolveValues(period);
+}
+
+/**
+ * Looks up the values and missingness indicators of the covariate at the
+ * given period, or the mean to be subtracted from the values of the
+ * behavior variable, so that covvalue() and missing() need not find them
+ * again for each alter.
+ */
+void CovariateNetworkAlterFunction::resolveValues(int period)
+{
+	this->lcovariateValues = 0;
+	this->lcovariateMissing = 0;
+	this->lbehaviorMean = 0;
+
+	if (this->lpConstantCovariate)
+	{
+		this->lcovariateValues = this->lpConstantCovariate->values();
+		this->lcovariateMissing = this->lpConstantCovariate->missingValues();
+	}
+	else if (this->lpChangingCovariate)
+	{
+		this->lcovariateValues = this->lpChangingCovariate->values(period);
+		this->lcovariateMissing =
+			this->lpChangingCovariate->missingValues(period);
+	}
+	else
+	{
+		this->lbehaviorMean = this->lpBehaviorData->overallMean();
+	}
 }
 
 /**
@@ -119,15 +150,11 @@ double CovariateNetworkAlterFunction::covmean() const
  */
 double CovariateNetworkAlterFunction::covvalue(int alter) const
 {
-	if (this->lpConstantCovariate)
+	if (this->lcovariateValues)
 	{
-		return this->lpConstantCovariate->value(alter);
+		return this->lcovariateValues[alter];
 	}
-	if (this->lpChangingCovariate)
-	{
-		return this->lpChangingCovariate->value(alter, this->lperiod);
-	}
-	return this->lvalues[alter] - this->lpBehaviorData->overallMean();
+	return this->lvalues[alter] - this->lbehaviorMean;
 }
 
 /**
@@ -154,13 +181,9 @@ bool CovariateNetworkAlterFunction::missing(int i) const
 {
 	bool missing = false;
 
-	if (this->lpConstantCovariate)
-	{
-		missing = this->lpConstantCovariate->missing(i);
-	}
-	else if (this->lpChangingCovariate)
+	if (this->lcovariateMissing)
 	{
-		missing = this->lpChangingCovariate->missing(i, this->lperiod);
+		missing = this->lcovariateMissing[i];
 	}
 	else
 	{
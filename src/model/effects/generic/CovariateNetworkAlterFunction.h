@@ -61,6 +61,8 @@ protected:
 	BehaviorLongitudinalData * pBehaviorData() const;
 
 private:
+	void resolveValues(int period);
+
 	std::string lcovariateName {};
 	int lperiod {};
 	ConstantCovariate * lpConstantCovariate;
@@ -71,6 +73,14 @@ private:
 	// This array is 0 for covariate-based effects.
 
 	const int * lvalues {};
+
+	// The values and missingness indicators of a covariate in the current
+	// period per each actor, or 0 for a behavior variable.
+	const double * lcovariateValues {};
+	const bool * lcovariateMissing {};
+
+	// The overall mean of a behavior variable
+	double lbehaviorMean {};
 };
 
 
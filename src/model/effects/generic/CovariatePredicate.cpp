@@ -63,27 +63,55 @@ void CovariatePredicate::initialize(const Data * pData,
 			name +
 			"' expected.");
 	}
+
+	this->resolveValues(period);
 }
 
 
 /**
- * Returns the covariate value for the given actor.
+ * Looks up the values and missingness indicators of the covariate at the
+ * given period, or the mean to be subtracted from the values of the
+ * behavior variable, so that covariateValue() and missing() need not find
+ * them again for each actor.
  */
-double CovariatePredicate::covariateValue(int i) const
+void CovariatePredicate::resolveValues(int period)
 {
-	double value = 0;
+	this->lcovariateValues = 0;
+	this->lcovariateMissing = 0;
+	this->lbehaviorMean = 0;
 
 	if (this->lpConstantCovariate)
 	{
-		value = this->lpConstantCovariate->value(i);
+		this->lcovariateValues = this->lpConstantCovariate->values();
+		this->lcovariateMissing = this->lpConstantCovariate->missingValues();
 	}
 	else if (this->lpChangingCovariate)
 	{
-		value = this->lpChangingCovariate->value(i, this->period());
+		this->lcovariateValues = this->lpChangingCovariate->values(period);
+		this->lcovariateMissing =
+			this->lpChangingCovariate->missingValues(period);
 	}
 	else
 	{
-		value = this->lvalues[i] - this->lpBehaviorData->overallMean();
+		this->lbehaviorMean = this->lpBehaviorData->overallMean();
+	}
+}
+
+
+/**
+ * Returns the covariate value for the given actor.
+ */
+double CovariatePredicate::covariateValue(int i) const
+{
+	double value = 0;
+
+	if (this->lcovariateValues)
+	{
+		value = this->lcovariateValues[i];
+	}
+	else
+	{
+		value = this->lvalues[i] - this->lbehaviorMean;
 	}
 
 	return value;
@@ -97,13 +125,9 @@ bool CovariatePredicate::missing(int i) const
 {
 	bool missing = false;
 
-	if (this->lpConstantCovariate)
-	{
-		missing = this->lpConstantCovariate->missing(i);
-	}
-	else if (this->lpChangingCovariate)
+	if (this->lcovariateMissing)
 	{
-		missing = this->lpChangingCovariate->missing(i, this->period());
+		missing = this->lcovariateMissing[i];
 	}
 	else
 	{
@@ -34,6 +34,8 @@ protected:
 	bool missing(int i) const;
 
 private:
+	void resolveValues(int period);
+
 	ConstantCovariate * lpConstantCovariate;
 	ChangingCovariate * lpChangingCovariate;
 	BehaviorLongitudinalData * lpBehaviorData;
@@ -42,6 +44,14 @@ private:
 	// This array is 0 for covariate-based effects.
 
 	const int * lvalues {};
+
+	// The values and missingness indicators of a covariate in the current
+	// period per each actor, or 0 for a behavior variable.
+	const double * lcovariateValues {};
+	const bool * lcovariateMissing {};
+
+	// The overall mean of a behavior variable
+	double lbehaviorMean {};
 };
 
 }
@@ -14,7 +14,9 @@
 #include "network/Network.h"
 #include "network/IncidentTieIterator.h"
 #include "model/variables/NetworkVariable.h"
+#include "model/tables/Cache.h"
 #include "model/tables/NetworkCache.h"
+#include "utils/MarkArray.h"
 #include "utils/SqrtTable.h"
 
 
@@ -44,7 +46,6 @@ IndirectTiesFunction::
  */
 IndirectTiesFunction::~IndirectTiesFunction()
 {
-	delete[] this->lmark;
 }
 
 /**
@@ -60,21 +61,7 @@ void IndirectTiesFunction::initialize(const Data * pData,
 	Cache * pCache)
 {
 	NetworkAlterFunction::initialize(pData, pState, period, pCache);
-	const Network * pNetwork = this->pNetwork();
-	int n = pNetwork->n();
-	int m = pNetwork->m();
-	if (m > n)
-	{
-		n = m;
-	}
-	// now n will be OK for any choice of firstIn and secondIn.
-
-	// A helper array of marks
-	this->lmark = new bool[n];
-	for (int i = 0; i < n; i++)
-	{
-		this->lmark[i] = false;
-	}
+	this->lpMarks = pCache->pMarkArray();
 }
 
 /**
@@ -94,12 +81,10 @@ void IndirectTiesFunction::preprocessEgo(int ego)
 	{
 		n = m;
 	}
+	// now n will be OK for any choice of firstIn and secondIn.
 	IncidentTieIterator iterI;
-	
-	for (int i = 0; i < n; i++)
-	{
-		this->lmark[i] = false;
-	}
+	MarkArray * pMarks = this->lpMarks;
+	pMarks->reset(n);
 
 	if (lfirstin)
 	{
@@ -110,7 +95,7 @@ void IndirectTiesFunction::preprocessEgo(int ego)
 		iterI = pNetwork->outTies(ego);
 	}
 
-	// Invariant: mark[h] = true if and only if a two-path from ego
+	// Invariant: h is marked if and only if a two-path from ego
 	// to h has been found.
 	// Traverse all two-paths from ego
 
@@ -130,10 +115,10 @@ void IndirectTiesFunction::preprocessEgo(int ego)
 		for ( ; iterJ.valid(); iterJ.next())
 		{
 			int h = iterJ.actor();
-			if ((!this->lmark[h]) && (h != ego))
+			if ((!pMarks->marked(h)) && (h != ego))
 			{
 				// The first two-path from ego to h is found.
-				this->lmark[h] = true;
+				pMarks->mark(h);
 				statistic ++;
 			}
 		}
@@ -144,9 +129,9 @@ void IndirectTiesFunction::preprocessEgo(int ego)
 // the direct ties have to be subtracted
 		for ( ;	iterI.valid(); iterI.next())
 		{
-			if (this->lmark[iterI.actor()])
+			if (pMarks->marked(iterI.actor()))
 			{
-				this->lmark[iterI.actor()] = false;
+				pMarks->unmark(iterI.actor());
 				statistic--;
 			}			
 		}		
@@ -25,6 +25,7 @@ class ConfigurationTable;
 // ----------------------------------------------------------------------------
 
 class SqrtTable;
+class MarkArray;
 
 
 // ----------------------------------------------------------------------------
@@ -59,8 +60,8 @@ private:
 	bool lsecondin {}; // second tie in- or outgoing?
 	// Lookup table for fast square root calculations:
 	SqrtTable * lsqrtTable;
-	// A helper array of marks for statistic calculation
-	bool * lmark {};
+	// The marks of the cache, shared with other effects
+	MarkArray * lpMarks {};
 	int lNbrDist2Nodes {};
 };
 
@@ -12,7 +12,6 @@
 #include "network/IncidentTieIterator.h"
 #include "network/Network.h"
 #include "model/variables/NetworkVariable.h"
-#include "model/ml/NetworkChange.h"
 
 namespace siena
 {
@@ -70,19 +69,16 @@ void LowerFilter::filterPermittedChanges(int ego, bool * permitted)
 
 
 /**
- * Returns if applying the given ministep on the current state of the
- * network would be valid with respect to this filter.
+ * Returns if this filter permits a change of the tie from actor i to
+ * actor j in the current state of the networks.
  */
-bool LowerFilter::validMiniStep(const NetworkChange * pMiniStep)
+bool LowerFilter::permittedChange(int i, int j)
 {
 	const Network * pNetwork1 = this->pVariable()->pNetwork();
 	const Network * pNetwork2 = this->pOtherVariable()->pNetwork();
 
 	// We shouldn't introduce a tie if it is not present in the other network.
 
-	int i = pMiniStep->ego();
-	int j = pMiniStep->alter();
-
 	return pNetwork1->tieValue(i, j) || pNetwork2->tieValue(i, j);
 }
 
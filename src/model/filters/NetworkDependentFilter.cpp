@@ -10,6 +10,7 @@
  *****************************************************************************/
 
 #include "NetworkDependentFilter.h"
+#include "model/variables/NetworkVariable.h"
 
 namespace siena
 {
@@ -25,4 +26,14 @@ NetworkDependentFilter::NetworkDependentFilter(
 	this->lpOtherVariable = pOtherVariable;
 }
 
+
+/**
+ * Returns the network of the other variable, whose ties this filter
+ * depends on.
+ */
+const Network * NetworkDependentFilter::pOtherNetwork() const
+{
+	return this->lpOtherVariable->pNetwork();
+}
+
 }
@@ -26,6 +26,8 @@ public:
 	NetworkDependentFilter(const NetworkVariable * pOwnerVariable,
 		const NetworkVariable * pOtherVariable);
 
+	virtual const Network * pOtherNetwork() const;
+
 protected:
 	inline const NetworkVariable * pOtherVariable() const;
 
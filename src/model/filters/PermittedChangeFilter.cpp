@@ -10,6 +10,7 @@
  *****************************************************************************/
 
 #include "PermittedChangeFilter.h"
+#include "model/ml/NetworkChange.h"
 
 namespace siena
 {
@@ -22,4 +23,24 @@ PermittedChangeFilter::PermittedChangeFilter(const NetworkVariable * pVariable)
 	this->lpVariable = pVariable;
 }
 
+
+/**
+ * Returns if applying the given ministep on the current state of the
+ * network would be valid with respect to this filter.
+ */
+bool PermittedChangeFilter::validMiniStep(const NetworkChange * pMiniStep)
+{
+	return this->permittedChange(pMiniStep->ego(), pMiniStep->alter());
+}
+
+
+/**
+ * Returns the network other than the network of the owner variable whose
+ * ties this filter depends on, or 0 if there is none.
+ */
+const Network * PermittedChangeFilter::pOtherNetwork() const
+{
+	return 0;
+}
+
 }
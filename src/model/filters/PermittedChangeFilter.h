@@ -21,6 +21,7 @@ namespace siena
 
 class NetworkVariable;
 class NetworkChange;
+class Network;
 
 
 // ----------------------------------------------------------------------------
@@ -42,10 +43,14 @@ public:
 	virtual void filterPermittedChanges(int ego, bool * permitted) = 0;
 
 	/**
-	 * Returns if applying the given ministep on the current state of the
-	 * network would be valid with respect to this filter.
+	 * Returns if a change of the tie between the given ego and alter
+	 * is permitted in the current state of the network. This agrees with
+	 * filterPermittedChanges for the single alter.
 	 */
-	virtual bool validMiniStep(const NetworkChange * pMiniStep) = 0;
+	virtual bool permittedChange(int ego, int alter) = 0;
+
+	virtual bool validMiniStep(const NetworkChange * pMiniStep);
+	virtual const Network * pOtherNetwork() const;
 
 protected:
 	PermittedChangeFilter(const NetworkVariable * pVariable);
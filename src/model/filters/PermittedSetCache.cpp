@@ -0,0 +1,253 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: PermittedSetCache.cpp
+ *
+ * Description: This file contains the implementation of the
+ * PermittedSetCache class.
+ *****************************************************************************/
+
+#include "PermittedSetCache.h"
+#include "network/Network.h"
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Constructors and destructor
+// ----------------------------------------------------------------------------
+
+/**
+ * Creates an empty cache for the given number of egos and the given number
+ * of alters in each permitted set.
+ */
+PermittedSetCache::PermittedSetCache(int n, int rowLength)
+{
+	this->ln = n;
+	this->lrowLength = rowLength;
+	this->lwords = (rowLength + 63) / 64;
+	this->lperiod = -1;
+	this->lrows.assign((size_t) n * this->lwords, 0);
+	this->lvalid.assign(n, false);
+}
+
+
+/**
+ * Stops listening to the networks.
+ */
+PermittedSetCache::~PermittedSetCache()
+{
+	for (unsigned i = 0; i < this->lnetworks.size(); i++)
+	{
+		if (this->lattached[i])
+		{
+			this->lnetworks[i]->removeNetworkChangeListener(this);
+		}
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Public interface
+// ----------------------------------------------------------------------------
+
+/**
+ * Adds a network whose changes may change the permitted sets.
+ */
+void PermittedSetCache::addNetwork(const Network * pNetwork)
+{
+	for (unsigned i = 0; i < this->lnetworks.size(); i++)
+	{
+		if (this->lnetworks[i] == pNetwork)
+		{
+			return;
+		}
+	}
+
+	this->lnetworks.push_back(pNetwork);
+	this->lattached.push_back(false);
+	this->invalidateAll();
+}
+
+
+/**
+ * Returns if the stored row of the given ego is up to date in the given
+ * period. Listens to the networks again if they have been disposed or
+ * reassigned meanwhile, in which case no row is up to date.
+ */
+bool PermittedSetCache::valid(int ego, int period)
+{
+	this->attach();
+
+	if (period != this->lperiod)
+	{
+		this->invalidateAll();
+		this->lperiod = period;
+	}
+
+	return this->lvalid[ego];
+}
+
+
+/**
+ * Returns if the stored row of the given ego is up to date, assuming the
+ * period has been checked by valid(ego, period) already.
+ */
+bool PermittedSetCache::valid(int ego) const
+{
+	return this->lvalid[ego];
+}
+
+
+/**
+ * Copies the stored row of the given ego to the given array of flags.
+ */
+void PermittedSetCache::get(int ego, bool * permitted) const
+{
+	const std::uint64_t * row = &this->lrows[(size_t) ego * this->lwords];
+
+	for (int alter = 0; alter < this->lrowLength; alter++)
+	{
+		permitted[alter] = (row[alter >> 6] >> (alter & 63)) & 1;
+	}
+}
+
+
+/**
+ * Stores the given array of flags as the row of the given ego.
+ */
+void PermittedSetCache::store(int ego, const bool * permitted)
+{
+	std::uint64_t * row = &this->lrows[(size_t) ego * this->lwords];
+
+	for (int word = 0; word < this->lwords; word++)
+	{
+		row[word] = 0;
+	}
+
+	for (int alter = 0; alter < this->lrowLength; alter++)
+	{
+		if (permitted[alter])
+		{
+			row[alter >> 6] |= std::uint64_t(1) << (alter & 63);
+		}
+	}
+
+	this->lvalid[ego] = true;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: INetworkChangeListener interface
+// ----------------------------------------------------------------------------
+
+/**
+ * Invoked when the cache starts listening to the given network.
+ */
+void PermittedSetCache::onInitializationEvent(const Network & rNetwork)
+{
+	this->invalidateAll();
+}
+
+
+/**
+ * Invoked when a tie is introduced in one of the networks.
+ */
+void PermittedSetCache::onTieIntroductionEvent(const Network & rNetwork,
+	const int ego,
+	const int alter)
+{
+	this->invalidate(ego);
+	this->invalidate(alter);
+}
+
+
+/**
+ * Invoked when a tie is withdrawn from one of the networks.
+ */
+void PermittedSetCache::onTieWithdrawalEvent(const Network & rNetwork,
+	const int ego,
+	const int alter)
+{
+	this->invalidate(ego);
+	this->invalidate(alter);
+}
+
+
+/**
+ * Invoked when all ties of one of the networks are removed.
+ */
+void PermittedSetCache::onNetworkClearEvent(const Network & rNetwork)
+{
+	this->invalidateAll();
+}
+
+
+/**
+ * Invoked when one of the networks is destroyed or assigned the contents
+ * of another network. The cache stops listening to the network until
+ * the next call to valid(ego, period).
+ */
+void PermittedSetCache::onNetworkDisposeEvent(const Network & rNetwork)
+{
+	rNetwork.removeNetworkChangeListener(this);
+
+	for (unsigned i = 0; i < this->lnetworks.size(); i++)
+	{
+		if (this->lnetworks[i] == &rNetwork)
+		{
+			this->lattached[i] = false;
+		}
+	}
+
+	this->invalidateAll();
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Private methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Registers this cache as a listener of all networks it is not listening
+ * to yet.
+ */
+void PermittedSetCache::attach()
+{
+	for (unsigned i = 0; i < this->lnetworks.size(); i++)
+	{
+		if (!this->lattached[i])
+		{
+			this->lnetworks[i]->addNetworkChangeListener(this);
+			this->lattached[i] = true;
+			this->invalidateAll();
+		}
+	}
+}
+
+
+/**
+ * Marks the row of the given actor as out of date. The alters of two-mode
+ * networks are ignored unless they are also egos, which just invalidates
+ * a row more than necessary.
+ */
+void PermittedSetCache::invalidate(int actor)
+{
+	if (actor < this->ln)
+	{
+		this->lvalid[actor] = false;
+	}
+}
+
+
+/**
+ * Marks all rows as out of date.
+ */
+void PermittedSetCache::invalidateAll()
+{
+	this->lvalid.assign(this->ln, false);
+}
+
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: PermittedSetCache.h
+ *
+ * Description: This file defines the class PermittedSetCache.
+ *****************************************************************************/
+
+#ifndef PERMITTEDSETCACHE_H_
+#define PERMITTEDSETCACHE_H_
+
+#include <cstdint>
+#include <vector>
+#include "network/INetworkChangeListener.h"
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Forward declarations
+// ----------------------------------------------------------------------------
+
+class Network;
+
+
+// ----------------------------------------------------------------------------
+// Section: Class description
+// ----------------------------------------------------------------------------
+
+/**
+ * Stores for each ego of a network variable the set of alters to which
+ * a tie change is permitted, as a row of bits.
+ *
+ * The permitted sets depend on the period and on the ties of the ego in
+ * the network of the variable and in the networks its filters depend on.
+ * The cache listens to these networks, and a change of the tie between
+ * two actors invalidates the rows of both actors; a change of the period
+ * invalidates all rows. A row is filled again by the owner variable the
+ * next time the ego is visited.
+ */
+class PermittedSetCache : public INetworkChangeListener
+{
+public:
+	PermittedSetCache(int n, int rowLength);
+	virtual ~PermittedSetCache();
+
+	void addNetwork(const Network * pNetwork);
+	bool valid(int ego, int period);
+	bool valid(int ego) const;
+	void get(int ego, bool * permitted) const;
+	inline bool permitted(int ego, int alter) const;
+	void store(int ego, const bool * permitted);
+
+	// INetworkChangeListener interface
+
+	virtual void onInitializationEvent(const Network & rNetwork);
+	virtual void onTieIntroductionEvent(const Network & rNetwork,
+		const int ego,
+		const int alter);
+	virtual void onTieWithdrawalEvent(const Network & rNetwork,
+		const int ego,
+		const int alter);
+	virtual void onNetworkClearEvent(const Network & rNetwork);
+	virtual void onNetworkDisposeEvent(const Network & rNetwork);
+
+private:
+	void attach();
+	void invalidate(int actor);
+	void invalidateAll();
+
+	// The networks whose changes may change the permitted sets
+	std::vector<const Network *> lnetworks;
+
+	// Indicates for each of these networks if the cache is listening to it
+	std::vector<bool> lattached;
+
+	// The number of egos
+	int ln {};
+
+	// The number of alters in a permitted set
+	int lrowLength {};
+
+	// The number of 64 bit words per row
+	int lwords {};
+
+	// The period of the stored rows
+	int lperiod {};
+
+	// The permitted sets, one row of lwords words per ego
+	std::vector<std::uint64_t> lrows;
+
+	// Indicates for each ego if its row is up to date
+	std::vector<bool> lvalid;
+};
+
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns if a tie change from the given ego to the given alter is
+ * permitted according to the stored row of the ego, which must be valid.
+ */
+bool PermittedSetCache::permitted(int ego, int alter) const
+{
+	return (this->lrows[ego * this->lwords + (alter >> 6)] >> (alter & 63)) & 1;
+}
+
+}
+
+#endif /* PERMITTEDSETCACHE_H_ */
@@ -11,6 +11,10 @@
 #include <vector>
 #include <stdexcept>
 #include <string>
+#include <cstring>
+#include <cstdint>
+#include <istream>
+#include <ostream>
 
 #include <Rinternals.h>
 
@@ -25,6 +29,7 @@
 #include "network/Network.h"
 #include "network/IncidentTieIterator.h"
 #include "data/Data.h"
+#include "data/ActorSet.h"
 #include "data/BehaviorLongitudinalData.h"
 #include "data/NetworkLongitudinalData.h"
 #include "model/variables/DependentVariable.h"
@@ -53,7 +58,8 @@ Chain::Chain(Data * pData)
 	this->lpFirst->pNext(this->lpLast);
 	this->lpLast->pPrevious(this->lpFirst);
 
-	this->resetOrderingKeys();
+	this->ltreePriorityState = 2463534242u;
+	this->resetTree();
 
 	this->lpData = pData;
 	this->lperiod = -1;
@@ -124,6 +130,7 @@ void Chain::clear()
 
 	this->lpFirst->pNext(this->lpLast);
 	this->lpLast->pPrevious(this->lpFirst);
+	this->resetTree();
 
 	this->lminiSteps.clear();
 	this->lminiSteps.push_back(this->lpLast);
@@ -158,23 +165,9 @@ void Chain::insertBefore(MiniStep * pNewMiniStep, MiniStep * pExistingMiniStep)
 	pNewMiniStep->pNext(pExistingMiniStep);
 	pExistingMiniStep->pPrevious(pNewMiniStep);
 
-	// Set the ordering key.
+	// Update the tree of positions.
 
-	double leftKey = pPreviousMiniStep->orderingKey();
-	double rightKey = pExistingMiniStep->orderingKey();
-	double newKey = (leftKey + rightKey) / 2;
-
-	if ((-leftKey + newKey) > 1e-10 && (- newKey +rightKey) > 1e-10)
-	{
-		pNewMiniStep->orderingKey(newKey);
-	}
-	else
-	{
-		// Bad. We have exhausted the double precision.
-		// However, using a linear time effort, we can restore a correct order.
-
-		this->resetOrderingKeys();
-	}
+	this->insertInTree(pNewMiniStep, pExistingMiniStep);
 
 	// Update the array of diagonal ministeps
 
@@ -236,6 +229,7 @@ void Chain::remove(MiniStep * pMiniStep)
 	pMiniStep->pNext()->pPrevious(pPrevious);
 	pMiniStep->pNext(0);
 	pMiniStep->pPrevious(0);
+	this->removeFromTree(pMiniStep);
 
 	// Next and previous pointers to ministeps of the same option
 
@@ -366,6 +360,7 @@ void Chain::connect(int period, MLSimulation * pMLSimulation)
 						else
 						{
 							// create step in structural subchain?
+							iter1.next();
 						}
 					}
 					else if (iter2.valid() &&
@@ -386,6 +381,7 @@ void Chain::connect(int period, MLSimulation * pMLSimulation)
 						else
 						{
 							// create step in structural subchain?
+							iter2.next();
 						}
 					}
 					else
@@ -808,23 +804,208 @@ void Chain::clearEndStateDifferences()
 }
 
 /**
- * Assigns new ordering keys for the ministeps of this chain. The new
- * ordering key of a ministep is its index in the list.
+ * Resets the tree of positions to contain the two dummy ministeps only.
+ * The dummies have the lowest possible priority, so they stay near the
+ * leaves of the tree.
  */
-void Chain::resetOrderingKeys()
+void Chain::resetTree()
 {
-	int key = 0;
-	MiniStep * pMiniStep = this->lpFirst;
+	this->lpFirst->lpTreeParent = 0;
+	this->lpFirst->lpTreeLeft = 0;
+	this->lpFirst->lpTreeRight = this->lpLast;
+	this->lpFirst->ltreeSize = 2;
+	this->lpFirst->ltreePriority = 0;
+
+	this->lpLast->lpTreeParent = this->lpFirst;
+	this->lpLast->lpTreeLeft = 0;
+	this->lpLast->lpTreeRight = 0;
+	this->lpLast->ltreeSize = 1;
+	this->lpLast->ltreePriority = 0;
+
+	this->lpTreeRoot = this->lpFirst;
+}
 
-	while (pMiniStep)
+
+/**
+ * Adds the given new ministep to the tree of positions just before the
+ * given existing ministep.
+ */
+void Chain::insertInTree(MiniStep * pNewMiniStep, MiniStep * pExistingMiniStep)
+{
+	pNewMiniStep->lpTreeLeft = 0;
+	pNewMiniStep->lpTreeRight = 0;
+	pNewMiniStep->ltreeSize = 1;
+	pNewMiniStep->ltreePriority = this->nextTreePriority();
+
+	// The new ministep becomes a leaf, either the left child of the existing
+	// ministep or the right child of its in-order predecessor.
+
+	MiniStep * pParent = pExistingMiniStep;
+
+	if (!pParent->lpTreeLeft)
 	{
-		pMiniStep->orderingKey(key);
-		pMiniStep = pMiniStep->pNext();
-		key++;
+		pParent->lpTreeLeft = pNewMiniStep;
+	}
+	else
+	{
+		pParent = pParent->lpTreeLeft;
+
+		while (pParent->lpTreeRight)
+		{
+			pParent = pParent->lpTreeRight;
+		}
+
+		pParent->lpTreeRight = pNewMiniStep;
+	}
+
+	pNewMiniStep->lpTreeParent = pParent;
+
+	for (MiniStep * pNode = pParent; pNode; pNode = pNode->lpTreeParent)
+	{
+		pNode->ltreeSize++;
+	}
+
+	// Restore the heap order of the priorities.
+
+	while (pNewMiniStep->lpTreeParent &&
+		pNewMiniStep->lpTreeParent->ltreePriority <
+			pNewMiniStep->ltreePriority)
+	{
+		this->rotateUp(pNewMiniStep);
 	}
 }
 
 
+/**
+ * Removes the given ministep from the tree of positions.
+ */
+void Chain::removeFromTree(MiniStep * pMiniStep)
+{
+	// Rotate the ministep down until it is a leaf, always lifting the
+	// child of higher priority to keep the heap order.
+
+	while (pMiniStep->lpTreeLeft || pMiniStep->lpTreeRight)
+	{
+		MiniStep * pChild = pMiniStep->lpTreeLeft;
+
+		if (!pChild ||
+			(pMiniStep->lpTreeRight &&
+				pMiniStep->lpTreeRight->ltreePriority > pChild->ltreePriority))
+		{
+			pChild = pMiniStep->lpTreeRight;
+		}
+
+		this->rotateUp(pChild);
+	}
+
+	MiniStep * pParent = pMiniStep->lpTreeParent;
+
+	if (pParent->lpTreeLeft == pMiniStep)
+	{
+		pParent->lpTreeLeft = 0;
+	}
+	else
+	{
+		pParent->lpTreeRight = 0;
+	}
+
+	for (MiniStep * pNode = pParent; pNode; pNode = pNode->lpTreeParent)
+	{
+		pNode->ltreeSize--;
+	}
+
+	pMiniStep->lpTreeParent = 0;
+	pMiniStep->ltreeSize = 0;
+}
+
+
+/**
+ * Rotates the given ministep above its parent in the tree of positions,
+ * preserving the in-order sequence of the ministeps.
+ */
+void Chain::rotateUp(MiniStep * pMiniStep)
+{
+	MiniStep * pParent = pMiniStep->lpTreeParent;
+	MiniStep * pGrandparent = pParent->lpTreeParent;
+
+	if (pParent->lpTreeLeft == pMiniStep)
+	{
+		pParent->lpTreeLeft = pMiniStep->lpTreeRight;
+
+		if (pMiniStep->lpTreeRight)
+		{
+			pMiniStep->lpTreeRight->lpTreeParent = pParent;
+		}
+
+		pMiniStep->lpTreeRight = pParent;
+	}
+	else
+	{
+		pParent->lpTreeRight = pMiniStep->lpTreeLeft;
+
+		if (pMiniStep->lpTreeLeft)
+		{
+			pMiniStep->lpTreeLeft->lpTreeParent = pParent;
+		}
+
+		pMiniStep->lpTreeLeft = pParent;
+	}
+
+	pParent->lpTreeParent = pMiniStep;
+	pMiniStep->lpTreeParent = pGrandparent;
+
+	if (!pGrandparent)
+	{
+		this->lpTreeRoot = pMiniStep;
+	}
+	else if (pGrandparent->lpTreeLeft == pParent)
+	{
+		pGrandparent->lpTreeLeft = pMiniStep;
+	}
+	else
+	{
+		pGrandparent->lpTreeRight = pMiniStep;
+	}
+
+	pParent->ltreeSize = treeSize(pParent->lpTreeLeft) +
+		treeSize(pParent->lpTreeRight) + 1;
+	pMiniStep->ltreeSize = treeSize(pMiniStep->lpTreeLeft) +
+		treeSize(pMiniStep->lpTreeRight) + 1;
+}
+
+
+/**
+ * Returns a new pseudo-random priority for the tree of positions. A simple
+ * xorshift generator suffices, and the priorities are never zero.
+ */
+unsigned Chain::nextTreePriority()
+{
+	unsigned x = this->ltreePriorityState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	this->ltreePriorityState = x;
+	return x;
+}
+
+
+/**
+ * Returns the number of ministeps in the subtree rooted at the given
+ * ministep, which may be 0.
+ */
+int Chain::treeSize(const MiniStep * pMiniStep)
+{
+	int size = 0;
+
+	if (pMiniStep)
+	{
+		size = pMiniStep->ltreeSize;
+	}
+
+	return size;
+}
+
+
 /**
  * Updates the "same option" related structures after the insertion of
  * the given ministep.
@@ -833,9 +1014,9 @@ void Chain::updateSameOptionPointersOnInsert(MiniStep * pNewMiniStep)
 {
 	MiniStep * pFirstMiniStep =
 		this->lfirstMiniStepPerOption[*pNewMiniStep->pOption()];
+	int position = this->position(pNewMiniStep);
 
-	if (!pFirstMiniStep ||
-		pFirstMiniStep->orderingKey() > pNewMiniStep->orderingKey())
+	if (!pFirstMiniStep || this->position(pFirstMiniStep) > position)
 	{
 		// The new ministep is the earliest for its option
 
@@ -854,8 +1035,7 @@ void Chain::updateSameOptionPointersOnInsert(MiniStep * pNewMiniStep)
 		MiniStep * pLeftMiniStep = pFirstMiniStep;
 
 		while (pLeftMiniStep->pNextWithSameOption() &&
-			pLeftMiniStep->pNextWithSameOption()->orderingKey() <
-				pNewMiniStep->orderingKey())
+			this->position(pLeftMiniStep->pNextWithSameOption()) < position)
 		{
 			pLeftMiniStep = pLeftMiniStep->pNextWithSameOption();
 		}
@@ -908,6 +1088,15 @@ void Chain::updateCCPs(MiniStep * pMiniStep)
 // Section: Accessors
 // ----------------------------------------------------------------------------
 
+/**
+ * Returns the observed data this chain refers to.
+ */
+Data * Chain::pData() const
+{
+	return this->lpData;
+}
+
+
 /**
  * Returns the period whose end observations are connected by this chain.
  */
@@ -1073,17 +1262,10 @@ MiniStep * Chain::randomDiagonalMiniStep() const
 MiniStep * Chain::randomMiniStep(MiniStep * pFirstMiniStep,
 	MiniStep * pLastMiniStep) const
 {
-	int length = this->intervalLength(pFirstMiniStep, pLastMiniStep);
-	int index = nextInt(length);
-	MiniStep * pMiniStep = pFirstMiniStep;
-
-	while (index > 0)
-	{
-		pMiniStep = pMiniStep->pNext();
-		index--;
-	}
+	int first = this->position(pFirstMiniStep);
+	int length = this->position(pLastMiniStep) - first + 1;
 
-	return pMiniStep;
+	return this->pMiniStepAt(first + nextInt(length));
 }
 
 
@@ -1121,21 +1303,68 @@ MiniStep * Chain::randomMissingBehaviorMiniStep() const
 // ----------------------------------------------------------------------------
 
 /**
- * Returns the length of the given interval of ministeps.
+ * Returns the position of the given ministep in this chain, where the
+ * dummy first ministep has position 0. Takes logarithmic time on average.
  */
-int Chain::intervalLength(const MiniStep * pFirstMiniStep,
-	const MiniStep * pLastMiniStep) const
+int Chain::position(const MiniStep * pMiniStep) const
 {
-	int length = 1;
-	const MiniStep * pMiniStep = pFirstMiniStep;
+	int position = treeSize(pMiniStep->lpTreeLeft);
 
-	while (pMiniStep != pLastMiniStep)
+	while (pMiniStep->lpTreeParent)
 	{
-		pMiniStep = pMiniStep->pNext();
-		length++;
+		const MiniStep * pParent = pMiniStep->lpTreeParent;
+
+		if (pParent->lpTreeRight == pMiniStep)
+		{
+			position += treeSize(pParent->lpTreeLeft) + 1;
+		}
+
+		pMiniStep = pParent;
 	}
 
-	return length;
+	return position;
+}
+
+
+/**
+ * Returns the ministep at the given position of this chain, where the
+ * dummy first ministep has position 0 and the dummy last ministep has
+ * position ministepCount().
+ */
+MiniStep * Chain::pMiniStepAt(int position) const
+{
+	MiniStep * pMiniStep = this->lpTreeRoot;
+
+	while (pMiniStep)
+	{
+		int leftSize = treeSize(pMiniStep->lpTreeLeft);
+
+		if (position < leftSize)
+		{
+			pMiniStep = pMiniStep->lpTreeLeft;
+		}
+		else if (position == leftSize)
+		{
+			break;
+		}
+		else
+		{
+			position -= leftSize + 1;
+			pMiniStep = pMiniStep->lpTreeRight;
+		}
+	}
+
+	return pMiniStep;
+}
+
+
+/**
+ * Returns the length of the given interval of ministeps.
+ */
+int Chain::intervalLength(const MiniStep * pFirstMiniStep,
+	const MiniStep * pLastMiniStep) const
+{
+	return this->position(pLastMiniStep) - this->position(pFirstMiniStep) + 1;
 }
 
 
@@ -1170,9 +1399,9 @@ MiniStep * Chain::nextMiniStepForOption(const Option & rOption,
 	const MiniStep * pFirstMiniStep) const
 {
 	MiniStep * pMiniStep = this->firstMiniStepForOption(rOption);
+	int first = this->position(pFirstMiniStep);
 
-	while (pMiniStep &&
-		pMiniStep->orderingKey() < pFirstMiniStep->orderingKey())
+	while (pMiniStep && this->position(pMiniStep) < first)
 	{
 		pMiniStep = pMiniStep->pNextWithSameOption();
 	}
@@ -1323,6 +1552,264 @@ Chain * Chain::copyChain() const
 	return pChain;
 	}
 
+// ----------------------------------------------------------------------------
+// Section: Binary format
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Identifies the binary format of a chain, including its version
+const char CHAIN_MAGIC[4] = {'S', 'C', 'H', '1'};
+
+// Flags of a ministep in the binary format
+const unsigned char NETWORK_FLAG = 1;
+const unsigned char DIAGONAL_FLAG = 2;
+
+template<class T>
+void writeColumn(ostream & rStream, const vector<T> & rValues)
+{
+	rStream.write(reinterpret_cast<const char *>(rValues.data()),
+		rValues.size() * sizeof(T));
+}
+
+template<class T>
+bool readColumn(istream & rStream, vector<T> & rValues, int32_t count)
+{
+	rValues.resize(count);
+	rStream.read(reinterpret_cast<char *>(rValues.data()),
+		rValues.size() * sizeof(T));
+	return !rStream.fail();
+}
+
+// Returns if a network ministep read from a stream refers to existing
+// actors. The alter of a diagonal ministep of a two-mode network is one
+// past the last receiver.
+bool validNetworkChange(const NetworkLongitudinalData * pData, int ego,
+	int alter)
+{
+	int m = pData->pReceivers()->n();
+	bool twoMode = pData->pSenders() != pData->pReceivers();
+
+	return ego >= 0 && ego < pData->pSenders()->n() &&
+		alter >= 0 && (alter < m || (alter == m && twoMode));
+}
+
+// Returns if a behavior ministep read from a stream refers to an existing
+// actor and changes the behavior by at most one step.
+bool validBehaviorChange(const BehaviorLongitudinalData * pData, int ego,
+	int difference)
+{
+	return ego >= 0 && ego < pData->n() &&
+		difference >= -1 && difference <= 1;
+}
+
+}
+
+/**
+ * Writes this chain to the given stream in a compact binary format. The
+ * ministeps of the chain, followed by the initial and end state
+ * differences, are stored column by column as arrays of numbers in the
+ * native byte order, so the format is meant for the same machine or for
+ * machines of the same architecture.
+ */
+void Chain::write(ostream & rStream) const
+{
+	vector<const MiniStep *> miniSteps;
+
+	for (const MiniStep * pMiniStep = this->lpFirst->pNext();
+		pMiniStep != this->lpLast;
+		pMiniStep = pMiniStep->pNext())
+	{
+		miniSteps.push_back(pMiniStep);
+	}
+
+	miniSteps.insert(miniSteps.end(),
+		this->linitialStateDifferences.begin(),
+		this->linitialStateDifferences.end());
+	miniSteps.insert(miniSteps.end(),
+		this->lendStateDifferences.begin(),
+		this->lendStateDifferences.end());
+
+	int32_t header[4] = {this->lperiod,
+		this->ministepCount() - 1,
+		(int32_t) this->linitialStateDifferences.size(),
+		(int32_t) this->lendStateDifferences.size()};
+	double moments[3] = {this->lmu, this->lsigma2, this->lfinalReciprocalRate};
+
+	rStream.write(CHAIN_MAGIC, sizeof(CHAIN_MAGIC));
+	rStream.write(reinterpret_cast<const char *>(header), sizeof(header));
+	rStream.write(reinterpret_cast<const char *>(moments), sizeof(moments));
+
+	int count = miniSteps.size();
+	vector<int32_t> variables(count);
+	vector<int32_t> egos(count);
+	vector<int32_t> values(count);
+	vector<unsigned char> flags(count);
+	vector<double> logOptionSetProbabilities(count);
+	vector<double> logChoiceProbabilities(count);
+	vector<double> reciprocalRates(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		const MiniStep * pMiniStep = miniSteps[i];
+		variables[i] = pMiniStep->variableId();
+		egos[i] = pMiniStep->ego();
+
+		if (pMiniStep->networkMiniStep())
+		{
+			values[i] =
+				dynamic_cast<const NetworkChange *>(pMiniStep)->alter();
+			flags[i] = NETWORK_FLAG;
+		}
+		else
+		{
+			values[i] =
+				dynamic_cast<const BehaviorChange *>(pMiniStep)->difference();
+			flags[i] = 0;
+		}
+
+		if (pMiniStep->diagonal())
+		{
+			flags[i] |= DIAGONAL_FLAG;
+		}
+
+		logOptionSetProbabilities[i] = pMiniStep->logOptionSetProbability();
+		logChoiceProbabilities[i] = pMiniStep->logChoiceProbability();
+		reciprocalRates[i] = pMiniStep->reciprocalRate();
+	}
+
+	writeColumn(rStream, variables);
+	writeColumn(rStream, egos);
+	writeColumn(rStream, values);
+	writeColumn(rStream, flags);
+	writeColumn(rStream, logOptionSetProbabilities);
+	writeColumn(rStream, logChoiceProbabilities);
+	writeColumn(rStream, reciprocalRates);
+}
+
+
+/**
+ * Reads a chain for the given data object written by Chain::write from
+ * the given stream. Returns 0 if the stream ends before the chain does, or
+ * if the period, a variable, an actor or a change of the chain does not
+ * exist for the data object.
+ */
+Chain * Chain::read(Data * pData, istream & rStream)
+{
+	char magic[sizeof(CHAIN_MAGIC)];
+	int32_t header[4];
+	double moments[3];
+
+	rStream.read(magic, sizeof(magic));
+	rStream.read(reinterpret_cast<char *>(header), sizeof(header));
+	rStream.read(reinterpret_cast<char *>(moments), sizeof(moments));
+
+	if (rStream.fail() ||
+		memcmp(magic, CHAIN_MAGIC, sizeof(CHAIN_MAGIC)) != 0 ||
+		header[0] < 0 || header[0] >= pData->observationCount() - 1 ||
+		header[1] < 0 || header[2] < 0 || header[3] < 0 ||
+		(int64_t) header[1] + header[2] + header[3] > INT32_MAX)
+	{
+		return 0;
+	}
+
+	int32_t count = header[1] + header[2] + header[3];
+	vector<int32_t> variables;
+	vector<int32_t> egos;
+	vector<int32_t> values;
+	vector<unsigned char> flags;
+	vector<double> logOptionSetProbabilities;
+	vector<double> logChoiceProbabilities;
+	vector<double> reciprocalRates;
+
+	if (!readColumn(rStream, variables, count) ||
+		!readColumn(rStream, egos, count) ||
+		!readColumn(rStream, values, count) ||
+		!readColumn(rStream, flags, count) ||
+		!readColumn(rStream, logOptionSetProbabilities, count) ||
+		!readColumn(rStream, logChoiceProbabilities, count) ||
+		!readColumn(rStream, reciprocalRates, count))
+	{
+		return 0;
+	}
+
+	const vector<LongitudinalData *> & rVariables =
+		pData->rDependentVariableData();
+	vector<MiniStep *> miniSteps(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		LongitudinalData * pVariableData = 0;
+
+		if (variables[i] >= 0 && variables[i] < (int) rVariables.size())
+		{
+			pVariableData = rVariables[variables[i]];
+		}
+
+		NetworkLongitudinalData * pNetworkData =
+			dynamic_cast<NetworkLongitudinalData *>(pVariableData);
+		BehaviorLongitudinalData * pBehaviorData =
+			dynamic_cast<BehaviorLongitudinalData *>(pVariableData);
+
+		if (flags[i] & ~(NETWORK_FLAG | DIAGONAL_FLAG))
+		{
+			pNetworkData = 0;
+			pBehaviorData = 0;
+		}
+
+		if ((flags[i] & NETWORK_FLAG) && pNetworkData &&
+			validNetworkChange(pNetworkData, egos[i], values[i]))
+		{
+			miniSteps[i] = new NetworkChange(pNetworkData,
+				egos[i],
+				values[i],
+				flags[i] & DIAGONAL_FLAG);
+		}
+		else if (!(flags[i] & NETWORK_FLAG) && pBehaviorData &&
+			validBehaviorChange(pBehaviorData, egos[i], values[i]))
+		{
+			miniSteps[i] = new BehaviorChange(pBehaviorData,
+				egos[i],
+				values[i]);
+		}
+		else
+		{
+			for (int j = 0; j < i; j++)
+			{
+				delete miniSteps[j];
+			}
+
+			return 0;
+		}
+
+		miniSteps[i]->logOptionSetProbability(logOptionSetProbabilities[i]);
+		miniSteps[i]->logChoiceProbability(logChoiceProbabilities[i]);
+		miniSteps[i]->reciprocalRate(reciprocalRates[i]);
+	}
+
+	Chain * pChain = new Chain(pData);
+	pChain->lperiod = header[0];
+
+	for (int i = 0; i < header[1]; i++)
+	{
+		pChain->insertBefore(miniSteps[i], pChain->lpLast);
+	}
+
+	pChain->linitialStateDifferences.assign(miniSteps.begin() + header[1],
+		miniSteps.begin() + header[1] + header[2]);
+	pChain->lendStateDifferences.assign(
+		miniSteps.begin() + header[1] + header[2],
+		miniSteps.end());
+
+	pChain->lmu = moments[0];
+	pChain->lsigma2 = moments[1];
+	pChain->lfinalReciprocalRate = moments[2];
+
+	return pChain;
+}
+
+
 //void Chain::dumpChain() const
 // see RSienaTest
 
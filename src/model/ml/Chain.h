@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <map>
+#include <iosfwd>
 #include "model/ml/Option.h"
 
 namespace siena
@@ -62,6 +63,7 @@ public:
 
 	// Accessors
 
+	Data * pData() const;
 	void period(int period);
 	int period() const;
 	MiniStep * pFirst() const;
@@ -81,6 +83,8 @@ public:
 
 	// Intervals
 
+	int position(const MiniStep * pMiniStep) const;
+	MiniStep * pMiniStepAt(int position) const;
 	int intervalLength(const MiniStep * pFirstMiniStep,
 		const MiniStep * pLastMiniStep) const;
 
@@ -107,10 +111,20 @@ public:
 
 	// Copy
 	Chain * copyChain() const;
+
+	// Binary format
+
+	void write(std::ostream & rStream) const;
+	static Chain * read(Data * pData, std::istream & rStream);
 //	void dumpChain() const;
 
 private:
-	void resetOrderingKeys();
+	void resetTree();
+	void insertInTree(MiniStep * pNewMiniStep, MiniStep * pExistingMiniStep);
+	void removeFromTree(MiniStep * pMiniStep);
+	void rotateUp(MiniStep * pMiniStep);
+	unsigned nextTreePriority();
+	static int treeSize(const MiniStep * pMiniStep);
 	void updateSameOptionPointersOnInsert(MiniStep * pMiniStep);
 	void updateCCPs(MiniStep * pMiniStep);
 
@@ -120,6 +134,18 @@ private:
 	// A dummy last ministep in the chain
 	MiniStep * lpLast;
 
+	// The root of a randomized balanced binary tree (treap) over all
+	// ministeps of the chain including the dummies, ordered by their
+	// position in the chain. Each node stores the size of its subtree,
+	// so positions and interval lengths take logarithmic time.
+
+	MiniStep * lpTreeRoot {};
+
+	// The state of the generator of tree priorities, which is private to
+	// the chain so that the random draws of the simulation are unaffected.
+
+	unsigned ltreePriorityState {};
+
 	// The underlying observed data
 	Data * lpData;
 
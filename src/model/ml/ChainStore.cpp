@@ -0,0 +1,396 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: ChainStore.cpp
+ *
+ * Description: This file contains the implementation of the
+ * ChainStore class.
+ *****************************************************************************/
+
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include "ChainStore.h"
+#include "Chain.h"
+#include "NetworkChange.h"
+
+using namespace std;
+
+namespace siena
+{
+
+namespace
+{
+
+// A rough estimate of the memory taken by a ministep of a chain in memory,
+// including its entries in the vectors and maps of the chain.
+const size_t BYTES_PER_MINISTEP = sizeof(NetworkChange) + 64;
+
+}
+
+// ----------------------------------------------------------------------------
+// Section: Constructors and destructor
+// ----------------------------------------------------------------------------
+
+/**
+ * Creates an empty store without a memory budget.
+ */
+ChainStore::ChainStore()
+{
+	this->lpSpillFile = 0;
+	this->lspilledCount = 0;
+	this->lbudget = 0;
+	this->lresidentBytes = 0;
+	this->lclock = 0;
+}
+
+
+/**
+ * Deletes the stored chains and the spill file.
+ */
+ChainStore::~ChainStore()
+{
+	for (unsigned period = 0; period < this->lchains.size(); period++)
+	{
+		this->clear(0, period);
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Periods and chains
+// ----------------------------------------------------------------------------
+
+/**
+ * Sets the number of periods from start. The stored chains of periods
+ * beyond the new number are deleted.
+ */
+void ChainStore::periods(int periods)
+{
+	for (int period = periods; period < this->periods(); period++)
+	{
+		this->clear(0, period);
+	}
+
+	this->lchains.resize(periods);
+}
+
+
+/**
+ * Returns the number of periods from start.
+ */
+int ChainStore::periods() const
+{
+	return this->lchains.size();
+}
+
+
+/**
+ * Returns the number of chains stored for the given period.
+ */
+int ChainStore::size(int period) const
+{
+	return this->lchains[period].size();
+}
+
+
+/**
+ * Adds the given chain to the chains of the given period. The store takes
+ * ownership of the chain, which must not be changed afterwards.
+ */
+void ChainStore::add(Chain * pChain, int period)
+{
+	StoredChain storedChain;
+	storedChain.pChain = pChain;
+	storedChain.pData = pChain->pData();
+	storedChain.offset = -1;
+	storedChain.length = 0;
+	storedChain.bytes = estimatedBytes(pChain);
+	storedChain.lastUse = ++this->lclock;
+
+	this->lchains[period].push_back(storedChain);
+	this->lresidentBytes += storedChain.bytes;
+	this->enforceBudget(0);
+}
+
+
+/**
+ * Returns the chain with the given index among the chains of the given
+ * period, reading it back from the spill file if necessary. The chain
+ * remains valid until the store is changed or another chain is requested.
+ */
+const Chain * ChainStore::pChain(int period, int index)
+{
+	StoredChain & rStoredChain = this->lchains[period][index];
+	rStoredChain.lastUse = ++this->lclock;
+
+	if (!rStoredChain.pChain)
+	{
+		this->load(rStoredChain);
+		this->enforceBudget(&rStoredChain);
+	}
+
+	return rStoredChain.pChain;
+}
+
+
+/**
+ * Removes the last chain of the given period from the store and returns
+ * it. The caller takes ownership of the chain.
+ */
+Chain * ChainStore::removeLast(int period)
+{
+	StoredChain & rStoredChain = this->lchains[period].back();
+
+	if (!rStoredChain.pChain)
+	{
+		this->load(rStoredChain);
+	}
+
+	Chain * pChain = rStoredChain.pChain;
+	this->lresidentBytes -= rStoredChain.bytes;
+	rStoredChain.pChain = 0;
+	this->release(rStoredChain);
+	this->lchains[period].pop_back();
+	this->enforceBudget(0);
+
+	return pChain;
+}
+
+
+/**
+ * Deletes all but the last keep chains of the given period, or all of
+ * them if keep is not positive.
+ */
+void ChainStore::clear(int keep, int period)
+{
+	vector<StoredChain> & rChains = this->lchains[period];
+	int count = rChains.size();
+
+	if (keep < 0)
+	{
+		keep = 0;
+	}
+	else if (keep > count)
+	{
+		keep = count;
+	}
+
+	for (int i = 0; i < count - keep; i++)
+	{
+		this->release(rChains[i]);
+	}
+
+	rChains.erase(rChains.begin(), rChains.begin() + count - keep);
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Memory budget
+// ----------------------------------------------------------------------------
+
+/**
+ * Sets the budget for the estimated memory taken by the chains in memory,
+ * in bytes. A budget of 0 means that all chains are kept in memory.
+ */
+void ChainStore::memoryBudget(size_t bytes)
+{
+	this->lbudget = bytes;
+	this->enforceBudget(0);
+}
+
+
+/**
+ * Returns the budget for the memory taken by the chains in memory.
+ */
+size_t ChainStore::memoryBudget() const
+{
+	return this->lbudget;
+}
+
+
+/**
+ * Returns the estimated memory taken by the chains in memory.
+ */
+size_t ChainStore::residentBytes() const
+{
+	return this->lresidentBytes;
+}
+
+
+/**
+ * Returns the number of stored chains that are not in memory.
+ */
+int ChainStore::spilledChainCount() const
+{
+	int count = 0;
+
+	for (unsigned period = 0; period < this->lchains.size(); period++)
+	{
+		for (unsigned i = 0; i < this->lchains[period].size(); i++)
+		{
+			if (!this->lchains[period][i].pChain)
+			{
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Private methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns an estimate of the memory taken by the given chain.
+ */
+size_t ChainStore::estimatedBytes(const Chain * pChain)
+{
+	return (pChain->ministepCount() +
+		pChain->rInitialStateDifferences().size() +
+		pChain->rEndStateDifferences().size()) * BYTES_PER_MINISTEP;
+}
+
+
+/**
+ * Deletes the given stored chain from memory and gives up its copy in the
+ * spill file. The spill file is discarded as soon as it holds no chains
+ * that are still stored.
+ */
+void ChainStore::release(StoredChain & rStoredChain)
+{
+	if (rStoredChain.pChain)
+	{
+		delete rStoredChain.pChain;
+		rStoredChain.pChain = 0;
+		this->lresidentBytes -= rStoredChain.bytes;
+	}
+
+	if (rStoredChain.offset >= 0)
+	{
+		rStoredChain.offset = -1;
+		this->lspilledCount--;
+
+		if (this->lspilledCount == 0)
+		{
+			fclose(this->lpSpillFile);
+			this->lpSpillFile = 0;
+		}
+	}
+}
+
+
+/**
+ * Reads the given stored chain back from the spill file.
+ */
+void ChainStore::load(StoredChain & rStoredChain)
+{
+	string bytes(rStoredChain.length, '\0');
+
+	if (fseek(this->lpSpillFile, rStoredChain.offset, SEEK_SET) != 0 ||
+		fread(&bytes[0], 1, bytes.size(), this->lpSpillFile) != bytes.size())
+	{
+		throw runtime_error("Cannot read a chain from the spill file");
+	}
+
+	istringstream stream(bytes);
+	rStoredChain.pChain = Chain::read(rStoredChain.pData, stream);
+
+	if (!rStoredChain.pChain)
+	{
+		throw runtime_error("Invalid chain in the spill file");
+	}
+
+	this->lresidentBytes += rStoredChain.bytes;
+}
+
+
+/**
+ * Removes the given stored chain from memory, writing it to the spill file
+ * first unless it is there already. Returns false, keeping the chain in
+ * memory, if the spill file cannot be written.
+ */
+bool ChainStore::spill(StoredChain & rStoredChain)
+{
+	if (rStoredChain.offset < 0)
+	{
+		if (!this->lpSpillFile)
+		{
+			this->lpSpillFile = tmpfile();
+
+			if (!this->lpSpillFile)
+			{
+				return false;
+			}
+		}
+
+		ostringstream stream;
+		rStoredChain.pChain->write(stream);
+		const string & bytes = stream.str();
+
+		if (fseek(this->lpSpillFile, 0, SEEK_END) != 0)
+		{
+			return false;
+		}
+
+		long offset = ftell(this->lpSpillFile);
+
+		if (offset < 0 ||
+			fwrite(bytes.data(), 1, bytes.size(), this->lpSpillFile) !=
+				bytes.size())
+		{
+			return false;
+		}
+
+		rStoredChain.offset = offset;
+		rStoredChain.length = bytes.size();
+		this->lspilledCount++;
+	}
+
+	delete rStoredChain.pChain;
+	rStoredChain.pChain = 0;
+	this->lresidentBytes -= rStoredChain.bytes;
+
+	return true;
+}
+
+
+/**
+ * Spills the least recently used chains until the chains in memory fit in
+ * the budget. The last chain of each period and the given chain are kept
+ * in memory.
+ */
+void ChainStore::enforceBudget(const StoredChain * pKeep)
+{
+	while (this->lbudget > 0 && this->lresidentBytes > this->lbudget)
+	{
+		StoredChain * pOldest = 0;
+
+		for (unsigned period = 0; period < this->lchains.size(); period++)
+		{
+			vector<StoredChain> & rChains = this->lchains[period];
+
+			for (int i = 0; i < (int) rChains.size() - 1; i++)
+			{
+				if (rChains[i].pChain &&
+					&rChains[i] != pKeep &&
+					(!pOldest || rChains[i].lastUse < pOldest->lastUse))
+				{
+					pOldest = &rChains[i];
+				}
+			}
+		}
+
+		if (!pOldest || !this->spill(*pOldest))
+		{
+			break;
+		}
+	}
+}
+
+}
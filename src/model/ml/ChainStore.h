@@ -0,0 +1,113 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: ChainStore.h
+ *
+ * Description: This file contains the definition of the ChainStore class.
+ *****************************************************************************/
+
+#ifndef CHAINSTORE_H_
+#define CHAINSTORE_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Forward declarations
+// ----------------------------------------------------------------------------
+
+class Chain;
+class Data;
+
+
+// ----------------------------------------------------------------------------
+// Section: Class definition
+// ----------------------------------------------------------------------------
+
+/**
+ * Stores the chains of a model for each period from start, in the order
+ * they were added.
+ *
+ * The store may be given a budget for the memory taken by its chains.
+ * When the budget is exceeded, the least recently used chains are written
+ * to a temporary file in the binary format of Chain::write and removed
+ * from memory; they are read back when they are requested again. The last
+ * chain of each period, which is the one the Metropolis-Hastings steps
+ * continue from, always stays in memory. Stored chains are never changed,
+ * so a chain that has been written once is not written again.
+ */
+class ChainStore
+{
+public:
+	ChainStore();
+	virtual ~ChainStore();
+
+	void periods(int periods);
+	int periods() const;
+	int size(int period) const;
+
+	void add(Chain * pChain, int period);
+	const Chain * pChain(int period, int index);
+	Chain * removeLast(int period);
+	void clear(int keep, int period);
+
+	void memoryBudget(std::size_t bytes);
+	std::size_t memoryBudget() const;
+	std::size_t residentBytes() const;
+	int spilledChainCount() const;
+
+private:
+	struct StoredChain
+	{
+		// The chain if it is in memory, otherwise 0
+		Chain * pChain;
+
+		// The data object of the chain, needed to read it back
+		Data * pData;
+
+		// The position and length of the chain in the spill file, or -1
+		// if it has not been written there
+		long offset;
+		long length;
+
+		// The estimated memory taken by the chain when it is in memory
+		std::size_t bytes;
+
+		// Tells when the chain was last added or requested
+		unsigned long lastUse;
+	};
+
+	static std::size_t estimatedBytes(const Chain * pChain);
+	void release(StoredChain & rStoredChain);
+	void load(StoredChain & rStoredChain);
+	bool spill(StoredChain & rStoredChain);
+	void enforceBudget(const StoredChain * pKeep);
+
+	// The stored chains per period from start
+	std::vector<std::vector<StoredChain> > lchains;
+
+	// The temporary file holding the spilled chains, if any
+	std::FILE * lpSpillFile;
+
+	// The number of stored chains with a copy in the spill file
+	int lspilledCount;
+
+	// The memory budget in bytes, where 0 means no budget
+	std::size_t lbudget;
+
+	// The estimated memory taken by the chains in memory
+	std::size_t lresidentBytes;
+
+	// Incremented whenever a chain is added or requested
+	unsigned long lclock;
+};
+
+}
+
+#endif /* CHAINSTORE_H_ */
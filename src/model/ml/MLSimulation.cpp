@@ -15,11 +15,13 @@
 #include <cmath>
 #include <R_ext/Error.h>
 #include <memory>
+#include <vector>
 #include "MLSimulation.h"
 
 #include <Rinternals.h>
 #include "utils/Random.h"
 #include "utils/Utils.h"
+#include "utils/Instrumentation.h"
 #include "network/Network.h"
 #include "network/TieIterator.h"
 #include "data/NetworkLongitudinalData.h"
@@ -44,6 +46,39 @@ namespace siena
 SEXP getMiniStepDF(const MiniStep& miniStep);
 SEXP getChainDF(const Chain& chain, bool sort=true);
 
+namespace
+{
+
+/**
+ * Returns the instrumentation counter for the given type of
+ * Metropolis-Hastings step, numbered as in MLStep, or -1 for the
+ * types not handled there.
+ */
+int stepTypeSlot(int stepType)
+{
+	static const char * const names[] = {"insertDiagonalMiniStep",
+		"cancelDiagonalMiniStep", "permute", "insertPermute",
+		"deletePermute", "insertMissing", "deleteMissing", "move"};
+	static vector<int> slots;
+
+	if (slots.empty())
+	{
+		for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+		{
+			slots.push_back(Instrumentation::slot(MHSTEP, names[i]));
+		}
+	}
+
+	if (stepType < 0 || stepType >= (int) slots.size())
+	{
+		return -1;
+	}
+
+	return slots[stepType];
+}
+
+}
+
 // ----------------------------------------------------------------------------
 // Section: Constructors and destructors
 // ----------------------------------------------------------------------------
@@ -321,7 +356,10 @@ void MLSimulation::setUpProbabilityArray()
  */
 void MLSimulation::MLStep()
 {
+	static const int slot = Instrumentation::slot(PHASE, "MLStep");
+	InstrumentationTimer timer(slot);
 	int stepType = nextIntWithProbabilities(NBRTYPES, this->lprobabilityArray);
+	InstrumentationTimer stepTimer(stepTypeSlot(stepType));
 	int c0 = this->lcurrentPermutationLength;
 //	Rf_PrintValue(getChainDF(*this->pChain()));
 	bool accept = false;
@@ -716,42 +754,44 @@ bool MLSimulation::move()
 
 	//// Position of ministepA
 
-	int piCount = 0;
-	MiniStep * pMiniStepC = pFirst;
-	while (pMiniStepC != pMiniStepA)
-	{
-		piCount++;
-		pMiniStepC = pMiniStepC->pNext();
-	}
-	int positionA = piCount;
+	int positionA = this->pChain()->position(pMiniStepA) -
+		this->pChain()->position(pFirst);
 
 	////CHOOSING MINISTEPB
 
-	// Replace raw arrays with std::vector for automatic memory management
-	std::vector<double> newReciprocalRate(intLength);
-	std::vector<double> newOptionSetProbability(intLength);
-	std::vector<double> newChoiceProbability(intLength);
-
-	std::vector<double> reciprocalRateA;
-	std::vector<double> optionSetProbabilityA;
-	std::vector<double> choiceProbabilityA;
+	// The work arrays keep their memory from one step to the next
+	std::vector<double> & newReciprocalRate = this->lnewReciprocalRates;
+	std::vector<double> & newOptionSetProbability =
+		this->lnewOptionSetProbabilities;
+	std::vector<double> & newChoiceProbability =
+		this->lnewChoiceProbabilities;
+	newReciprocalRate.assign(intLength, 0.0);
+	newOptionSetProbability.assign(intLength, 0.0);
+	newChoiceProbability.assign(intLength, 0.0);
+
+	std::vector<double> & reciprocalRateA = this->lreciprocalRatesA;
+	std::vector<double> & optionSetProbabilityA =
+		this->loptionSetProbabilitiesA;
+	std::vector<double> & choiceProbabilityA = this->lchoiceProbabilitiesA;
 
 	if (this->pModel()->localML())
 	{
-		reciprocalRateA.resize(intLength);
-		optionSetProbabilityA.resize(intLength);
-		choiceProbabilityA.resize(intLength);
+		reciprocalRateA.assign(intLength, 0.0);
+		optionSetProbabilityA.assign(intLength, 0.0);
+		choiceProbabilityA.assign(intLength, 0.0);
 	}
 
-	std::vector<bool> updateProb(intLength, false);
-	std::vector<double> pi(intLength, 0.0);
+	std::vector<bool> & updateProb = this->lupdateFlags;
+	std::vector<double> & pi = this->lmoveProbabilities;
+	updateProb.assign(intLength, false);
+	pi.assign(intLength, 0.0);
 
 	pi[0] = 1;
-	piCount = 0;
+	int piCount = 0;
 
 	// Use std::unique_ptr for automatic memory management of pMiniStepAReverse
 	std::unique_ptr<MiniStep> pMiniStepAReverse(pMiniStepA->createReverseMiniStep());
-	pMiniStepC = pFirst;
+	MiniStep * pMiniStepC = pFirst;
 
 	// CREATING VARIABLES, EGOS AND ALTERS FOR MiniSteps A AND C
 	DependentVariable * pVariableA = this->lvariables[pMiniStepA->variableId()];
@@ -1121,7 +1161,8 @@ bool MLSimulation::permute(int c0)
 		pMiniStepA = this->pChain()->randomMiniStep();
 	}
 
-	vector<MiniStep *> interval;
+	vector<MiniStep *> & interval = this->linterval;
+	interval.clear();
 	MiniStep * pMiniStep = pMiniStepA;
 
 	while ((int) interval.size() < c0 && pMiniStep != this->pChain()->pLast())
@@ -1147,9 +1188,12 @@ bool MLSimulation::permute(int c0)
 	double sumlprob_new = 0;
 	double mu_new = this->pChain()->mu();
 	double sigma2_new = this->pChain()->sigma2();
-	double * newReciprocalRate = new double[interval.size()];
-	double * newOptionSetProbability = new double[interval.size()];
-	double * newChoiceProbability = new double[interval.size()];
+	vector<double> & newReciprocalRate = this->lnewReciprocalRates;
+	newReciprocalRate.resize(interval.size());
+	vector<double> & newOptionSetProbability = this->lnewOptionSetProbabilities;
+	newOptionSetProbability.resize(interval.size());
+	vector<double> & newChoiceProbability = this->lnewChoiceProbabilities;
+	newChoiceProbability.resize(interval.size());
 
 	for (unsigned i = 0; i < interval.size() && valid; i++)
 	{
@@ -1241,10 +1285,6 @@ bool MLSimulation::permute(int c0)
 
 	this->recordOutcome(*interval[0], accept, PERMUTE, false);
 
-	delete[] newChoiceProbability;
-	delete[] newOptionSetProbability;
-	delete[] newReciprocalRate;
-
 	return accept;
 }
 
@@ -1353,7 +1393,8 @@ bool MLSimulation::insertPermute(int c0)
 		    this->pChain()->randomMiniStep(pMiniStepA->pNext(), pMiniStepD);
     }
 
-    vector<MiniStep *> interval;
+    vector<MiniStep *> & interval = this->linterval;
+    interval.clear();
     MiniStep * pMiniStep = pMiniStepA;
 
     bool validInterval = true;
@@ -1397,14 +1438,14 @@ bool MLSimulation::insertPermute(int c0)
     int egoInsert = 0;
     int alterInsert = 0;
     NetworkVariable * pNetworkVariableInsert = 0;
-    bool * N2vector = 0;
+    vector<bool> & N2vector = this->llocalFlags;
     bool N2 = true;
 
     if (this->pModel()->localML())
     {
         pNetworkVariableInsert =
 			dynamic_cast<NetworkVariable *>(pVariableInsert);
-        N2vector = new bool[interval.size()];
+        N2vector.assign(interval.size(), false);
         egoInsert = pLeftMiniStep->ego();
         if (pLeftMiniStep->networkMiniStep())
         {
@@ -1417,9 +1458,12 @@ bool MLSimulation::insertPermute(int c0)
     double sumlprob_new = 0;
     double mu_new = this->pChain()->mu();
     double sigma2_new = this->pChain()->sigma2();
-    double * newReciprocalRate = new double[interval.size()];
-    double * newOptionSetProbability = new double[interval.size()];
-    double * newChoiceProbability = new double[interval.size()];
+    vector<double> & newReciprocalRate = this->lnewReciprocalRates;
+    newReciprocalRate.resize(interval.size());
+    vector<double> & newOptionSetProbability = this->lnewOptionSetProbabilities;
+    newOptionSetProbability.resize(interval.size());
+    vector<double> & newChoiceProbability = this->lnewChoiceProbabilities;
+    newChoiceProbability.resize(interval.size());
 
     // We execute the new chain, do the necessary calculations, and
     // simultaneously check if the new chain is valid.
@@ -1701,13 +1745,6 @@ bool MLSimulation::insertPermute(int c0)
     {
 		delete pLeftMiniStep;
     }
-    delete[] newChoiceProbability;
-    delete[] newOptionSetProbability;
-    delete[] newReciprocalRate;
-    if (this->pModel()->localML())
-    {
-        delete[] N2vector;
-    }
     return accept;
 }
 
@@ -1768,7 +1805,8 @@ bool MLSimulation::deletePermute(int c0)
     }
 
     // Create the permuted interval of ministeps
-    vector<MiniStep *> interval;
+    vector<MiniStep *> & interval = this->linterval;
+    interval.clear();
     MiniStep * pMiniStep = pMiniStepA->pNext();
 
     bool validInterval = true;
@@ -1817,9 +1855,12 @@ bool MLSimulation::deletePermute(int c0)
     double rr = pMiniStepA->reciprocalRate();
     double mu_new = this->pChain()->mu() - rr;
     double sigma2_new = this->pChain()->sigma2() - rr * rr;
-    double * newReciprocalRate = new double[interval.size()];
-    double * newOptionSetProbability = new double[interval.size()];
-    double * newChoiceProbability = new double[interval.size()];
+    vector<double> & newReciprocalRate = this->lnewReciprocalRates;
+    newReciprocalRate.resize(interval.size());
+    vector<double> & newOptionSetProbability = this->lnewOptionSetProbabilities;
+    newOptionSetProbability.resize(interval.size());
+    vector<double> & newChoiceProbability = this->lnewChoiceProbabilities;
+    newChoiceProbability.resize(interval.size());
 
     if (!missdat)
     {
@@ -1846,7 +1887,7 @@ bool MLSimulation::deletePermute(int c0)
 
     int egoDelete = 0;
     int alterDelete = 0;
-    bool * N2vector = 0;
+    vector<bool> & N2vector = this->llocalFlags;
     bool N2 = true;
     DependentVariable * pVariableDelete = 0;
     NetworkVariable * pNetworkVariableDelete = 0;
@@ -1858,7 +1899,7 @@ bool MLSimulation::deletePermute(int c0)
         {
             alterDelete = dynamic_cast<NetworkChange *>(pMiniStepA)->alter();
         }
-        N2vector = new bool[interval.size()];
+        N2vector.assign(interval.size(), false);
         pVariableDelete = this->lvariables[pMiniStepA->variableId()];
         pNetworkVariableDelete =
 			dynamic_cast<NetworkVariable *>(pVariableDelete);
@@ -2118,14 +2159,6 @@ bool MLSimulation::deletePermute(int c0)
 		}
     }
 
-    if (this->pModel()->localML())
-    {
-        delete[] N2vector;
-    }
-    delete[] newChoiceProbability;
-    delete[] newOptionSetProbability;
-    delete[] newReciprocalRate;
-
     return accept;
 }
 
@@ -2300,9 +2333,12 @@ bool MLSimulation::insertMissing()
 	int size =
 		this->pChain()->intervalLength(this->pChain()->pFirst()->pNext(),
 			pMiniStepA) - 1;
-	double * newReciprocalRate = new double[size];
-	double * newOptionSetProbability = new double[size];
-	double * newChoiceProbability = new double[size];
+	vector<double> & newReciprocalRate = this->lnewReciprocalRates;
+	newReciprocalRate.resize(size);
+	vector<double> & newOptionSetProbability = this->lnewOptionSetProbabilities;
+	newOptionSetProbability.resize(size);
+	vector<double> & newChoiceProbability = this->lnewChoiceProbabilities;
+	newChoiceProbability.resize(size);
 
 	int i = 0;
 
@@ -2434,9 +2470,6 @@ bool MLSimulation::insertMissing()
 		delete pNewMiniStep;
 	}
 
-	delete[] newReciprocalRate;
-	delete[] newOptionSetProbability;
-	delete[] newChoiceProbability;
 	delete pDummyMiniStep;
 
 	return accept;
@@ -2614,9 +2647,12 @@ bool MLSimulation::deleteMissing()
 	int size =
 		this->pChain()->intervalLength(this->pChain()->pFirst()->pNext(),
 			pMiniStepA) - 1;
-	double * newReciprocalRate = new double[size];
-	double * newOptionSetProbability = new double[size];
-	double * newChoiceProbability = new double[size];
+	vector<double> & newReciprocalRate = this->lnewReciprocalRates;
+	newReciprocalRate.resize(size);
+	vector<double> & newOptionSetProbability = this->lnewOptionSetProbabilities;
+	newOptionSetProbability.resize(size);
+	vector<double> & newChoiceProbability = this->lnewChoiceProbabilities;
+	newChoiceProbability.resize(size);
 
 	int i = 0;
 
@@ -2723,10 +2759,6 @@ bool MLSimulation::deleteMissing()
 		delete pMiniStepA;
 	}
 
-	delete[] newChoiceProbability;
-	delete[] newOptionSetProbability;
-	delete[] newReciprocalRate;
-
 	return accept;
 }
 
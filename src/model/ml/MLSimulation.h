@@ -132,6 +132,23 @@ private:
 
 	// A vector of options with missing values in the initial observation
 	std::vector<const Option *> linitialMissingOptions{};
+
+	// Work arrays of the Metropolis-Hastings steps, kept as members so
+	// that their memory is reused by the following steps: the interval
+	// of ministeps of a permutation, the proposed reciprocal rates, log
+	// option set and log choice probabilities of the ministeps, the same
+	// for the moved ministep at each position, the probabilities of these
+	// positions, and flags per ministep.
+	std::vector<MiniStep *> linterval;
+	std::vector<double> lnewReciprocalRates;
+	std::vector<double> lnewOptionSetProbabilities;
+	std::vector<double> lnewChoiceProbabilities;
+	std::vector<double> lreciprocalRatesA;
+	std::vector<double> loptionSetProbabilitiesA;
+	std::vector<double> lchoiceProbabilitiesA;
+	std::vector<double> lmoveProbabilities;
+	std::vector<bool> lupdateFlags;
+	std::vector<bool> llocalFlags;
 };
 
 }
@@ -41,7 +41,11 @@ MiniStep::MiniStep(LongitudinalData * pData, int ego)
 	this->ldiagonalIndex = -1;
 	this->lconsecutiveCancelingPairIndex = -1;
 	this->lmissingIndex = -1;
-	this->lorderingKey = 0;
+	this->lpTreeParent = 0;
+	this->lpTreeLeft = 0;
+	this->lpTreeRight = 0;
+	this->ltreeSize = 0;
+	this->ltreePriority = 0;
 	this->ldiagonal = false;
 	this->lpChangeContributions = 0;
 }
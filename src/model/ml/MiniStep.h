@@ -88,9 +88,6 @@ public:
 	inline int missingIndex() const;
 	inline void missingIndex(int index);
 
-	inline double orderingKey() const;
-	inline void orderingKey(double key);
-
 	virtual void makeChange(DependentVariable * pVariable);
     bool diagonal() const;
 	virtual bool missing(int period) const;
@@ -172,11 +169,20 @@ private:
 
 	int lmissingIndex {};
 
-	// An arbitrary double value that corresponds with the chain order,
-	// i.e. x.lorderingKey < y.lorderingKey whenever x and y is part
-	// of the same chain and x precedes y in the chain.
+	// The parent and children of this ministep in the order statistic
+	// tree of the owner chain. An in-order traversal of the tree visits
+	// the ministeps in chain order.
+
+	MiniStep * lpTreeParent {};
+	MiniStep * lpTreeLeft {};
+	MiniStep * lpTreeRight {};
 
-	double lorderingKey {};
+	// The number of ministeps in the subtree rooted at this ministep
+	int ltreeSize {};
+
+	// The heap priority of this ministep in the tree, not less than the
+	// priorities of its children
+	unsigned ltreePriority {};
 
 	// Stores for each effect its contributions to the tie flip probabilities or behavior change probabilities
 	std::map<const EffectInfo *, std::vector<double> > * lpChangeContributions;
@@ -358,23 +364,6 @@ void MiniStep::missingIndex(int index)
 	this->lmissingIndex = index;
 }
 
-/**
- * Returns the ordering key of this ministep.
- */
-double MiniStep::orderingKey() const
-{
-	return this->lorderingKey;
-}
-
-
-/**
- * Stores the ordering key of this ministep.
- */
-void MiniStep::orderingKey(double key)
-{
-	this->lorderingKey = key;
-}
-
 }
 
 #endif /* MINISTEP_H_ */
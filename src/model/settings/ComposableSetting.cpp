@@ -39,10 +39,10 @@ void ComposableSetting::terminateSetting(Network* const lpNetwork) {
 	lpsecondSetting->terminateSetting(lpNetwork);
 }
 
-void ComposableSetting::initDyadicSetting(const std::map<int, double>& row,
-		int ego) {
-	lpfirstSetting->initDyadicSetting(row, ego);
-	lpsecondSetting->initDyadicSetting(row, ego);
+void ComposableSetting::initDyadicSetting(const int* const pRow,
+		int rowSize, int ego) {
+	lpfirstSetting->initDyadicSetting(pRow, rowSize, ego);
+	lpsecondSetting->initDyadicSetting(pRow, rowSize, ego);
 }
 
 void ComposableSetting::initPermittedSteps(const bool* const permitted) {
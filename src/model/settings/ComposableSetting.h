@@ -22,7 +22,7 @@ public:
 
 	void terminateSetting(Network* const lpNetwork);
 
-	void initDyadicSetting(const std::map<int, double>& row, int ego);
+	void initDyadicSetting(const int* const pRow, int rowSize, int ego);
 
 	void initPermittedSteps(const bool* const permitted);
 
@@ -5,12 +5,14 @@
  *      Author: ortmann
  */
 
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 #include "DyadicSetting.h"
 
 #include "../../network/iterators/UnionTieIterator.h"
 #include "../../network/iterators/SingleIterator.h"
-#include "../../network/iterators/IntDoubleMapIterator.h"
+#include "../../network/iterators/IntVecIterator.h"
 
 
 using namespace std;
@@ -48,15 +50,16 @@ ITieIterator* DyadicSetting::getSteps() {
 	return lpiter->clone();
 }
 
-void DyadicSetting::initDyadicSetting(const std::map<int, double>& row,
+void DyadicSetting::initDyadicSetting(const int* const pRow, int rowSize,
 		int ego) {
 	if (lpiter == 0) {
-	if (row.find(ego) == row.end()) {
-			IntDoubleMapIterator iter1(row.begin(), row.end());
+	const vector<int> row(pRow, pRow + rowSize);
+	if (!binary_search(row.begin(), row.end(), ego)) {
+			IntVecIterator iter1(row.begin(), row.end());
 			SingleIterator iter2(ego);
 			lpiter = new UnionTieIterator(iter1, iter2);
 	} else {
-		lpiter = new IntDoubleMapIterator(row.begin(), row.end());
+		lpiter = new IntVecIterator(row.begin(), row.end());
 	}
 	} else {
 	throw runtime_error("setting has not been terminated or is used in different contexts");
@@ -34,7 +34,7 @@ public:
 
 	ITieIterator* getSteps();
 
-	void initDyadicSetting(const std::map<int, double>& row, int ego);
+	void initDyadicSetting(const int* const pRow, int rowSize, int ego);
 
 protected:
 
@@ -44,8 +44,6 @@ protected:
 
 private:
 
-	void createSteps(const std::map<int, double>& row);
-
 	ITieIterator* lpiter;
 
 };
@@ -38,9 +38,9 @@ void MeetingSetting::terminateSetting(Network* const lpNetwork) {
 	lpSetting->terminateSetting(lpNetwork);
 }
 
-void MeetingSetting::initDyadicSetting(const std::map<int, double>& row,
-		int ego) {
-	lpSetting->initDyadicSetting(row, ego);
+void MeetingSetting::initDyadicSetting(const int* const pRow,
+		int rowSize, int ego) {
+	lpSetting->initDyadicSetting(pRow, rowSize, ego);
 }
 
 void MeetingSetting::initPermittedSteps(const bool* const permitted) {
@@ -8,8 +8,6 @@
 #ifndef SETTING_H_
 #define SETTING_H_
 
-#include <map>
-
 namespace siena {
 
 class ITieIterator;
@@ -51,7 +49,15 @@ public:
 
 	void terminateSetting(int ego);
 
-	virtual void initDyadicSetting(const std::map<int, double>& /*row*/, int /*ego*/) {
+	/**
+	 * Initializes a setting defined by the non-zero values of a row of
+	 * a dyadic covariate.
+	 * @param[in] pRow the increasing alters with non-zero values
+	 * @param[in] rowSize the number of alters in pRow
+	 * @param[in] ego the ego whose row is given
+	 */
+	virtual void initDyadicSetting(const int* const /*pRow*/,
+			int /*rowSize*/, int /*ego*/) {
 	}
 
 	virtual void initPermittedSteps(const bool* const permitted) = 0;
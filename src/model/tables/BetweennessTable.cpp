@@ -33,6 +33,15 @@ BetweennessTable::BetweennessTable(NetworkCache * pOwner) :
 // Section: ConfigurationTable implementation
 // ----------------------------------------------------------------------------
 
+/**
+ * Returns the name of this table.
+ */
+std::string BetweennessTable::name() const
+{
+	return "Betweenness";
+}
+
+
 /**
  * Calculates the betweenness counts for all actors.
  */
@@ -46,23 +55,17 @@ void BetweennessTable::calculate()
 	const Network * pNetwork = this->pNetwork();
 	int n = pNetwork->n();
 
-	// Helper array
-	int * mark = new int[n];
-
-	for (int i = 0; i < n; i++)
-	{
-		mark[i] = -1;
-	}
-
 	for (int i = 0; i < n; i++)
 	{
 		// Mark the out-neighbors of actor i
 
+		this->lmarks.reset(n);
+
 		for (IncidentTieIterator iter = pNetwork->outTies(i);
 			iter.valid();
 			iter.next())
 		{
-			mark[iter.actor()] = i;
+			this->lmarks.mark(iter.actor());
 		}
 
 		// Consider each two-path starting at i
@@ -79,18 +82,16 @@ void BetweennessTable::calculate()
 			{
 				int h = iterJ.actor();
 
-				if (i != h && mark[h] != i)
+				if (i != h && !this->lmarks.marked(h))
 				{
 					// We have found a two-path i -> j -> h with no tie
 					// from i to h, so we increase the betweenness of j.
 
-					this->ltable[j]++;
+					this->increment(j);
 				}
 			}
 		}
 	}
-
-	delete[] mark;
 }
 
 }
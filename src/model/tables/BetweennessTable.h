@@ -13,6 +13,7 @@
 
 #include "ConfigurationTable.h"
 #include "network/NetworkUtils.h"
+#include "utils/MarkArray.h"
 
 namespace siena
 {
@@ -27,8 +28,15 @@ class BetweennessTable : public ConfigurationTable
 public:
 	BetweennessTable(NetworkCache * pOwner);
 
+	virtual std::string name() const;
+
 protected:
 	virtual void calculate();
+
+private:
+	// Marks the out-neighbors of the current actor, reused across
+	// calculations
+	MarkArray lmarks;
 };
 
 }
@@ -76,7 +76,7 @@ TwoNetworkCache * Cache::pTwoNetworkCache(const Network * pFirstNetwork,
 
 	if (iter != this->ltwoNetworkCaches.end())
 	{
-		map <const Network *, TwoNetworkCache *> cacheMap = iter->second;
+		map <const Network *, TwoNetworkCache *> & cacheMap = iter->second;
 		map <const Network *, TwoNetworkCache *>::iterator iter2 =
 			cacheMap.find(pSecondNetwork);
 		if (iter2 != cacheMap.end())
@@ -114,7 +114,7 @@ void Cache::initialize(int ego)
 		 iter != this->ltwoNetworkCaches.end();
 		 iter++)
 	{
-		map<const Network *, TwoNetworkCache *> cacheMap = iter->second;
+		map<const Network *, TwoNetworkCache *> & cacheMap = iter->second;
 		for (map<const Network *, TwoNetworkCache *>::iterator iter2 =
 				 cacheMap.begin();
 			 iter2 != cacheMap.end();
@@ -126,4 +126,16 @@ void Cache::initialize(int ego)
 	}
 }
 
+
+/**
+ * Returns an array of marks shared by all users of this cache. It may only
+ * be used within a single calculation, starting with MarkArray::reset,
+ * as the next user may reset it. Effects keeping marks between calls must
+ * have their own array.
+ */
+MarkArray * Cache::pMarkArray()
+{
+	return &this->lmarks;
+}
+
 }
@@ -12,6 +12,7 @@
 #define CACHE_H_
 
 #include <map>
+#include "utils/MarkArray.h"
 
 namespace siena
 {
@@ -41,12 +42,16 @@ public:
 	TwoNetworkCache * pTwoNetworkCache(const Network * pFirstNetwork,
 		const Network * pSecondNetwork);
 	void initialize(int ego);
+	MarkArray * pMarkArray();
 
 private:
 	std::map<const Network *, NetworkCache *> lnetworkCaches;
 	std::map<const Network *, std::map<const Network *, TwoNetworkCache *> >
 		ltwoNetworkCaches;
 	int lego {};
+
+	// Scratch marks shared by the effects and tables using this cache
+	MarkArray lmarks;
 };
 
 }
@@ -9,9 +9,11 @@
  * class.
  *****************************************************************************/
 
+#include <algorithm>
 #include "ConfigurationTable.h"
 #include "network/Network.h"
 #include "model/tables/NetworkCache.h"
+#include "utils/Instrumentation.h"
 
 namespace siena
 {
@@ -27,7 +29,7 @@ ConfigurationTable::ConfigurationTable(NetworkCache * pOwner)
 {
 	this->lpOwner = pOwner;
 	this->lpNetwork = pOwner->pNetwork();
-	this->ltable = new int[this->lpNetwork->n()];
+	this->ltable = new int[this->lpNetwork->n()]();
 
 	// This will make sure that the table is calculated on the first
 	// call to the get(...) method, as the network modification count
@@ -56,15 +58,20 @@ ConfigurationTable::~ConfigurationTable()
  */
 int ConfigurationTable::get(int i)
 {
-	// If the network has changed, recalculate the table
+	this->update();
+	return this->ltable[i];
+}
 
-	if (this->lpNetwork->modificationCount() != this->llastModificationCount)
-	{
-		this->calculate();
-		this->llastModificationCount = this->lpNetwork->modificationCount();
-	}
 
-	return this->ltable[i];
+/**
+ * Returns the actors with a non-zero number of configurations in ascending
+ * order, so that a sum over them adds its terms in the same order as a sum
+ * over all actors. The vector is valid until the table is recalculated.
+ */
+const std::vector<int> & ConfigurationTable::nonZeroActors()
+{
+	this->update();
+	return this->sortedNonZeroActors();
 }
 
 
@@ -95,13 +102,67 @@ const Network * ConfigurationTable::pNetwork() const
 // ----------------------------------------------------------------------------
 
 /**
- * Resets the internal array to zeroes.
+ * Resets the internal array to zeroes. Only the entries of the actors
+ * in lnonZeroActors are cleared, as all other entries are zero already.
  */
 void ConfigurationTable::reset()
 {
-	for (int i = 0; i < this->lpNetwork->n(); i++)
+	for (unsigned k = 0; k < this->lnonZeroActors.size(); k++)
+	{
+		this->ltable[this->lnonZeroActors[k]] = 0;
+	}
+
+	this->lnonZeroActors.clear();
+	this->lnonZeroActorsSorted = false;
+}
+
+
+/**
+ * Sorts the actors with non-zero entries unless this has been done since
+ * the last reset, and returns them.
+ */
+const std::vector<int> & ConfigurationTable::sortedNonZeroActors()
+{
+	if (!this->lnonZeroActorsSorted)
+	{
+		std::sort(this->lnonZeroActors.begin(), this->lnonZeroActors.end());
+		this->lnonZeroActorsSorted = true;
+	}
+
+	return this->lnonZeroActors;
+}
+
+
+/**
+ * Returns the instrumentation counter for the calculations of this table.
+ */
+int ConfigurationTable::instrumentationSlot()
+{
+	if (this->linstrumentationSlot < 0)
+	{
+		this->linstrumentationSlot =
+			Instrumentation::slot(TABLE, this->name());
+	}
+
+	return this->linstrumentationSlot;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Private methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Recalculates the table if the network has changed since the last
+ * calculation.
+ */
+void ConfigurationTable::update()
+{
+	if (this->lpNetwork->modificationCount() != this->llastModificationCount)
 	{
-		this->ltable[i] = 0;
+		InstrumentationTimer timer(this->instrumentationSlot());
+		this->calculate();
+		this->llastModificationCount = this->lpNetwork->modificationCount();
 	}
 }
 
@@ -11,6 +11,9 @@
 #ifndef CONFIGURATIONTABLE_H_
 #define CONFIGURATIONTABLE_H_
 
+#include <string>
+#include <vector>
+
 namespace siena
 {
 
@@ -47,6 +50,13 @@ public:
 	virtual ~ConfigurationTable();
 
 	virtual int get(int i);
+	virtual const std::vector<int> & nonZeroActors();
+
+	/**
+	 * Returns the name of the configuration type for the instrumentation
+	 * of the table calculations.
+	 */
+	virtual std::string name() const = 0;
 
 protected:
 	NetworkCache * pOwner() const;
@@ -60,11 +70,24 @@ protected:
 	virtual void calculate() = 0;
 
 	void reset();
+	inline void increment(int i);
+	const std::vector<int> & sortedNonZeroActors();
+	int instrumentationSlot();
 
-	// The internal storage
+	// The internal storage. Derived classes change it only by the method
+	// increment, so that every non-zero entry is listed in lnonZeroActors.
 	int * ltable;
 
+	// The actors with non-zero entries in ltable, in the order in which
+	// their entries were first incremented until they are sorted
+	std::vector<int> lnonZeroActors;
+
+	// Indicates if lnonZeroActors has been sorted since the last reset
+	bool lnonZeroActorsSorted {};
+
 private:
+	void update();
+
 	// The network cache owning this configuration table
 	NetworkCache * lpOwner;
 
@@ -75,8 +98,29 @@ private:
 	// was calculated.
 
 	int llastModificationCount;
+
+	// The instrumentation counter of the calculations of this table, or -1
+	// if not looked up yet
+	int linstrumentationSlot {-1};
 };
 
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Increments the entry of the given actor, remembering the actor if the
+ * entry was zero before.
+ */
+void ConfigurationTable::increment(int i)
+{
+	if (this->ltable[i]++ == 0)
+	{
+		this->lnonZeroActors.push_back(i);
+	}
+}
+
 }
 
 #endif /*CONFIGURATIONTABLE_H_*/
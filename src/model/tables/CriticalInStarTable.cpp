@@ -35,6 +35,15 @@ CriticalInStarTable::CriticalInStarTable(NetworkCache * pOwner) :
 // Section: ConfigurationTable implementation
 // ----------------------------------------------------------------------------
 
+/**
+ * Returns the name of this table.
+ */
+std::string CriticalInStarTable::name() const
+{
+	return "CriticalInStar";
+}
+
+
 /**
  * Calculates the number of critical in-stars between the ego and all
  * other actors.
@@ -71,7 +80,7 @@ void CriticalInStarTable::calculate()
 				iter1.valid();
 				iter1.next())
 			{
-				this->ltable[iter1.actor()]++;
+				this->increment(iter1.actor());
 			}
 		}
 		else if (pTwoPathTable->get(h) == 1)
@@ -96,7 +105,7 @@ void CriticalInStarTable::calculate()
 
 				if (this->pOwner()->outTieExists(j))
 				{
-					this->ltable[j]++;
+					this->increment(j);
 					found = true;
 				}
 			}
@@ -27,6 +27,8 @@ class CriticalInStarTable : public EgocentricConfigurationTable
 public:
 	CriticalInStarTable(NetworkCache * pOwner);
 
+	virtual std::string name() const;
+
 protected:
 	virtual void calculate();
 };
@@ -1,4 +1,5 @@
 #include "EgocentricConfigurationTable.h"
+#include "utils/Instrumentation.h"
 
 namespace siena
 {
@@ -36,16 +37,22 @@ void EgocentricConfigurationTable::initialize(int ego)
  */
 int EgocentricConfigurationTable::get(int i)
 {
-	if (!this->lupdated)
-	{
-		this->calculate();
-		this->lupdated = true;
-	}
-
+	this->update();
 	return this->ltable[i];
 }
 
 
+/**
+ * Returns the actors with a non-zero number of configurations for the
+ * current ego, in ascending order.
+ */
+const std::vector<int> & EgocentricConfigurationTable::nonZeroActors()
+{
+	this->update();
+	return this->sortedNonZeroActors();
+}
+
+
 /**
  * Returns the current ego of this configuration table.
  */
@@ -54,4 +61,19 @@ int EgocentricConfigurationTable::ego() const
 	return this->lego;
 }
 
+
+/**
+ * Calculates the table for the current ego unless this has been done
+ * already.
+ */
+void EgocentricConfigurationTable::update()
+{
+	if (!this->lupdated)
+	{
+		InstrumentationTimer timer(this->instrumentationSlot());
+		this->calculate();
+		this->lupdated = true;
+	}
+}
+
 }
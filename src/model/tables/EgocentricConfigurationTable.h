@@ -28,11 +28,14 @@ public:
 
 	void initialize(int ego);
 	virtual int get(int i);
+	virtual const std::vector<int> & nonZeroActors();
 
 protected:
 	int ego() const;
 
 private:
+	void update();
+
 	// Indicates the ego this table has been calculated for
 	int lego {};
 
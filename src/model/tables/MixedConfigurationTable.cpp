@@ -12,6 +12,7 @@
 #include "MixedConfigurationTable.h"
 #include "network/Network.h"
 #include "model/tables/TwoNetworkCache.h"
+#include "utils/Instrumentation.h"
 
 namespace siena
 {
@@ -36,14 +37,14 @@ MixedConfigurationTable::MixedConfigurationTable(TwoNetworkCache * pOwner)
 		std::max(std::max(this->lpFirstNetwork->n(), this->lpFirstNetwork->m()),
 			std::max(this->lpSecondNetwork->n(), this->lpSecondNetwork->m()));
 
-	this->ltable = new int[this->ltableSize];
+	this->ltable = new int[this->ltableSize]();
+	this->lnonZeroPositions.assign(this->ltableSize, -1);
 
-	// This will make sure that the table is calculated on the first
-	// call to the get(...) method, as the network modification count
-	// starts with 0.
+	// Listen to the changes of both networks. The table is calculated on
+	// the first call to the get(...) method.
 
-	this->llastFirstModificationCount = -1;
-	this->llastSecondModificationCount = -1;
+	this->lvalid = false;
+	this->attach();
 }
 
 
@@ -52,6 +53,16 @@ MixedConfigurationTable::MixedConfigurationTable(TwoNetworkCache * pOwner)
  */
 MixedConfigurationTable::~MixedConfigurationTable()
 {
+	if (this->lfirstNetworkAttached)
+	{
+		this->lpFirstNetwork->removeNetworkChangeListener(this);
+	}
+
+	if (this->lsecondNetworkAttached)
+	{
+		this->lpSecondNetwork->removeNetworkChangeListener(this);
+	}
+
 	delete[] this->ltable;
 	this->ltable = 0;
 }
@@ -66,21 +77,88 @@ MixedConfigurationTable::~MixedConfigurationTable()
  */
 int MixedConfigurationTable::get(int i)
 {
-	// If the network has changed, recalculate the table
+	this->update();
+	return this->ltable[i];
+}
+
+
+/**
+ * Returns the actors with a non-zero number of configurations, in no
+ * particular order. The vector is valid until the table is recalculated
+ * or updated.
+ */
+const std::vector<int> & MixedConfigurationTable::nonZeroActors()
+{
+	this->update();
+	return this->lnonZeroActors;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: INetworkChangeListener interface
+// ----------------------------------------------------------------------------
+
+/**
+ * Invoked when the table starts listening to the given network, or when
+ * the network is assigned the contents of another network.
+ */
+void MixedConfigurationTable::onInitializationEvent(const Network & rNetwork)
+{
+	this->invalidate();
+}
+
+
+/**
+ * Invoked when a tie is introduced in one of the networks.
+ */
+void MixedConfigurationTable::onTieIntroductionEvent(const Network & rNetwork,
+	const int ego,
+	const int alter)
+{
+	this->onTieChange(rNetwork, ego, alter, 1);
+}
+
 
-	if ((this->lpFirstNetwork->modificationCount() !=
-		this->llastFirstModificationCount) ||
-		(this->lpSecondNetwork->modificationCount() !=
-			this->llastSecondModificationCount))
+/**
+ * Invoked when a tie is withdrawn from one of the networks.
+ */
+void MixedConfigurationTable::onTieWithdrawalEvent(const Network & rNetwork,
+	const int ego,
+	const int alter)
+{
+	this->onTieChange(rNetwork, ego, alter, -1);
+}
+
+
+/**
+ * Invoked when all ties of one of the networks are removed.
+ */
+void MixedConfigurationTable::onNetworkClearEvent(const Network & rNetwork)
+{
+	this->invalidate();
+}
+
+
+/**
+ * Invoked when one of the networks is destroyed or assigned the contents
+ * of another network. The table stops listening to the network, so that
+ * it does not refer to a destroyed network.
+ */
+void MixedConfigurationTable::onNetworkDisposeEvent(const Network & rNetwork)
+{
+	rNetwork.removeNetworkChangeListener(this);
+
+	if (&rNetwork == this->lpFirstNetwork)
 	{
-		this->calculate();
-		this->llastFirstModificationCount =
-			this->lpFirstNetwork->modificationCount();
-		this->llastSecondModificationCount =
-			this->lpSecondNetwork->modificationCount();
+		this->lfirstNetworkAttached = false;
 	}
 
-	return this->ltable[i];
+	if (&rNetwork == this->lpSecondNetwork)
+	{
+		this->lsecondNetworkAttached = false;
+	}
+
+	this->invalidate();
 }
 
 
@@ -119,13 +197,145 @@ const Network * MixedConfigurationTable::pSecondNetwork() const
 // ----------------------------------------------------------------------------
 
 /**
- * Resets the internal array to zeroes.
+ * Updates the table for the given change of the tie from ego to alter in
+ * the given network, which has already been applied to the network.
+ * Returns false if the table cannot be updated incrementally, in which
+ * case it is recalculated when accessed next. The default implementation
+ * always returns false.
+ * @param[in] change 1 if the tie was introduced, -1 if it was withdrawn
+ */
+bool MixedConfigurationTable::applyTieChange(const Network & rNetwork,
+	int ego,
+	int alter,
+	int change)
+{
+	return false;
+}
+
+
+/**
+ * Makes sure the table is recalculated when accessed next.
+ */
+void MixedConfigurationTable::invalidate()
+{
+	this->lvalid = false;
+}
+
+
+/**
+ * Resets the internal array to zeroes. Only the entries of the actors
+ * in lnonZeroActors are cleared, as all other entries are zero already.
  */
 void MixedConfigurationTable::reset()
 {
-	for (int i = 0; i < this->ltableSize; i++)
+	for (unsigned k = 0; k < this->lnonZeroActors.size(); k++)
 	{
+		int i = this->lnonZeroActors[k];
 		this->ltable[i] = 0;
+		this->lnonZeroPositions[i] = -1;
+	}
+
+	this->lnonZeroActors.clear();
+}
+
+
+/**
+ * Adds the given amount to the entry of the given actor, keeping the list
+ * of actors with non-zero entries up to date.
+ */
+void MixedConfigurationTable::add(int i, int change)
+{
+	int oldValue = this->ltable[i];
+	this->ltable[i] += change;
+
+	if (oldValue == 0)
+	{
+		this->lnonZeroPositions[i] = this->lnonZeroActors.size();
+		this->lnonZeroActors.push_back(i);
+	}
+	else if (this->ltable[i] == 0)
+	{
+		// Move the last listed actor into the place of i
+
+		int position = this->lnonZeroPositions[i];
+		int last = this->lnonZeroActors.back();
+		this->lnonZeroActors[position] = last;
+		this->lnonZeroPositions[last] = position;
+		this->lnonZeroActors.pop_back();
+		this->lnonZeroPositions[i] = -1;
+	}
+}
+
+
+/**
+ * Returns the instrumentation counter for the calculations of this table.
+ */
+int MixedConfigurationTable::instrumentationSlot()
+{
+	if (this->linstrumentationSlot < 0)
+	{
+		this->linstrumentationSlot =
+			Instrumentation::slot(TABLE, this->name());
+	}
+
+	return this->linstrumentationSlot;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Private methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Recalculates the table if it does not agree with the current networks,
+ * listening to the networks again if they have been disposed meanwhile.
+ */
+void MixedConfigurationTable::update()
+{
+	if (!this->lvalid)
+	{
+		this->attach();
+
+		InstrumentationTimer timer(this->instrumentationSlot());
+		this->calculate();
+		this->lvalid = true;
+	}
+}
+
+
+/**
+ * Registers this table as a listener of both networks, unless it is
+ * registered already.
+ */
+void MixedConfigurationTable::attach()
+{
+	if (!this->lfirstNetworkAttached)
+	{
+		this->lpFirstNetwork->addNetworkChangeListener(this);
+		this->lfirstNetworkAttached = true;
+	}
+
+	if (!this->lsecondNetworkAttached)
+	{
+		this->lpSecondNetwork->addNetworkChangeListener(this);
+		this->lsecondNetworkAttached = true;
+	}
+}
+
+
+/**
+ * Updates the table for a changed tie if it is valid, or invalidates it
+ * if the derived class cannot update it incrementally.
+ */
+void MixedConfigurationTable::onTieChange(const Network & rNetwork,
+	int ego,
+	int alter,
+	int change)
+{
+	if (this->lvalid &&
+		!this->applyTieChange(rNetwork, ego, alter, change))
+	{
+		this->invalidate();
 	}
 }
 
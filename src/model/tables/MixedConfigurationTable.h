@@ -11,6 +11,10 @@
 #ifndef MIXEDCONFIGURATIONTABLE_H_
 #define MIXEDCONFIGURATIONTABLE_H_
 
+#include <string>
+#include <vector>
+#include "network/INetworkChangeListener.h"
+
 namespace siena
 {
 
@@ -37,16 +41,40 @@ class Network;
  * The configuration tables are grouped in and owned by an instance of the
  * NetworkCache class.
  *
+ * The table listens to the changes of both networks. Derived classes can
+ * override the method applyTieChange to update the table for a single
+ * changed tie; otherwise, the table is recalculated the next time it is
+ * accessed after any change of either network.
+ *
  * The configuration tables are used to speedup the calculations involving
  * effects.
  */
-class MixedConfigurationTable
+class MixedConfigurationTable : public INetworkChangeListener
 {
 public:
 	MixedConfigurationTable(TwoNetworkCache * pOwner);
 	virtual ~MixedConfigurationTable();
 
 	virtual int get(int i);
+	virtual const std::vector<int> & nonZeroActors();
+
+	/**
+	 * Returns the name of the configuration type for the instrumentation
+	 * of the table calculations.
+	 */
+	virtual std::string name() const = 0;
+
+	// INetworkChangeListener interface
+
+	virtual void onInitializationEvent(const Network & rNetwork);
+	virtual void onTieIntroductionEvent(const Network & rNetwork,
+		const int ego,
+		const int alter);
+	virtual void onTieWithdrawalEvent(const Network & rNetwork,
+		const int ego,
+		const int alter);
+	virtual void onNetworkClearEvent(const Network & rNetwork);
+	virtual void onNetworkDisposeEvent(const Network & rNetwork);
 
 protected:
 	TwoNetworkCache * pOwner() const;
@@ -60,12 +88,31 @@ protected:
 	 */
 	virtual void calculate() = 0;
 
+	virtual bool applyTieChange(const Network & rNetwork,
+		int ego,
+		int alter,
+		int change);
+
+	void invalidate();
 	void reset();
+	inline void increment(int i);
+	void add(int i, int change);
+	int instrumentationSlot();
 
-	// The internal storage
+	// The internal storage. Derived classes change it only by the methods
+	// increment and add, so that lnonZeroActors lists exactly the actors
+	// with non-zero entries.
 	int * ltable;
 
+	// The actors with non-zero entries in ltable, in no particular order
+	std::vector<int> lnonZeroActors;
+
 private:
+	void update();
+	void attach();
+	void onTieChange(const Network & rNetwork, int ego, int alter,
+		int change);
+
 	// The network cache owning this configuration table
 	TwoNetworkCache * lpOwner;
 
@@ -75,20 +122,46 @@ private:
 	// The secondnetwork this configuration table is associated with
 	const Network * lpSecondNetwork;
 
-	// The modification count of the first network on the last time this table
-	// was calculated.
-
-	int llastFirstModificationCount {};
-
-	// The modification count of the second network on the last time this table
-	// was calculated.
+	// Indicates if the table agrees with the current networks
+	bool lvalid {};
 
-	int llastSecondModificationCount {};
+	// Indicates if the table is registered as a listener of the first or
+	// second network. The table detaches itself when the contents of a
+	// network are disposed, as the network may be about to be destroyed,
+	// and registers again when it is accessed next.
+	bool lfirstNetworkAttached {};
+	bool lsecondNetworkAttached {};
 
 	// The number of elements in ltable
 	int ltableSize {};
+
+	// The position of each actor in lnonZeroActors, or -1 if the entry
+	// of the actor is zero
+	std::vector<int> lnonZeroPositions;
+
+	// The instrumentation counter of the calculations of this table, or -1
+	// if not looked up yet
+	int linstrumentationSlot {-1};
 };
 
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Increments the entry of the given actor, remembering the actor if the
+ * entry was zero before.
+ */
+void MixedConfigurationTable::increment(int i)
+{
+	if (this->ltable[i]++ == 0)
+	{
+		this->lnonZeroPositions[i] = this->lnonZeroActors.size();
+		this->lnonZeroActors.push_back(i);
+	}
+}
+
 }
 
 #endif /*MIXEDCONFIGURATIONTABLE_H_*/
@@ -19,7 +19,6 @@ MixedEgocentricConfigurationTable::MixedEgocentricConfigurationTable(
 	// The table has not been calculated for any ego yet.
 
 	this->lego = -1;
-	this->lupdated = false;
 }
 
 
@@ -29,30 +28,20 @@ MixedEgocentricConfigurationTable::~MixedEgocentricConfigurationTable()
 
 
 /**
- * Initializes the table for the given ego.
+ * Initializes the table for the given ego. The table is kept if it has
+ * been calculated for the same ego before, as it follows the changes of
+ * the networks since then.
  */
 void MixedEgocentricConfigurationTable::initialize(int ego)
 {
-	// Store the ego
-	this->lego = ego;
-
-	// Make sure the table is recalculated in the next call to get(...)
-	this->lupdated = false;
-}
-
-
-/**
- * Returns the number of configurations corresponding to the given actor.
- */
-int MixedEgocentricConfigurationTable::get(int i)
-{
-	if (!this->lupdated)
+	if (ego != this->lego)
 	{
-		this->calculate();
-		this->lupdated = true;
-	}
+		// Store the ego
+		this->lego = ego;
 
-	return this->ltable[i];
+		// Make sure the table is recalculated in the next call to get(...)
+		this->invalidate();
+	}
 }
 
 
@@ -36,7 +36,6 @@ public:
 	virtual ~MixedEgocentricConfigurationTable();
 
 	void initialize(int ego);
-	virtual int get(int i);
 
 protected:
 	int ego() const;
@@ -44,8 +43,6 @@ protected:
 private:
 	// Indicates the ego this table has been calculated for
 	int lego {};
-
-	bool lupdated {};
 };
 
 }
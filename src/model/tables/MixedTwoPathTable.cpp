@@ -40,6 +40,20 @@ MixedTwoPathTable::MixedTwoPathTable(TwoNetworkCache * pOwner,
 // Section: ConfigurationTable implementation
 // ----------------------------------------------------------------------------
 
+/**
+ * Returns the name of this table, showing the directions of both steps.
+ */
+std::string MixedTwoPathTable::name() const
+{
+	// The directions are abbreviated by the first letters of FORWARD,
+	// BACKWARD, RECIPROCAL, and EITHER.
+
+	const char * letters = "FBRE";
+	return std::string("MixedTwoPath(") + letters[this->lfirstStepDirection] + "," +
+		letters[this->lsecondStepDirection] + ")";
+}
+
+
 /**
  * Calculates the number of generalized two-paths between the ego and all
  * other actors.
@@ -93,48 +107,217 @@ void MixedTwoPathTable::performFirstStep(Iterator iter)
 	{
 		int middleActor = iter.actor();
 		iter.next();
-		// Choose the right iterator for the second step
-		if (this->lsecondStepDirection == FORWARD)
+		this->performSecondStep(middleActor, 1);
+	}
+}
+
+
+/**
+ * Performs the second step from the given middle actor, adding the given
+ * change to the values of the actors reached.
+ */
+void MixedTwoPathTable::performSecondStep(int middleActor, int change)
+{
+	// Choose the right iterator for the second step
+	if (this->lsecondStepDirection == FORWARD)
+	{
+		this->addSecondSteps(
+				this->pSecondNetwork()->outTies(middleActor), change);
+	}
+	else if (this->lsecondStepDirection == BACKWARD)
+	{
+		this->addSecondSteps(
+				this->pSecondNetwork()->inTies(middleActor, "mtpt2"), change);
+	}
+	else if (this->lsecondStepDirection == EITHER)
+	{
+		const OneModeNetwork * pOneModeSecondNetwork =
+			dynamic_cast<const OneModeNetwork *>(this->pSecondNetwork());
+		this->addSecondSteps(
+			pOneModeSecondNetwork->eitherTies(middleActor), change);
+	}
+	// Final case refers to RECIPROCAL
+	else if (this->lsecondStepDirection == RECIPROCAL)
+	{
+		const OneModeNetwork * pOneModeSecondNetwork =
+			dynamic_cast<const OneModeNetwork *>(this->pSecondNetwork());
+		this->addSecondSteps(
+				pOneModeSecondNetwork->reciprocatedTies(middleActor), change);
+	}
+}
+
+
+/**
+ * Adds the given change to the values of the actors of the given iterator
+ * that are stored in this table.
+ */
+template<class Iterator>
+void MixedTwoPathTable::addSecondSteps(Iterator iter, int change)
+{
+	while (iter.valid())
+	{
+		if (change == 1)
 		{
-			this->performSecondStep(
-					this->pSecondNetwork()->outTies(middleActor));
+			this->increment(iter.actor());
 		}
-		else if (this->lsecondStepDirection == BACKWARD)
+		else
 		{
-			this->performSecondStep(
-					this->pSecondNetwork()->inTies(middleActor, "mtpt2"));
+			this->add(iter.actor(), change);
 		}
-		else if (this->lsecondStepDirection == EITHER)
+
+		iter.next();
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Incremental updates
+// ----------------------------------------------------------------------------
+
+/**
+ * Updates the table for the change of the tie from ego to alter in one of
+ * the networks. A changed first step from the ego to a middle actor h
+ * changes the values of all actors reached from h in the second step, and
+ * a changed second step from h to an actor j changes the value of j if
+ * the first step from the ego to h exists. This takes time proportional
+ * to the degree of h instead of a recalculation of the whole table.
+ */
+bool MixedTwoPathTable::applyTieChange(const Network & rNetwork,
+	int ego,
+	int alter,
+	int change)
+{
+	// If both steps are in the same network, a changed tie can change both
+	// steps at once; the table is recalculated then.
+
+	if (this->pFirstNetwork() == this->pSecondNetwork() || ego == alter)
+	{
+		return false;
+	}
+
+	int from[2];
+	int to[2];
+
+	if (&rNetwork == this->pFirstNetwork())
+	{
+		int count = this->changedSteps(rNetwork, this->firstStepTraversal(),
+			ego, alter, from, to);
+
+		for (int k = 0; k < count; k++)
 		{
-			const OneModeNetwork * pOneModeSecondNetwork =
-				dynamic_cast<const OneModeNetwork *>(this->pSecondNetwork());
-			this->performSecondStep(
-				pOneModeSecondNetwork->eitherTies(middleActor));
+			if (from[k] == this->ego())
+			{
+				this->performSecondStep(to[k], change);
+			}
 		}
-		// Final case refers to RECIPROCAL
-		else if (this->lsecondStepDirection == RECIPROCAL)
+	}
+	else
+	{
+		int count = this->changedSteps(rNetwork, this->lsecondStepDirection,
+			ego, alter, from, to);
+
+		for (int k = 0; k < count; k++)
 		{
-			const OneModeNetwork * pOneModeSecondNetwork =
-				dynamic_cast<const OneModeNetwork *>(this->pSecondNetwork());
-			this->performSecondStep(
-					pOneModeSecondNetwork->reciprocatedTies(middleActor));
+			if (this->firstStepExists(from[k]))
+			{
+				this->add(to[k], change);
+			}
 		}
 	}
+
+	return true;
 }
 
 
 /**
- * Performs the second step by iterating over the actors of the given
- * iterator and incrementing their values that are stored in this table.
+ * Returns the kind of ties traversed in the first step. As in calculate(),
+ * a first step in EITHER direction traverses reciprocated ties.
  */
-template<class Iterator>
-void MixedTwoPathTable::performSecondStep(Iterator iter)
+Direction MixedTwoPathTable::firstStepTraversal() const
 {
-	while (iter.valid())
+	if (this->lfirstStepDirection == EITHER)
 	{
-		this->ltable[iter.actor()]++;
-		iter.next();
+		return RECIPROCAL;
+	}
+
+	return this->lfirstStepDirection;
+}
+
+
+/**
+ * Indicates if the first step from the ego to the given middle actor
+ * exists in the first network.
+ */
+bool MixedTwoPathTable::firstStepExists(int middleActor) const
+{
+	const Network * pNetwork = this->pFirstNetwork();
+	int ego = this->ego();
+	Direction direction = this->firstStepTraversal();
+
+	if (direction == FORWARD)
+	{
+		return middleActor < pNetwork->m() &&
+			pNetwork->hasEdge(ego, middleActor);
+	}
+
+	if (middleActor >= pNetwork->n() || ego >= pNetwork->m())
+	{
+		return false;
+	}
+
+	if (direction == BACKWARD)
+	{
+		return pNetwork->hasEdge(middleActor, ego);
 	}
+
+	return pNetwork->hasEdge(ego, middleActor) &&
+		pNetwork->hasEdge(middleActor, ego);
+}
+
+
+/**
+ * Stores the steps in the given direction that appeared or disappeared
+ * by the change of the tie from ego to alter in the given network, which
+ * has already been applied, and returns their number (0, 1, or 2).
+ * @param[out] pFrom the start of each changed step
+ * @param[out] pTo the end of each changed step
+ */
+int MixedTwoPathTable::changedSteps(const Network & rNetwork,
+	Direction direction,
+	int ego,
+	int alter,
+	int * pFrom,
+	int * pTo) const
+{
+	if (direction == FORWARD)
+	{
+		pFrom[0] = ego;
+		pTo[0] = alter;
+		return 1;
+	}
+
+	if (direction == BACKWARD)
+	{
+		pFrom[0] = alter;
+		pTo[0] = ego;
+		return 1;
+	}
+
+	// A reciprocated tie changes only if the reverse tie exists, and a tie
+	// in either direction only if the reverse tie does not exist.
+
+	bool reverseTieExists = rNetwork.hasEdge(alter, ego);
+
+	if (reverseTieExists != (direction == RECIPROCAL))
+	{
+		return 0;
+	}
+
+	pFrom[0] = ego;
+	pTo[0] = alter;
+	pFrom[1] = alter;
+	pTo[1] = ego;
+	return 2;
 }
 
 }
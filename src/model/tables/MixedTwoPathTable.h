@@ -34,12 +34,27 @@ public:
 		Direction firstStepDirection,
 		Direction secondStepDirection);
 
+	virtual std::string name() const;
+
 protected:
 	virtual void calculate();
+	virtual bool applyTieChange(const Network & rNetwork,
+		int ego,
+		int alter,
+		int change);
 
 private:
 	template<class Iterator> void performFirstStep(Iterator iter);
-	template<class Iterator> void performSecondStep(Iterator iter);
+	void performSecondStep(int middleActor, int change);
+	template<class Iterator> void addSecondSteps(Iterator iter, int change);
+	Direction firstStepTraversal() const;
+	bool firstStepExists(int middleActor) const;
+	int changedSteps(const Network & rNetwork,
+		Direction direction,
+		int ego,
+		int alter,
+		int * pFrom,
+		int * pTo) const;
 
 	// The direction of the first step
 	Direction lfirstStepDirection {};
@@ -27,7 +27,7 @@ NetworkCache::NetworkCache(const Network * pNetwork)
 {
 	this->lpNetwork = pNetwork;
 
-	this->loutTieValues = new int[pNetwork->m()];
+	this->loutTieValues = new int[pNetwork->m()]();
 
 	this->loneModeNetwork =
 		dynamic_cast<const OneModeNetwork *>(pNetwork) != 0;
@@ -41,7 +41,7 @@ NetworkCache::NetworkCache(const Network * pNetwork)
 
 	if (this->loneModeNetwork)
 	{
-		this->linTieValues = new int[pNetwork->n()];
+		this->linTieValues = new int[pNetwork->n()]();
 		this->lpTwoPathTable =
 			new TwoPathTable(this, FORWARD, FORWARD);
 		this->lpReverseTwoPathTable =
@@ -119,13 +119,17 @@ NetworkCache::~NetworkCache()
 
 void NetworkCache::initialize(int ego)
 {
-	// Out-tie indicators
+	// Out-tie indicators. Only the entries of the previous ego's ties
+	// are non-zero, so that clearing them takes time proportional to
+	// its degree rather than to the number of actors.
 
-	for (int i = 0; i < this->lpNetwork->m(); i++)
+	for (unsigned i = 0; i < this->loutTieActors.size(); i++)
 	{
-		this->loutTieValues[i] = 0;
+		this->loutTieValues[this->loutTieActors[i]] = 0;
 	}
 
+	this->loutTieActors.clear();
+
 	if (ego >= 0 && ego < this->lpNetwork->n())
 	{
 		for (IncidentTieIterator iter = this->lpNetwork->outTies(ego);
@@ -133,6 +137,7 @@ void NetworkCache::initialize(int ego)
 			iter.next())
 		{
 			this->loutTieValues[iter.actor()] = iter.value();
+			this->loutTieActors.push_back(iter.actor());
 		}
 	}
 
@@ -140,11 +145,13 @@ void NetworkCache::initialize(int ego)
 
 	if (this->loneModeNetwork)
 	{
-		for (int i = 0; i < this->lpNetwork->n(); i++)
+		for (unsigned i = 0; i < this->linTieActors.size(); i++)
 		{
-			this->linTieValues[i] = 0;
+			this->linTieValues[this->linTieActors[i]] = 0;
 		}
 
+		this->linTieActors.clear();
+
 		if (ego >= 0 && ego < this->lpNetwork->n())
 		{
 			for (IncidentTieIterator iter = this->lpNetwork->inTies(ego, "nwc");
@@ -152,6 +159,7 @@ void NetworkCache::initialize(int ego)
 				iter.next())
 			{
 				this->linTieValues[iter.actor()] = iter.value();
+				this->linTieActors.push_back(iter.actor());
 			}
 		}
 	}
@@ -13,6 +13,8 @@
 #ifndef NETWORKCACHE_H_
 #define NETWORKCACHE_H_
 
+#include <vector>
+
 namespace siena
 {
 
@@ -74,6 +76,11 @@ private:
 	// Stores the values of ties to ego from each of the alters.
 	int * linTieValues {};
 
+	// The alters with non-zero entries in loutTieValues and linTieValues,
+	// so that only these entries are cleared for the next ego
+	std::vector<int> loutTieActors;
+	std::vector<int> linTieActors;
+
 	// Stores the values of the stepType (settings model)
 	int lstepTypeValue {};
 
@@ -29,8 +29,8 @@ TwoNetworkCache::TwoNetworkCache(const Network * pFirstNetwork,
 	this->lpFirstNetwork = pFirstNetwork;
 	this->lpSecondNetwork = pSecondNetwork;
 
-	this->lfirstOutTieValues = new int[pFirstNetwork->m()];
-	this->lsecondOutTieValues = new int[pSecondNetwork->m()];
+	this->lfirstOutTieValues = new int[pFirstNetwork->m()]();
+	this->lsecondOutTieValues = new int[pSecondNetwork->m()]();
 
 	this->loneModeFirstNetwork =
 		dynamic_cast<const OneModeNetwork *>(pFirstNetwork) != 0;
@@ -116,13 +116,16 @@ TwoNetworkCache::~TwoNetworkCache()
 
 void TwoNetworkCache::initialize(int ego)
 {
-	// Out-tie indicators
+	// Out-tie indicators. Only the entries of the alters of the previous
+	// ego have to be cleared.
 
-	for (int i = 0; i < this->lpFirstNetwork->m(); i++)
+	for (unsigned k = 0; k < this->lfirstOutTieAlters.size(); k++)
 	{
-		this->lfirstOutTieValues[i] = 0;
+		this->lfirstOutTieValues[this->lfirstOutTieAlters[k]] = 0;
 	}
 
+	this->lfirstOutTieAlters.clear();
+
 	if (ego >= 0 && ego < this->lpFirstNetwork->n())
 	{
 		for (IncidentTieIterator iter = this->lpFirstNetwork->outTies(ego);
@@ -130,14 +133,17 @@ void TwoNetworkCache::initialize(int ego)
 			iter.next())
 		{
 			this->lfirstOutTieValues[iter.actor()] = iter.value();
+			this->lfirstOutTieAlters.push_back(iter.actor());
 		}
 	}
 
-	for (int i = 0; i < this->lpSecondNetwork->m(); i++)
+	for (unsigned k = 0; k < this->lsecondOutTieAlters.size(); k++)
 	{
-		this->lsecondOutTieValues[i] = 0;
+		this->lsecondOutTieValues[this->lsecondOutTieAlters[k]] = 0;
 	}
 
+	this->lsecondOutTieAlters.clear();
+
 	if (ego >= 0 && ego < this->lpSecondNetwork->n())
 	{
 		this->lsecondOutDegree = 0;
@@ -146,6 +152,7 @@ void TwoNetworkCache::initialize(int ego)
 			iter.next())
 		{
 			this->lsecondOutTieValues[iter.actor()] = iter.value();
+			this->lsecondOutTieAlters.push_back(iter.actor());
 			this->lsecondOutDegree++;
 		}
 	}
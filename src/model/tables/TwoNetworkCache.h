@@ -13,6 +13,8 @@
 #ifndef TWONETWORKCACHE_H_
 #define TWONETWORKCACHE_H_
 
+#include <vector>
+
 namespace siena
 {
 
@@ -84,6 +86,11 @@ private:
 	int * lsecondOutTieValues {};
 	int lsecondOutDegree {};
 
+	// The alters with non-zero entries in lfirstOutTieValues and
+	// lsecondOutTieValues
+	std::vector<int> lfirstOutTieAlters;
+	std::vector<int> lsecondOutTieAlters;
+
 	// The number of two-paths from the ego to each of the alters
 	MixedEgocentricConfigurationTable * lpTwoPathTable;
 
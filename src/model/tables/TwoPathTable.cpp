@@ -38,6 +38,20 @@ TwoPathTable::TwoPathTable(NetworkCache * pOwner,
 // Section: ConfigurationTable implementation
 // ----------------------------------------------------------------------------
 
+/**
+ * Returns the name of this table, showing the directions of both steps.
+ */
+std::string TwoPathTable::name() const
+{
+	// The directions are abbreviated by the first letters of FORWARD,
+	// BACKWARD, RECIPROCAL, and EITHER.
+
+	const char * letters = "FBRE";
+	return std::string("TwoPath(") + letters[this->lfirstStepDirection] + "," +
+		letters[this->lsecondStepDirection] + ")";
+}
+
+
 /**
  * Calculates the number of generalized two-paths between the ego and all
  * other actors.
@@ -121,7 +135,7 @@ void TwoPathTable::performSecondStep(Iterator iter)
 {
 	while (iter.valid())
 	{
-		this->ltable[iter.actor()]++;
+		this->increment(iter.actor());
 		iter.next();
 	}
 }
@@ -33,6 +33,8 @@ public:
 		Direction firstStepDirection,
 		Direction secondStepDirection);
 
+	virtual std::string name() const;
+
 protected:
 	virtual void calculate();
 
@@ -17,6 +17,8 @@
 #include <R_ext/Error.h>
 #include "data/ActorSet.h"
 #include "utils/Random.h"
+#include "utils/Utils.h"
+#include "utils/Instrumentation.h"
 #include <Rinternals.h>
 #include <R_ext/Print.h>
 #include <R_ext/Arith.h>
@@ -68,6 +70,11 @@ BehaviorVariable::BehaviorVariable(BehaviorLongitudinalData * pData,
 		this->lprobabilities[i] = 0;
 	}
 
+	this->lderivativeProducts =
+		new double[pSimulation->pModel()->rEvaluationEffects(pData->name()).size() +
+			pSimulation->pModel()->rEndowmentEffects(pData->name()).size() +
+			pSimulation->pModel()->rCreationEffects(pData->name()).size()];
+
 	this->lbehaviorModelType = BehaviorModelType(pData->behModelType());
 	this->lego = 0;
 	this->lupPossible = true;
@@ -85,6 +92,7 @@ BehaviorVariable::~BehaviorVariable()
 	this->lpData = 0;
 	this->lvalues = 0;
 	delete[] this->lprobabilities;
+	delete[] this->lderivativeProducts;
 	// Delete arrays of contributions
 
 	for (int i = 0; i < 3; i++)
@@ -365,6 +373,9 @@ void BehaviorVariable::makeChange(int actor)
  */
 void BehaviorVariable::calculateProbabilities(int actor)
 {
+	static const int slot =
+		Instrumentation::slot(PHASE, "calculateBehaviorProbabilities");
+	InstrumentationTimer timer(slot);
 	double maxValue = 0.0; // used to be R_NegInf, but always there is a 0
 
 	this->preprocessEgo();
@@ -517,6 +528,45 @@ void BehaviorVariable::calculateProbabilities(int actor)
 }
 
 
+/**
+ * Returns the contribution of the i-th effect of the given function if the
+ * behavior of the given actor is changed by the given amount. The
+ * contribution of an interaction between preceding effects of the function
+ * is derived from the contributions of these effects, which must have been
+ * stored in the given array already.
+ */
+double BehaviorVariable::changeContribution(const Function * pFunction,
+	int i,
+	int actor,
+	int difference,
+	const double * contributions) const
+{
+	const vector<int> & rInteractingEffects =
+		pFunction->rInteractingEffects(i);
+
+	if (rInteractingEffects.empty())
+	{
+		BehaviorEffect * pEffect = (BehaviorEffect *) pFunction->rEffects()[i];
+		InstrumentationTimer timer(pEffect);
+		return pEffect->calculateChangeContribution(actor, difference);
+	}
+
+	// As in BehaviorInteractionEffect::calculateChangeContribution
+
+	double contribution = contributions[rInteractingEffects[0]] *
+		contributions[rInteractingEffects[1]];
+
+	contribution /= difference;
+
+	if (rInteractingEffects.size() > 2)
+	{
+		contribution *= contributions[rInteractingEffects[2]] / difference;
+	}
+
+	return contribution;
+}
+
+
 /**
  * Returns the total contribution of all effects in the evaluation function if
  * the behavior of the given actor is changed by the given amount.
@@ -530,8 +580,11 @@ double BehaviorVariable::totalEvaluationContribution(int actor,
 	for (unsigned i = 0; i < pFunction->rEffects().size(); i++)
 	{
 		BehaviorEffect * pEffect = (BehaviorEffect *) pFunction->rEffects()[i];
-		double thisContribution =
-			pEffect->calculateChangeContribution(actor, difference);
+		double thisContribution = this->changeContribution(pFunction,
+			i,
+			actor,
+			difference,
+			this->levaluationEffectContribution[difference + 1]);
 		if (this->pSimulation()->pModel()->needChangeContributions())
 		{
 			(* this->lpChangeContribution)[pEffect->pEffectInfo()]
@@ -553,8 +606,11 @@ double BehaviorVariable::totalEndowmentContribution(int actor,
 	for (unsigned i = 0; i < pFunction->rEffects().size(); i++)
 	{
 		BehaviorEffect * pEffect = (BehaviorEffect *) pFunction->rEffects()[i];
-		double thisContribution =
-			pEffect->calculateChangeContribution(actor, difference);
+		double thisContribution = this->changeContribution(pFunction,
+			i,
+			actor,
+			difference,
+			this->lendowmentEffectContribution[difference + 1]);
 		if (this->pSimulation()->pModel()->needChangeContributions())
 		{
 			(* this->lpChangeContribution)[pEffect->pEffectInfo()]
@@ -582,8 +638,11 @@ double BehaviorVariable::totalCreationContribution(int actor,
 	for (unsigned i = 0; i < pFunction->rEffects().size(); i++)
 	{
 		BehaviorEffect * pEffect = (BehaviorEffect *) pFunction->rEffects()[i];
-		double thisContribution =
-			pEffect->calculateChangeContribution(actor, difference);
+		double thisContribution = this->changeContribution(pFunction,
+			i,
+			actor,
+			difference,
+			this->lcreationEffectContribution[difference + 1]);
 		if (this->pSimulation()->pModel()->needChangeContributions())
 		{
 			(* this->lpChangeContribution)[pEffect->pEffectInfo()]
@@ -634,7 +693,7 @@ void BehaviorVariable::accumulateScores(int difference,
 			this->pSimulation()->score(pEffect->pEffectInfo()) + score);
 		if (R_IsNaN(score))
 		{
-			Rf_error("nan in accumulateScores1");
+			engineError("nan in accumulateScores1");
 		}
 	}
 
@@ -668,7 +727,7 @@ void BehaviorVariable::accumulateScores(int difference,
 		}
 		if (R_IsNaN(score))
 		{
-			Rf_error("nan in accumulateScores2");
+			engineError("nan in accumulateScores2");
 		}
 
 		this->pSimulation()->score(pEffect->pEffectInfo(),
@@ -697,7 +756,7 @@ void BehaviorVariable::accumulateScores(int difference,
 
 		if (R_IsNaN(score))
 		{
-			Rf_error("nan in accumulateScores3");
+			engineError("nan in accumulateScores3");
 		}
 
 		this->pSimulation()->score(pEffect->pEffectInfo(),
@@ -784,7 +843,7 @@ void BehaviorVariable::accumulateDerivatives() const
 	Effect * pEffect1;
 	Effect * pEffect2;
 	double derivative;
-	double * product = new double[totalEffects];
+	double * product = this->lderivativeProducts;
 	double contribution1 = 0.0;
 	double contribution2 = 0.0;
 
@@ -1004,7 +1063,6 @@ void BehaviorVariable::accumulateDerivatives() const
 				product[effect1] * product[effect2]);
 		}
 	}
-	delete[] product;
 }
 
 /**
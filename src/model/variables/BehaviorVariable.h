@@ -73,6 +73,11 @@ public:
 private:
 	void preprocessEgo();
 	void preprocessEffects(const Function * pFunction);
+	double changeContribution(const Function * pFunction,
+		int i,
+		int actor,
+		int difference,
+		const double * contributions) const;
 	double totalEvaluationContribution(int actor,
 		int difference) const;
 	double totalEndowmentContribution(int actor,
@@ -111,6 +116,10 @@ private:
 	// lprobabilities[2] - probability of an upward change
 	double * lprobabilities {};
 
+	// The expected contribution of each effect of the three functions
+	// over the possible changes, used when accumulating derivatives
+	double * lderivativeProducts {};
+
 	// Indicates if upward change is possible in the current situation
 	bool lupPossible {};
 
@@ -66,6 +66,7 @@ namespace siena
 		this->ltotalRate = 0;
 		this->lnonSettingsRate = 0;
 		this->lrate = new double[this->n()];
+		this->lrateTree.reset(this->n());
 		this->lcovariateRates = new double[this->n()];
 		this->lpEvaluationFunction = new Function();
 		this->lpEndowmentFunction = new Function();
@@ -502,7 +503,7 @@ namespace siena
 		for (unsigned i = 0; i < rEffects.size(); i++)
 		{
 			EffectInfo *pEffectInfo = rEffects[i];
-			Effect *pEffect = factory.createEffect(pEffectInfo);
+			Effect *pEffect = factory.createEffect(pEffectInfo, pFunction);
 			pFunction->addEffect(pEffect);
 		}
 	}
@@ -713,6 +714,11 @@ namespace siena
 				sumRatesSquared += this->lrate[i] * this->lrate[i];
 			}
 
+			if (this->symmetric() && this->networkModelTypeB())
+			{
+				this->lrateTree.reset(n, this->lrate);
+			}
+
 			if (this->pSimulation()->pModel()->needScores())
 			{
 				this->calculateScoreSumTerms(); // for the non-constant rate components
@@ -797,6 +803,27 @@ namespace siena
 		return this->lrate[actor];
 	}
 
+	/**
+	 * Draws an actor with probability proportional to its rate of change,
+	 * in time logarithmic in the number of actors. The rates are only
+	 * indexed for symmetric networks of model type B, and it is assumed
+	 * that they have been calculated already.
+	 */
+	int DependentVariable::randomActor() const
+	{
+		return this->lrateTree.find(nextDouble() * this->lrateTree.total());
+	}
+
+	/**
+	 * Returns the sum of the rates of change of all actors of a symmetric
+	 * network of model type B, where the total rate refers to pairs of
+	 * actors instead.
+	 */
+	double DependentVariable::sumOfRates() const
+	{
+		return this->lrateTree.total();
+	}
+
 	/**
 	 * Recalculates the covariate-based components of the rate functions using
 	 * the current values of parameters and changing covariates.
@@ -17,6 +17,7 @@
 #include <string>
 #include "utils/NamedObject.h"
 #include "model/Function.h"
+#include "utils/WeightTree.h"
 
 namespace siena
 {
@@ -117,6 +118,8 @@ public:
 	double totalRate() const;
 	double nonSettingsRate() const;
 	double rate(int actor) const;
+	int randomActor() const;
+	double sumOfRates() const;
 	inline double basicRate() const;
 
 	int simulatedDistance() const;
@@ -229,6 +232,11 @@ private:
 	// The rate of change for each actor
 	double * lrate {};
 
+	// The rates of change of the actors of a symmetric network of model
+	// type B, indexed for drawing an actor with probability proportional
+	// to its rate
+	WeightTree lrateTree;
+
 	// The basic rate parameter for the current period
 	double lbasicRate {};
 
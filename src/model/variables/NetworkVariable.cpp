@@ -18,6 +18,7 @@
 #include "network/NetworkUtils.h"
 #include "utils/Utils.h"
 #include "utils/Random.h"
+#include "utils/Instrumentation.h"
 #include "data/ActorSet.h"
 #include "network/Network.h"
 #include "network/OneModeNetwork.h"
@@ -26,6 +27,7 @@
 #include "data/NetworkLongitudinalData.h"
 #include "data/ConstantDyadicCovariate.h"
 #include "data/ChangingDyadicCovariate.h"
+#include "data/DyadicCovariateMatrix.h"
 #include "data/OneModeNetworkLongitudinalData.h"
 #include "model/EpochSimulation.h"
 #include "model/SimulationActorSet.h"
@@ -36,6 +38,7 @@
 #include "model/tables/NetworkCache.h"
 #include "model/ml/NetworkChange.h"
 #include "model/filters/PermittedChangeFilter.h"
+#include "model/filters/PermittedSetCache.h"
 #include "model/ml/Chain.h"
 #include "model/settings/Setting.h"
 
@@ -55,6 +58,9 @@ namespace siena
 
 SEXP getMiniStepDF(const MiniStep& miniStep);
 
+// The largest number of bits stored by the cache of permitted sets
+const double MAX_PERMITTED_SET_CACHE_BITS = 1 << 29;
+
 // ----------------------------------------------------------------------------
 // Section: Construction
 // ----------------------------------------------------------------------------
@@ -129,6 +135,14 @@ NetworkVariable::NetworkVariable(NetworkLongitudinalData * pData,
 				rCreationEffects(pData->name()).size()];
 	}
 
+	this->lderivativeProducts =
+		new double[pSimulation->pModel()->
+				rEvaluationEffects(pData->name()).size() +
+			pSimulation->pModel()->
+				rEndowmentEffects(pData->name()).size() +
+			pSimulation->pModel()->
+				rCreationEffects(pData->name()).size()];
+
 	this->lpNetworkCache =
 		pSimulation->pCache()->pNetworkCache(this->lpNetwork);
 
@@ -170,6 +184,9 @@ NetworkVariable::NetworkVariable(NetworkLongitudinalData * pData,
  */
 NetworkVariable::~NetworkVariable()
 {
+	delete this->lpPermittedSetCache;
+	this->lpPermittedSetCache = 0;
+
 	for (int i = 0; i < numberSettings(); i++) {
 		lsettings[i]->terminateSetting(lpNetwork);
 	}
@@ -210,6 +227,7 @@ NetworkVariable::~NetworkVariable()
 	delete[] this->lsymmetricEvaluationEffectContribution;
 	delete[] this->lsymmetricEndowmentEffectContribution;
 	delete[] this->lsymmetricCreationEffectContribution;
+	delete[] this->lderivativeProducts;
 
 	this->lsymmetricEvaluationEffectContribution = 0;
 	this->lsymmetricEndowmentEffectContribution = 0;
@@ -238,6 +256,28 @@ NetworkVariable::~NetworkVariable()
 void NetworkVariable::addPermittedChangeFilter(PermittedChangeFilter * pFilter)
 {
 	this->lpermittedChangeFilters.push_back(pFilter);
+
+	// The filters make the permitted sets expensive to calculate, so
+	// these are cached per ego, unless the cache would be too large.
+
+	int rowLength = this->m();
+
+	if (!this->oneModeNetwork())
+	{
+		rowLength++;
+	}
+
+	if (!this->lpPermittedSetCache &&
+		(double) this->n() * rowLength <= MAX_PERMITTED_SET_CACHE_BITS)
+	{
+		this->lpPermittedSetCache = new PermittedSetCache(this->n(), rowLength);
+		this->lpPermittedSetCache->addNetwork(this->lpNetwork);
+	}
+
+	if (this->lpPermittedSetCache && pFilter->pOtherNetwork())
+	{
+		this->lpPermittedSetCache->addNetwork(pFilter->pOtherNetwork());
+	}
 }
 
 
@@ -347,6 +387,10 @@ void NetworkVariable::initialize(int period)
 {
 	DependentVariable::initialize(period);
 
+	// The receiver weights depend on the parameters and on the effects,
+	// which are initialized for the period after the variables.
+	this->lreceiverWeightsValid = false;
+
 	// Copy the respective observation
 
 	if (this->oneModeNetwork())
@@ -414,6 +458,7 @@ void NetworkVariable::actOnJoiner(const SimulationActorSet * pActorSet,
 	int actor)
 {
 	DependentVariable::actOnJoiner(pActorSet, actor);
+	this->lreceiverWeightsValid = false;
 
 	const Network * pStartNetwork = this->lpData->pNetwork(this->period());
 
@@ -481,6 +526,7 @@ void NetworkVariable::actOnLeaver(const SimulationActorSet * pActorSet,
 	int actor)
 {
 	DependentVariable::actOnLeaver(pActorSet, actor);
+	this->lreceiverWeightsValid = false;
 
 	if (pActorSet == this->pSenders())
 	{
@@ -521,6 +567,8 @@ void NetworkVariable::actOnLeaver(const SimulationActorSet * pActorSet,
 void NetworkVariable::setLeaverBack(const SimulationActorSet * pActorSet,
 	int actor)
 {
+	this->lreceiverWeightsValid = false;
+
 	if (pActorSet == this->pSenders())
 	{
 		// Reset ties from the given actor to values at start
@@ -617,6 +665,15 @@ void NetworkVariable::makeChange(int actor)
 		alter = this->lalter;
 // this->lalter is determined in calculateModelTypeBProbabilities()
 	}
+	else if (this->chooseSparseTwoModeAlter(&alter))
+	{
+		// No scores, derivatives, or chain are needed in this case.
+
+		if (this->lnetworkModelTypeDoubleStep)
+		{
+			this->lalter = alter;
+		}
+	}
 	else
 	{
 		this->calculateTieFlipProbabilities();
@@ -758,6 +815,11 @@ void NetworkVariable::makeChange(int actor)
 
 		this->lpNetwork->setTieValue(this->lego, alter, 1 - currentValue);
 
+		if (!this->oneModeNetwork())
+		{
+			this->updateReceiverWeight(alter);
+		}
+
 		if (this->oneModeNetwork())
 		{
 			const OneModeNetworkLongitudinalData * pData =
@@ -816,6 +878,22 @@ void NetworkVariable::calculatePermissibleChanges()
 {
 	NetworkLongitudinalData * pData = (NetworkLongitudinalData *) this->pData();
 
+	// Without settings, the permitted set of the ego may be stored
+	// from an earlier visit.
+
+	PermittedSetCache * pCache = 0;
+
+	if (this->stepType() == -1)
+	{
+		pCache = this->lpPermittedSetCache;
+	}
+
+	if (pCache && pCache->valid(this->lego, this->period()))
+	{
+		pCache->get(this->lego, this->lpermitted);
+		return;
+	}
+
 	int m = this->m();
 	for (int i = 0; i < m; ++i)
 	{
@@ -838,7 +916,7 @@ void NetworkVariable::calculatePermissibleChanges()
 		int i = ii;
 		if (this->stepType() > -1) {
 			if (!iter->valid()) {
-				Rf_error( "size of iterator != size setting");
+				engineError( "size of iterator != size setting");
 			}
 			i = iter->actor();
 			iter->next();
@@ -894,6 +972,93 @@ void NetworkVariable::calculatePermissibleChanges()
 		this->lpermitted[m] = true;
 	}
 
+	if (pCache)
+	{
+		pCache->store(this->lego, this->lpermitted);
+	}
+}
+
+
+/**
+ * Returns if the tie flip from the ego to the given alter is permitted,
+ * which agrees with <code>lpermitted</code> as calculated by
+ * calculatePermissibleChanges for an alter other than the ego, in the
+ * absence of settings.
+ */
+bool NetworkVariable::permittedAlter(int alter) const
+{
+	if (this->lpPermittedSetCache &&
+		this->lpPermittedSetCache->valid(this->lego, this->period()))
+	{
+		return this->lpPermittedSetCache->permitted(this->lego, alter);
+	}
+
+	NetworkLongitudinalData * pData = (NetworkLongitudinalData *) this->pData();
+	bool permitted;
+
+	if (this->lpNetworkCache->outTieExists(alter))
+	{
+		permitted = !pData->upOnly(this->period());
+	}
+	else
+	{
+		permitted = !pData->downOnly(this->period()) &&
+			this->lpNetwork->outDegree(this->lego) < pData->maxDegree();
+	}
+
+	permitted = permitted && !pData->structural(this->lego, alter, this->period());
+
+	for (unsigned i = 0;
+		i < this->lpermittedChangeFilters.size() && permitted;
+		i++)
+	{
+		permitted =
+			this->lpermittedChangeFilters[i]->permittedChange(this->lego, alter);
+	}
+
+	return permitted;
+}
+
+
+/**
+ * Returns the number of permitted alters other than the ego, counting only
+ * up to the given limit. The alters the ego is tied to are tried first,
+ * then the others in order, so that typically only a few alters are
+ * checked.
+ */
+int NetworkVariable::permittedAlterCount(int limit) const
+{
+	NetworkLongitudinalData * pData = (NetworkLongitudinalData *) this->pData();
+	int count = 0;
+
+	if (!pData->upOnly(this->period()))
+	{
+		for (IncidentTieIterator iter = this->lpNetwork->outTies(this->lego);
+			iter.valid() && count < limit;
+			iter.next())
+		{
+			if (this->permittedAlter(iter.actor()))
+			{
+				count++;
+			}
+		}
+	}
+
+	if (!pData->downOnly(this->period()) &&
+		this->lpNetwork->outDegree(this->lego) < pData->maxDegree())
+	{
+		for (int i = 0; i < this->m() && count < limit; i++)
+		{
+			if (i != this->lego &&
+				!this->lpNetworkCache->outTieExists(i) &&
+				this->permittedAlter(i))
+			{
+				count++;
+			}
+		}
+	}
+
+	return count;
 }
 
 
@@ -908,15 +1073,12 @@ void NetworkVariable::calculatePermissibleChanges()
  */
 void NetworkVariable::calculateTieFlipContributions()
 {
+	static const int slot =
+		Instrumentation::slot(PHASE, "calculateTieFlipContributions");
+	InstrumentationTimer timer(slot);
 	int evaluationEffectCount = this->pEvaluationFunction()->rEffects().size();
 	int endowmentEffectCount = this->pEndowmentFunction()->rEffects().size();
 	int creationEffectCount = this->pCreationFunction()->rEffects().size();
-	const vector<Effect *> & rEvaluationEffects =
-		this->pEvaluationFunction()->rEffects();
-	const vector<Effect *> & rEndowmentEffects =
-		this->pEndowmentFunction()->rEffects();
-	const vector<Effect *> & rCreationEffects =
-		this->pCreationFunction()->rEffects();
 	bool twoModeNetwork = !this->oneModeNetwork();
 
 	int m = this->m();
@@ -936,7 +1098,7 @@ void NetworkVariable::calculateTieFlipContributions()
 		if (this->stepType() != -1)
 		{
 			if (!permIter->valid()) {
-				Rf_error("permitted iter length != settings permitted size");
+				engineError("permitted iter length != settings permitted size");
 			}
 			alter = permIter->actor();
 			permIter->next();
@@ -952,20 +1114,19 @@ void NetworkVariable::calculateTieFlipContributions()
 		// as (alter == this->lego) is dealt with later.
 		// TODO: check if this can safely be dropped.
 		{
-			for (int i = 0; i < evaluationEffectCount; i++)
-			{
-				NetworkEffect * pEffect =
-					(NetworkEffect *) rEvaluationEffects[i];
-				double contribution = pEffect->calculateContribution(alter);
+			double * contributions = this->levaluationEffectContribution[alter];
+			this->calculateContributions(this->pEvaluationFunction(),
+				alter,
+				contributions);
 
-				// Tie withdrawals contribute in the opposite way
+			// Tie withdrawals contribute in the opposite way
 
-				if (this->lpNetworkCache->outTieExists(alter))
+			if (this->lpNetworkCache->outTieExists(alter))
+			{
+				for (int i = 0; i < evaluationEffectCount; i++)
 				{
-					contribution = -contribution;
+					contributions[i] = -contributions[i];
 				}
-
-				this->levaluationEffectContribution[alter][i] = contribution;
 			}
 		}
 		else
@@ -985,12 +1146,14 @@ void NetworkVariable::calculateTieFlipContributions()
 		if (this->lpNetworkCache->outTieExists(alter) &&
 			this->lpermitted[alter])
 		{
+			double * contributions = this->lendowmentEffectContribution[alter];
+			this->calculateContributions(this->pEndowmentFunction(),
+				alter,
+				contributions);
+
 			for (int i = 0; i < endowmentEffectCount; i++)
 			{
-				NetworkEffect * pEffect =
-					(NetworkEffect *) rEndowmentEffects[i];
-				this->lendowmentEffectContribution[alter][i] =
-					-pEffect->calculateContribution(alter);
+				contributions[i] = -contributions[i];
 			}
 		}
 		else
@@ -1015,15 +1178,9 @@ void NetworkVariable::calculateTieFlipContributions()
 			this->lpermitted[alter] &&
 			(twoModeNetwork || alter != this->lego))
 		{
-			for (int i = 0; i < creationEffectCount; i++)
-			{
-				NetworkEffect * pEffect =
-					(NetworkEffect *) rCreationEffects[i];
-				double contribution =
-					pEffect->calculateContribution(alter);
-
-				this->lcreationEffectContribution[alter][i] = contribution;
-			}
+			this->calculateContributions(this->pCreationFunction(),
+				alter,
+				this->lcreationEffectContribution[alter]);
 		}
 		else
 		{
@@ -1085,6 +1242,44 @@ void NetworkVariable::calculateTieFlipContributions()
 }
 
 
+/**
+ * Stores the contribution of each effect of the given function to the
+ * creation of the tie from the ego to the given alter in the given array.
+ * The contributions of interaction effects between preceding effects of
+ * the function are derived from the stored contributions of these effects.
+ */
+void NetworkVariable::calculateContributions(const Function * pFunction,
+	int alter,
+	double * contributions) const
+{
+	const vector<Effect *> & rEffects = pFunction->rEffects();
+
+	for (unsigned i = 0; i < rEffects.size(); i++)
+	{
+		const vector<int> & rInteractingEffects =
+			pFunction->rInteractingEffects(i);
+
+		if (rInteractingEffects.empty())
+		{
+			NetworkEffect * pEffect = (NetworkEffect *) rEffects[i];
+			InstrumentationTimer effectTimer(pEffect);
+			contributions[i] = pEffect->calculateContribution(alter);
+		}
+		else
+		{
+			double contribution = contributions[rInteractingEffects[0]];
+
+			for (unsigned k = 1; k < rInteractingEffects.size(); k++)
+			{
+				contribution *= contributions[rInteractingEffects[k]];
+			}
+
+			contributions[i] = contribution;
+		}
+	}
+}
+
+
 /**
  * If Settings model, chooses the setting;
  * calculates the probability of each actor
@@ -1253,7 +1448,7 @@ void NetworkVariable::calculateTieFlipProbabilities()
 			egoOutDegree = this->lpNetwork->outDegree(this->lego);
 			if (egoOutDegree > m)
 			{
-					Rf_error("outdegree > primary setting size");
+					engineError("outdegree > primary setting size");
 			}
 //			else if (egoOutDegree < m)
 //			{
@@ -1272,7 +1467,7 @@ void NetworkVariable::calculateTieFlipProbabilities()
 		{
 			if (!permIter->valid())
 			{
-				Rf_error( "permIter size differs from setting size");
+				engineError( "permIter size differs from setting size");
 			}
 			alter = permIter->actor();
 			permIter->next();
@@ -1358,7 +1553,7 @@ void NetworkVariable::calculateTieFlipProbabilities()
 		{
 			if (!permIter->valid())
 			{
-				Rf_error( "permitted iter length != settings permitted size");
+				engineError( "permitted iter length != settings permitted size");
 			}
 			alter = permIter->actor();
 			permIter->next();
@@ -1441,7 +1636,7 @@ void NetworkVariable::calculateTieFlipProbabilities()
 		Rprintf("this actor = %d\n", (this->lego + 1) );
 		Rprintf("this period = %d\n", (this->period() + 1) );
 		// counting starts at 0
-		Rf_error("total probability non-positive");
+		engineError("total probability non-positive");
 	}
 
 	// delete iter
@@ -1475,7 +1670,7 @@ void NetworkVariable::accumulateScores(int alter) const
 		if (alter >= m) {
 			Rprintf("this->n = %d this->m = %d m = %d alter = %d \n", this->n(),
 					this->m(), m, alter);
-		Rf_error("alter too large");
+		engineError("alter too large");
 	}
 	for (int h = 0; h < m; h++)
 	{
@@ -1484,7 +1679,7 @@ void NetworkVariable::accumulateScores(int alter) const
 	}
 	if (sumPermitted <= 0)
 	{
-		Rf_error("nothing was permitted");
+		engineError("nothing was permitted");
 	}
 	else if (sumPermitted >= 2)
 		// if sumPermitted == 1, no contribution to scores
@@ -1499,7 +1694,7 @@ void NetworkVariable::accumulateScores(int alter) const
 			{
 				Rprintf("R_IsNaN error: i = %d ego = %d alter = %d m = %d\n",
 					i, this->lego, alter, m);
-				Rf_error("nan score 41");
+				engineError("nan score 41");
 			}
 			if (curSetting) {
 				permIter->reset();
@@ -1513,7 +1708,7 @@ void NetworkVariable::accumulateScores(int alter) const
 				{
 					if (!permIter->valid())
 					{
-						Rf_error("iterator not valid");
+						engineError("iterator not valid");
 					}
 					j = permIter->actor();
 					permIter->next();
@@ -1545,14 +1740,14 @@ void NetworkVariable::accumulateScores(int alter) const
 							this->levaluationEffectContribution[j][i]);
 					Rprintf("R_IsNaN Rf_error: this->lprobabilities[j] = %f\n",
 							this->lprobabilities[j]);
-					Rf_error("nan score 1");
+					engineError("nan score 1");
 				}
 			}
 			if (R_IsNaN(this->pSimulation()->score(pEffect->pEffectInfo())))
 			{
 				Rprintf("R_IsNaN error: i = %d ego = %d alter = %d m = %d\n",
 					i, this->lego, alter, m);
-					Rf_error("nan score 0");
+					engineError("nan score 0");
 			}
 			this->pSimulation()->score(pEffect->pEffectInfo(),
 				this->pSimulation()->score(pEffect->pEffectInfo()) + score);
@@ -1583,7 +1778,7 @@ void NetworkVariable::accumulateScores(int alter) const
 				{
 					if (!permIter->valid())
 					{
-						Rf_error("iterator not valid");
+						engineError("iterator not valid");
 					}
 					j = permIter->actor();
 					permIter->next();
@@ -1623,7 +1818,7 @@ void NetworkVariable::accumulateScores(int alter) const
 				{
 					if (!permIter->valid())
 					{
-						Rf_error("iterator not valid");
+						engineError("iterator not valid");
 					}
 					j = permIter->actor();
 					permIter->next();
@@ -1646,6 +1841,376 @@ void NetworkVariable::accumulateScores(int alter) const
 }
 
 
+// ----------------------------------------------------------------------------
+// Section: Sparse two-mode simulation
+// ----------------------------------------------------------------------------
+
+/**
+ * Draws the alter for the current ego of a two-mode network without
+ * evaluating every receiver, and returns false without drawing anything
+ * if the model does not allow it. Only the receivers with a tie or a
+ * structural tie variable from the ego are evaluated one by one. For any
+ * other receiver, the contribution of a new tie is the sum of a part
+ * depending on the ego only, calculated once, and a part depending on the
+ * receiver only, whose exponential is kept in lreceiverWeights. The alter
+ * is drawn from the same probabilities, including the no-change option,
+ * and with the same random number as by calculateTieFlipProbabilities,
+ * in time logarithmic in the number of receivers. The weights are summed
+ * in another order, so that the probabilities agree only up to rounding
+ * and a trajectory can occasionally take another alter than on the dense
+ * path; this is only done if the model allows it (Model::sparseTwoMode).
+ */
+bool NetworkVariable::chooseSparseTwoModeAlter(int * pAlter)
+{
+	const Model * pModel = this->pSimulation()->pModel();
+
+	if (!pModel->sparseTwoMode() ||
+		this->oneModeNetwork() ||
+		this->numberSettings() > 0 ||
+		!this->lpermittedChangeFilters.empty() ||
+		pModel->needScores() ||
+		pModel->needDerivatives() ||
+		pModel->needChain() ||
+		pModel->needChangeContributions())
+	{
+		return false;
+	}
+
+	if (!this->lreceiverWeightsValid)
+	{
+		this->calculateReceiverWeights();
+	}
+
+	if (!this->lsparseTwoMode)
+	{
+		return false;
+	}
+
+	NetworkLongitudinalData * pData = (NetworkLongitudinalData *) this->pData();
+	int m = this->m();
+	this->preprocessEgo(this->lego);
+
+	// Collect the receivers with a tie or a structural tie variable from
+	// the ego, and the values of flipping the permitted ones, as in
+	// calculatePermissibleChanges and calculateTieFlipProbabilities.
+
+	bool upOnly = pData->upOnly(this->period());
+	bool newTiesPermitted = !pData->downOnly(this->period()) &&
+		this->lpNetwork->outDegree(this->lego) < pData->maxDegree();
+	IncidentTieIterator tieIter = this->lpNetwork->outTies(this->lego);
+	IncidentTieIterator structuralIter =
+		pData->pStructuralTieNetwork(this->period())->outTies(this->lego);
+
+	this->lcandidates.clear();
+	this->lcandidateValues.clear();
+	int permittedCount = 0;
+	double maxValue = 0;
+
+	while (tieIter.valid() || structuralIter.valid())
+	{
+		int alter;
+		bool structural = false;
+
+		if (!structuralIter.valid() ||
+			(tieIter.valid() && tieIter.actor() < structuralIter.actor()))
+		{
+			alter = tieIter.actor();
+			tieIter.next();
+		}
+		else
+		{
+			alter = structuralIter.actor();
+			structural = true;
+
+			if (tieIter.valid() && tieIter.actor() == alter)
+			{
+				tieIter.next();
+			}
+
+			structuralIter.next();
+		}
+
+		bool permitted = !structural &&
+			(this->lpNetworkCache->outTieExists(alter) ?
+				!upOnly : newTiesPermitted);
+		double value = R_NegInf;
+
+		if (permitted)
+		{
+			value = this->tieFlipValue(alter);
+			maxValue = max(maxValue, value);
+			permittedCount++;
+		}
+
+		this->lcandidates.push_back(alter);
+		this->lcandidateValues.push_back(value);
+	}
+
+	int otherCount = m - this->lcandidates.size();
+
+	if (!newTiesPermitted)
+	{
+		otherCount = 0;
+	}
+
+	// With a single permitted alter, calculateTieFlipProbabilities makes
+	// the no-change option certain in a way not reproduced here.
+
+	if (permittedCount + otherCount < 2)
+	{
+		return false;
+	}
+
+	int candidateCount = this->lcandidates.size();
+
+	if (otherCount == 0)
+	{
+		// Only the candidates and the no-change option remain, in the
+		// order of the receivers.
+
+		this->lcandidateWeights.resize(candidateCount + 1);
+		double total = 0;
+
+		for (int k = 0; k < candidateCount; k++)
+		{
+			this->lcandidateWeights[k] =
+				exp(this->lcandidateValues[k] - maxValue);
+			total += this->lcandidateWeights[k];
+		}
+
+		this->lcandidateWeights[candidateCount] = exp(-maxValue);
+		total += this->lcandidateWeights[candidateCount];
+
+		for (int k = 0; k <= candidateCount; k++)
+		{
+			this->lcandidateWeights[k] /= total;
+		}
+
+		int k = nextIntWithProbabilities(candidateCount + 1,
+			this->lcandidateWeights.data());
+		*pAlter = k < candidateCount ? this->lcandidates[k] : m;
+		return true;
+	}
+
+	// The part of the value of a new tie depending on the ego only, taken
+	// at some receiver without a tie variable from the ego.
+
+	int other = 0;
+
+	for (int k = 0; k < candidateCount && this->lcandidates[k] == other; k++)
+	{
+		other++;
+	}
+
+	double egoValue = 0;
+	const Function * pFunctions[] =
+		{this->pEvaluationFunction(), this->pCreationFunction()};
+
+	for (const Function * pFunction : pFunctions)
+	{
+		for (Effect * pEffect : pFunction->rEffects())
+		{
+			NetworkEffect * pNetworkEffect = (NetworkEffect *) pEffect;
+
+			if (pNetworkEffect->constantNewTieContribution())
+			{
+				egoValue += pEffect->parameter() *
+					pNetworkEffect->calculateContribution(other);
+			}
+		}
+	}
+
+	// Replace the weights of the candidates by their actual weights on the
+	// same scale, remembering the stored ones.
+
+	double offset = egoValue + this->lreceiverWeightOffset;
+	double noChangeWeight = exp(-offset);
+	this->lcandidateWeights.resize(candidateCount);
+
+	for (int k = 0; k < candidateCount; k++)
+	{
+		int alter = this->lcandidates[k];
+		this->lcandidateWeights[k] = this->lreceiverWeights.weight(alter);
+		this->lreceiverWeights.weight(alter,
+			exp(this->lcandidateValues[k] - offset));
+	}
+
+	double otherTotal = this->lreceiverWeights.total();
+	double total = otherTotal + noChangeWeight;
+	bool valid = std::isfinite(total) && total > 0;
+
+	if (valid)
+	{
+		double value = nextDouble() * total;
+		*pAlter = value > otherTotal ? m : this->lreceiverWeights.find(value);
+	}
+
+	for (int k = 0; k < candidateCount; k++)
+	{
+		this->lreceiverWeights.weight(this->lcandidates[k],
+			this->lcandidateWeights[k]);
+	}
+
+	// If the weights overflowed, let calculateTieFlipProbabilities handle
+	// the ministep and rescale the weights for the next ones.
+
+	if (!valid)
+	{
+		this->lreceiverWeightsValid = false;
+	}
+
+	return valid;
+}
+
+
+/**
+ * Returns the sum of the contributions of flipping the tie from the ego
+ * to the given alter, weighted by the parameters, as calculated for the
+ * selection probabilities in calculateTieFlipProbabilities.
+ */
+double NetworkVariable::tieFlipValue(int alter)
+{
+	bool tieExists = this->lpNetworkCache->outTieExists(alter);
+	double value = 0;
+
+	double * contributions = this->levaluationEffectContribution[alter];
+	this->calculateContributions(this->pEvaluationFunction(),
+		alter,
+		contributions);
+	const vector<Effect *> & rEvaluationEffects =
+		this->pEvaluationFunction()->rEffects();
+
+	for (unsigned i = 0; i < rEvaluationEffects.size(); i++)
+	{
+		double contribution = tieExists ? -contributions[i] : contributions[i];
+		value += rEvaluationEffects[i]->parameter() * contribution;
+	}
+
+	// The endowment effects count for withdrawals, the tie creation
+	// effects for creations.
+
+	const Function * pFunction = tieExists ?
+		this->pEndowmentFunction() : this->pCreationFunction();
+	contributions = tieExists ?
+		this->lendowmentEffectContribution[alter] :
+		this->lcreationEffectContribution[alter];
+	this->calculateContributions(pFunction, alter, contributions);
+
+	for (unsigned i = 0; i < pFunction->rEffects().size(); i++)
+	{
+		double contribution = tieExists ? -contributions[i] : contributions[i];
+		value += pFunction->rEffects()[i]->parameter() * contribution;
+	}
+
+	return value;
+}
+
+
+/**
+ * Returns if the contribution of a new tie for each effect of the given
+ * function is either the same for all receivers without a tie from the
+ * ego or depends on the receiver only.
+ */
+bool NetworkVariable::sparseTwoModeFunction(const Function * pFunction) const
+{
+	for (unsigned i = 0; i < pFunction->rEffects().size(); i++)
+	{
+		NetworkEffect * pEffect = (NetworkEffect *) pFunction->rEffects()[i];
+
+		if (!pFunction->rInteractingEffects(i).empty() ||
+			!(pEffect->constantNewTieContribution() ||
+				pEffect->alterNewTieContribution()))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Returns the part of the value of a new tie to the given receiver that
+ * depends on the receiver only.
+ */
+double NetworkVariable::receiverLogWeight(int alter) const
+{
+	double value = 0;
+	const Function * pFunctions[] =
+		{this->pEvaluationFunction(), this->pCreationFunction()};
+
+	for (const Function * pFunction : pFunctions)
+	{
+		for (Effect * pEffect : pFunction->rEffects())
+		{
+			NetworkEffect * pNetworkEffect = (NetworkEffect *) pEffect;
+
+			if (pNetworkEffect->alterNewTieContribution())
+			{
+				value += pEffect->parameter() *
+					pNetworkEffect->newTieContribution(alter);
+			}
+		}
+	}
+
+	return value;
+}
+
+
+/**
+ * Decides if the alters can be drawn by chooseSparseTwoModeAlter and
+ * calculates the weights of all receivers in that case. The weights are
+ * taken relative to the largest one to avoid overflow.
+ */
+void NetworkVariable::calculateReceiverWeights()
+{
+	this->lreceiverWeightsValid = true;
+	this->lsparseTwoMode =
+		this->sparseTwoModeFunction(this->pEvaluationFunction()) &&
+		this->sparseTwoModeFunction(this->pCreationFunction());
+
+	if (!this->lsparseTwoMode)
+	{
+		return;
+	}
+
+	int m = this->m();
+	vector<double> logWeights(m);
+	this->lreceiverWeightOffset = 0;
+
+	for (int alter = 0; alter < m; alter++)
+	{
+		logWeights[alter] = this->receiverLogWeight(alter);
+
+		if (alter == 0 || logWeights[alter] > this->lreceiverWeightOffset)
+		{
+			this->lreceiverWeightOffset = logWeights[alter];
+		}
+	}
+
+	this->lreceiverWeights.reset(m);
+
+	for (int alter = 0; alter < m; alter++)
+	{
+		this->lreceiverWeights.weight(alter,
+			exp(logWeights[alter] - this->lreceiverWeightOffset));
+	}
+}
+
+
+/**
+ * Updates the weight of the given receiver after a change of its ties.
+ */
+void NetworkVariable::updateReceiverWeight(int alter)
+{
+	if (this->lreceiverWeightsValid && this->lsparseTwoMode)
+	{
+		this->lreceiverWeights.weight(alter,
+			exp(this->receiverLogWeight(alter) - this->lreceiverWeightOffset));
+	}
+}
+
+
 // ----------------------------------------------------------------------------
 // Section: symmetric networks methods
 // ----------------------------------------------------------------------------
@@ -2184,50 +2749,51 @@ void NetworkVariable::calculateSymmetricTieFlipProbabilities(int alter,
 /**
  * Proposes and calculates probabilities for change.
  * Used for symmetric networks with model types beginning with B only.
+ * The alter is drawn from the rates of all actors, and without settings
+ * only the proposed dyad is checked and evaluated, so that the work does
+ * not grow with the number of actors.
  */
 bool NetworkVariable::calculateModelTypeBProbabilities()
 {
-	this->preprocessEgo(this->lego);
-	this->calculatePermissibleChanges();
-
 	// choose alter
 	int alter = this->lego;
+	int numberPermitted = 0;
 
-	double * cumulativeRates = new double[this->n()];
+	if (this->stepType() == -1)
+	{
+		// Only two permitted alters need to be found, and only the dyad
+		// of the chosen alter needs to be checked.
 
-	int numberPermitted = 0;
-	for (int i = 0; i < this->n(); i++)
+		numberPermitted = this->permittedAlterCount(2);
+	}
+	else
 	{
-		if (this->lpermitted[i] && i != this->lego)
-		{
-			numberPermitted++;
-		}
-		cumulativeRates[i] = this->rate(i);
-		if (i > 0)
+		this->calculatePermissibleChanges();
+
+		for (int i = 0; i < this->n(); i++)
 		{
-			cumulativeRates[i] += cumulativeRates[i - 1];
+			if (this->lpermitted[i] && i != this->lego)
+			{
+				numberPermitted++;
+			}
 		}
-
-    }
+	}
 
 	if (numberPermitted > 1)
 	{
 		while (alter == this->lego)
 		{
-			alter = nextIntWithCumulativeProbabilities(this->n(),
-				cumulativeRates);
+			alter = this->randomActor();
 		}
 	}
 
-	this->lalterProbability = this->rate(alter) / cumulativeRates[this->n() - 1];
-
-	delete [] cumulativeRates;
-
+	this->lalterProbability = this->rate(alter) / this->sumOfRates();
 	this->lalter = alter;
 //	Rprintf("net ego %d alter %d\n",this->lego, this->lalter);
 
-	if (numberPermitted == 0 ||  (!this->lpermitted[alter]) ||
-		alter == this->lego)
+	if (numberPermitted == 0 || alter == this->lego ||
+		(this->stepType() == -1 && !this->permittedAlter(alter)) ||
+		(this->stepType() != -1 && !this->lpermitted[alter]))
 	{
 		return false;
 	}
@@ -2398,7 +2964,7 @@ void NetworkVariable::accumulateDerivatives() const
 	Effect * pEffect1;
 	Effect * pEffect2;
 	double derivative;
-	double * product = new double[totalEffects];
+	double * product = this->lderivativeProducts;
 	double contribution1 = 0.0;
 	double contribution2 = 0.0;
 
@@ -2762,15 +3328,18 @@ void NetworkVariable::initializeSetting() {
 		dynamic_cast<NetworkLongitudinalData *>(this->pData());
 	Setting* setting = lsettings[stepType()];
 	string covariateName = pNetworkData->rSettingNames().at(this->stepType()).getCovarName();
+	const DyadicCovariateMatrix * pValues = 0;
 	if (pSimulation()->pData()->pConstantDyadicCovariate(covariateName)) {
-		setting->initDyadicSetting(
-				pSimulation()->pData()->pConstantDyadicCovariate(covariateName)->rRowValues(
-					ego()), ego());
+		pValues = pSimulation()->pData()->pConstantDyadicCovariate(
+				covariateName)->pValues();
 	}
 	if (pSimulation()->pData()->pChangingDyadicCovariate(covariateName)) {
-		setting->initDyadicSetting(
-				pSimulation()->pData()->pChangingDyadicCovariate(covariateName)->rRowValues(
-					ego(), period()), ego());
+		pValues = pSimulation()->pData()->pChangingDyadicCovariate(
+				covariateName)->pValues(period());
+	}
+	if (pValues) {
+		setting->initDyadicSetting(pValues->rowActors(ego()),
+				pValues->rowSize(ego()), ego());
 	}
 	setting->initSetting(ego());
 }
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "DependentVariable.h"
+#include "utils/WeightTree.h"
 
 namespace siena
 {
@@ -27,6 +28,7 @@ class Network;
 class NetworkLongitudinalData;
 class NetworkCache;
 class PermittedChangeFilter;
+class PermittedSetCache;
 class ITieIterator;
 
 // ----------------------------------------------------------------------------
@@ -86,7 +88,12 @@ private:
 	void preprocessEgo(int ego);
 	void preprocessEgo(const Function * pFunction, int ego);
 	void calculatePermissibleChanges();
+	bool permittedAlter(int alter) const;
+	int permittedAlterCount(int limit) const;
 	void calculateTieFlipContributions();
+	void calculateContributions(const Function * pFunction,
+		int alter,
+		double * contributions) const;
 	void calculateTieFlipProbabilities();
 	void accumulateScores(int alter) const;
 	void accumulateDerivatives() const;
@@ -100,6 +107,12 @@ private:
 	void calculateSymmetricTieFlipProbabilities(int alter, int sub, bool aagree);
 	bool calculateModelTypeBProbabilities();
 	bool diagonalMiniStep(int ego, int alter) const;
+	bool chooseSparseTwoModeAlter(int * pAlter);
+	double tieFlipValue(int alter);
+	bool sparseTwoModeFunction(const Function * pFunction) const;
+	double receiverLogWeight(int alter) const;
+	void calculateReceiverWeights();
+	void updateReceiverWeight(int alter);
 
 	void initializeSetting();
 	// The current state of the network
@@ -144,6 +157,10 @@ private:
 	// Selection probability per each alter
 	double * lprobabilities {};
 
+	// The expected contribution of each effect of the three functions
+	// over the alters, used when accumulating derivatives
+	double * lderivativeProducts {};
+
 	// The cache object for repeated access of various structural properties
 	// of this network during the simulation.
 
@@ -154,6 +171,11 @@ private:
 
 	std::vector<PermittedChangeFilter *> lpermittedChangeFilters;
 
+	// The permitted sets of the egos stored from earlier visits, if
+	// there are filters.
+
+	PermittedSetCache * lpPermittedSetCache {};
+
 	// Vectors of tie flip contributions to effects for models with
 	// cooperation between actor and alter.
 
@@ -191,6 +213,27 @@ private:
 
 	// the model type:
 	NetworkModelType lnetworkModelType;
+
+	// For two-mode networks whose evaluation and creation effects allow
+	// it, the exponential of the part of the contribution of a new tie
+	// that depends on the receiver only, per receiver and relative to
+	// lreceiverWeightOffset, stored for drawing the alter without
+	// evaluating each receiver (see chooseSparseTwoModeAlter).
+	WeightTree lreceiverWeights;
+	double lreceiverWeightOffset {};
+
+	// Indicates if lreceiverWeights and lsparseTwoMode agree with the
+	// current network and parameters
+	bool lreceiverWeightsValid {};
+
+	// Indicates if the effects allow drawing alters by lreceiverWeights
+	bool lsparseTwoMode {};
+
+	// The receivers with a tie or a structural tie variable from the
+	// current ego, in increasing order, and their selection weights
+	std::vector<int> lcandidates;
+	std::vector<double> lcandidateValues;
+	std::vector<double> lcandidateWeights;
 };
 
 
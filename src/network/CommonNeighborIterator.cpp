@@ -1,4 +1,5 @@
 #include "CommonNeighborIterator.h"
+#include "NetworkUtils.h"
 #include "../utils/Utils.h"
 
 namespace siena {
@@ -15,7 +16,11 @@ CommonNeighborIterator::CommonNeighborIterator(const IncidentTieIterator& iter1,
 		const IncidentTieIterator& iter2) :
 		ITieIterator(), //
 		liter1(iter1), //
-		liter2(iter2) {
+		liter2(iter2), //
+		lscanFirst(iter2.indexed()), //
+		lscanSecond(!iter2.indexed() && iter1.indexed()), //
+		lskip(!iter1.indexed() && !iter2.indexed()
+			&& lookupPreferred(iter1, iter2)) {
 	// Make sure they point to the first common actor.
 	this->skipMismatches();
 }
@@ -28,6 +33,14 @@ CommonNeighborIterator::CommonNeighborIterator(const IncidentTieIterator& iter1,
  * Indicates if there are still some common actors to be reported.
  */
 bool CommonNeighborIterator::valid() const {
+	if (this->lscanFirst) {
+		return this->liter1.valid();
+	}
+
+	if (this->lscanSecond) {
+		return this->liter2.valid();
+	}
+
 	return this->liter1.valid() && this->liter2.valid();
 }
 
@@ -39,7 +52,12 @@ int CommonNeighborIterator::actor() const {
 		throw InvalidIteratorException();
 	}
 
-	// Both iterators point to the same actor, so we can use any iterator.
+	// Both iterators point to the same actor, so we can use any iterator
+	// that is traversed.
+	if (this->lscanSecond) {
+		return this->liter2.actor();
+	}
+
 	return this->liter1.actor();
 }
 
@@ -54,8 +72,14 @@ void CommonNeighborIterator::next() {
 	// Advance both iterators until they point to the next common actor
 	// or we run out of actors.
 
-	this->liter1.next();
-	this->liter2.next();
+	if (!this->lscanSecond) {
+		this->liter1.next();
+	}
+
+	if (!this->lscanFirst) {
+		this->liter2.next();
+	}
+
 	this->skipMismatches();
 }
 
@@ -72,6 +96,32 @@ CommonNeighborIterator* CommonNeighborIterator::clone() const {
  * no such an actor, one of the iterators becomes invalid and we stop.
  */
 void CommonNeighborIterator::skipMismatches() {
+	if (this->lscanFirst) {
+		while (liter1.valid() && !liter2.hasNeighbor(liter1.actor())) {
+			liter1.next();
+		}
+		return;
+	}
+
+	if (this->lscanSecond) {
+		while (liter2.valid() && !liter1.hasNeighbor(liter2.actor())) {
+			liter2.next();
+		}
+		return;
+	}
+
+	if (this->lskip) {
+		while (liter1.valid() && liter2.valid()
+				&& liter1.actor() != liter2.actor()) {
+			if (liter1.actor() < liter2.actor()) {
+				liter1.skipTo(liter2.actor());
+			} else {
+				liter2.skipTo(liter1.actor());
+			}
+		}
+		return;
+	}
+
 	while (this->liter1.valid() && this->liter2.valid()
 			&& this->liter1.actor() != this->liter2.actor()) {
 		while (liter1.valid() && liter1.actor() < liter2.actor()) {
@@ -90,7 +140,10 @@ CommonNeighborIterator::CommonNeighborIterator(
 		const CommonNeighborIterator& rhs) :
 		ITieIterator(rhs), //
 		liter1(rhs.liter1), //
-		liter2(rhs.liter2) {
+		liter2(rhs.liter2), //
+		lscanFirst(rhs.lscanFirst), //
+		lscanSecond(rhs.lscanSecond), //
+		lskip(rhs.lskip) {
 	// note there is no need to skip matches this has been down by rhs
 }
 
@@ -99,4 +152,5 @@ CommonNeighborIterator::CommonNeighborIterator(
 void siena::CommonNeighborIterator::reset() {
 	liter1.reset();
 	liter2.reset();
+	this->skipMismatches();
 }
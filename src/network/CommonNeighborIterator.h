@@ -8,7 +8,9 @@ namespace siena {
 
 /**
  * This class defines an iterator over actors that are common to a pair
- * of incident tie iterators.
+ * of incident tie iterators. If the neighbors of one of the iterators are
+ * indexed by a bit row of the network, only the other iterator is traversed
+ * and its actors are looked up in the row.
  */
 class CommonNeighborIterator: ITieIterator {
 public:
@@ -29,6 +31,15 @@ private:
 	IncidentTieIterator liter1;
 	IncidentTieIterator liter2;
 
+	// Indicates if only the first (second) iterator is traversed, as the
+	// neighbors of the other one are indexed.
+	bool lscanFirst;
+	bool lscanSecond;
+
+	// Indicates if the iterators are merged by skipping ahead in logarithmic
+	// time, as one of them has many more ties than the other.
+	bool lskip;
+
 	CommonNeighborIterator& operator=(const CommonNeighborIterator&);
 };
 
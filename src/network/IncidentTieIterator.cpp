@@ -20,7 +20,10 @@ IncidentTieIterator::IncidentTieIterator() :
 		ITieIterator(), //
 		lstart(), //
 		lcurrent(lstart), //
-		lend(lcurrent) {
+		lend(lcurrent), //
+		lpTies(0), //
+		lpNeighborBits(0), //
+		lneighborWordCount(0) {
 }
 
 
@@ -33,14 +36,20 @@ IncidentTieIterator::IncidentTieIterator(const std::map<int, int> & ties) :
 		ITieIterator(), //
 		lstart(ties.begin()), //
 		lcurrent(lstart), //
-		lend(ties.end()) {
+		lend(ties.end()), //
+		lpTies(&ties), //
+		lpNeighborBits(0), //
+		lneighborWordCount(0) {
 }
 
 IncidentTieIterator::IncidentTieIterator(const IncidentTieIterator& rhs) :
 		ITieIterator(rhs), //
 		lstart(rhs.lstart), //
 		lcurrent(rhs.lcurrent), //
-		lend(rhs.lend) {
+		lend(rhs.lend), //
+		lpTies(rhs.lpTies), //
+		lpNeighborBits(rhs.lpNeighborBits), //
+		lneighborWordCount(rhs.lneighborWordCount) {
 }
 
 IncidentTieIterator* IncidentTieIterator::clone() const {
@@ -58,7 +67,26 @@ IncidentTieIterator::IncidentTieIterator(const std::map<int, int> & ties,
 		ITieIterator(), //
 		lstart(ties.lower_bound(lowerBound)), //
 		lcurrent(lstart), //
-		lend(ties.end()) {
+		lend(ties.end()), //
+		lpTies(&ties), //
+		lpNeighborBits(0), //
+		lneighborWordCount(0) {
+}
+
+//
+// Creates an iterator over a collection of ties represented by the
+// given map, whose neighbors are also indexed by the given bit row,
+// unless the row is empty.
+//
+IncidentTieIterator::IncidentTieIterator(const std::map<int, int> & ties,
+		const std::vector<std::uint64_t> & rNeighborBits) :
+		ITieIterator(), //
+		lstart(ties.begin()), //
+		lcurrent(lstart), //
+		lend(ties.end()), //
+		lpTies(&ties), //
+		lpNeighborBits(rNeighborBits.empty() ? 0 : rNeighborBits.data()), //
+		lneighborWordCount(rNeighborBits.size()) {
 }
 
 }
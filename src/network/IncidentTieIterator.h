@@ -13,6 +13,8 @@
 #define INCIDENTTIEITERATOR_H_
 
 #include <map>
+#include <vector>
+#include <cstdint>
 
 #include "iterators/ITieIterator.h"
 
@@ -74,11 +76,64 @@ public:
 		lcurrent = lstart;
 	}
 
+	/**
+	 * Indicates if the neighbors of this iterator are indexed by a bit
+	 * row and all of them are still ahead of the iterator, such that
+	 * hasNeighbor and the bit row can be used instead of the iterator.
+	 */
+	inline bool indexed() const {
+		return lpNeighborBits && lcurrent == lstart;
+	}
+
+	/**
+	 * Returns the bit row of an indexed iterator.
+	 */
+	inline const std::uint64_t * neighborBits() const {
+		return lpNeighborBits;
+	}
+
+	/**
+	 * Returns the number of words of the bit row of an indexed iterator.
+	 */
+	inline unsigned neighborWordCount() const {
+		return lneighborWordCount;
+	}
+
+	/**
+	 * Returns the number of ties of the underlying collection, including
+	 * the ones before a lower bound or the current position.
+	 */
+	inline int neighborCount() const {
+		return lpTies ? lpTies->size() : 0;
+	}
+
+	/**
+	 * Moves the iterator to the first tie whose neighbor is not less than
+	 * the given actor, in logarithmic time.
+	 */
+	inline void skipTo(int actor) {
+		if (lcurrent != lend && lcurrent->first < actor) {
+			lcurrent = lpTies->lower_bound(actor);
+		}
+	}
+
+	/**
+	 * Returns if the given actor is among all neighbors of this iterator,
+	 * regardless of the current position. Requires an indexed iterator.
+	 */
+	inline bool hasNeighbor(int actor) const {
+		unsigned word = actor >> 6;
+		return word < lneighborWordCount &&
+			((lpNeighborBits[word] >> (actor & 63)) & 1);
+	}
+
 	IncidentTieIterator* clone() const;
 
 private:
 	IncidentTieIterator(const std::map<int, int> & ties);
 	IncidentTieIterator(const std::map<int, int> & ties, int lowerBound);
+	IncidentTieIterator(const std::map<int, int> & ties,
+		const std::vector<std::uint64_t> & rNeighborBits);
 
 
 	/////////////////////////////////////////////////////////
@@ -92,6 +147,14 @@ private:
 
 	// Points to the end of the underlying map
 	std::map<int, int>::const_iterator lend;
+
+	// The underlying map, or 0 for a dummy iterator
+	const std::map<int, int> * lpTies;
+
+	// The bit row of the neighbors kept by the network for actors with
+	// many ties, or 0, and its number of words
+	const std::uint64_t * lpNeighborBits;
+	unsigned lneighborWordCount;
 };
 
 }
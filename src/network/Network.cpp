@@ -13,6 +13,7 @@
 
 #include <map>
 #include <stdexcept>
+#include <mutex>
 #include <limits>
 #include <algorithm>
 
@@ -24,6 +25,26 @@
 
 namespace siena {
 
+// ----------------------------------------------------------------------------
+// Section: Local declarations
+// ----------------------------------------------------------------------------
+
+namespace {
+
+// The number of ties from which the ties of an actor are indexed by a bit
+// row. The row is released when the number of ties falls below half of this
+// number, so that an actor near the threshold does not rebuild it often.
+const unsigned INDEXED_TIE_COUNT = 32;
+
+/**
+ * Returns if the bit of the given actor is set in the given row.
+ */
+inline bool hasBit(const std::vector<std::uint64_t> & rRow, int actor) {
+	return (rRow[actor >> 6] >> (actor & 63)) & 1;
+}
+
+}
+
 // ----------------------------------------------------------------------------
 // Section: Construction and destruction
 // ----------------------------------------------------------------------------
@@ -75,6 +96,8 @@ Network::Network(const Network & rNetwork) {
 				rNetwork.lpInTies[i].end());
 	}
 
+	this->loutTieRows = rNetwork.loutTieRows;
+	this->linTieRows = rNetwork.linTieRows;
 	this->ltieCount = rNetwork.ltieCount;
 	this->lmodificationCount = 0;
 }
@@ -117,6 +140,8 @@ Network & Network::operator=(const Network & rNetwork) {
 					rNetwork.lpInTies[i].end());
 		}
 
+		this->loutTieRows = rNetwork.loutTieRows;
+		this->linTieRows = rNetwork.linTieRows;
 		this->ltieCount = rNetwork.ltieCount;
 		this->lmodificationCount++;
 	}
@@ -147,6 +172,8 @@ void Network::allocateArrays() {
 
 	this->lpOutTies = new std::map<int, int>[this->ln];
 	this->lpInTies = new std::map<int, int>[this->lm];
+	this->loutTieRows.assign(this->ln, std::vector<std::uint64_t>());
+	this->linTieRows.assign(this->lm, std::vector<std::uint64_t>());
 }
 
 /**
@@ -158,6 +185,8 @@ void Network::deleteArrays() {
 
 	this->lpOutTies = 0;
 	this->lpInTies = 0;
+	this->loutTieRows.clear();
+	this->linTieRows.clear();
 }
 
 /**
@@ -248,6 +277,8 @@ int Network::changeTieValue(int i, int j, int v, ChangeType type) {
 			// since we don't have to find the element.
 			egoMap.erase(iter);
 			this->lpInTies[j].erase(i);
+			this->unindexTie(this->loutTieRows[i], egoMap, j);
+			this->unindexTie(this->linTieRows[j], this->lpInTies[j], i);
 		} else {
 			// the value of the edge has been changed
 			iter->second = v;
@@ -258,6 +289,8 @@ int Network::changeTieValue(int i, int j, int v, ChangeType type) {
 		// as a hint speeds things up.
 		egoMap.insert(iter, std::map<int, int>::value_type(j, v));
 		lpInTies[j].insert(std::map<int, int>::value_type(i, v));
+		this->indexTie(this->loutTieRows[i], egoMap, j, this->lm);
+		this->indexTie(this->linTieRows[j], this->lpInTies[j], i, this->ln);
 	}
 	// Remember that the network has changed
 	this->lmodificationCount++;
@@ -300,6 +333,14 @@ int Network::tieValue(int i, int j) const {
 	this->checkSenderRange(i);
 	this->checkReceiverRange(j, "tieValue");
 
+	// The bit row of a sender with many ties tells at once if there is
+	// no tie.
+	const std::vector<std::uint64_t> & rRow = this->loutTieRows[i];
+
+	if (!rRow.empty() && !hasBit(rRow, j)) {
+		return 0;
+	}
+
 	// Look for the tie
 	std::map<int, int>::const_iterator iter = this->lpOutTies[i].find(j);
 
@@ -328,6 +369,9 @@ void Network::clear() {
 		this->lpInTies[i].clear();
 	}
 
+	this->loutTieRows.assign(this->ln, std::vector<std::uint64_t>());
+	this->linTieRows.assign(this->lm, std::vector<std::uint64_t>());
+
 	// The ties are gone.
 	this->ltieCount = 0;
 
@@ -378,7 +422,7 @@ TieIterator Network::ties() const {
  */
 IncidentTieIterator Network::inTies(int i) const {
 	this->checkReceiverRange(i, "inTies");
-	return IncidentTieIterator(this->lpInTies[i]);
+	return IncidentTieIterator(this->lpInTies[i], this->linTieRows[i]);
 }
 
 
@@ -387,7 +431,7 @@ IncidentTieIterator Network::inTies(int i) const {
  */
 IncidentTieIterator Network::inTies(int i, std::string mess) const {
 	this->checkReceiverRange(i, mess + " inTies");
-	return IncidentTieIterator(this->lpInTies[i]);
+	return IncidentTieIterator(this->lpInTies[i], this->linTieRows[i]);
 }
 
 /**
@@ -413,7 +457,7 @@ IncidentTieIterator Network::inTies(int i, int lowerBound) const {
  */
 IncidentTieIterator Network::outTies(int i) const {
 	this->checkSenderRange(i);
-	return IncidentTieIterator(this->lpOutTies[i]);
+	return IncidentTieIterator(this->lpOutTies[i], this->loutTieRows[i]);
 }
 
 // ----------------------------------------------------------------------------
@@ -532,6 +576,11 @@ bool Network::complete() const {
 bool Network::hasEdge(int ego, int alter) const {
 	checkSenderRange(ego);
 	checkReceiverRange(alter, "hasEdge");
+
+	if (!this->loutTieRows[ego].empty()) {
+		return hasBit(this->loutTieRows[ego], alter);
+	}
+
 	return lpOutTies[ego].find(alter) != lpOutTies[ego].end();
 }
 
@@ -586,26 +635,45 @@ void Network::checkReceiverRange(int i, std::string message) const {
 	}
 }
 
+namespace {
+
+/**
+ * Serializes the changes of the listener lists. The observed networks are
+ * shared by simulations running on several threads, each of which attaches
+ * the configuration tables of its own statistic calculations to them.
+ */
+std::mutex & listenerMutex() {
+	static std::mutex lmutex;
+	return lmutex;
+}
+
+}
+
 /**
  * Adds the given <i>listener</i> from the network, if it is not yet attached.
  */
 void Network::addNetworkChangeListener(
-		INetworkChangeListener* const listener) {
-	// ensure that the list is a set (no duplicates)
-	std::list<INetworkChangeListener*>::iterator tmp = std::find(
-			lNetworkChangeListener.begin(), lNetworkChangeListener.end(),
-			listener);
-	if (tmp == lNetworkChangeListener.end()) {
+		INetworkChangeListener* const listener) const {
+	{
+		std::lock_guard<std::mutex> lock(listenerMutex());
+		// ensure that the list is a set (no duplicates)
+		std::list<INetworkChangeListener*>::iterator tmp = std::find(
+				lNetworkChangeListener.begin(), lNetworkChangeListener.end(),
+				listener);
+		if (tmp != lNetworkChangeListener.end()) {
+			return;
+		}
 		lNetworkChangeListener.push_back(listener);
-		listener->onInitializationEvent(*this);
 	}
+	listener->onInitializationEvent(*this);
 }
 
 /**
  * Removes the given <i>listener</i> from the network.
  */
 void Network::removeNetworkChangeListener(
-		INetworkChangeListener* const listener) {
+		INetworkChangeListener* const listener) const {
+	std::lock_guard<std::mutex> lock(listenerMutex());
 	std::list<INetworkChangeListener*>::iterator tmp = std::find(
 			lNetworkChangeListener.begin(), lNetworkChangeListener.end(),
 			listener);
@@ -615,11 +683,19 @@ void Network::removeNetworkChangeListener(
 	}
 }
 
+/**
+ * Informs all listeners that the contents of the network are discarded,
+ * either because the network is destroyed or because it is assigned
+ * another network. Listeners may remove themselves from the network while
+ * handling the event.
+ */
 void Network::fireNetworkDisposeEvent() {
-	for (std::list<INetworkChangeListener*>::const_iterator iter =
+	std::list<INetworkChangeListener*>::const_iterator iter =
 			lNetworkChangeListener.begin();
-			iter != lNetworkChangeListener.end(); ++iter) {
-		(*iter)->onNetworkDisposeEvent(*this);
+	while (iter != lNetworkChangeListener.end()) {
+		INetworkChangeListener* listener = *iter;
+		++iter;
+		listener->onNetworkDisposeEvent(*this);
 	}
 }
 
@@ -651,6 +727,46 @@ bool Network::isOneMode() const {
 	return false;
 }
 
+/**
+ * Records the new tie to the given actor in the bit row of a neighbor set
+ * that already contains the tie, creating the row over the given number of
+ * actors when the set reaches INDEXED_TIE_COUNT ties.
+ */
+void Network::indexTie(std::vector<std::uint64_t> & rRow,
+		const std::map<int, int> & rTies,
+		int actor,
+		int actorCount) {
+	if (!rRow.empty()) {
+		rRow[actor >> 6] |= std::uint64_t(1) << (actor & 63);
+	} else if (rTies.size() >= INDEXED_TIE_COUNT) {
+		rRow.assign((actorCount + 63) / 64, 0);
+
+		for (std::map<int, int>::const_iterator iter = rTies.begin();
+				iter != rTies.end(); ++iter) {
+			rRow[iter->first >> 6] |= std::uint64_t(1) << (iter->first & 63);
+		}
+	}
+}
+
+/**
+ * Removes the withdrawn tie to the given actor from the bit row of a
+ * neighbor set, releasing the row when the set has fewer than half of
+ * INDEXED_TIE_COUNT ties left.
+ */
+void Network::unindexTie(std::vector<std::uint64_t> & rRow,
+		const std::map<int, int> & rTies,
+		int actor) {
+	if (rRow.empty()) {
+		return;
+	}
+
+	if (rTies.size() < INDEXED_TIE_COUNT / 2) {
+		std::vector<std::uint64_t>().swap(rRow);
+	} else {
+		rRow[actor >> 6] &= ~(std::uint64_t(1) << (actor & 63));
+	}
+}
+
 /**
  * Inform all listeners that edge (ego,alter) has been removed to the network.
  */
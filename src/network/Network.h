@@ -15,6 +15,8 @@
 #include <map>
 #include <list>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 namespace siena {
 
@@ -85,9 +87,10 @@ public:
 	int inTwoStarCount(int i, int j) const;
 	int twoPathCount(int i, int j) const;
 
-	void addNetworkChangeListener(INetworkChangeListener* const listener);
+	void addNetworkChangeListener(INetworkChangeListener* const listener) const;
 
-	void removeNetworkChangeListener(INetworkChangeListener* const listener);
+	void removeNetworkChangeListener(
+			INetworkChangeListener* const listener) const;
 
 	inline int modificationCount() const;
 
@@ -100,8 +103,9 @@ protected:
 	void checkReceiverRange(int i, std::string message) const;
 	virtual int maxTieCount() const;
 
-	// set of network change listener
-	std::list<INetworkChangeListener*> lNetworkChangeListener;
+	// set of network change listener; listening does not change the network,
+	// so listeners can be attached to const networks.
+	mutable std::list<INetworkChangeListener*> lNetworkChangeListener;
 private:
 	void allocateArrays();
 	void deleteArrays();
@@ -109,6 +113,13 @@ private:
 	void fireNetworkClearEvent() const;
 	void fireIntroductionEvent(int ego, int alter) const;
 	void fireWithdrawalEvent(int ego, int alter) const;
+	void indexTie(std::vector<std::uint64_t> & rRow,
+		const std::map<int, int> & rTies,
+		int actor,
+		int actorCount);
+	void unindexTie(std::vector<std::uint64_t> & rRow,
+		const std::map<int, int> & rTies,
+		int actor);
 
 	// The number of senders
 	int ln {};
@@ -126,6 +137,15 @@ private:
 
 	std::map<int, int> * lpInTies;
 
+	// Bit rows indexing the outgoing ties of the senders and the incoming
+	// ties of the receivers with many ties, so that the existence of a tie
+	// of such an actor is looked up in constant time. Bit j of row
+	// loutTieRows[i] is set if there is a tie (i,j), and bit i of row
+	// linTieRows[j] likewise. The rows of the other actors are empty.
+
+	std::vector<std::vector<std::uint64_t> > loutTieRows;
+	std::vector<std::vector<std::uint64_t> > linTieRows;
+
 	// The number of ties of this network
 	int ltieCount {};
 
@@ -8,6 +8,9 @@
  * Description: This module contains some utilities specific to the
  * 'data' library.
  *****************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <set>
 #include "NetworkUtils.h"
@@ -19,28 +22,134 @@
 namespace siena
 {
 
+// ----------------------------------------------------------------------------
+// Section: Local declarations
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// The ratio of the numbers of ties of two iterators above which the common
+// actors are found by looking up the actors of the shorter iterator in the
+// longer one rather than by merging both.
+const int LOOKUP_RATIO = 16;
+
+}
+
+
 /**
  * Returns the number of actors iterated over by both of the given iterators.
  */
 int commonActorCount(IncidentTieIterator iter1, IncidentTieIterator iter2)
 {
+	return commonActorCount(iter1, iter2, std::numeric_limits<int>::max());
+}
+
+
+/**
+ * Returns the number of actors iterated over by both of the given iterators,
+ * but at most the given threshold; the counting stops as soon as the
+ * threshold is reached. Depending on the iterators, the bit rows of two
+ * indexed iterators are intersected word by word, the actors of one
+ * iterator are looked up in the bit row or the ties of the other, or the
+ * two sorted sequences of actors are merged.
+ */
+int commonActorCount(IncidentTieIterator iter1, IncidentTieIterator iter2,
+	int threshold)
+{
+	int count = 0;
+
+	if (iter1.indexed() && iter2.indexed())
+	{
+		const std::uint64_t * pBits1 = iter1.neighborBits();
+		const std::uint64_t * pBits2 = iter2.neighborBits();
+		unsigned wordCount =
+			std::min(iter1.neighborWordCount(), iter2.neighborWordCount());
+
+		for (unsigned word = 0; word < wordCount && count < threshold; word++)
+		{
+			count += __builtin_popcountll(pBits1[word] & pBits2[word]);
+		}
+
+		return std::min(count, threshold);
+	}
+
+	if (iter1.indexed())
+	{
+		std::swap(iter1, iter2);
+	}
+
+	if (iter2.indexed())
+	{
+		for (; iter1.valid() && count < threshold; iter1.next())
+		{
+			count += iter2.hasNeighbor(iter1.actor());
+		}
+
+		return count;
+	}
+
 	// Note that ties incident to an actor are sorted in an increasing order
 	// of its neighbors.
 
-	int count = 0;
+	if (lookupPreferred(iter1, iter2))
+	{
+		if (iter1.neighborCount() > iter2.neighborCount())
+		{
+			std::swap(iter1, iter2);
+		}
 
-	CommonNeighborIterator iter(iter1, iter2);
+		for (; iter1.valid() && iter2.valid() && count < threshold;
+			iter1.next())
+		{
+			iter2.skipTo(iter1.actor());
 
-	while (iter.valid())
+			if (iter2.valid() && iter2.actor() == iter1.actor())
+			{
+				count++;
+			}
+		}
+
+		return count;
+	}
+
+	while (iter1.valid() && iter2.valid() && count < threshold)
 	{
-		count++;
-		iter.next();
+		if (iter1.actor() < iter2.actor())
+		{
+			iter1.next();
+		}
+		else if (iter1.actor() > iter2.actor())
+		{
+			iter2.next();
+		}
+		else
+		{
+			count++;
+			iter1.next();
+			iter2.next();
+		}
 	}
 
 	return count;
 }
 
 
+/**
+ * Indicates if the common actors of the given iterators are better found by
+ * looking up the actors of one iterator in the ties of the other, as the
+ * numbers of their ties differ widely.
+ */
+bool lookupPreferred(const IncidentTieIterator & iter1,
+	const IncidentTieIterator & iter2)
+{
+	int count1 = iter1.neighborCount();
+	int count2 = iter2.neighborCount();
+
+	return count1 > LOOKUP_RATIO * count2 || count2 > LOOKUP_RATIO * count1;
+}
+
+
 /**
  * Creates a new network representing the symmetric difference of the
  * two given networks.
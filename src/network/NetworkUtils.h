@@ -40,6 +40,10 @@ class Network;
 // ----------------------------------------------------------------------------
 
 int commonActorCount(IncidentTieIterator iter1, IncidentTieIterator iter2);
+int commonActorCount(IncidentTieIterator iter1, IncidentTieIterator iter2,
+	int threshold);
+bool lookupPreferred(const IncidentTieIterator & iter1,
+	const IncidentTieIterator & iter2);
 Network * symmetricDifference(const Network * pNetwork1,
 	const Network * pNetwork2);
 
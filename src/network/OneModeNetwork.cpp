@@ -9,6 +9,8 @@
  * OneModeNetwork class.
  *****************************************************************************/
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <stdexcept>
 #include <string>
@@ -18,6 +20,7 @@
 #include "network/CommonNeighborIterator.h"
 #include "network/INetworkChangeListener.h"
 #include "network/UnionNeighborIterator.h"
+#include "network/NetworkUtils.h"
 
 namespace siena {
 
@@ -287,27 +290,10 @@ int OneModeNetwork::truncatedTwoPathCount(int i, int j, int threshold) const {
 	this->checkSenderRange(i);
 	this->checkReceiverRange(j, "truncatedTwoPathCount");
 
-	// Iterate the outgoing ties of i and incoming ties of j simultaneously
-	// and count the number of matching neighbors. Stop as soon as the
-	// threshold value is reached.
+	// Count the neighbors common to the outgoing ties of i and incoming
+	// ties of j, stopping as soon as the threshold value is reached.
 
-	IncidentTieIterator outIter = this->outTies(i);
-	IncidentTieIterator inIter = this->inTies(j);
-	int count = 0;
-
-	while (outIter.valid() && inIter.valid() && count < threshold) {
-		if (outIter.actor() < inIter.actor()) {
-			outIter.next();
-		} else if (outIter.actor() > inIter.actor()) {
-			inIter.next();
-		} else {
-			count++;
-			outIter.next();
-			inIter.next();
-		}
-	}
-
-	return count;
+	return commonActorCount(this->outTies(i), this->inTies(j), threshold);
 }
 
 /**
@@ -362,26 +348,10 @@ bool OneModeNetwork::atMostKTwoPaths(int i, int j, int k,
 	this->checkSenderRange(i);
 	this->checkReceiverRange(j,"atMostKTwoPaths");
 
-	// Iterate the outgoing ties of i and incoming ties of j simultaneously
-	// and count the number of matching neighbors. Stop as soon as their number
-	// exceeds k.
-
-	IncidentTieIterator outIter = this->outTies(i);
-	IncidentTieIterator inIter = this->inTies(j);
-	twoPathCount = 0;
-
-	while (outIter.valid() && inIter.valid() && twoPathCount <= k) {
-		if (outIter.actor() < inIter.actor()) {
-			outIter.next();
-		} else if (outIter.actor() > inIter.actor()) {
-			inIter.next();
-		} else {
-			twoPathCount++;
-			outIter.next();
-			inIter.next();
-		}
-	}
+	// Count the neighbors common to the outgoing ties of i and incoming
+	// ties of j, stopping as soon as their number exceeds k.
 
+	twoPathCount = commonActorCount(this->outTies(i), this->inTies(j), k + 1);
 	return twoPathCount <= k;
 }
 
@@ -400,6 +370,38 @@ void OneModeNetwork::neighborCensus(int i, int j, int & n3, int & n4) const {
 	IncidentTieIterator iterators[] = { this->inTies(i), this->outTies(i),
 			this->inTies(j), this->outTies(j) };
 
+	if (iterators[0].indexed() && iterators[1].indexed()
+			&& iterators[2].indexed() && iterators[3].indexed()) {
+		// All four neighbor sets are indexed by bit rows. Per word, the
+		// actors in all four sets are a & b & c & d, and the ones in at
+		// least three sets are (a & b & (c | d)) | (c & d & (a | b)).
+
+		const std::uint64_t * pA = iterators[0].neighborBits();
+		const std::uint64_t * pB = iterators[1].neighborBits();
+		const std::uint64_t * pC = iterators[2].neighborBits();
+		const std::uint64_t * pD = iterators[3].neighborBits();
+		unsigned wordCount = iterators[0].neighborWordCount();
+
+		for (int k = 1; k < 4; k++) {
+			wordCount = std::min(wordCount, iterators[k].neighborWordCount());
+		}
+
+		n3 = 0;
+		n4 = 0;
+
+		for (unsigned word = 0; word < wordCount; word++) {
+			std::uint64_t ab = pA[word] & pB[word];
+			std::uint64_t cd = pC[word] & pD[word];
+			std::uint64_t all = ab & cd;
+			std::uint64_t atLeastThree = (ab & (pC[word] | pD[word]))
+					| (cd & (pA[word] | pB[word]));
+			n4 += __builtin_popcountll(all);
+			n3 += __builtin_popcountll(atLeastThree & ~all);
+		}
+
+		return;
+	}
+
 	// How many of these iterators are valid?
 
 	int validIteratorCount = 0;
@@ -15,6 +15,7 @@
  */
 #include <vector>
 #include <cstring>
+#include <stdexcept>
 // #include <Rinternals.h> // included by siena07internals.h
 #include "siena07internals.h"
 #include "data/Data.h"
@@ -1229,6 +1230,7 @@ void setupDyadicCovariateGroup(SEXP DYADVARGROUP, Data *pData)
 					myActorSet1, myActorSet2);
 		setupDyadicCovariate(VECTOR_ELT(DYADVARGROUP, dyadicCovariate),
 				pConstantDyadicCovariate);
+		pConstantDyadicCovariate->selectStorage();
 		SEXP mean;
 		PROTECT(mean = Rf_install("mean"));
 		SEXP Mean = Rf_getAttrib(VECTOR_ELT(DYADVARGROUP, dyadicCovariate),
@@ -1320,6 +1322,7 @@ void setupChangingDyadicCovariateGroup(SEXP VARDYADGROUP, Data * pData)
 		setupChangingDyadicObservations(VECTOR_ELT(VARDYADGROUP,
 					changingDyadic),
 				pChangingDyadicCovariate);
+		pChangingDyadicCovariate->selectStorage();
 		SEXP mean;
 		PROTECT(mean = Rf_install("mean"));
 		SEXP Mean = Rf_getAttrib(VECTOR_ELT(VARDYADGROUP, changingDyadic),
@@ -1589,13 +1592,14 @@ SEXP createInteractionEffects(SEXP EFFECTS, Model *pModel,
 }
 
 /**
- *  Retrieves the contributions to all possible tie flips or behavior changes for each of the effects,
- *  for one period. The call will relate to one group only, although all effects
- *  are the same apart from the basic rates. Not used in maximum likelihood.
+ *  Retrieves the effects for which the contributions to all possible tie flips
+ *  or behavior changes are calculated, in the order of the effects list.
+ *  The effects are the same for all groups and periods.
+ *  Not used in maximum likelihood.
  */
 
-void getChangeContributionStatistics(SEXP EFFECTSLIST,
-		const StatisticCalculator * pCalculator, vector<vector<double *> > *rChangeContributions)
+void getChangeContributionEffects(SEXP EFFECTSLIST,
+		vector<EffectInfo *> * rEffects)
 {
     // get the column names from the names attribute
     SEXP cols = PROTECT(Rf_install("names"));
@@ -1643,10 +1647,7 @@ void getChangeContributionStatistics(SEXP EFFECTSLIST,
                 if (strcmp(effectType, "eval") == 0)
                 {
 					EffectInfo * pEffectInfo = (EffectInfo *) R_ExternalPtrAddr(VECTOR_ELT(VECTOR_ELT(EFFECTS,pointerCol), i));
-					if(rChangeContributions != 0)
-                    {
-						rChangeContributions->push_back(pCalculator->staticChangeContributions(pEffectInfo));
-                    }
+					rEffects->push_back(pEffectInfo);
                 }
             }
         }
@@ -1718,15 +1719,11 @@ void getActorStatistics(SEXP EFFECTSLIST,
 }
 
 /**
- *  Retrieves the values of the statistics and scores for each of the effects,
- *  for one period. The call will relate to one group only, although all effects
- *  are the same apart from the basic rates. Not used in maximum likelihood.
+ *  Reads the description of the statistic of each of the effects from the
+ *  effects object, in the order of the parameters.
  */
-void getStatistics(SEXP EFFECTSLIST,
-		const StatisticCalculator * pCalculator,
-		int period, int group, const Data *pData,
-		const EpochSimulation * pEpochSimulation,
-		vector<double> * rfra, vector<double> *rscore)
+void getStatisticRequests(SEXP EFFECTSLIST,
+		vector<StatisticRequest> * pRequests)
 {
 
 	// get the column names from the names attribute
@@ -1758,10 +1755,7 @@ void getStatistics(SEXP EFFECTSLIST,
 			&rateTypeCol, &intptr1Col, &intptr2Col, &intptr3Col,
 			&settingCol);
 
-
-	double statistic = 0;
-	double score = 0;
-	int istore = 0;
+	pRequests->clear();
 
 	for (int ii = 0; ii < Rf_length(EFFECTSLIST); ii++)
 	{
@@ -1772,47 +1766,147 @@ void getStatistics(SEXP EFFECTSLIST,
 
 		for (int i = 0; i < Rf_length(VECTOR_ELT(EFFECTS,0)); i++)
 		{
-			const char * effectName =
+			StatisticRequest request;
+			request.networkName = networkName;
+			request.effectName =
 				CHAR(STRING_ELT(VECTOR_ELT(EFFECTS, effectCol),  i));
-			//	int parm = INTEGER(VECTOR_ELT(EFFECTS, parmCol))[i];
-			const char * interaction1 =
+			request.interaction1 =
 				CHAR(STRING_ELT(VECTOR_ELT(EFFECTS, int1Col),i));
-			//	const char * interaction2 =
-			//CHAR(STRING_ELT(VECTOR_ELT(EFFECTS, int2Col), i));
-			//double initialValue =
-			//REAL(VECTOR_ELT(EFFECTS, initValCol))[i];
-			const char * effectType =
+			request.effectType =
 				CHAR(STRING_ELT(VECTOR_ELT(EFFECTS, typeCol), i));
-			const char * netType =
+			request.netType =
 				CHAR(STRING_ELT(VECTOR_ELT(EFFECTS, netTypeCol), i));
-			const char * rateType =
+			request.rateType =
 				CHAR(STRING_ELT(VECTOR_ELT(EFFECTS, rateTypeCol), i));
-			const char * setting =
+			request.setting =
 				CHAR(STRING_ELT(VECTOR_ELT(EFFECTS, settingCol), i));
-			//	Rprintf("%s %s \n", effectType, netType);
-			if (strcmp(effectType, "rate") == 0)
+
+			if (request.effectType == "rate" &&
+				(request.effectName == "Rate" ||
+					request.effectName == "scale"))
+			{
+				request.group = INTEGER(VECTOR_ELT(EFFECTS, groupCol))[i] - 1;
+				request.period =
+					INTEGER(VECTOR_ELT(EFFECTS, periodCol))[i] - 1;
+			}
+			else if (request.effectType == "rate" ||
+				request.effectType == "eval" ||
+				request.effectType == "endow" ||
+				request.effectType == "creation" ||
+				request.effectType == "gmm")
+			{
+				request.pEffectInfo = (EffectInfo *)
+					R_ExternalPtrAddr(
+							VECTOR_ELT(VECTOR_ELT(EFFECTS,
+									pointerCol), i));
+			}
+			else
+			{
+				Rf_error("invalid effect type %s\n",
+					request.effectType.c_str());
+			}
+
+			pRequests->push_back(request);
+		}
+	}
+	UNPROTECT(1);
+}
+
+/**
+ *  Retrieves the values of the statistics and scores for each of the effects,
+ *  for one period. The call will relate to one group only, although all effects
+ *  are the same apart from the basic rates. Not used in maximum likelihood.
+ */
+void getStatistics(SEXP EFFECTSLIST,
+		const StatisticCalculator * pCalculator,
+		int period, int group, const Data *pData,
+		const EpochSimulation * pEpochSimulation,
+		vector<double> * rfra, vector<double> *rscore)
+{
+	vector<StatisticRequest> requests;
+	getStatisticRequests(EFFECTSLIST, &requests);
+	getStatistics(requests, pCalculator, period, group, pData,
+		pEpochSimulation, rfra, rscore);
+}
+
+/**
+ *  Retrieves the values of the statistics and scores for the given
+ *  statistic requests, for one period. Does not use the R API, so that it
+ *  can be called for simulations running on other threads; errors are
+ *  reported by exceptions.
+ */
+void getStatistics(const vector<StatisticRequest> & rRequests,
+		const StatisticCalculator * pCalculator,
+		int period, int group, const Data *pData,
+		const EpochSimulation * pEpochSimulation,
+		vector<double> * rfra, vector<double> *rscore)
+{
+	double statistic = 0;
+	double score = 0;
+
+	for (unsigned istore = 0; istore < rRequests.size(); istore++)
+	{
+		const StatisticRequest & rRequest = rRequests[istore];
+		const char * networkName = rRequest.networkName.c_str();
+		const string & effectName = rRequest.effectName;
+		const char * interaction1 = rRequest.interaction1.c_str();
+		const string & effectType = rRequest.effectType;
+		const string & netType = rRequest.netType;
+		const string & rateType = rRequest.rateType;
+		const string & setting = rRequest.setting;
+		EffectInfo * pEffectInfo = rRequest.pEffectInfo;
+
+		if (effectType == "rate")
+		{
+			if (effectName == "Rate" || effectName == "scale")
 			{
-				if (strcmp(effectName, "Rate") == 0 ||
-					strcmp(effectName, "scale") == 0)
+				if (rRequest.period == period && rRequest.group == group)
 				{
-					int groupno =
-						INTEGER(VECTOR_ELT(EFFECTS, groupCol))[i];
-					int periodno =
-						INTEGER(VECTOR_ELT(EFFECTS, periodCol))[i];
-					if ((periodno - 1) == period && (groupno - 1) == group)
+
+					if (netType == "behavior")
 					{
+						LongitudinalData * pNetworkData =
+							pData->pBehaviorData(networkName);
+						statistic = pCalculator->distance(pNetworkData,
+								period);
+						if (pEpochSimulation)
+						{
+							const DependentVariable * pVariable =
+								pEpochSimulation->pVariable(networkName);
+							score = pVariable->basicRateScore();
+						}
+						else
+						{
+							score = 0;
+						}
+					}
+					else if (netType == "continuous")
+					{
+						statistic = pCalculator->totalDistance(period);
 
-						if (strcmp(netType, "behavior") == 0)
+						if (pEpochSimulation)
+						{
+							score = pEpochSimulation->pSdeSimulation()->basicScaleScore();
+						}
+						else
+						{
+							score = 0;
+						}
+					}
+					else
+					{
+						if (setting == "")
 						{
 							LongitudinalData * pNetworkData =
-								pData->pBehaviorData(networkName);
+								pData->pNetworkData(networkName);
 							statistic = pCalculator->distance(pNetworkData,
 									period);
-							//	Rprintf("%f behavior dist\n", statistic);
 							if (pEpochSimulation)
 							{
+								/* find  dependent variable for the score */
 								const DependentVariable * pVariable =
-									pEpochSimulation->pVariable(networkName);
+									pEpochSimulation->
+									pVariable(networkName);
 								score = pVariable->basicRateScore();
 							}
 							else
@@ -1820,327 +1914,214 @@ void getStatistics(SEXP EFFECTSLIST,
 								score = 0;
 							}
 						}
-						else if (strcmp(netType, "continuous") == 0)
+						else
 						{
-							statistic = pCalculator->totalDistance(period);
-
+							LongitudinalData * pNetworkData =
+								pData->pNetworkData(networkName);
+							statistic =
+								pCalculator->settingDistance(pNetworkData,
+										setting, period);
 							if (pEpochSimulation)
 							{
-								score = pEpochSimulation->pSdeSimulation()->basicScaleScore();
-								// Rprintf("The tau score gets update with %f\n", score); NYNKE
+								/* find dependent variable for the score */
+								const DependentVariable * pVariable =
+									pEpochSimulation->
+									pVariable(networkName);
+								score =
+									pVariable->settingRateScore(setting);
 							}
 							else
 							{
 								score = 0;
 							}
-						}
-						else
-						{
-							if (strcmp(setting, "") == 0)
-							{
-								LongitudinalData * pNetworkData =
-									pData->pNetworkData(networkName);
-								statistic = pCalculator->distance(pNetworkData,
-										period);
-								if (pEpochSimulation)
-								{
-									/* find  dependent variable for the score */
-									const DependentVariable * pVariable =
-										pEpochSimulation->
-										pVariable(networkName);
-									score = pVariable->basicRateScore();
-								}
-								else
-								{
-									score = 0;
-								}
-							}
-							else
-							{
-								LongitudinalData * pNetworkData =
-									pData->pNetworkData(networkName);
-								statistic =
-									pCalculator->settingDistance(pNetworkData,
-											setting, period);
-								if (pEpochSimulation)
-								{
-									/* find dependent variable for the score */
-									const DependentVariable * pVariable =
-										pEpochSimulation->
-										pVariable(networkName);
-									score =
-										pVariable->settingRateScore(setting);
-								}
-								else
-								{
-									score = 0;
-								}
 
-							}
 						}
 					}
-					else
-					{
-						statistic = 0;
-						score = 0;
-					}
 				}
-				else if (strcmp(rateType, "structural") == 0)
+				else
+				{
+					statistic = 0;
+					score = 0;
+				}
+			}
+			else if (rateType == "structural")
+			{
+				statistic = pCalculator->statistic(pEffectInfo);
+				if (pEpochSimulation)
 				{
-					EffectInfo * pEffectInfo = (EffectInfo *)
-						R_ExternalPtrAddr(
-								VECTOR_ELT(VECTOR_ELT(EFFECTS,
-										pointerCol), i));
-					statistic = pCalculator->statistic(pEffectInfo);
-					if (pEpochSimulation)
+					const DependentVariable * pVariable =
+						pEpochSimulation->pVariable(networkName);
+					const NetworkVariable * pNetworkVariable;
+					if (strcmp(interaction1, "") == 0)
 					{
-						const DependentVariable * pVariable =
+						pNetworkVariable =
+							(const NetworkVariable *)
 							pEpochSimulation->pVariable(networkName);
-						const NetworkVariable * pNetworkVariable;
-						if (strcmp(interaction1, "") == 0)
-						{
-							pNetworkVariable =
-								(const NetworkVariable *)
-								pEpochSimulation->pVariable(networkName);
-						}
-						else
-						{
-							pNetworkVariable =
-								(const NetworkVariable *)
-								pEpochSimulation->pVariable(interaction1);
-						}
-						if (strcmp(effectName, "outRate") == 0)
-						{
-							score =
-								pVariable->outDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "inRate") == 0)
-						{
-							score =
-								pVariable->inDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "recipRate") == 0)
-						{
-							score =
-								pVariable->reciprocalDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "outRateInv") == 0)
-						{
-							score =
-								pVariable->inverseOutDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "outRateLog") == 0)
-						{
-							score =
-								pVariable->logOutDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "inRateInv") == 0)
-						{
-							score =
-								pVariable->inverseInDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "inRateLog") == 0)
-						{
-							score =
-								pVariable->logInDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "outRateLog") == 0)
-						{
-							score =
-								pVariable->logOutDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "recipRateInv") == 0)
-						{
-							score =
-								pVariable->inversereciprocalDegreeScore(pNetworkVariable);
-						}
-						else if (strcmp(effectName, "recipRateLog") == 0)
-						{
-							score =
-								pVariable->logreciprocalDegreeScore(pNetworkVariable);
-						}
-						else
-						{
-
-							Rf_error("Unexpected rate effect %s\n",
-									effectName);
-						}
 					}
 					else
 					{
-						score = 0;
+						pNetworkVariable =
+							(const NetworkVariable *)
+							pEpochSimulation->pVariable(interaction1);
 					}
-				}
-				else if (strcmp(rateType, "diffusion") == 0)
-				{
-					EffectInfo * pEffectInfo = (EffectInfo *)
-						R_ExternalPtrAddr(
-								VECTOR_ELT(VECTOR_ELT(EFFECTS,
-										pointerCol), i));
-					statistic = pCalculator->statistic(pEffectInfo);
-					if (pEpochSimulation)
+					if (effectName == "outRate")
 					{
-						if (strcmp(effectName, "avExposure") == 0 ||
-								strcmp(effectName, "totExposure") == 0 ||
-								strcmp(effectName, "susceptAvIn") == 0 ||
-								strcmp(effectName, "infectIn") == 0 ||
-								strcmp(effectName, "infectDeg") == 0 ||
-								strcmp(effectName, "infectOut") == 0 ||
-								strcmp(effectName, "susceptAvCovar") == 0 ||
-								strcmp(effectName, "infectCovar") == 0 ||
-								strcmp(effectName, "anyInExposureDist2") == 0 ||
-								strcmp(effectName, "totInExposureDist2") == 0 ||
-								strcmp(effectName, "avTinExposureDist2") == 0 ||
-								strcmp(effectName, "totAInExposureDist2") == 0)
-						{
-							score = pEpochSimulation->score(pEffectInfo);
-						}
-						else
-						{
-							Rf_error("Unexpected rate effect %s\n",
-									effectName);
-						}
+						score =
+							pVariable->outDegreeScore(pNetworkVariable);
 					}
-					else
+					else if (effectName == "inRate")
 					{
-						score = 0;
+						score =
+							pVariable->inDegreeScore(pNetworkVariable);
 					}
-				}
-				else
-				{
-					EffectInfo * pEffectInfo = (EffectInfo *)
-						R_ExternalPtrAddr(
-								VECTOR_ELT(VECTOR_ELT(EFFECTS,
-										pointerCol), i));
-					statistic = pCalculator->statistic(pEffectInfo);
-
-					if (pEpochSimulation)
+					else if (effectName == "recipRate")
 					{
-						ConstantCovariate * pConstantCovariate =
-							pData->pConstantCovariate(interaction1);
-						ChangingCovariate * pChangingCovariate =
-							pData->pChangingCovariate(interaction1);
-						BehaviorVariable * pBehavior =
-							(BehaviorVariable *)
-							pEpochSimulation->pVariable(interaction1);
-						//find the network
-
-						const DependentVariable * pVariable =
-							pEpochSimulation->pVariable(networkName);
-
-						if (pConstantCovariate)
-						{
-							score = pVariable->constantCovariateScore(
-									pConstantCovariate);
-						}
-						else if (pChangingCovariate)
-						{
-							score = pVariable->changingCovariateScore(
-									pChangingCovariate);
-						}
-						else if (pBehavior)
-						{
-							score = pVariable->behaviorVariableScore(
-									pBehavior);
-						}
-						else
-						{
-							Rf_error("No individual covariate named %s.",
-									interaction1);
-						}
+						score =
+							pVariable->reciprocalDegreeScore(pNetworkVariable);
+					}
+					else if (effectName == "outRateInv")
+					{
+						score =
+							pVariable->inverseOutDegreeScore(pNetworkVariable);
+					}
+					else if (effectName == "outRateLog")
+					{
+						score =
+							pVariable->logOutDegreeScore(pNetworkVariable);
+					}
+					else if (effectName == "inRateInv")
+					{
+						score =
+							pVariable->inverseInDegreeScore(pNetworkVariable);
+					}
+					else if (effectName == "inRateLog")
+					{
+						score =
+							pVariable->logInDegreeScore(pNetworkVariable);
+					}
+					else if (effectName == "recipRateInv")
+					{
+						score =
+							pVariable->inversereciprocalDegreeScore(pNetworkVariable);
+					}
+					else if (effectName == "recipRateLog")
+					{
+						score =
+							pVariable->logreciprocalDegreeScore(pNetworkVariable);
 					}
 					else
 					{
-						score = 0;
+						throw domain_error("Unexpected rate effect " +
+							effectName);
 					}
 				}
-
+				else
+				{
+					score = 0;
+				}
 			}
-			else
+			else if (rateType == "diffusion")
 			{
-				if (strcmp(effectType, "eval") == 0)
+				statistic = pCalculator->statistic(pEffectInfo);
+				if (pEpochSimulation)
 				{
-					EffectInfo * pEffectInfo = (EffectInfo *)
-						R_ExternalPtrAddr(
-								VECTOR_ELT(VECTOR_ELT(EFFECTS,
-										pointerCol), i));
-					statistic =	pCalculator->statistic(pEffectInfo);
-					if (pEpochSimulation)
+					if (effectName == "avExposure" ||
+							effectName == "totExposure" ||
+							effectName == "susceptAvIn" ||
+							effectName == "infectIn" ||
+							effectName == "infectDeg" ||
+							effectName == "infectOut" ||
+							effectName == "susceptAvCovar" ||
+							effectName == "infectCovar" ||
+							effectName == "anyInExposureDist2" ||
+							effectName == "totInExposureDist2" ||
+							effectName == "avTinExposureDist2" ||
+							effectName == "totAInExposureDist2")
 					{
 						score = pEpochSimulation->score(pEffectInfo);
 					}
 					else
 					{
-						score = 0;
+						throw domain_error("Unexpected rate effect " +
+							effectName);
 					}
 				}
-				else if (strcmp(effectType, "endow") == 0)
+				else
 				{
-					EffectInfo * pEffectInfo = (EffectInfo *)
-						R_ExternalPtrAddr(
-								VECTOR_ELT(VECTOR_ELT(EFFECTS,
-										pointerCol), i));
-					statistic = pCalculator->statistic(pEffectInfo);
-					if (strcmp(netType, "behavior") != 0)
-					{
-						statistic = -1 * statistic;
-					}
-					if (pEpochSimulation)
+					score = 0;
+				}
+			}
+			else
+			{
+				statistic = pCalculator->statistic(pEffectInfo);
+
+				if (pEpochSimulation)
+				{
+					ConstantCovariate * pConstantCovariate =
+						pData->pConstantCovariate(interaction1);
+					ChangingCovariate * pChangingCovariate =
+						pData->pChangingCovariate(interaction1);
+					BehaviorVariable * pBehavior =
+						(BehaviorVariable *)
+						pEpochSimulation->pVariable(interaction1);
+					//find the network
+
+					const DependentVariable * pVariable =
+						pEpochSimulation->pVariable(networkName);
+
+					if (pConstantCovariate)
 					{
-						score = pEpochSimulation->score(pEffectInfo);
+						score = pVariable->constantCovariateScore(
+								pConstantCovariate);
 					}
-					else
+					else if (pChangingCovariate)
 					{
-						score = 0;
+						score = pVariable->changingCovariateScore(
+								pChangingCovariate);
 					}
-				}
-				else if (strcmp(effectType, "creation") == 0)
-				{
-					EffectInfo * pEffectInfo = (EffectInfo *)
-						R_ExternalPtrAddr(
-								VECTOR_ELT(VECTOR_ELT(EFFECTS,
-										pointerCol), i));
-					statistic = pCalculator->statistic(pEffectInfo);
-					if (pEpochSimulation)
+					else if (pBehavior)
 					{
-						score = pEpochSimulation->score(pEffectInfo);
+						score = pVariable->behaviorVariableScore(
+								pBehavior);
 					}
 					else
 					{
-						score = 0;
+						throw domain_error(
+							"No individual covariate named " +
+							rRequest.interaction1 + ".");
 					}
 				}
-				else if (strcmp(effectType, "gmm") == 0)
-				{
-				  EffectInfo * pEffectInfo = (EffectInfo *)
-				  R_ExternalPtrAddr(
-				    VECTOR_ELT(VECTOR_ELT(EFFECTS,
-                              pointerCol), i));
-				  statistic = pCalculator->statistic(pEffectInfo);
-				  if (pEpochSimulation)
-				  {
-				    score = pEpochSimulation->score(pEffectInfo);
-				  }
-				  else
-				  {
-				    score = 0;
-				  }
-				}
 				else
 				{
-					Rf_error("invalid effect type %s\n", effectType);
+					score = 0;
 				}
 			}
-			(*rfra)[istore] = statistic;
+
+		}
+		else
+		{
+			/* eval, endow, creation or gmm, as checked by
+			   getStatisticRequests */
+			statistic = pCalculator->statistic(pEffectInfo);
+			if (effectType == "endow" && netType != "behavior")
+			{
+				statistic = -1 * statistic;
+			}
 			if (pEpochSimulation)
 			{
-				//		Rprintf("%f %d \n", score, istore);
-				(*rscore)[istore] = score;
+				score = pEpochSimulation->score(pEffectInfo);
+			}
+			else
+			{
+				score = 0;
 			}
-			istore++; /* keep forgetting to move the ++ */
+		}
+		(*rfra)[istore] = statistic;
+		if (pEpochSimulation)
+		{
+			(*rscore)[istore] = score;
 		}
 	}
-	UNPROTECT(1);
 }
 
 /**
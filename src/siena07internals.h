@@ -14,6 +14,7 @@
 
 #include <Rinternals.h>
 
+#include <string>
 #include <vector>
 
 namespace siena
@@ -21,6 +22,7 @@ namespace siena
 	class Data;
 	class Model;
 	class StatisticCalculator;
+	class EffectInfo;
 	class EpochSimulation;
 	class MLSimulation;
 	class NetworkLongitudinalData;
@@ -211,14 +213,12 @@ SEXP createInteractionEffects(SEXP EFFECTS, Model *pModel,
 		int typeCol, int intptr1Col, int intptr2Col, int intptr3Col);
 
 /**
- *  Retrieves the contributions to all possible tie flips or behavior changes
- *  for each of the effects, for one period. The call will relate to one group
- *  only, although all effects are the same apart from the basic rates. Not
- *  used in maximum likelihood.
+ *  Retrieves the effects for which the contributions to all possible tie
+ *  flips or behavior changes are calculated, in the order of the effects
+ *  list. Not used in maximum likelihood.
  */
-void getChangeContributionStatistics(SEXP EFFECTSLIST,
-	const StatisticCalculator * pCalculator,
-	std::vector<std::vector<double * > > *rChangeContributions);
+void getChangeContributionEffects(SEXP EFFECTSLIST,
+	std::vector<EffectInfo *> * rEffects);
 
 /**
  *  Retrieves the statistics of individual actors for each of the effects,
@@ -229,6 +229,36 @@ void getActorStatistics(SEXP EFFECTSLIST,
 	const StatisticCalculator * pCalculator,
 	std::vector<double *> *rActorStatistics);
 
+/**
+ *  The description of the statistic of one effect, read from the effects
+ *  object once so that the statistics of many simulations can be retrieved
+ *  without the R API.
+ */
+struct StatisticRequest
+{
+	std::string networkName;
+	std::string effectName;
+	std::string effectType;
+	std::string netType;
+	std::string rateType;
+	std::string interaction1;
+	std::string setting;
+
+	// The group and period of a basic rate effect, counted from 0
+	int group {-1};
+	int period {-1};
+
+	// The effect of any other statistic
+	EffectInfo * pEffectInfo {};
+};
+
+/**
+ *  Reads the description of the statistic of each of the effects from the
+ *  effects object, in the order of the parameters.
+ */
+void getStatisticRequests(SEXP EFFECTSLIST,
+	std::vector<StatisticRequest> * pRequests);
+
 /**
  *  Retrieves the values of the statistics and scores for each of the effects,
  *  for one period. The call will relate to one group only, although all effects
@@ -240,6 +270,16 @@ void getStatistics(SEXP EFFECTSLIST,
 	const EpochSimulation * pEpochSimulation,
 	std::vector<double> * rfra, std::vector<double> *rscore);
 
+/**
+ *  Retrieves the values of the statistics and scores for the given
+ *  statistic requests, for one period, without using the R API.
+ */
+void getStatistics(const std::vector<StatisticRequest> & rRequests,
+	const StatisticCalculator * pCalculator,
+	int period, int group, const Data *pData,
+	const EpochSimulation * pEpochSimulation,
+	std::vector<double> * rfra, std::vector<double> *rscore);
+
 /**
  *  retrieves the values of the scores and derivatives for each of the effects,
  *  for one period. The call will relate to one group only, although all effects
@@ -18,24 +18,30 @@
 #include <stdexcept>
 #include <vector>
 #include <cstring>
+#include <cmath>
 #include "siena07models.h"
 #include "siena07internals.h"
 #include "siena07utilities.h"
 #include "data/Data.h"
 #include "data/LongitudinalData.h"
+#include "data/NetworkLongitudinalData.h"
 #include "model/EffectInfo.h"
 #include "model/Model.h"
 #include "model/State.h"
 #include "model/StatisticCalculator.h"
 #include "utils/Random.h"
+#include "utils/Instrumentation.h"
+#include "utils/ParallelFor.h"
 #include "model/EpochSimulation.h"
 #include "model/variables/BehaviorVariable.h"
 #include "model/variables/NetworkVariable.h"
 #include "model/ml/MLSimulation.h"
 #include "model/ml/Chain.h"
+#include "model/ml/ChainStore.h"
 #include "model/ml/MiniStep.h"
 #include "model/ml/NetworkChange.h"
 #include "model/ml/BehaviorChange.h"
+#include "model/auxiliary/AuxiliaryStatistic.h"
 #include <R_ext/Error.h>
 #include <R_ext/Random.h>
 #include <Rinternals.h>
@@ -56,475 +62,953 @@ static int sexp_to_int(SEXP value, int def) {
 	return def;
 }
 
-extern "C"
-{
-
 /**
- *  Does one forward simulation for all the data by period within group
+ * Returns the element of the given R list with the given name, or
+ * R_NilValue if there is no such element.
  */
-SEXP forwardModel(SEXP DERIV, SEXP DATAPTR, SEXP SEEDS,
-	SEXP FROMFINITEDIFF, SEXP MODELPTR, SEXP EFFECTSLIST,
-	SEXP THETA, SEXP RANDOMSEED2, SEXP RETURNDEPS, SEXP NEEDSEEDS,
-	SEXP USESTREAMS, SEXP ADDCHAINTOSTORE, SEXP RETURNCHAINS, SEXP RETURNLOGLIK,
-	SEXP RETURNACTORSTATISTICS, SEXP RETURNCHANGECONTRIBUTIONS, SEXP RETURNDATAFRAME)
+static SEXP listElement(SEXP list, const char * name)
 {
-	SEXP NEWRANDOMSEED = PROTECT(Rf_duplicate(RANDOMSEED2)); // for parallel testing only
-
-	/* create a simulation and return the observed statistics and scores */
+	SEXP names = Rf_getAttrib(list, R_NamesSymbol);
 
-	/* get hold of the data vector */
-	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
+	for (int i = 0; i < Rf_length(list); i++)
+	{
+		if (strcmp(CHAR(STRING_ELT(names, i)), name) == 0)
+		{
+			return VECTOR_ELT(list, i);
+		}
+	}
 
-	/* get hold of the model object */
-	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
-	//	Rprintf("%x %x\n", pGroupData, pModel);
-	int nGroups = pGroupData->size();
+	return R_NilValue;
+}
 
-	/* find total number of periods to process */
-	int totObservations = totalPeriods(*pGroupData);
-	int fromFiniteDiff = Rf_asInteger(FROMFINITEDIFF);
-	int useStreams = Rf_asInteger(USESTREAMS);
-	int addChainToStore = sexp_to_int(ADDCHAINTOSTORE, 0);
-	int returnDependents = Rf_asInteger(RETURNDEPS);
-	int returnChains = sexp_to_int(RETURNCHAINS, 0);
-	int returnLoglik = sexp_to_int(RETURNLOGLIK, 0);
-	int returnActorStatistics = sexp_to_int(RETURNACTORSTATISTICS, 0);
-	int returnChangeContributions = sexp_to_int(RETURNCHANGECONTRIBUTIONS, 0);
-	int returnDataFrame = sexp_to_int(RETURNDATAFRAME, 0);
-	int deriv = Rf_asInteger(DERIV);
-	int needSeeds = Rf_asInteger(NEEDSEEDS);
+/**
+ * Simulates all periods of all groups once with the current parameters and
+ * stores the statistics summed over the periods in fra and, if requested,
+ * the summed scores in score. The sums are accumulated in long double, as
+ * colSums does in R.
+ */
+static void simulateStatisticSums(const vector<StatisticRequest> & rRequests,
+	vector<Data *> * pGroupData, Model * pModel, int dim,
+	vector<double> * fra, vector<double> * score)
+{
+	vector<long double> fraSum(dim, 0);
+	vector<long double> scoreSum(dim, 0);
+	vector<double> statistic(dim);
+	vector<double> periodScore(dim);
 
-	/* set the deriv flag on the model */
-	pModel->needScores(deriv);
-	pModel->needDerivatives(false);
-//	pModel->needDerivatives(deriv); // ABC
+	for (unsigned group = 0; group < pGroupData->size(); group++)
+	{
+		Data * pData = (*pGroupData)[group];
+		EpochSimulation * pEpochSimulation =
+			new EpochSimulation(pData, pModel);
 
-	/* set the chain flag on the model */
-	pModel->needChain(returnChains == 1 || addChainToStore == 1
-			|| returnLoglik == 1 || returnChangeContributions == 1);
+		for (int period = 0; period < pData->observationCount() - 1; period++)
+		{
+			pEpochSimulation->runEpoch(period);
 
-	/* set the change contribution flag on the model */
-	pModel->needChangeContributions(returnChangeContributions);
+			State State(pEpochSimulation);
+			StatisticCalculator Calculator(pData, pModel, &State, period);
+			getStatistics(rRequests, &Calculator, period, group, pData,
+				pEpochSimulation, &statistic, &periodScore);
 
-	/* update the parameters */
-	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+			for (int i = 0; i < dim; i++)
+			{
+				fraSum[i] += statistic[i];
+				scoreSum[i] += periodScore[i];
+			}
+		}
 
-	/* ans will be the return value */
-	SEXP ans = PROTECT(Rf_allocVector(VECSXP, 10));
+		delete pEpochSimulation;
+	}
 
-	/* count up the total number of parameters */
-	int dim = 0;
-	for (int i = 0; i < Rf_length(EFFECTSLIST); i++)
+	for (int i = 0; i < dim; i++)
 	{
-		dim += Rf_length(VECTOR_ELT(VECTOR_ELT(EFFECTSLIST, i), 0));
+		(*fra)[i] = (double) fraSum[i];
+		(*score)[i] = (double) scoreSum[i];
 	}
+}
 
-	/* get the random seed from R into memory */
-	GetRNGstate();
+/**
+ * Calculates the auxiliary statistics of the model for the given state at
+ * the end of the given period, storing the values of statistic k in the
+ * replications x periods x size array rAuxiliary[k] at the given
+ * replication and period from the start.
+ */
+static void storeAuxiliaryStatistics(const Model * pModel, const Data * pData,
+	const State * pState, int period, int replication, int replications,
+	int periodFromStart, int periods, const vector<double *> & rAuxiliary)
+{
+	const vector<AuxiliaryStatistic *> & rStatistics =
+		pModel->rAuxiliaryStatistics();
+	vector<double> values;
 
-	/* fra will contain the simulated statistics and must be initialised
-	   to 0. Use rfra to reduce function evaluations. */
-	SEXP fra;
-	double * rfra;
-	PROTECT(fra = Rf_allocMatrix(REALSXP, dim, totObservations));
-	rfra = REAL(fra);
-	for (int i = 0; i < Rf_length(fra); i++)
+	for (unsigned k = 0; k < rStatistics.size(); k++)
 	{
-		rfra[i] = 0;
+		values.resize(rStatistics[k]->size());
+		rStatistics[k]->calculate(pData, pState, period, values.data());
+
+		for (unsigned level = 0; level < values.size(); level++)
+		{
+			rAuxiliary[k][replication +
+				replications * (periodFromStart + periods * level)] =
+				values[level];
+		}
 	}
-	/* ntim is the total time taken in each period (relevant for conditional
-		 estimation) */
-	SEXP ntim;
-	double * rntim;
-	PROTECT(ntim = Rf_allocVector(REALSXP, totObservations));
-	rntim = REAL(ntim);
-	for (int i = 0; i < Rf_length(ntim); i++)
-		rntim[i] = 0.0;
+}
 
-	/* sims will be the returned simulated dependent variables */
-	SEXP sims;
-	PROTECT(sims = Rf_allocVector(VECSXP, nGroups));
-	if (returnDependents)
+/**
+ * Allocates the list of the arrays of the auxiliary statistics of the model,
+ * one replications x periods x size array per statistic, filled with zeros,
+ * and stores pointers to the values of the arrays in pAuxiliary. The list
+ * is returned unprotected.
+ */
+static SEXP allocateAuxiliaryStatistics(const Model * pModel,
+	int replications, int periods, vector<double *> * pAuxiliary)
+{
+	const vector<AuxiliaryStatistic *> & rStatistics =
+		pModel->rAuxiliaryStatistics();
+	SEXP AUXILIARY = PROTECT(Rf_allocVector(VECSXP, rStatistics.size()));
+	pAuxiliary->clear();
+
+	for (unsigned k = 0; k < rStatistics.size(); k++)
 	{
-		int nVariables = (*pGroupData)[0]->rDependentVariableData().size();
-		for (int group = 0; group < nGroups; group++)
+		SEXP VALUES = Rf_alloc3DArray(REALSXP, replications, periods,
+			rStatistics[k]->size());
+		SET_VECTOR_ELT(AUXILIARY, k, VALUES);
+		double * values = REAL(VALUES);
+		for (int i = 0; i < Rf_length(VALUES); i++)
 		{
-			SET_VECTOR_ELT(sims, group, Rf_allocVector(VECSXP, nVariables));
-			for (int variable = 0; variable < nVariables; variable++)
-			{
-				SET_VECTOR_ELT(VECTOR_ELT(sims, group), variable,
-					Rf_allocVector(VECSXP, (*pGroupData)[group]->
-						observationCount() - 1));
-			}
+			values[i] = 0;
 		}
+		pAuxiliary->push_back(values);
 	}
-	/* chains will be the returned chains */
-	SEXP chains = PROTECT(Rf_allocVector(VECSXP, nGroups));
-	if (returnChains)
+
+	UNPROTECT(1);
+	return AUXILIARY;
+}
+
+/**
+ * Simulates all periods of all groups once with the current parameters, as
+ * replication number replication of replications. The statistics and, if
+ * scores are needed, the scores of each period are stored in the arrays fra
+ * and sc of dimensions replications x periods x effects, the simulated
+ * time of each period in the replications x periods matrix ntim, and the
+ * auxiliary statistics of the model in the arrays rAuxiliary. Does not
+ * use the R API, so that replications can run on several threads.
+ */
+static void simulateReplication(const vector<StatisticRequest> & rRequests,
+	vector<Data *> * pGroupData, Model * pModel, int replication,
+	int replications, int periods, double * fra, double * sc, double * ntim,
+	const vector<double *> & rAuxiliary)
+{
+	int dim = rRequests.size();
+	vector<double> statistic(dim);
+	vector<double> score(dim);
+	int periodFromStart = 0;
+
+	for (unsigned group = 0; group < pGroupData->size(); group++)
 	{
-		for (int group = 0; group < nGroups; group++)
+		Data * pData = (*pGroupData)[group];
+		EpochSimulation simulation(pData, pModel);
+
+		for (int period = 0; period < pData->observationCount() - 1; period++)
 		{
-			SET_VECTOR_ELT(chains, group,
-				Rf_allocVector(VECSXP, (*pGroupData)[group]->
-					observationCount() - 1));
+			simulation.runEpoch(period);
+
+			State State(&simulation);
+			StatisticCalculator Calculator(pData, pModel, &State, period);
+			getStatistics(rRequests, &Calculator, period, group, pData,
+				&simulation, &statistic, &score);
+
+			for (int i = 0; i < dim; i++)
+			{
+				int index = replication +
+					replications * (periodFromStart + periods * i);
+				fra[index] = statistic[i];
+
+				if (sc)
+				{
+					sc[index] = score[i];
+				}
+			}
+
+			if (pModel->conditional())
+			{
+				ntim[replication + replications * periodFromStart] =
+					simulation.time();
+			}
+
+			storeAuxiliaryStatistics(pModel, pData, &State, period,
+				replication, replications, periodFromStart, periods,
+				rAuxiliary);
+
+			periodFromStart++;
 		}
 	}
+}
 
-	/* changeContributionChain will be the returned change contributions for all chains */
-	SEXP changeContributionChains = PROTECT(Rf_allocVector(VECSXP, nGroups));
-	if (returnChangeContributions)
+/**
+ * Simulates every period of every group once with the current parameters,
+ * each period drawing from a random number stream started with the seed of
+ * that period, on the given number of threads. The statistics are stored
+ * in the periods x effects matrix fra, and the simulated time of each
+ * period in ntim. As the periods of the method of moments start from the
+ * observations, they are independent of each other.
+ */
+static void simulatePeriods(const vector<StatisticRequest> & rRequests,
+	vector<Data *> * pGroupData, Model * pModel,
+	const vector<unsigned long long> & rSeeds, int threads, double * fra,
+	double * ntim)
+{
+	int dim = rRequests.size();
+	int periods = rSeeds.size();
+	vector<int> groups;
+	vector<int> groupPeriods;
+
+	for (unsigned group = 0; group < pGroupData->size(); group++)
 	{
-		for (int group = 0; group < nGroups; group++)
+		for (int period = 0;
+			period < (*pGroupData)[group]->observationCount() - 1;
+			period++)
 		{
-			SET_VECTOR_ELT(changeContributionChains, group,
-					Rf_allocVector(VECSXP, (*pGroupData)[group]->observationCount() - 1));
+			groups.push_back(group);
+			groupPeriods.push_back(period);
 		}
 	}
 
-	/* actorStats will be the returned statistics of individual actors*/
-	SEXP actorStats = PROTECT(Rf_allocVector(VECSXP,nGroups));
-	if(returnActorStatistics)
+	parallelFor(periods, threads, [&](int periodFromStart)
 	{
-		SEXP NETWORKTYPES;
-		NETWORKTYPES = createRObjectAttributes(EFFECTSLIST, actorStats);
-		int objEffects = Rf_length(NETWORKTYPES);
-		for (int group = 0; group < nGroups; group++)
+		int group = groups[periodFromStart];
+		int period = groupPeriods[periodFromStart];
+		Data * pData = (*pGroupData)[group];
+		vector<double> statistic(dim);
+		vector<double> score(dim);
+
+		RandomStream stream(rSeeds[periodFromStart]);
+		currentRandomStream(&stream);
+
+		try
 		{
-			SET_VECTOR_ELT(actorStats, group, Rf_allocVector(VECSXP, (*pGroupData)[group]->observationCount()-1));
-			for (int p = 0; p < (*pGroupData)[group]->observationCount()-1; p++)
+			EpochSimulation simulation(pData, pModel);
+			simulation.runEpoch(period);
+
+			State State(&simulation);
+			StatisticCalculator Calculator(pData, pModel, &State, period);
+			getStatistics(rRequests, &Calculator, period, group, pData,
+				&simulation, &statistic, &score);
+
+			for (int i = 0; i < dim; i++)
 			{
-				SET_VECTOR_ELT(VECTOR_ELT(actorStats,group), p, Rf_allocVector(VECSXP,objEffects));
+				fra[periodFromStart + periods * i] = statistic[i];
 			}
+
+			ntim[periodFromStart] =
+				pModel->conditional() ? simulation.time() : 0;
+		}
+		catch (...)
+		{
+			currentRandomStream(0);
+			throw;
 		}
-	}
 
-	/* loglik will be the returned log likelihoods */
-	SEXP logliks = PROTECT(Rf_allocVector(REALSXP, totObservations));
-	double * Rlogliks = REAL(logliks);
+		currentRandomStream(0);
+	});
+}
 
-	/* seed store is a list to save the random states */
-	SEXP seedstore = PROTECT(Rf_allocVector(VECSXP, nGroups));
-	for (int group = 0; group < nGroups; group++)
+/**
+ * Runs the replications of simulateReplications and returns their results.
+ * The engine errors of the replications are thrown on as exceptions, after
+ * the random number state has been sent back to R.
+ */
+static SEXP phase3Replications(SEXP DATAPTR, SEXP MODELPTR,
+	SEXP EFFECTSLIST, SEXP THETA, SEXP REPLICATIONS, SEXP DERIV, SEXP THREADS)
+{
+	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+	int replications = Rf_asInteger(REPLICATIONS);
+	int deriv = Rf_asInteger(DERIV);
+	int threads = Rf_asInteger(THREADS);
+
+	/* the counters of the instrumentation are not shared between threads */
+	if (Instrumentation::enabled())
 	{
-		SET_VECTOR_ELT(seedstore, group,
-			Rf_allocVector(VECSXP, (*pGroupData)[group]->observationCount() - 1));
+		threads = 1;
 	}
 
-	/* rs will allow us to access or set the .Random.seed in R */
-	SEXP rs = PROTECT(Rf_install(".Random.seed"));
-
-	/* scores will hold the return values of the scores */
-	SEXP scores;
-	double *rscores;
-	PROTECT(scores = Rf_allocMatrix(REALSXP, dim, totObservations));
-	rscores = REAL(scores);
-	for (int i = 0; i < Rf_length(scores); i++)
-		rscores[i] = 0.0;
-
-	int periodFromStart = 0;
+	pModel->needScores(deriv);
+	pModel->needDerivatives(false);
+	pModel->needChain(false);
+	pModel->needChangeContributions(false);
+	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
 
-	SEXP Cgstr = R_NilValue;
-	SEXP STREAMS = R_NilValue;
-	SEXP ans2, ans3, ans4, R_fcall1, R_fcall2, R_fcall3, R_fcall4;
-	SEXP seedvector;
+	vector<StatisticRequest> requests;
+	getStatisticRequests(EFFECTSLIST, &requests);
+	int dim = requests.size();
+	int periods = totalPeriods(*pGroupData);
 
-	if (useStreams)
+	const char * ansNames[] = {"statistics", "fra", "sc", "ntim",
+		"auxiliary"};
+	SEXP ans = PROTECT(Rf_allocVector(VECSXP, 5));
+	SEXP names = PROTECT(Rf_allocVector(STRSXP, 5));
+	for (int i = 0; i < 5; i++)
 	{
-		// create an R character string
-		PROTECT(Cgstr = Rf_allocVector(STRSXP,1));
-		SET_STRING_ELT(Cgstr, 0, Rf_mkChar("Cg"));
-
-		// find out which stream we are using
-		PROTECT(R_fcall1 = Rf_lang1(Rf_install(".lec.GetStreams")));
-		PROTECT(STREAMS = Rf_eval(R_fcall1, R_GlobalEnv));
+		SET_STRING_ELT(names, i, Rf_mkChar(ansNames[i]));
 	}
+	Rf_setAttrib(ans, R_NamesSymbol, names);
 
-	/* group loop here */
-	for (int group = 0; group < nGroups; group++)
+	SEXP STATISTICS = PROTECT(Rf_allocMatrix(REALSXP, replications, dim));
+	SEXP FRA = PROTECT(Rf_alloc3DArray(REALSXP, replications, periods, dim));
+	SEXP SC = R_NilValue;
+	if (deriv)
 	{
-		/* random states need store (not fromFiniteDiff)
-		   or restore (fromFiniteDiff) for each period
-		   within each  group */
-		SEXP seeds = R_NilValue;
-		if (fromFiniteDiff)
+		SC = Rf_alloc3DArray(REALSXP, replications, periods, dim);
+	}
+	PROTECT(SC);
+	SEXP NTIM = PROTECT(Rf_allocMatrix(REALSXP, replications, periods));
+	vector<double *> auxiliary;
+	SEXP AUXILIARY = PROTECT(allocateAuxiliaryStatistics(pModel,
+		replications, periods, &auxiliary));
+
+	double * fra = REAL(FRA);
+	double * sc = deriv ? REAL(SC) : 0;
+	double * ntim = REAL(NTIM);
+	for (int i = 0; i < Rf_length(FRA); i++)
+	{
+		fra[i] = 0;
+		if (sc)
 		{
-			seeds = VECTOR_ELT(SEEDS, group);
+			sc[i] = 0;
 		}
+	}
+	for (int i = 0; i < Rf_length(NTIM); i++)
+	{
+		ntim[i] = 0;
+	}
 
-		/* find out how many periods in this Data object */
-		Data * pData = (*pGroupData)[group];
-		int observations = pData->observationCount();
-
-		/* create my epochsimulation object */
-		EpochSimulation * pEpochSimulation  = new
-			EpochSimulation(pData, pModel);
+	GetRNGstate();
 
-		for (int period = 0; period < observations - 1; period++)
+	if (threads <= 1)
+	{
+		try
 		{
-
-			periodFromStart++;
-
-			if (!Rf_isNull(RANDOMSEED2)) /* parallel testing versus Siena3 */
+			for (int replication = 0; replication < replications;
+				replication++)
 			{
-				// overwrite R's random number seed
-				Rf_defineVar(rs, RANDOMSEED2, R_GlobalEnv);
-				// get it into memory
-				GetRNGstate();
-				// move on one
-				nextDouble();
-				// write it back to R
-				PutRNGstate();
-			}
-			else /* normal run */
-			{
-				if (fromFiniteDiff) /* restore state */
-				{
-					if (useStreams) /* using lecuyer random numbers */
-					{
-						// overwrite the current state in R
-						PROTECT(R_fcall2 = Rf_lang4(Rf_install("[[<-"),
-								Rf_install(".lec.Random.seed.table"), Cgstr,
-								VECTOR_ELT(seeds, period)));
-						PROTECT(ans2 = Rf_eval(R_fcall2, R_GlobalEnv));
-						// get the overwritten state into C table
-						PROTECT(R_fcall3 =
-							Rf_lang2(Rf_install(".lec.CurrentStream"),
-								STREAMS));
-						PROTECT(ans3 = Rf_eval(R_fcall3, R_GlobalEnv));
-						UNPROTECT(4);
-					}
-					else /* using normal random numbers */
-					{
-						// overwrite R's current state
-						Rf_defineVar(rs, VECTOR_ELT(seeds, period),
-							R_GlobalEnv);
-						// get the value from .Random.seed into memory
-						GetRNGstate();
-					}
-				}
-				else /* save state */
-				{
-					if (needSeeds)
-					{
-						if (useStreams)
-						{
-							PROTECT(R_fcall2 =
-								Rf_lang2(Rf_install(".lec.ResetNextSubstream"),
-									STREAMS));
-							PROTECT(ans2 = Rf_eval(R_fcall2, R_GlobalEnv));
-
-							PROTECT(R_fcall3 =
-								Rf_lang2(Rf_install(".lec.CurrentStream"),
-									STREAMS));
-							PROTECT(ans3 = Rf_eval(R_fcall3, R_GlobalEnv));
-							// get the relevant current state from R
-							PROTECT(R_fcall4 = Rf_lang3(Rf_install("[["),
-									Rf_install(".lec.Random.seed.table"),
-									Cgstr));
-							ans4 = Rf_eval(R_fcall4, R_GlobalEnv);
-							// value is not kept unless we duplicate it
-							PROTECT(seedvector = Rf_duplicate(ans4));
-							// store the Cg values
-							SET_VECTOR_ELT(VECTOR_ELT(seedstore, group),
-								period, seedvector);
-							UNPROTECT(6);
-						}
-						else
-						{
-							PutRNGstate();
-							SET_VECTOR_ELT(VECTOR_ELT(seedstore, group),
-								period, R_getVar(rs, R_GlobalEnv, TRUE));
-						}
-					}
-				}
-			}
-
-			/* only needed for forward chains */
-			if (pModel->needChain())
-			{
-				pEpochSimulation->clearChain();
-			}
-			/* run the epoch simulation for this period */
-			pEpochSimulation->runEpoch(period);
-
-			State State(pEpochSimulation);
-			StatisticCalculator Calculator(pData, pModel, &State,
-				period);
-			vector<double> statistic(dim);
-			vector<double> score(dim);
-			getStatistics(EFFECTSLIST, &Calculator,
-				period, group, pData, pEpochSimulation,
-				&statistic, &score);  // ABC
-			/* fill up matrices for  return value list */
-			int iii = (periodFromStart - 1) * dim;
-			for (unsigned effectNo = 0; effectNo < statistic.size();
-				 effectNo++)
-			{
-				rfra[iii + effectNo] = statistic[effectNo];
-				rscores[iii + effectNo] = score[effectNo];
+				simulateReplication(requests, pGroupData, pModel,
+					replication, replications, periods, fra, sc, ntim,
+					auxiliary);
 			}
+		}
+		catch (...)
+		{
+			PutRNGstate();
+			throw;
+		}
+	}
+	else
+	{
+		/* seeds for the streams of the replications */
+		vector<unsigned long long> seeds(replications);
+		for (int replication = 0; replication < replications; replication++)
+		{
+			unsigned long long high = unif_rand() * 4294967296.0;
+			unsigned long long low = unif_rand() * 4294967296.0;
+			seeds[replication] = (high << 32) | low;
+		}
 
-			if(returnActorStatistics)
-			{
-				StatisticCalculator Calculator(pData, pModel, &State, period, returnActorStatistics);
-				vector<double *> actorStatistics;
-				getActorStatistics(EFFECTSLIST, &Calculator, &actorStatistics);
-				int actors = pData->rDependentVariableData()[0]->n();
-				for(unsigned e = 0; e < actorStatistics.size(); e++)
-				{
-					SEXP actorStatsValues;
-					PROTECT(actorStatsValues = Rf_allocVector(REALSXP, actors));
-					double * astats = REAL(actorStatsValues);
-					for(int i = 0; i < actors; i++)
-					{
-						astats[i] = actorStatistics.at(e)[i];
-					}
-					SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(actorStats,group), period), e, actorStatsValues);
-					UNPROTECT(1);
-				}
-			}
-			if (pModel->conditional())
-			{
-				rntim[periodFromStart - 1] = pEpochSimulation->time();
-			}
-			// get simulated network
-			if (returnDependents)
-			{
-				const vector<DependentVariable *> rVariables =
-					pEpochSimulation->rVariables();
-				for (unsigned i = 0; i < rVariables.size(); i++)
-				{
-					// Rprintf("attach var %d (2)\n", i);
-					SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(sims, group), i), period,
-							var_to_sexp(rVariables[i]));
-				}
-                
-                const vector<ContinuousVariable *> rContinuousVariables =
-                    pEpochSimulation->rContinuousVariables();
-                for (unsigned i = 0; i < rContinuousVariables.size(); i++)
-                {
-                    ContinuousVariable * pContinuousVariable =
-                        rContinuousVariables[i];
-                    SEXP theseValues = getContinuousValues(*pContinuousVariable);
-                        SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(sims,
-                                    group), i + rVariables.size()),
-                                    period, theseValues);
-                }
-			}
-			if (returnChains)
+		try
+		{
+			parallelFor(replications, threads, [&](int replication)
 			{
-				SEXP thisChain;
-				if (returnDataFrame)
+				RandomStream stream(seeds[replication]);
+				currentRandomStream(&stream);
+				try
 				{
-					thisChain = getChainDFPlus(*(pEpochSimulation->pChain()), true);
+					simulateReplication(requests, pGroupData, pModel,
+						replication, replications, periods, fra, sc, ntim,
+						auxiliary);
 				}
-				else
+				catch (...)
 				{
-					thisChain = getChainList(*(pEpochSimulation->pChain()));
+					currentRandomStream(0);
+					throw;
 				}
-				SET_VECTOR_ELT(VECTOR_ELT(chains, group), period, thisChain);
-			}
-			if(returnChangeContributions)
-			{
-				SEXP thisChangeContributions = getChangeContributionsList(*(pEpochSimulation->pChain()), EFFECTSLIST);
-				SET_VECTOR_ELT(VECTOR_ELT(changeContributionChains, group), period, thisChangeContributions);
-			}
-			if (returnLoglik)
-			{
-				pEpochSimulation->simpleRates(pModel->simpleRates());
-				Rlogliks[periodFromStart - 1] =
-					pEpochSimulation->calculateLikelihood();
-			}
-			if (addChainToStore)
-			{
-				pModel->chainStore(*(pEpochSimulation->pChain()),
-					periodFromStart - 1);
-			}
-		} /* end of period */
-		delete pEpochSimulation;
-	} /* end of group */
+				currentRandomStream(0);
+			});
+		}
+		catch (...)
+		{
+			PutRNGstate();
+			throw;
+		}
+	}
 
-	/* send the .Random.seed back to R */
 	PutRNGstate();
-	NEWRANDOMSEED = R_getVar(rs, R_GlobalEnv, TRUE);
 
-	/* set up the return object */
-	if (!fromFiniteDiff)
+	/* the statistics summed over the periods, in long double as colSums */
+	double * statistics = REAL(STATISTICS);
+	for (int i = 0; i < dim; i++)
 	{
-		if (needSeeds)
+		for (int replication = 0; replication < replications; replication++)
 		{
-			SET_VECTOR_ELT(ans, 2, seedstore);
+			long double sum = 0;
+			for (int period = 0; period < periods; period++)
+			{
+				sum += fra[replication + replications * (period + periods * i)];
+			}
+			statistics[replication + replications * i] = (double) sum;
 		}
 	}
-	if (deriv)
+
+	SET_VECTOR_ELT(ans, 0, STATISTICS);
+	SET_VECTOR_ELT(ans, 1, FRA);
+	SET_VECTOR_ELT(ans, 2, SC);
+	SET_VECTOR_ELT(ans, 3, NTIM);
+	SET_VECTOR_ELT(ans, 4, AUXILIARY);
+	UNPROTECT(7);
+	return ans;
+}
+
+/**
+ * Does the simulations of finiteDifferences and returns their results.
+ */
+static SEXP finiteDifferenceDerivatives(SEXP DATAPTR, SEXP MODELPTR,
+	SEXP EFFECTSLIST, SEXP THETA, SEXP EPSILON, SEXP PERTURB, SEXP THREADS)
+{
+	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+	int threads = Rf_asInteger(THREADS);
+
+	/* the counters of the instrumentation are not shared between threads */
+	if (Instrumentation::enabled())
 	{
-		SET_VECTOR_ELT(ans, 1, scores);
+		threads = 1;
 	}
-	if (returnDependents)
+
+	pModel->needScores(false);
+	pModel->needDerivatives(false);
+	pModel->needChain(false);
+	pModel->needChangeContributions(false);
+
+	vector<StatisticRequest> requests;
+	getStatisticRequests(EFFECTSLIST, &requests);
+	int dim = requests.size();
+	int periods = totalPeriods(*pGroupData);
+
+	if (Rf_length(THETA) != dim || Rf_length(EPSILON) != dim ||
+		Rf_length(PERTURB) != dim)
 	{
-		SET_VECTOR_ELT(ans, 5, sims);/* not done in phase 2 !!test this */
+		throw invalid_argument(
+			"theta, epsilon and perturb must have one element per effect");
 	}
-	SET_VECTOR_ELT(ans, 0, fra);
-	SET_VECTOR_ELT(ans, 3, ntim);
 
-	if (!Rf_isNull(RANDOMSEED2))
+	const char * ansNames[] = {"fra", "sdf", "sdf2", "ntim"};
+	SEXP ans = PROTECT(Rf_allocVector(VECSXP, 4));
+	SEXP names = PROTECT(Rf_allocVector(STRSXP, 4));
+	for (int i = 0; i < 4; i++)
 	{
-		SET_VECTOR_ELT(ans, 4, NEWRANDOMSEED);
+		SET_STRING_ELT(names, i, Rf_mkChar(ansNames[i]));
 	}
-	if (useStreams)
+	Rf_setAttrib(ans, R_NamesSymbol, names);
+
+	SEXP FRA = PROTECT(Rf_allocMatrix(REALSXP, periods, dim));
+	SEXP SDF = PROTECT(Rf_allocMatrix(REALSXP, dim, dim));
+	SEXP SDF2 = PROTECT(Rf_alloc3DArray(REALSXP, periods, dim, dim));
+	SEXP NTIM = PROTECT(Rf_allocVector(REALSXP, periods));
+	SEXP PERTURBEDTHETA = PROTECT(Rf_duplicate(THETA));
+	double * fra = REAL(FRA);
+	double * sdf = REAL(SDF);
+	double * sdf2 = REAL(SDF2);
+	double * ntim = REAL(NTIM);
+	double * epsilon = REAL(EPSILON);
+	int * perturb = LOGICAL(PERTURB);
+
+	for (int i = 0; i < Rf_length(SDF); i++)
 	{
-		UNPROTECT(3);
+		sdf[i] = 0;
+	}
+	for (int i = 0; i < Rf_length(SDF2); i++)
+	{
+		sdf2[i] = 0;
 	}
-	SET_VECTOR_ELT(ans, 6, chains);
-	SET_VECTOR_ELT(ans, 7, logliks);
-	SET_VECTOR_ELT(ans, 8, changeContributionChains);
-	SET_VECTOR_ELT(ans, 9, actorStats);
-	UNPROTECT(12);
-	return(ans);
-}
 
-/** Does some MH steps for a specified group and period.
- * Designed to be used for parallel processing, and currently the only
- * function available. Loop is always constructed in R. Probably would be
- * better to do it in C unless parallel processing.
- */
-SEXP mlPeriod(SEXP DERIV, SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
-	SEXP THETA, SEXP GROUP, SEXP PERIOD,
-	SEXP NRUNMH, SEXP ADDCHAINTOSTORE,
-	SEXP RETURNDATAFRAME, SEXP RETURNDEPS, SEXP RETURNCHAINS,
-	SEXP RETURNLOGLIK, SEXP ONLYLOGLIK)
-{
-	/* do some MH steps and return some or all of the scores and derivs
-	   of the chain at the end or the calculated log likelihood*/
+	/* one seed per period, shared by all the simulations */
+	GetRNGstate();
+	vector<unsigned long long> seeds(periods);
+	for (int period = 0; period < periods; period++)
+	{
+		unsigned long long high = unif_rand() * 4294967296.0;
+		unsigned long long low = unif_rand() * 4294967296.0;
+		seeds[period] = (high << 32) | low;
+	}
+	PutRNGstate();
 
-	/* get hold of the data vector */
-	vector<Data *> * pGroupData = (vector<Data *> *)
-		R_ExternalPtrAddr(DATAPTR);
+	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+	simulatePeriods(requests, pGroupData, pModel, seeds, threads, fra, ntim);
 
-	int group = Rf_asInteger(GROUP) - 1;
-	int period = Rf_asInteger(PERIOD) - 1;
-	int groupPeriod = periodFromStart(*pGroupData, group, period);
+	vector<double> perturbedFra(periods * dim);
+	vector<double> perturbedNtim(periods);
 
-	/* get hold of the data object */
-	Data * pData = (*pGroupData)[group];
+	for (int parameter = 0; parameter < dim; parameter++)
+	{
+		if (!perturb[parameter])
+		{
+			continue;
+		}
 
-	/* get hold of the model object */
-	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+		REAL(PERTURBEDTHETA)[parameter] =
+			REAL(THETA)[parameter] + epsilon[parameter];
+		updateParameters(EFFECTSLIST, PERTURBEDTHETA, pGroupData, pModel);
+		REAL(PERTURBEDTHETA)[parameter] = REAL(THETA)[parameter];
+		simulatePeriods(requests, pGroupData, pModel, seeds, threads,
+			&perturbedFra[0], &perturbedNtim[0]);
 
-	/* update the parameters */
-	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+		for (int i = 0; i < dim; i++)
+		{
+			double sum = 0;
 
-	/* create the ML simulation object */
-	MLSimulation * pMLSimulation = new MLSimulation(pData, pModel);
+			for (int period = 0; period < periods; period++)
+			{
+				int index = period + periods * i;
+				double difference = perturbedFra[index] - fra[index];
+				sdf2[period + periods * (parameter + dim * i)] =
+					difference / epsilon[parameter];
+				sum += difference;
+			}
 
-	/* initialize some data from model */
-	pMLSimulation->simpleRates(pModel->simpleRates());
+			sdf[parameter + dim * i] = sum / epsilon[parameter];
+		}
+	}
 
-	pMLSimulation->currentPermutationLength(
-		pModel->currentPermutationLength(period));
+	/* leave the model with the unperturbed parameters */
+	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
 
-	// next calls are ambiguous unless I use a const pModel
-	const Model * pConstModel = pModel;
+	SET_VECTOR_ELT(ans, 0, FRA);
+	SET_VECTOR_ELT(ans, 1, SDF);
+	SET_VECTOR_ELT(ans, 2, SDF2);
+	SET_VECTOR_ELT(ans, 3, NTIM);
+	UNPROTECT(7);
+	return ans;
+}
+
+/**
+ * Runs the iterations of phase2Subphase up to lastIteration and returns the
+ * updated state, after sending the random number state back to R.
+ */
+static SEXP phase2Iterations(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP STATE, SEXP CONTROL)
+{
+	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+
+	/* the constant settings */
+	const double * targets = REAL(listElement(CONTROL, "targets"));
+	const int * fixed = LOGICAL(listElement(CONTROL, "fixed"));
+	const int * posj = LOGICAL(listElement(CONTROL, "posj"));
+	const double * sd = REAL(listElement(CONTROL, "sd"));
+	const double * dinvv = REAL(listElement(CONTROL, "dinvv"));
+	const double * standardization =
+		REAL(listElement(CONTROL, "standardization"));
+	SEXP SFINVCOV = listElement(CONTROL, "sfinvcov");
+	const double * dfraDiagonal = REAL(listElement(CONTROL, "dfradiag"));
+	const double * regrCoef = REAL(listElement(CONTROL, "regrCoef"));
+	double gain = Rf_asReal(listElement(CONTROL, "gain"));
+	double truncation = Rf_asReal(listElement(CONTROL, "truncation"));
+	double thetaBound = Rf_asReal(listElement(CONTROL, "thetaBound"));
+	int diagg = Rf_asLogical(listElement(CONTROL, "diagg"));
+	int standardizeVar = Rf_asLogical(listElement(CONTROL, "standardizeVar"));
+	int standardizeWithTruncation =
+		Rf_asLogical(listElement(CONTROL, "standardizeWithTruncation"));
+	int doubleAveraging = Rf_asLogical(listElement(CONTROL, "doubleAveraging"));
+	int dolby = Rf_asLogical(listElement(CONTROL, "dolby"));
+	int canRepeat = Rf_asLogical(listElement(CONTROL, "canRepeat"));
+	int n2min = Rf_asInteger(listElement(CONTROL, "n2min"));
+	int n2max = Rf_asInteger(listElement(CONTROL, "n2max"));
+	int subphase = Rf_asInteger(listElement(CONTROL, "subphase"));
+	int lastIteration =
+		min(n2max, Rf_asInteger(listElement(CONTROL, "lastIteration")));
+
+	/* the state, which is copied and updated */
+	const char * stateNames[] = {"theta", "thav", "prod0", "prod1",
+		"sumfra", "prevfra", "truncated", "positivized", "ac", "thavn",
+		"nit", "maxacor", "minacor", "boundExceeded", "finished", "thetas",
+		"fras"};
+	const int stateCount = 17;
+	SEXP ans = PROTECT(Rf_allocVector(VECSXP, stateCount));
+	SEXP names = PROTECT(Rf_allocVector(STRSXP, stateCount));
+	for (int i = 0; i < stateCount; i++)
+	{
+		SET_STRING_ELT(names, i, Rf_mkChar(stateNames[i]));
+	}
+	Rf_setAttrib(ans, R_NamesSymbol, names);
+
+	for (int i = 0; i < 8; i++)
+	{
+		SEXPTYPE type = i < 6 ? REALSXP : (i == 6 ? LGLSXP : INTSXP);
+		SET_VECTOR_ELT(ans, i, Rf_coerceVector(
+			listElement(STATE, stateNames[i]), type));
+		SET_VECTOR_ELT(ans, i, Rf_duplicate(VECTOR_ELT(ans, i)));
+	}
+
+	double * theta = REAL(VECTOR_ELT(ans, 0));
+	double * thav = REAL(VECTOR_ELT(ans, 1));
+	double * prod0 = REAL(VECTOR_ELT(ans, 2));
+	double * prod1 = REAL(VECTOR_ELT(ans, 3));
+	double * sumfra = REAL(VECTOR_ELT(ans, 4));
+	double * prevfra = REAL(VECTOR_ELT(ans, 5));
+	int * truncated = LOGICAL(VECTOR_ELT(ans, 6));
+	int * positivized = INTEGER(VECTOR_ELT(ans, 7));
+	double thavn = Rf_asReal(listElement(STATE, "thavn"));
+	int nit = Rf_asInteger(listElement(STATE, "nit"));
+	double maxacor = Rf_asReal(listElement(STATE, "maxacor"));
+	double minacor = Rf_asReal(listElement(STATE, "minacor"));
+	int startNit = nit;
+
+	int dim = Rf_length(VECTOR_ELT(ans, 0));
+	SEXP AC = PROTECT(Rf_allocVector(REALSXP, dim));
+	double * ac = REAL(AC);
+	for (int i = 0; i < dim; i++)
+	{
+		ac[i] = prod0[i] > 1e-12 ? prod1[i] / prod0[i] : -2;
+	}
+	int freeCount = 0;
+	for (int i = 0; i < dim; i++)
+	{
+		if (!fixed[i])
+		{
+			freeCount++;
+		}
+	}
+	if (!diagg && freeCount > 0 &&
+		Rf_length(SFINVCOV) != freeCount * freeCount)
+	{
+		Rf_error("sfinvcov does not match the free parameters");
+	}
+
+	/* theta is passed on to the model through a vector of its own */
+	SEXP THETA = PROTECT(Rf_allocVector(REALSXP, dim));
+
+	/* the parameters and deviations of each iteration */
+	int rows = lastIteration - startNit;
+	SEXP THETAS = PROTECT(Rf_allocMatrix(REALSXP, rows, dim + 1));
+	SEXP FRAS = PROTECT(Rf_allocMatrix(REALSXP, rows, dim + 1));
+
+	pModel->needScores(dolby);
+	pModel->needDerivatives(false);
+	pModel->needChain(false);
+	pModel->needChangeContributions(false);
+
+	vector<StatisticRequest> requests;
+	getStatisticRequests(EFFECTSLIST, &requests);
+	vector<double> fra(dim);
+	vector<double> score(dim);
+	vector<double> product(dim);
+	vector<double> changestep(dim);
+	vector<double> freeFra(freeCount);
+	bool boundExceeded = false;
+	bool finished = false;
+
+	GetRNGstate();
+
+	while (nit < lastIteration)
+	{
+		int row = nit - startNit;
+		nit++;
+
+		REAL(THETAS)[row] = subphase;
+		for (int i = 0; i < dim; i++)
+		{
+			REAL(THETAS)[row + (i + 1) * rows] = theta[i];
+			REAL(THETA)[i] = theta[i];
+		}
+
+		updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+		try
+		{
+			simulateStatisticSums(requests, pGroupData, pModel, dim, &fra,
+				&score);
+		}
+		catch (...)
+		{
+			PutRNGstate();
+			throw;
+		}
+
+		REAL(FRAS)[row] = subphase;
+		for (int i = 0; i < dim; i++)
+		{
+			fra[i] -= targets[i];
+			REAL(FRAS)[row + (i + 1) * rows] = fra[i];
+
+			if (dolby)
+			{
+				// Subtract the regression on the scores
+				fra[i] -= regrCoef[i] * score[i];
+			}
+		}
+
+		/* autocorrelations for the end of the subphase */
+		if (nit % 2 == 1)
+		{
+			for (int i = 0; i < dim; i++)
+			{
+				prevfra[i] = fra[i];
+			}
+		}
+		else
+		{
+			maxacor = -99;
+			minacor = 1;
+			for (int i = 0; i < dim; i++)
+			{
+				prod0[i] += fra[i] * fra[i];
+				prod1[i] += fra[i] * prevfra[i];
+				ac[i] = prod0[i] > 1e-12 ? prod1[i] / prod0[i] : -2;
+
+				if (!fixed[i])
+				{
+					maxacor = max(maxacor, ac[i]);
+
+					if (ac[i] > -1.0)
+					{
+						minacor = min(minacor, ac[i]);
+					}
+				}
+			}
+		}
+
+		/* limit the change */
+		double maxRatio = 1.0;
+		if (diagg)
+		{
+			maxRatio = R_NegInf;
+			for (int i = 0; i < dim; i++)
+			{
+				double ratio = fixed[i] ? 1.0 : fabs(fra[i]) / sd[i];
+
+				if (!ISNAN(ratio))
+				{
+					maxRatio = max(maxRatio, ratio);
+				}
+			}
+		}
+		else if (freeCount > 0)
+		{
+			const double * sfInvCov = REAL(SFINVCOV);
+			int k = 0;
+			for (int i = 0; i < dim; i++)
+			{
+				if (!fixed[i])
+				{
+					freeFra[k++] = fra[i];
+				}
+			}
+
+			double quadraticForm = 0;
+			for (int j = 0; j < freeCount; j++)
+			{
+				double element = 0;
+				for (int i = 0; i < freeCount; i++)
+				{
+					element += freeFra[i] * sfInvCov[i + j * freeCount];
+				}
+				quadraticForm += element * freeFra[j];
+			}
+			maxRatio = sqrt(quadraticForm / freeCount);
+		}
+		if (ISNAN(maxRatio))
+		{
+			maxRatio = 1.0;
+		}
+		if (maxRatio > truncation)
+		{
+			for (int i = 0; i < dim; i++)
+			{
+				fra[i] = truncation * fra[i] / maxRatio;
+			}
+			truncated[nit - 1] = TRUE;
+		}
+		if (doubleAveraging)
+		{
+			for (int i = 0; i < dim; i++)
+			{
+				sumfra[i] += fra[i];
+				fra[i] = sumfra[i];
+			}
+		}
+
+		/* the change step */
+		if (!diagg)
+		{
+			for (int i = 0; i < dim; i++)
+			{
+				product[i] = 0;
+			}
+			for (int j = 0; j < dim; j++)
+			{
+				for (int i = 0; i < dim; i++)
+				{
+					product[i] += dinvv[i + j * dim] * fra[j];
+				}
+			}
+		}
+		for (int i = 0; i < dim; i++)
+		{
+			if (standardizeVar)
+			{
+				if (diagg)
+				{
+					changestep[i] = fra[i] / sd[i];
+				}
+				else if (standardizeWithTruncation)
+				{
+					changestep[i] = product[i] * min(standardization[i], 1.0);
+				}
+				else
+				{
+					changestep[i] = product[i] * standardization[i];
+				}
+			}
+			else if (diagg)
+			{
+				changestep[i] = fra[i] / dfraDiagonal[i];
+			}
+			else
+			{
+				changestep[i] = product[i];
+			}
+		}
+
+		/* update theta, checking the positivity restriction */
+		bool reachedBound = false;
+		for (int i = 0; i < dim; i++)
+		{
+			double fchange = fixed[i] ? 0.0 : gain * changestep[i];
+
+			if (ISNAN(fchange))
+			{
+				fchange = 0;
+			}
+			if (fchange > theta[i])
+			{
+				if (posj[i])
+				{
+					positivized[i]++;
+					fchange = theta[i] * 0.5;
+				}
+			}
+			if (!posj[i])
+			{
+				positivized[i] = 0;
+			}
+
+			if (doubleAveraging)
+			{
+				theta[i] = thav[i] / thavn - fchange;
+			}
+			else
+			{
+				theta[i] -= fchange;
+			}
+		}
+		for (int i = 0; i < dim; i++)
+		{
+			thav[i] += theta[i];
+
+			if (!fixed[i] && fabs(theta[i]) > thetaBound)
+			{
+				reachedBound = true;
+			}
+		}
+		thavn++;
+
+		/* do we stop? */
+		if (!(ISNAN(minacor) || ISNAN(maxacor)))
+		{
+			finished = (nit >= n2min && maxacor < 1e-10) ||
+				nit >= n2max ||
+				(nit >= 50 && minacor < -0.8 && canRepeat);
+		}
+
+		if (reachedBound)
+		{
+			boundExceeded = true;
+			break;
+		}
+		if (finished)
+		{
+			break;
+		}
+	}
+
+	PutRNGstate();
+
+	/* return the state with the trajectory of this call */
+	int done = nit - startNit;
+	SEXP thetas = PROTECT(Rf_allocMatrix(REALSXP, done, dim + 1));
+	SEXP fras = PROTECT(Rf_allocMatrix(REALSXP, done, dim + 1));
+	for (int j = 0; j <= dim; j++)
+	{
+		for (int row = 0; row < done; row++)
+		{
+			REAL(thetas)[row + j * done] = REAL(THETAS)[row + j * rows];
+			REAL(fras)[row + j * done] = REAL(FRAS)[row + j * rows];
+		}
+	}
+
+	SET_VECTOR_ELT(ans, 8, AC);
+	SET_VECTOR_ELT(ans, 9, Rf_ScalarReal(thavn));
+	SET_VECTOR_ELT(ans, 10, Rf_ScalarInteger(nit));
+	SET_VECTOR_ELT(ans, 11, Rf_ScalarReal(maxacor));
+	SET_VECTOR_ELT(ans, 12, Rf_ScalarReal(minacor));
+	SET_VECTOR_ELT(ans, 13, Rf_ScalarLogical(boundExceeded));
+	SET_VECTOR_ELT(ans, 14, Rf_ScalarLogical(finished || nit >= n2max));
+	SET_VECTOR_ELT(ans, 15, thetas);
+	SET_VECTOR_ELT(ans, 16, fras);
+	UNPROTECT(8);
+	return ans;
+}
+
+/**
+ * Does the Metropolis-Hastings steps of mlPeriod and returns their results.
+ */
+static SEXP mlPeriodSteps(SEXP DERIV, SEXP DATAPTR, SEXP MODELPTR,
+	SEXP EFFECTSLIST, SEXP THETA, SEXP GROUP, SEXP PERIOD,
+	SEXP NRUNMH, SEXP ADDCHAINTOSTORE,
+	SEXP RETURNDATAFRAME, SEXP RETURNDEPS, SEXP RETURNCHAINS,
+	SEXP RETURNLOGLIK, SEXP ONLYLOGLIK)
+{
+	/* do some MH steps and return some or all of the scores and derivs
+	   of the chain at the end or the calculated log likelihood*/
+
+	/* get hold of the data vector */
+	vector<Data *> * pGroupData = (vector<Data *> *)
+		R_ExternalPtrAddr(DATAPTR);
+
+	int group = Rf_asInteger(GROUP) - 1;
+	int period = Rf_asInteger(PERIOD) - 1;
+	int groupPeriod = periodFromStart(*pGroupData, group, period);
+
+	/* get hold of the data object */
+	Data * pData = (*pGroupData)[group];
+
+	/* get hold of the model object */
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+
+	/* update the parameters */
+	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+
+	/* create the ML simulation object */
+	MLSimulation * pMLSimulation = new MLSimulation(pData, pModel);
+
+	/* initialize some data from model */
+	pMLSimulation->simpleRates(pModel->simpleRates());
+
+	pMLSimulation->currentPermutationLength(
+		pModel->currentPermutationLength(period));
+
+	// next calls are ambiguous unless I use a const pModel
+	const Model * pConstModel = pModel;
 
 	pMLSimulation->
 		missingNetworkProbability(pConstModel->
@@ -533,23 +1017,28 @@ SEXP mlPeriod(SEXP DERIV, SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
 		missingBehaviorProbability(pConstModel->
 			missingBehaviorProbability(groupPeriod));
 
-	// get chain for this period from model
-	Chain * pChain = pModel->rChainStore(groupPeriod).back();
-
-	// then copy the chain to the MLSimulation object. (deleting new one first)
-	pMLSimulation->pChain(pChain->copyChain());
-	//	Rprintf(" %d\n", pMLSimulation->pChain()->ministepCount());
-
 	int addChainToStore = 0;
 	if (!Rf_isNull(ADDCHAINTOSTORE))
 	{
 		addChainToStore = Rf_asInteger(ADDCHAINTOSTORE);
 	}
-	// prepare to recreate after the simulation
-	if (!addChainToStore)
+
+	// get the last chain for this period from the model. If it is to be
+	// recreated after the simulation anyway, hand it over to the
+	// MLSimulation object rather than copying it. (deleting new one first)
+	ChainStore * pChainStore = pModel->pChainStore();
+	Chain * pChain = 0;
+	if (addChainToStore)
+	{
+		pChain = pChainStore->pChain(groupPeriod,
+			pChainStore->size(groupPeriod) - 1)->copyChain();
+	}
+	else
 	{
-		pModel->deleteLastChainStore(groupPeriod);
+		pChain = pChainStore->removeLast(groupPeriod);
 	}
+	pMLSimulation->pChain(pChain);
+	//	Rprintf(" %d\n", pMLSimulation->pChain()->ministepCount());
 
 	int returnDeps = 0;
 	if (!Rf_isNull(RETURNDEPS))
@@ -611,7 +1100,13 @@ SEXP mlPeriod(SEXP DERIV, SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
 	pChain = pMLSimulation->pChain();
 	pChain->createInitialStateDifferences();
 	pMLSimulation->createEndStateDifferences();
-	pModel->chainStore(*pChain, groupPeriod);
+
+	// Store the chain on the model without copying it as soon as it is
+	// complete, so that an error below does not leave the store without it.
+	// The simulation only reads the chain from here on, and the last chain
+	// of a period stays in memory; it is released before the simulation
+	// is deleted.
+	pModel->chainStore(pChain, groupPeriod);
 
 	/* and current permutation length */
 	pModel->currentPermutationLength(period,
@@ -730,48 +1225,721 @@ SEXP mlPeriod(SEXP DERIV, SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
 		{
 			for (unsigned ii = 0; ii < derivs.size(); ii++)
 			{
-				rdff[ii] = derivs[ii];
+				rdff[ii] = derivs[ii];
+			}
+		}
+		PROTECT(ans = Rf_allocVector(VECSXP, 12));
+		nProtects++;
+
+		/* set up the return object */
+		if (deriv)
+		{
+			SET_VECTOR_ELT(ans, 6, dff);
+		}
+		if (returnChains)
+		{
+			SET_VECTOR_ELT(ans, 5, sims);/* not done in phase 2 !!!!test this*/
+		}
+		SET_VECTOR_ELT(ans, 0, fra);
+		SET_VECTOR_ELT(ans, 7, accepts);
+		SET_VECTOR_ELT(ans, 8, rejects);
+		SET_VECTOR_ELT(ans, 9, aborts);
+		SET_VECTOR_ELT(ans, 10, Rf_ScalarReal(loglik));
+		SET_VECTOR_ELT(ans, 11, theseDeps);
+
+//	Rf_PrintValue(getChainDF(*pChain, true));
+	}
+	else
+	{
+		PROTECT(ans = Rf_allocVector(VECSXP, 5));
+		nProtects++;
+		SET_VECTOR_ELT(ans, 0, Rf_ScalarReal(loglik));
+		SET_VECTOR_ELT(ans, 1, accepts);
+		SET_VECTOR_ELT(ans, 2, rejects);
+		SET_VECTOR_ELT(ans, 3, aborts);
+//		SET_VECTOR_ELT(ans, 4, sims);
+//		SET_VECTOR_ELT(ans, 5, theseDeps);
+	}
+
+	PutRNGstate();
+
+	/* the chain belongs to the model now */
+	pMLSimulation->releaseChain();
+
+	delete pMLSimulation;
+	UNPROTECT(nProtects);
+	return(ans);
+}
+
+/**
+ * Recalculates the probabilities of the chain of getChainProbabilities and
+ * returns them.
+ */
+static SEXP chainProbabilities(SEXP DATAPTR, SEXP MODELPTR,
+	SEXP GROUP, SEXP PERIOD, SEXP INDEX, SEXP EFFECTSLIST, SEXP THETA,
+	SEXP GETSCORES)
+{
+	/* need to make sure the parameters have been updated first */
+
+	/* get hold of the data vector */
+	vector<Data *> * pGroupData = (vector<Data *> *)
+		R_ExternalPtrAddr(DATAPTR);
+
+	int group = Rf_asInteger(GROUP) - 1;
+	int period = Rf_asInteger(PERIOD) - 1;
+	int groupPeriod = periodFromStart(*pGroupData, group, period);
+	Data * pData = (*pGroupData)[group];
+	/* get hold of the model object */
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+
+	/* update the parameters */
+	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+
+	/* create the ML simulation object */
+	MLSimulation * pMLSimulation = new MLSimulation(pData, pModel);
+
+	pMLSimulation->simpleRates(pModel->simpleRates());
+
+	// get chain for this period from model
+	ChainStore * pChainStore = pModel->pChainStore();
+	int index = pChainStore->size(groupPeriod) - Rf_asInteger(INDEX);
+	//Rprintf(" %d \n",pChainStore->size(groupPeriod));
+	if (index < 0)
+	{
+		Rf_error("index invalid");
+	}
+	const Chain * pChain = pChainStore->pChain(groupPeriod, index);
+	// then copy the chain to the MLSimulation object. (deleting new one first)
+	pMLSimulation->pChain(pChain->copyChain());
+
+	int needScores = Rf_asInteger(GETSCORES);
+	int deriv = 0;
+	pModel->needScores(needScores);
+	pModel->needDerivatives(deriv);
+
+	/* set the number of steps to zero */
+	pModel->numberMLSteps(0);
+
+	/* run the epoch simulation for this period (do initialization) */
+	pMLSimulation->runEpoch(period);
+
+	SEXP ans;
+	PROTECT(ans = Rf_allocVector(VECSXP, 3));
+
+	double loglik = pMLSimulation->calculateLikelihood();
+
+	SET_VECTOR_ELT(ans, 0, Rf_ScalarReal(loglik));
+
+	if (needScores)
+	{
+		int dim = 0;
+		for (int i = 0; i < Rf_length(EFFECTSLIST); i++)
+		{
+			dim += Rf_length(VECTOR_ELT(VECTOR_ELT(EFFECTSLIST, i), 0));
+		}
+
+		/* fra will contain the scores and must be initialised
+		   to 0. Use rfra to reduce function evaluations. */
+		SEXP fra;
+		double * rfra;
+		PROTECT(fra = Rf_allocVector(REALSXP, dim));
+		rfra = REAL(fra);
+		for (int i = 0; i < Rf_length(fra); i++)
+		{
+			rfra[i] = 0;
+		}
+
+		/* dff will hold the return values of the derivatives */
+		SEXP dff;
+		double *rdff;
+		if (deriv)
+		{
+			PROTECT(dff = Rf_allocVector(REALSXP, dim * dim));
+			rdff = REAL(dff);
+			for (int i = 0; i < Rf_length(dff); i++)
+			{
+				rdff[i] = 0.0;
+			}
+		}
+
+		/* collect the scores and derivatives */
+		vector<double> derivs(dim * dim);
+		vector<double> score(dim);
+		getScores(EFFECTSLIST, 	period, group, pMLSimulation,
+			&derivs, &score);
+		/* fill up vectors for  return value list */
+		for (unsigned effectNo = 0; effectNo < score.size();
+			 effectNo++)
+		{
+			rfra[effectNo] = score[effectNo];
+		}
+		if (deriv)
+		{
+			for (unsigned ii = 0; ii < derivs.size(); ii++)
+			{
+				rdff[ii] = derivs[ii];
+			}
+		}
+		SET_VECTOR_ELT(ans, 1, fra);
+		UNPROTECT(1);
+		if (deriv)
+		{
+			SET_VECTOR_ELT(ans, 2, dff);
+			UNPROTECT(1);
+		}
+	}
+
+	delete pMLSimulation;
+
+	UNPROTECT(1);
+	return  ans;
+}
+
+extern "C"
+{
+
+/**
+ *  Does one forward simulation for all the data by period within group
+ */
+SEXP forwardModel(SEXP DERIV, SEXP DATAPTR, SEXP SEEDS,
+	SEXP FROMFINITEDIFF, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP THETA, SEXP RANDOMSEED2, SEXP RETURNDEPS, SEXP NEEDSEEDS,
+	SEXP USESTREAMS, SEXP ADDCHAINTOSTORE, SEXP RETURNCHAINS, SEXP RETURNLOGLIK,
+	SEXP RETURNACTORSTATISTICS, SEXP RETURNCHANGECONTRIBUTIONS, SEXP RETURNDATAFRAME)
+{
+	SEXP NEWRANDOMSEED = PROTECT(Rf_duplicate(RANDOMSEED2)); // for parallel testing only
+
+	/* create a simulation and return the observed statistics and scores */
+
+	/* get hold of the data vector */
+	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
+
+	/* get hold of the model object */
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+	//	Rprintf("%x %x\n", pGroupData, pModel);
+	int nGroups = pGroupData->size();
+
+	/* find total number of periods to process */
+	int totObservations = totalPeriods(*pGroupData);
+	int fromFiniteDiff = Rf_asInteger(FROMFINITEDIFF);
+	int useStreams = Rf_asInteger(USESTREAMS);
+	int addChainToStore = sexp_to_int(ADDCHAINTOSTORE, 0);
+	int returnDependents = Rf_asInteger(RETURNDEPS);
+	int returnChains = sexp_to_int(RETURNCHAINS, 0);
+	int returnLoglik = sexp_to_int(RETURNLOGLIK, 0);
+	int returnActorStatistics = sexp_to_int(RETURNACTORSTATISTICS, 0);
+	int returnChangeContributions = sexp_to_int(RETURNCHANGECONTRIBUTIONS, 0);
+	int returnDataFrame = sexp_to_int(RETURNDATAFRAME, 0);
+	int deriv = Rf_asInteger(DERIV);
+	int needSeeds = Rf_asInteger(NEEDSEEDS);
+
+	/* set the deriv flag on the model */
+	pModel->needScores(deriv);
+	pModel->needDerivatives(false);
+//	pModel->needDerivatives(deriv); // ABC
+
+	/* set the chain flag on the model */
+	pModel->needChain(returnChains == 1 || addChainToStore == 1
+			|| returnLoglik == 1 || returnChangeContributions == 1);
+
+	/* set the change contribution flag on the model */
+	pModel->needChangeContributions(returnChangeContributions);
+
+	/* update the parameters */
+	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+
+	/* ans will be the return value */
+	SEXP ans = PROTECT(Rf_allocVector(VECSXP, 11));
+
+	/* count up the total number of parameters */
+	int dim = 0;
+	for (int i = 0; i < Rf_length(EFFECTSLIST); i++)
+	{
+		dim += Rf_length(VECTOR_ELT(VECTOR_ELT(EFFECTSLIST, i), 0));
+	}
+
+	/* the statistics to be retrieved from each simulation */
+	vector<StatisticRequest> requests;
+	getStatisticRequests(EFFECTSLIST, &requests);
+
+	/* get the random seed from R into memory */
+	GetRNGstate();
+
+	/* fra will contain the simulated statistics and must be initialised
+	   to 0. Use rfra to reduce function evaluations. */
+	SEXP fra;
+	double * rfra;
+	PROTECT(fra = Rf_allocMatrix(REALSXP, dim, totObservations));
+	rfra = REAL(fra);
+	for (int i = 0; i < Rf_length(fra); i++)
+	{
+		rfra[i] = 0;
+	}
+	/* ntim is the total time taken in each period (relevant for conditional
+		 estimation) */
+	SEXP ntim;
+	double * rntim;
+	PROTECT(ntim = Rf_allocVector(REALSXP, totObservations));
+	rntim = REAL(ntim);
+	for (int i = 0; i < Rf_length(ntim); i++)
+		rntim[i] = 0.0;
+
+	/* sims will be the returned simulated dependent variables */
+	SEXP sims;
+	PROTECT(sims = Rf_allocVector(VECSXP, nGroups));
+	if (returnDependents)
+	{
+		int nVariables = (*pGroupData)[0]->rDependentVariableData().size();
+		for (int group = 0; group < nGroups; group++)
+		{
+			SET_VECTOR_ELT(sims, group, Rf_allocVector(VECSXP, nVariables));
+			for (int variable = 0; variable < nVariables; variable++)
+			{
+				SET_VECTOR_ELT(VECTOR_ELT(sims, group), variable,
+					Rf_allocVector(VECSXP, (*pGroupData)[group]->
+						observationCount() - 1));
+			}
+		}
+	}
+	/* chains will be the returned chains */
+	SEXP chains = PROTECT(Rf_allocVector(VECSXP, nGroups));
+	if (returnChains)
+	{
+		for (int group = 0; group < nGroups; group++)
+		{
+			SET_VECTOR_ELT(chains, group,
+				Rf_allocVector(VECSXP, (*pGroupData)[group]->
+					observationCount() - 1));
+		}
+	}
+
+	/* changeContributionChain will be the returned change contributions for all chains */
+	SEXP changeContributionChains = PROTECT(Rf_allocVector(VECSXP, nGroups));
+	if (returnChangeContributions)
+	{
+		for (int group = 0; group < nGroups; group++)
+		{
+			SET_VECTOR_ELT(changeContributionChains, group,
+					Rf_allocVector(VECSXP, (*pGroupData)[group]->observationCount() - 1));
+		}
+	}
+
+	/* actorStats will be the returned statistics of individual actors*/
+	SEXP actorStats = PROTECT(Rf_allocVector(VECSXP,nGroups));
+	if(returnActorStatistics)
+	{
+		SEXP NETWORKTYPES;
+		NETWORKTYPES = createRObjectAttributes(EFFECTSLIST, actorStats);
+		int objEffects = Rf_length(NETWORKTYPES);
+		for (int group = 0; group < nGroups; group++)
+		{
+			SET_VECTOR_ELT(actorStats, group, Rf_allocVector(VECSXP, (*pGroupData)[group]->observationCount()-1));
+			for (int p = 0; p < (*pGroupData)[group]->observationCount()-1; p++)
+			{
+				SET_VECTOR_ELT(VECTOR_ELT(actorStats,group), p, Rf_allocVector(VECSXP,objEffects));
+			}
+		}
+	}
+
+	/* loglik will be the returned log likelihoods */
+	SEXP logliks = PROTECT(Rf_allocVector(REALSXP, totObservations));
+	double * Rlogliks = REAL(logliks);
+
+	/* auxiliary will hold the auxiliary statistics of each period */
+	vector<double *> auxiliary;
+	SEXP auxiliaryStatistics = PROTECT(allocateAuxiliaryStatistics(pModel,
+		1, totObservations, &auxiliary));
+
+	/* seed store is a list to save the random states */
+	SEXP seedstore = PROTECT(Rf_allocVector(VECSXP, nGroups));
+	for (int group = 0; group < nGroups; group++)
+	{
+		SET_VECTOR_ELT(seedstore, group,
+			Rf_allocVector(VECSXP, (*pGroupData)[group]->observationCount() - 1));
+	}
+
+	/* rs will allow us to access or set the .Random.seed in R */
+	SEXP rs = PROTECT(Rf_install(".Random.seed"));
+
+	/* scores will hold the return values of the scores */
+	SEXP scores;
+	double *rscores;
+	PROTECT(scores = Rf_allocMatrix(REALSXP, dim, totObservations));
+	rscores = REAL(scores);
+	for (int i = 0; i < Rf_length(scores); i++)
+		rscores[i] = 0.0;
+
+	int periodFromStart = 0;
+
+	SEXP Cgstr = R_NilValue;
+	SEXP STREAMS = R_NilValue;
+	SEXP ans2, ans3, ans4, R_fcall1, R_fcall2, R_fcall3, R_fcall4;
+	SEXP seedvector;
+
+	if (useStreams)
+	{
+		// create an R character string
+		PROTECT(Cgstr = Rf_allocVector(STRSXP,1));
+		SET_STRING_ELT(Cgstr, 0, Rf_mkChar("Cg"));
+
+		// find out which stream we are using
+		PROTECT(R_fcall1 = Rf_lang1(Rf_install(".lec.GetStreams")));
+		PROTECT(STREAMS = Rf_eval(R_fcall1, R_GlobalEnv));
+	}
+
+	/* group loop here */
+	for (int group = 0; group < nGroups; group++)
+	{
+		/* random states need store (not fromFiniteDiff)
+		   or restore (fromFiniteDiff) for each period
+		   within each  group */
+		SEXP seeds = R_NilValue;
+		if (fromFiniteDiff)
+		{
+			seeds = VECTOR_ELT(SEEDS, group);
+		}
+
+		/* find out how many periods in this Data object */
+		Data * pData = (*pGroupData)[group];
+		int observations = pData->observationCount();
+
+		/* create my epochsimulation object */
+		EpochSimulation * pEpochSimulation  = new
+			EpochSimulation(pData, pModel);
+
+		for (int period = 0; period < observations - 1; period++)
+		{
+
+			periodFromStart++;
+
+			if (!Rf_isNull(RANDOMSEED2)) /* parallel testing versus Siena3 */
+			{
+				// overwrite R's random number seed
+				Rf_defineVar(rs, RANDOMSEED2, R_GlobalEnv);
+				// get it into memory
+				GetRNGstate();
+				// move on one
+				nextDouble();
+				// write it back to R
+				PutRNGstate();
+			}
+			else /* normal run */
+			{
+				if (fromFiniteDiff) /* restore state */
+				{
+					if (useStreams) /* using lecuyer random numbers */
+					{
+						// overwrite the current state in R
+						PROTECT(R_fcall2 = Rf_lang4(Rf_install("[[<-"),
+								Rf_install(".lec.Random.seed.table"), Cgstr,
+								VECTOR_ELT(seeds, period)));
+						PROTECT(ans2 = Rf_eval(R_fcall2, R_GlobalEnv));
+						// get the overwritten state into C table
+						PROTECT(R_fcall3 =
+							Rf_lang2(Rf_install(".lec.CurrentStream"),
+								STREAMS));
+						PROTECT(ans3 = Rf_eval(R_fcall3, R_GlobalEnv));
+						UNPROTECT(4);
+					}
+					else /* using normal random numbers */
+					{
+						// overwrite R's current state
+						Rf_defineVar(rs, VECTOR_ELT(seeds, period),
+							R_GlobalEnv);
+						// get the value from .Random.seed into memory
+						GetRNGstate();
+					}
+				}
+				else /* save state */
+				{
+					if (needSeeds)
+					{
+						if (useStreams)
+						{
+							PROTECT(R_fcall2 =
+								Rf_lang2(Rf_install(".lec.ResetNextSubstream"),
+									STREAMS));
+							PROTECT(ans2 = Rf_eval(R_fcall2, R_GlobalEnv));
+
+							PROTECT(R_fcall3 =
+								Rf_lang2(Rf_install(".lec.CurrentStream"),
+									STREAMS));
+							PROTECT(ans3 = Rf_eval(R_fcall3, R_GlobalEnv));
+							// get the relevant current state from R
+							PROTECT(R_fcall4 = Rf_lang3(Rf_install("[["),
+									Rf_install(".lec.Random.seed.table"),
+									Cgstr));
+							ans4 = Rf_eval(R_fcall4, R_GlobalEnv);
+							// value is not kept unless we duplicate it
+							PROTECT(seedvector = Rf_duplicate(ans4));
+							// store the Cg values
+							SET_VECTOR_ELT(VECTOR_ELT(seedstore, group),
+								period, seedvector);
+							UNPROTECT(6);
+						}
+						else
+						{
+							PutRNGstate();
+							SET_VECTOR_ELT(VECTOR_ELT(seedstore, group),
+								period, R_getVar(rs, R_GlobalEnv, TRUE));
+						}
+					}
+				}
+			}
+
+			/* only needed for forward chains */
+			if (pModel->needChain())
+			{
+				pEpochSimulation->clearChain();
+			}
+			/* run the epoch simulation for this period */
+			pEpochSimulation->runEpoch(period);
+
+			State State(pEpochSimulation);
+			StatisticCalculator Calculator(pData, pModel, &State,
+				period);
+			vector<double> statistic(dim);
+			vector<double> score(dim);
+			getStatistics(requests, &Calculator,
+				period, group, pData, pEpochSimulation,
+				&statistic, &score);  // ABC
+			/* fill up matrices for  return value list */
+			int iii = (periodFromStart - 1) * dim;
+			for (unsigned effectNo = 0; effectNo < statistic.size();
+				 effectNo++)
+			{
+				rfra[iii + effectNo] = statistic[effectNo];
+				rscores[iii + effectNo] = score[effectNo];
+			}
+
+			if(returnActorStatistics)
+			{
+				StatisticCalculator Calculator(pData, pModel, &State, period, returnActorStatistics);
+				vector<double *> actorStatistics;
+				getActorStatistics(EFFECTSLIST, &Calculator, &actorStatistics);
+				int actors = pData->rDependentVariableData()[0]->n();
+				for(unsigned e = 0; e < actorStatistics.size(); e++)
+				{
+					SEXP actorStatsValues;
+					PROTECT(actorStatsValues = Rf_allocVector(REALSXP, actors));
+					double * astats = REAL(actorStatsValues);
+					for(int i = 0; i < actors; i++)
+					{
+						astats[i] = actorStatistics.at(e)[i];
+					}
+					SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(actorStats,group), period), e, actorStatsValues);
+					UNPROTECT(1);
+				}
+			}
+			if (pModel->conditional())
+			{
+				rntim[periodFromStart - 1] = pEpochSimulation->time();
+			}
+			storeAuxiliaryStatistics(pModel, pData, &State, period, 0, 1,
+				periodFromStart - 1, totObservations, auxiliary);
+			// get simulated network
+			if (returnDependents)
+			{
+				const vector<DependentVariable *> rVariables =
+					pEpochSimulation->rVariables();
+				for (unsigned i = 0; i < rVariables.size(); i++)
+				{
+					// Rprintf("attach var %d (2)\n", i);
+					SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(sims, group), i), period,
+							var_to_sexp(rVariables[i]));
+				}
+                
+                const vector<ContinuousVariable *> rContinuousVariables =
+                    pEpochSimulation->rContinuousVariables();
+                for (unsigned i = 0; i < rContinuousVariables.size(); i++)
+                {
+                    ContinuousVariable * pContinuousVariable =
+                        rContinuousVariables[i];
+                    SEXP theseValues = getContinuousValues(*pContinuousVariable);
+                        SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(sims,
+                                    group), i + rVariables.size()),
+                                    period, theseValues);
+                }
+			}
+			if (returnChains)
+			{
+				SEXP thisChain;
+				if (returnDataFrame)
+				{
+					thisChain = getChainDFPlus(*(pEpochSimulation->pChain()), true);
+				}
+				else
+				{
+					thisChain = getChainList(*(pEpochSimulation->pChain()));
+				}
+				SET_VECTOR_ELT(VECTOR_ELT(chains, group), period, thisChain);
 			}
-		}
-		PROTECT(ans = Rf_allocVector(VECSXP, 12));
-		nProtects++;
+			if(returnChangeContributions)
+			{
+				SEXP thisChangeContributions = getChangeContributionsList(*(pEpochSimulation->pChain()), EFFECTSLIST);
+				SET_VECTOR_ELT(VECTOR_ELT(changeContributionChains, group), period, thisChangeContributions);
+			}
+			if (returnLoglik)
+			{
+				pEpochSimulation->simpleRates(pModel->simpleRates());
+				Rlogliks[periodFromStart - 1] =
+					pEpochSimulation->calculateLikelihood();
+			}
+			if (addChainToStore)
+			{
+				pModel->chainStore(*(pEpochSimulation->pChain()),
+					periodFromStart - 1);
+			}
+		} /* end of period */
+		delete pEpochSimulation;
+	} /* end of group */
 
-		/* set up the return object */
-		if (deriv)
-		{
-			SET_VECTOR_ELT(ans, 6, dff);
-		}
-		if (returnChains)
+	/* send the .Random.seed back to R */
+	PutRNGstate();
+	NEWRANDOMSEED = R_getVar(rs, R_GlobalEnv, TRUE);
+
+	/* set up the return object */
+	if (!fromFiniteDiff)
+	{
+		if (needSeeds)
 		{
-			SET_VECTOR_ELT(ans, 5, sims);/* not done in phase 2 !!!!test this*/
+			SET_VECTOR_ELT(ans, 2, seedstore);
 		}
-		SET_VECTOR_ELT(ans, 0, fra);
-		SET_VECTOR_ELT(ans, 7, accepts);
-		SET_VECTOR_ELT(ans, 8, rejects);
-		SET_VECTOR_ELT(ans, 9, aborts);
-		SET_VECTOR_ELT(ans, 10, Rf_ScalarReal(loglik));
-		SET_VECTOR_ELT(ans, 11, theseDeps);
-
-//	Rf_PrintValue(getChainDF(*pChain, true));
 	}
-	else
+	if (deriv)
 	{
-		PROTECT(ans = Rf_allocVector(VECSXP, 5));
-		nProtects++;
-		SET_VECTOR_ELT(ans, 0, Rf_ScalarReal(loglik));
-		SET_VECTOR_ELT(ans, 1, accepts);
-		SET_VECTOR_ELT(ans, 2, rejects);
-		SET_VECTOR_ELT(ans, 3, aborts);
-//		SET_VECTOR_ELT(ans, 4, sims);
-//		SET_VECTOR_ELT(ans, 5, theseDeps);
+		SET_VECTOR_ELT(ans, 1, scores);
+	}
+	if (returnDependents)
+	{
+		SET_VECTOR_ELT(ans, 5, sims);/* not done in phase 2 !!test this */
 	}
+	SET_VECTOR_ELT(ans, 0, fra);
+	SET_VECTOR_ELT(ans, 3, ntim);
 
-	PutRNGstate();
-	delete pMLSimulation;
-	UNPROTECT(nProtects);
+	if (!Rf_isNull(RANDOMSEED2))
+	{
+		SET_VECTOR_ELT(ans, 4, NEWRANDOMSEED);
+	}
+	if (useStreams)
+	{
+		UNPROTECT(3);
+	}
+	SET_VECTOR_ELT(ans, 6, chains);
+	SET_VECTOR_ELT(ans, 7, logliks);
+	SET_VECTOR_ELT(ans, 8, changeContributionChains);
+	SET_VECTOR_ELT(ans, 9, actorStats);
+	SET_VECTOR_ELT(ans, 10, auxiliaryStatistics);
+	UNPROTECT(13);
 	return(ans);
 }
 
+/**
+ * Runs the iterations of one repeat of a subphase of phase 2 of the
+ * Robbins-Monro algorithm, as doIterations in phase2.r does for a single
+ * process: each iteration simulates the model with the current parameters,
+ * truncates the deviations from the targets, and updates the parameters
+ * with the given gain. The iteration stops by the same criteria as in R,
+ * as soon as a free parameter exceeds the bound thetaBound, which is left
+ * to R to report, or after the iteration lastIteration of CONTROL, so that
+ * R can calibrate its reporting frequency and report progress in between.
+ *
+ * STATE is a list with the components theta, thav, thavn, nit, prod0,
+ * prod1, maxacor, minacor, sumfra, prevfra, truncated, and positivized
+ * of the R control object z, so that the iterations can be resumed after
+ * a return; CONTROL holds the targets and the constant settings of
+ * the subphase. The updated state is returned as a list of the same
+ * components, together with the autocorrelations, the flags
+ * boundExceeded and finished, and the parameters used and the deviations
+ * obtained in each iteration of this call.
+ *
+ * A user interrupt is only checked for after the iterations have returned
+ * the random number state to R and released their objects.
+ */
+SEXP phase2Subphase(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP STATE, SEXP CONTROL)
+{
+	return callEngine([&]()
+	{
+		return phase2Iterations(DATAPTR, MODELPTR, EFFECTSLIST, STATE,
+			CONTROL);
+	});
+}
+
+/**
+ * Runs the given number of independent forward simulations of all groups
+ * and periods with the parameters THETA, as needed for phase 3 of the
+ * estimation. Returns a list with the statistics summed over the periods as
+ * a replications x effects matrix (statistics), the statistics and the
+ * scores of each period as replications x periods x effects arrays (fra,
+ * and sc if DERIV is true), and the simulated time of each period as a
+ * replications x periods matrix (ntim), and the auxiliary statistics of
+ * the model as a list of replications x periods x size arrays (auxiliary).
+ *
+ * With a single thread the replications use the random number generator
+ * of R, in the same order as a sequence of calls of forwardModel. With
+ * more threads each replication draws from a stream of its own, seeded
+ * from the generator of R, so that the results do not depend on the number
+ * of threads or the order in which the replications are run. Errors of
+ * the engine on these threads are raised as R errors once all threads have
+ * finished.
+ */
+SEXP simulateReplications(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP THETA, SEXP REPLICATIONS, SEXP DERIV, SEXP THREADS)
+{
+	return callEngine([&]()
+	{
+		return phase3Replications(DATAPTR, MODELPTR, EFFECTSLIST, THETA,
+			REPLICATIONS, DERIV, THREADS);
+	});
+}
+
+/**
+ * Estimates the derivative matrix of the expected statistics with respect
+ * to the parameters THETA by finite differences with common random numbers.
+ * All periods are simulated with THETA, and again after adding EPSILON[i]
+ * to parameter i for each i with PERTURB[i] true; a period uses the same
+ * random number stream in all these simulations. Returns a list with the
+ * statistics of the unperturbed simulation as a periods x effects matrix
+ * (fra), the derivatives as an effects x effects matrix with a row per
+ * perturbed parameter (sdf), the derivatives per period as a periods x
+ * effects x effects array (sdf2), and the simulated time of each period
+ * (ntim). Rows of unperturbed parameters are 0.
+ *
+ * The periods of each simulation run on THREADS threads. The simulations
+ * with different parameters run one after the other, as the parameters
+ * are stored in the model shared by the threads. Errors of the engine,
+ * on any thread, are raised as R errors once all threads have finished.
+ */
+SEXP finiteDifferences(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP THETA, SEXP EPSILON, SEXP PERTURB, SEXP THREADS)
+{
+	return callEngine([&]()
+	{
+		return finiteDifferenceDerivatives(DATAPTR, MODELPTR, EFFECTSLIST,
+			THETA, EPSILON, PERTURB, THREADS);
+	});
+}
+
+/** Does some MH steps for a specified group and period.
+ * Designed to be used for parallel processing, and currently the only
+ * function available. Loop is always constructed in R. Probably would be
+ * better to do it in C unless parallel processing.
+ */
+SEXP mlPeriod(SEXP DERIV, SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP THETA, SEXP GROUP, SEXP PERIOD,
+	SEXP NRUNMH, SEXP ADDCHAINTOSTORE,
+	SEXP RETURNDATAFRAME, SEXP RETURNDEPS, SEXP RETURNCHAINS,
+	SEXP RETURNLOGLIK, SEXP ONLYLOGLIK)
+{
+	return callEngine([&]()
+	{
+		return mlPeriodSteps(DERIV, DATAPTR, MODELPTR, EFFECTSLIST, THETA,
+			GROUP, PERIOD, NRUNMH, ADDCHAINTOSTORE, RETURNDATAFRAME,
+			RETURNDEPS, RETURNCHAINS, RETURNLOGLIK, ONLYLOGLIK);
+	});
+}
+
 /**
  * Clears the chains that have been stored on a model for a particular period
  * from start,  Leave KEEP ones for reuse
@@ -789,127 +1957,124 @@ SEXP clearStoredChains(SEXP MODELPTR, SEXP KEEP, SEXP GROUPPERIOD)
 }
 
 
-/** Recalculates the probabilities for a stored chain
- * corresponding to a specific group and period and
- * (negative) index. (index 1 is final).
+/**
+ * Sets the budget for the memory taken by the chains stored on a model, in
+ * megabytes. Beyond the budget, the least recently used chains are kept in
+ * a temporary file instead of memory. A budget of 0 removes the limit.
  */
-SEXP getChainProbabilities(SEXP DATAPTR, SEXP MODELPTR,
-	SEXP GROUP, SEXP PERIOD, SEXP INDEX, SEXP EFFECTSLIST, SEXP THETA,
-	SEXP GETSCORES)
+SEXP setChainStoreBudget(SEXP MODELPTR, SEXP MEGABYTES)
 {
-	/* need to make sure the parameters have been updated first */
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+	double megabytes = Rf_asReal(MEGABYTES);
 
-	/* get hold of the data vector */
-	vector<Data *> * pGroupData = (vector<Data *> *)
-		R_ExternalPtrAddr(DATAPTR);
+	if (ISNAN(megabytes) || megabytes < 0)
+	{
+		Rf_error("Invalid chain store budget");
+	}
 
-	int group = Rf_asInteger(GROUP) - 1;
-	int period = Rf_asInteger(PERIOD) - 1;
-	int groupPeriod = periodFromStart(*pGroupData, group, period);
-	Data * pData = (*pGroupData)[group];
-	/* get hold of the model object */
-	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+	pModel->pChainStore()->memoryBudget((size_t) (megabytes * 1024 * 1024));
 
-	/* update the parameters */
-	updateParameters(EFFECTSLIST, THETA, pGroupData, pModel);
+	return R_NilValue;
+}
 
-	/* create the ML simulation object */
-	MLSimulation * pMLSimulation = new MLSimulation(pData, pModel);
 
-	pMLSimulation->simpleRates(pModel->simpleRates());
+/**
+ * Sets if the alters of two-mode networks may be drawn from a tree of
+ * receiver weights, which agrees with the usual draw only up to rounding.
+ */
+SEXP setSparseTwoMode(SEXP MODELPTR, SEXP ENABLE)
+{
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+	pModel->sparseTwoMode(Rf_asLogical(ENABLE) == TRUE);
 
-	// get chain for this period from model
-	int index = pModel->rChainStore(groupPeriod).size() - Rf_asInteger(INDEX);
-	//Rprintf(" %d \n",pModel->rChainStore(groupPeriod).size());
-	if (index < 0)
-	{
-		Rf_error("index invalid");
-	}
-	Chain * pChain = pModel->rChainStore(groupPeriod)[index];
-	// then copy the chain to the MLSimulation object. (deleting new one first)
-	pMLSimulation->pChain(pChain->copyChain());
+	return R_NilValue;
+}
 
-	int needScores = Rf_asInteger(GETSCORES);
-	int deriv = 0;
-	pModel->needScores(needScores);
-	pModel->needDerivatives(deriv);
 
-	/* set the number of steps to zero */
-	pModel->numberMLSteps(0);
+/**
+ * Switches the instrumentation of the simulation code on or off. If RESET
+ * is true, the counters are set to zero first.
+ */
+SEXP setInstrumentation(SEXP ENABLE, SEXP RESET)
+{
+	if (Rf_asLogical(RESET))
+	{
+		Instrumentation::reset();
+	}
 
-	/* run the epoch simulation for this period (do initialization) */
-	pMLSimulation->runEpoch(period);
+	Instrumentation::enabled(Rf_asLogical(ENABLE));
 
-	SEXP ans;
-	PROTECT(ans = Rf_allocVector(VECSXP, 3));
+	return R_NilValue;
+}
 
-	double loglik = pMLSimulation->calculateLikelihood();
 
-	SET_VECTOR_ELT(ans, 0, Rf_ScalarReal(loglik));
+/**
+ * Returns the instrumentation counters that recorded any calls, as a list
+ * of the columns category, name, calls, and seconds.
+ */
+SEXP getInstrumentation()
+{
+	int count = 0;
 
-	if (needScores)
+	for (int i = 0; i < Instrumentation::slotCount(); i++)
 	{
-		int dim = 0;
-		for (int i = 0; i < Rf_length(EFFECTSLIST); i++)
-		{
-			dim += Rf_length(VECTOR_ELT(VECTOR_ELT(EFFECTSLIST, i), 0));
-		}
-
-		/* fra will contain the scores and must be initialised
-		   to 0. Use rfra to reduce function evaluations. */
-		SEXP fra;
-		double * rfra;
-		PROTECT(fra = Rf_allocVector(REALSXP, dim));
-		rfra = REAL(fra);
-		for (int i = 0; i < Rf_length(fra); i++)
+		if (Instrumentation::calls(i) > 0)
 		{
-			rfra[i] = 0;
+			count++;
 		}
+	}
 
-		/* dff will hold the return values of the derivatives */
-		SEXP dff;
-		double *rdff;
-		if (deriv)
-		{
-			PROTECT(dff = Rf_allocVector(REALSXP, dim * dim));
-			rdff = REAL(dff);
-			for (int i = 0; i < Rf_length(dff); i++)
-			{
-				rdff[i] = 0.0;
-			}
-		}
+	SEXP categories = PROTECT(Rf_allocVector(STRSXP, count));
+	SEXP names = PROTECT(Rf_allocVector(STRSXP, count));
+	SEXP calls = PROTECT(Rf_allocVector(REALSXP, count));
+	SEXP seconds = PROTECT(Rf_allocVector(REALSXP, count));
+	int row = 0;
 
-		/* collect the scores and derivatives */
-		vector<double> derivs(dim * dim);
-		vector<double> score(dim);
-		getScores(EFFECTSLIST, 	period, group, pMLSimulation,
-			&derivs, &score);
-		/* fill up vectors for  return value list */
-		for (unsigned effectNo = 0; effectNo < score.size();
-			 effectNo++)
-		{
-			rfra[effectNo] = score[effectNo];
-		}
-		if (deriv)
-		{
-			for (unsigned ii = 0; ii < derivs.size(); ii++)
-			{
-				rdff[ii] = derivs[ii];
-			}
-		}
-		SET_VECTOR_ELT(ans, 1, fra);
-		UNPROTECT(1);
-		if (deriv)
+	for (int i = 0; i < Instrumentation::slotCount(); i++)
+	{
+		if (Instrumentation::calls(i) > 0)
 		{
-			SET_VECTOR_ELT(ans, 2, dff);
-			UNPROTECT(1);
+			SET_STRING_ELT(categories, row,
+				Rf_mkChar(Instrumentation::category(i).c_str()));
+			SET_STRING_ELT(names, row,
+				Rf_mkChar(Instrumentation::name(i).c_str()));
+			REAL(calls)[row] = Instrumentation::calls(i);
+			REAL(seconds)[row] = Instrumentation::seconds(i);
+			row++;
 		}
 	}
 
-	delete pMLSimulation;
+	SEXP ans = PROTECT(Rf_allocVector(VECSXP, 4));
+	SET_VECTOR_ELT(ans, 0, categories);
+	SET_VECTOR_ELT(ans, 1, names);
+	SET_VECTOR_ELT(ans, 2, calls);
+	SET_VECTOR_ELT(ans, 3, seconds);
+
+	SEXP columnNames = PROTECT(Rf_allocVector(STRSXP, 4));
+	SET_STRING_ELT(columnNames, 0, Rf_mkChar("category"));
+	SET_STRING_ELT(columnNames, 1, Rf_mkChar("name"));
+	SET_STRING_ELT(columnNames, 2, Rf_mkChar("calls"));
+	SET_STRING_ELT(columnNames, 3, Rf_mkChar("seconds"));
+	Rf_setAttrib(ans, R_NamesSymbol, columnNames);
+
+	UNPROTECT(6);
+	return ans;
+}
 
-	UNPROTECT(1);
-	return  ans;
+
+/** Recalculates the probabilities for a stored chain
+ * corresponding to a specific group and period and
+ * (negative) index. (index 1 is final).
+ */
+SEXP getChainProbabilities(SEXP DATAPTR, SEXP MODELPTR,
+	SEXP GROUP, SEXP PERIOD, SEXP INDEX, SEXP EFFECTSLIST, SEXP THETA,
+	SEXP GETSCORES)
+{
+	return callEngine([&]()
+	{
+		return chainProbabilities(DATAPTR, MODELPTR, GROUP, PERIOD, INDEX,
+			EFFECTSLIST, THETA, GETSCORES);
+	});
 }
 
 }
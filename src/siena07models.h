@@ -39,12 +39,54 @@ SEXP mlPeriod(SEXP DERIV, SEXP DATAPTR,
 	SEXP RETURNCHAINS, SEXP RETURNLOGLIK, SEXP ONLYLOGLIK);
 
 
+/**
+ * Runs the iterations of one repeat of a subphase of phase 2 of the
+ * Robbins-Monro algorithm
+ */
+SEXP phase2Subphase(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP STATE, SEXP CONTROL);
+
+/**
+ * Runs independent forward simulations for phase 3, possibly on several
+ * threads
+ */
+SEXP simulateReplications(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP THETA, SEXP REPLICATIONS, SEXP DERIV, SEXP THREADS);
+
+/**
+ * Estimates the derivative matrix by finite differences with common
+ * random numbers
+ */
+SEXP finiteDifferences(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP THETA, SEXP EPSILON, SEXP PERTURB, SEXP THREADS);
+
 SEXP clearStoredChains(SEXP MODELPTR, SEXP KEEP, SEXP GROUPPERIOD);
 
+/**
+ * Sets the memory budget of the chains stored on a model in megabytes
+ */
+SEXP setChainStoreBudget(SEXP MODELPTR, SEXP MEGABYTES);
+
+/**
+ * Sets if the alters of two-mode networks may be drawn from a tree of
+ * receiver weights
+ */
+SEXP setSparseTwoMode(SEXP MODELPTR, SEXP ENABLE);
+
 SEXP getChainProbabilities(SEXP DATAPTR, SEXP MODELPTR,
 	SEXP GROUP, SEXP PERIOD, SEXP INDEX, SEXP EFFECTSLIST, SEXP THETA,
 	SEXP GETSCORES);
 
+/**
+ * Switches the instrumentation of the simulation on or off
+ */
+SEXP setInstrumentation(SEXP ENABLE, SEXP RESET);
+
+/**
+ * Returns the instrumentation counters as a list of columns
+ */
+SEXP getInstrumentation();
+
 } // extern "C"
 
 #endif /*SIENA07MODELS_H_*/
@@ -15,9 +15,13 @@
  */
 
 
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include <cstring>
 #include <exception>
+#include <functional>
 #include <R_ext/Random.h>
 #include <R_ext/Print.h>
 
@@ -35,7 +39,10 @@
 #include "model/EffectInfo.h"
 #include "data/ActorSet.h"
 #include "model/ml/MLSimulation.h"
+#include "model/auxiliary/AuxiliaryStatistic.h"
 #include "model/variables/DependentVariable.h"
+#include "utils/Instrumentation.h"
+#include "utils/ParallelFor.h"
 #include <R_ext/Error.h>
 #include <Rinternals.h>
 
@@ -53,6 +60,52 @@ static int sexp_to_int(SEXP value, int def) {
 	return def;
 }
 
+/**
+ * Calls body(periodFromStart, group, period, effectThreads) for every period
+ * of every group, on the given number of threads. If there are at least as
+ * many periods as threads the periods run in parallel and effectThreads is
+ * 1; otherwise they run one after the other, and effectThreads is the number
+ * of threads among which the statistic calculations of each period may
+ * share the evaluation effects. The body must not use the R API if more
+ * than one thread is used, and the data must not change any more. Errors
+ * of the engine are thrown as exceptions, so the callers run through
+ * callEngine.
+ */
+static void forEachTargetPeriod(vector<Data *> * pGroupData, int threads,
+	const function<void(int, int, int, int)> & body)
+{
+	vector<int> groups;
+	vector<int> groupPeriods;
+
+	for (unsigned group = 0; group < pGroupData->size(); group++)
+	{
+		for (int period = 0;
+			period < (*pGroupData)[group]->observationCount() - 1;
+			period++)
+		{
+			groups.push_back(group);
+			groupPeriods.push_back(period);
+		}
+	}
+
+	int periods = groups.size();
+
+	/* the counters of the instrumentation are not shared between threads */
+	if (Instrumentation::enabled())
+	{
+		threads = 1;
+	}
+
+	int periodThreads = periods >= threads ? threads : 1;
+	int effectThreads = periods >= threads ? 1 : threads;
+
+	parallelFor(periods, periodThreads, [&](int periodFromStart)
+	{
+		body(periodFromStart, groups[periodFromStart],
+			groupPeriods[periodFromStart], effectThreads);
+	});
+}
+
 extern "C"
 {
 
@@ -684,7 +737,77 @@ SEXP setupModelOptions(SEXP DATAPTR, SEXP MODELPTR, SEXP MAXDEGREE,
 
 }
 
-SEXP getTargetActorStatistics(SEXP dataptr, SEXP modelptr, SEXP effectslist, SEXP parallelrun)
+/**
+ * Replaces the auxiliary statistics of the model by the ones specified in
+ * the list SPECIFICATIONS. Each specification is a list of the type of the
+ * statistic, a character vector of the names of the dependent variables it
+ * is calculated for, the levels of the statistic, and a logical indicating
+ * if distributions are cumulative. An empty list removes all statistics.
+ */
+SEXP setAuxiliaryStatistics(SEXP DATAPTR, SEXP MODELPTR, SEXP SPECIFICATIONS)
+{
+	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
+	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
+
+	pModel->clearAuxiliaryStatistics();
+
+	for (int i = 0; i < Rf_length(SPECIFICATIONS); i++)
+	{
+		SEXP SPECIFICATION = VECTOR_ELT(SPECIFICATIONS, i);
+		string type = CHAR(STRING_ELT(VECTOR_ELT(SPECIFICATION, 0), 0));
+		SEXP NAMES = VECTOR_ELT(SPECIFICATION, 1);
+		SEXP LEVELS = VECTOR_ELT(SPECIFICATION, 2);
+
+		vector<string> names;
+		for (int j = 0; j < Rf_length(NAMES); j++)
+		{
+			names.push_back(CHAR(STRING_ELT(NAMES, j)));
+		}
+		vector<double> levels(REAL(LEVELS), REAL(LEVELS) + Rf_length(LEVELS));
+
+		// Check that the variables exist in all groups, as the statistics
+		// are calculated for every group.
+
+		for (unsigned j = 0; j < names.size(); j++)
+		{
+			bool behavior = type == "BehaviorDistribution" || j == 1;
+
+			for (unsigned group = 0; group < pGroupData->size(); group++)
+			{
+				Data * pData = (*pGroupData)[group];
+
+				if ((behavior && !pData->pBehaviorData(names[j])) ||
+					(!behavior && !pData->pNetworkData(names[j])))
+				{
+					pModel->clearAuxiliaryStatistics();
+					Rf_error("unknown variable %s for auxiliary statistic %s",
+						names[j].c_str(), type.c_str());
+				}
+			}
+		}
+
+		AuxiliaryStatistic * pStatistic = AuxiliaryStatistic::create(type,
+			names,
+			levels,
+			Rf_asLogical(VECTOR_ELT(SPECIFICATION, 3)));
+
+		if (!pStatistic)
+		{
+			pModel->clearAuxiliaryStatistics();
+			Rf_error("unknown auxiliary statistic %s", type.c_str());
+		}
+
+		pModel->addAuxiliaryStatistic(pStatistic);
+	}
+
+	return R_NilValue;
+}
+
+/**
+ * Returns the actor statistics of the observed data, for getTargets.
+ */
+static SEXP getTargetActorStatistics(SEXP dataptr, SEXP modelptr, SEXP effectslist, SEXP parallelrun,
+	SEXP threads)
 {
 	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(dataptr);
 	Model * pModel = (Model *) R_ExternalPtrAddr(modelptr);
@@ -708,13 +831,32 @@ SEXP getTargetActorStatistics(SEXP dataptr, SEXP modelptr, SEXP effectslist, SEX
 		}
 	}
 
+	// The statistics of all periods are calculated first, possibly on
+	// several threads, and then returned to R one period after the other.
+	// The calculators are released before their states, also if an error
+	// of the engine is thrown.
+	int totObservations = totalPeriods(*pGroupData);
+	vector<unique_ptr<State> > states(totObservations);
+	vector<unique_ptr<StatisticCalculator> > calculators(totObservations);
+
+	forEachTargetPeriod(pGroupData, sexp_to_int(threads, 1),
+		[&](int periodFromStart, int group, int period, int effectThreads)
+	{
+		Data * pData = (*pGroupData)[group];
+		states[periodFromStart].reset(new State(pData, period + 1));
+		calculators[periodFromStart].reset(new StatisticCalculator(pData,
+			pModel, states[periodFromStart].get(), period, true, false,
+			effectThreads));
+	});
+
+	int periodFromStart = 0;
+
 	for (size_t group = 0; group < nGroups; group++)
 	{
 		Data * pData = (*pGroupData)[group];
 		for (int period = 0; period < pData->observationCount() - 1; period++)
 		{
-			State state(pData, period + 1);
-			StatisticCalculator calculator(pData, pModel, &state, period, true);
+			StatisticCalculator & calculator = *calculators[periodFromStart];
 			int actors = pData->rDependentVariableData()[0]->n();
 			vector<double *> actorStatistics;
 			getActorStatistics(effectslist, &calculator, &actorStatistics);
@@ -730,6 +872,9 @@ SEXP getTargetActorStatistics(SEXP dataptr, SEXP modelptr, SEXP effectslist, SEX
 				SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(altStats, group), period+1), e, actorStatsValues);
 				UNPROTECT(1);         
 			}
+			calculators[periodFromStart].reset();
+			states[periodFromStart].reset();
+			periodFromStart++;
 		}
 	}
 	UNPROTECT(2);
@@ -737,7 +882,13 @@ SEXP getTargetActorStatistics(SEXP dataptr, SEXP modelptr, SEXP effectslist, SEX
 }
 
 
-SEXP getTargetsChangeContributions(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST, SEXP PARALLELRUN)
+/**
+ * Returns the static change contributions of the observed data, for
+ * getTargets. The arrays are R objects referenced by the result, so they
+ * are reclaimed by R if an error of the engine is raised.
+ */
+static SEXP getTargetsChangeContributions(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST, SEXP PARALLELRUN,
+	SEXP THREADS)
 {
 	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
 	Model * pModel = (Model *) R_ExternalPtrAddr(MODELPTR);
@@ -748,93 +899,99 @@ SEXP getTargetsChangeContributions(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST
 	}
 	size_t nGroups = pGroupData->size();
 
-	SEXP altStats = PROTECT(Rf_allocVector(VECSXP, nGroups));
-	SEXP NETWORKTYPES = PROTECT(createRObjectAttributes(EFFECTSLIST, altStats));
-	int objEffects = Rf_length(NETWORKTYPES);
+	// The effects are grouped by dependent variable, keeping their order.
+	vector<EffectInfo *> effects;
+	getChangeContributionEffects(EFFECTSLIST, &effects);
+	vector<string> variableNames;
+	vector<vector<EffectInfo *> > variableEffects;
 
-	for (size_t group = 0; group < nGroups; group++)
+	for (unsigned e = 0; e < effects.size(); e++)
 	{
-		SET_VECTOR_ELT(altStats, group, Rf_allocVector(VECSXP, (*pGroupData)[group]->observationCount()-1));
-		for (int p = 0; p < (*pGroupData)[group]->observationCount()-1; p++)
+		unsigned v = 0;
+		while (v < variableNames.size() &&
+			variableNames[v] != effects[e]->variableName())
 		{
-			SET_VECTOR_ELT(VECTOR_ELT(altStats, group), p, Rf_allocVector(VECSXP, objEffects));
+			v++;
 		}
+		if (v == variableNames.size())
+		{
+			variableNames.push_back(effects[e]->variableName());
+			variableEffects.push_back(vector<EffectInfo *>());
+		}
+		variableEffects[v].push_back(effects[e]);
 	}
 
+	SEXP altStats = PROTECT(Rf_allocVector(VECSXP, nGroups));
+	createRObjectAttributes(EFFECTSLIST, altStats);
+	SEXP VARIABLENAMES = PROTECT(Rf_allocVector(STRSXP, variableNames.size()));
+
+	for (unsigned v = 0; v < variableNames.size(); v++)
+	{
+		SET_STRING_ELT(VARIABLENAMES, v, Rf_mkChar(variableNames[v].c_str()));
+	}
+
+	// For each period and dependent variable, the contributions of the
+	// effects are returned in an array of choices by egos by effects,
+	// which is allocated here and filled by the statistic calculator.
+	// The choices are the alters up to the number of egos for networks,
+	// and the downward change, no change and upward change for behavior.
+	int totObservations = totalPeriods(*pGroupData);
+	vector<map<EffectInfo *, double *> > storage(totObservations);
+	int periodFromStart = 0;
+
 	for (size_t group = 0; group < nGroups; group++)
 	{
 		Data * pData = (*pGroupData)[group];
+		SET_VECTOR_ELT(altStats, group,
+			Rf_allocVector(VECSXP, pData->observationCount() - 1));
 
 		for (int period = 0; period < pData->observationCount() - 1; period++)
 		{
-			State State (pData, period);
-			// TODO altStats[0] == altStats[1] ??
-			StatisticCalculator calculator(pData, pModel, &State, period, false, true);
-			vector<vector<double *>> changeContributions;
-			getChangeContributionStatistics(EFFECTSLIST, &calculator, &changeContributions);
-			int actors = pData->rDependentVariableData()[0]->n();
-			for (unsigned e = 0; e < changeContributions.size(); e++)
+			SEXP periodStats = Rf_allocVector(VECSXP, variableNames.size());
+			SET_VECTOR_ELT(VECTOR_ELT(altStats, group), period, periodStats);
+			Rf_setAttrib(periodStats, R_NamesSymbol, VARIABLENAMES);
+
+			for (unsigned v = 0; v < variableNames.size(); v++)
 			{
-				SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(altStats, group), period),
-								e, Rf_allocVector(VECSXP, actors));
+				int egos;
 				int choices;
-				if (strcmp(CHAR(STRING_ELT(NETWORKTYPES, e)), "behavior") == 0)
+				BehaviorLongitudinalData * pBehaviorData =
+					pData->pBehaviorData(variableNames[v]);
+				if (pBehaviorData)
 				{
+					egos = pBehaviorData->n();
 					choices = 3;
 				}
 				else
 				{
-					choices = actors; // will not work for bipartite
-					// But I did not find a convenient way to get knowledge of m() to here
+					// for bipartite networks the first alters are used
+					egos = pData->pNetworkData(variableNames[v])->n();
+					choices = egos;
 				}
-				for (int actor = 0; actor < actors; actor++)
+				SEXP contributions = Rf_alloc3DArray(REALSXP, choices, egos,
+					variableEffects[v].size());
+				SET_VECTOR_ELT(periodStats, v, contributions);
+				for (unsigned e = 0; e < variableEffects[v].size(); e++)
 				{
-					SEXP actorsVal = PROTECT(Rf_allocVector(REALSXP, choices));
-					double * d = REAL(actorsVal);
-					for (int i = 0; i < Rf_length(actorsVal); i++)
-					{
-						d[i] = changeContributions.at(e).at(actor)[i];
-					}
-					SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(altStats, group), period), e), 
-								actor, actorsVal);
-					UNPROTECT(1);         
+					storage[periodFromStart][variableEffects[v][e]] =
+						REAL(contributions) + (size_t) e * egos * choices;
 				}
 			}
+			periodFromStart++;
 		}
-		
-        // // Handle period 0 separately
-		// State State (pData, 0);
-		// StatisticCalculator calculator(pData, pModel, &State, 0, false, true);
-		// vector<vector<double *>> changeContributions;
-		// getChangeContributionStatistics(EFFECTSLIST, &calculator, &changeContributions);
-		// int actors = pData->rDependentVariableData()[0]->n();
-		// for (unsigned e = 0; e < changeContributions.size(); e++)
-		// {
-		// 	SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(altStats, group), 0),
-		// 		e, Rf_allocVector(VECSXP, actors));
-		// 	int choices;
-		// 	if (strcmp(CHAR(STRING_ELT(NETWORKTYPES, e)), "behavior") == 0)
-		// 	{
-		// 		choices = 3;
-		// 	}
-		// 	else
-		// 	{						
-		// 		choices = actors; // will not work for bipartite
-		// 	}
-		// 	for (int actor = 0; actor < actors; actor++)
-		// 	{
-		// 		SEXP actorsVal = PROTECT(Rf_allocVector(REALSXP, choices));
-		// 		double * d = REAL(actorsVal);
-		// 		for (int i = 0; i < Rf_length(actorsVal); i++)
-		// 		{
-		// 			d[i] = changeContributions.at(e).at(actor)[i];
-		// 		}
-		// 		SET_VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(VECTOR_ELT(altStats, group), 0), e), 
-		// 				actor, actorsVal);
-		// 		UNPROTECT(1);     
-		// 	}
-		// }
 	}
+
+	// The contributions of all periods are calculated, possibly on several
+	// threads, directly into the arrays.
+	forEachTargetPeriod(pGroupData, sexp_to_int(THREADS, 1),
+		[&](int periodFromStart, int group, int period, int effectThreads)
+	{
+		Data * pData = (*pGroupData)[group];
+		State state(pData, period);
+		StatisticCalculator calculator(pData, pModel, &state, period,
+			storage[periodFromStart], effectThreads);
+	});
+
 	UNPROTECT(2);
 	return altStats;
 }
@@ -842,26 +999,11 @@ SEXP getTargetsChangeContributions(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST
 
 
 /**
- *  Gets target values relative to the input data
+ * Returns the target statistics of the observed data, for getTargets.
  */
-SEXP getTargets(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
-	SEXP PARALLELRUN, SEXP RETURNACTORSTATISTICS,
-	SEXP RETURNSTATICCHANGECONTRIBUTIONS)
+static SEXP getTargetStatistics(SEXP DATAPTR, SEXP MODELPTR,
+	SEXP EFFECTSLIST, SEXP PARALLELRUN, SEXP THREADS)
 {
-	// select alternative result type
-	int returnActorStatistics = sexp_to_int(RETURNACTORSTATISTICS, 0);
-	int returnStaticChangeContributions = sexp_to_int(RETURNSTATICCHANGECONTRIBUTIONS, 0);
-	if (returnActorStatistics + returnStaticChangeContributions >= 2)
-	{
-		Rf_error("returnActorStatistics and returnStaticChangeContributions are mutually exclusive");
-	}
-	if (returnActorStatistics) {
-		return getTargetActorStatistics(DATAPTR, MODELPTR, EFFECTSLIST, PARALLELRUN);
-	}
-	if (returnStaticChangeContributions) {
-		return getTargetsChangeContributions(DATAPTR, MODELPTR, EFFECTSLIST, PARALLELRUN);
-	}
-
 	/* get hold of the data vector */
 	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
 
@@ -878,7 +1020,6 @@ SEXP getTargets(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
 		//		pModel->parallelRun(true);
 		//  }
 	}
-	size_t nGroups = pGroupData->size();
 	int totObservations = totalPeriods(*pGroupData);
 
 	// find the number of effects over all dependent variables:
@@ -901,49 +1042,80 @@ SEXP getTargets(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
 
 	// find the targets: for each data object separately:
 	// add them up on return to R (easier to check!)
-	int periodFromStart = 0;
+	vector<StatisticRequest> requests;
+	getStatisticRequests(EFFECTSLIST, &requests);
 
-	for (size_t group = 0; group < nGroups; group++)
+	forEachTargetPeriod(pGroupData, sexp_to_int(THREADS, 1),
+		[&](int periodFromStart, int group, int period, int effectThreads)
 	{
 		Data * pData = (*pGroupData)[group];
-
-		for (int period = 0; period < pData->observationCount() - 1; period++)
+		//	EpochSimulation  Simulation(pData, pModel);
+		//Simulation.initialize(period + 1);
+		State State (pData, period + 1);
+		//State State (&Simulation);
+		StatisticCalculator Calculator (pData, pModel, &State,
+			period, false, false, effectThreads);
+		vector<double> statistic(nEffects);
+		vector<double> score(nEffects); /* not used */
+
+		getStatistics(requests, &Calculator, period,
+				group, pData, (EpochSimulation *) 0, &statistic, &score);
+		/* fill up matrices for return value list */
+		int iii = periodFromStart * nEffects;
+		for (unsigned effectNo = 0; effectNo < statistic.size(); effectNo++)
 		{
-			periodFromStart++;
-			//	EpochSimulation  Simulation(pData, pModel);
-			//Simulation.initialize(period + 1);
-			State State (pData, period + 1);
-			//State State (&Simulation);
-			StatisticCalculator Calculator (pData, pModel, &State,
-				period);
-			vector<double> statistic(nEffects);
-			vector<double> score(nEffects); /* not used */
-			vector<double> deriv(nEffects*nEffects); /* ABC not used */
-
-			getStatistics(EFFECTSLIST, &Calculator, period,
-					group, pData, (EpochSimulation *) 0, &statistic, &score); 
-			//getStatistics(EFFECTSLIST, &Calculator, period,
-			//			group, pData, &Simulation,
-			//&statistic, &score);
-			//	Rprintf("%f %f \n",statistic[1], statistic[2]);
-			/* fill up matrices for return value list */
-			int iii = (periodFromStart - 1) * nEffects;
-			for (unsigned effectNo = 0; effectNo < statistic.size(); effectNo++)
-			{
-				rfra[iii + effectNo] = statistic[effectNo];
-			}
+			rfra[iii + effectNo] = statistic[effectNo];
 		}
-	}
+	});
 	UNPROTECT(1);
 	return fra;
 }
 
+/**
+ *  Gets target values relative to the input data. The periods of all
+ *  groups, or if there are fewer periods than THREADS the evaluation
+ *  effects of each period, are spread over THREADS threads. Errors of the
+ *  engine, on any thread, are raised as R errors once all threads have
+ *  finished.
+ */
+SEXP getTargets(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
+	SEXP PARALLELRUN, SEXP RETURNACTORSTATISTICS,
+	SEXP RETURNSTATICCHANGECONTRIBUTIONS, SEXP THREADS)
+{
+	// select alternative result type
+	int returnActorStatistics = sexp_to_int(RETURNACTORSTATISTICS, 0);
+	int returnStaticChangeContributions = sexp_to_int(RETURNSTATICCHANGECONTRIBUTIONS, 0);
+	if (returnActorStatistics + returnStaticChangeContributions >= 2)
+	{
+		Rf_error("returnActorStatistics and returnStaticChangeContributions are mutually exclusive");
+	}
+	return callEngine([&]()
+	{
+		if (returnStaticChangeContributions)
+		{
+			return getTargetsChangeContributions(DATAPTR, MODELPTR,
+				EFFECTSLIST, PARALLELRUN, THREADS);
+		}
+
+		if (returnActorStatistics)
+		{
+			return getTargetActorStatistics(DATAPTR, MODELPTR, EFFECTSLIST,
+				PARALLELRUN, THREADS);
+		}
+
+		return getTargetStatistics(DATAPTR, MODELPTR, EFFECTSLIST,
+			PARALLELRUN, THREADS);
+	});
+}
+
 
 
 /**
  * Sets up a minimal chain and does pre burnin and burnin.
  * Processes a complete set of data objects, creating a chain for each
- * period and returning the address.
+ * period and returning the address. The current chains are returned as
+ * lists, or as raw vectors in the binary format of Chain::write if
+ * BINARYCHAINS is true.
  */
 /**
   * NOTE; FOR SOME CONFIGURATIONS OF STRUCTURAL ZEROS
@@ -951,7 +1123,8 @@ SEXP getTargets(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
  */
 SEXP mlMakeChains(SEXP DATAPTR, SEXP MODELPTR,
 		SEXP PROBS, SEXP PRMIN, SEXP PRMIB, SEXP MINIMUMPERM,
-		SEXP MAXIMUMPERM, SEXP INITIALPERM, SEXP LOCALML)
+		SEXP MAXIMUMPERM, SEXP INITIALPERM, SEXP LOCALML,
+		SEXP BINARYCHAINS)
 {
 	/* get hold of the data vector */
 	vector<Data *> * pGroupData = (vector<Data *> *) R_ExternalPtrAddr(DATAPTR);
@@ -999,6 +1172,7 @@ SEXP mlMakeChains(SEXP DATAPTR, SEXP MODELPTR,
 	}
 	pModel->localML(localML);
 
+	bool binaryChains = Rf_asLogical(BINARYCHAINS) == TRUE;
 	int periodFromStart = 0;
 
 	for (int group = 0; group < nGroups; group++)
@@ -1053,8 +1227,9 @@ SEXP mlMakeChains(SEXP DATAPTR, SEXP MODELPTR,
 			pMLSimulation->createEndStateDifferences();
 			pModel->chainStore(*pChain, periodFromStart);
 
-			/* return chain as a list */
-			SEXP ch1 = PROTECT(getChainList(*pChain));
+			/* return chain, to be copied to sub processes */
+			SEXP ch1 = PROTECT(binaryChains ? getChainRaw(*pChain) :
+				getChainList(*pChain));
 			//PROTECT(ch1 = getChainDFPlus(*pChain, true));
 			SET_VECTOR_ELT(currentChains, periodFromStart, ch1);
 			UNPROTECT(1);
@@ -1161,9 +1336,17 @@ SEXP mlInitializeSubProcesses(SEXP DATAPTR, SEXP MODELPTR, SEXP PROBS,
 			pModel->missingBehaviorProbability(prmib[periodFromStart]);
 
 			/* copy the chain for this period onto the model */
-			Chain * pChain = makeChainFromList(pData,
-				VECTOR_ELT(CHAINS, periodFromStart), period);
-			pModel->chainStore(*pChain, periodFromStart);
+			SEXP CHAIN = VECTOR_ELT(CHAINS, periodFromStart);
+			Chain * pChain;
+			if (TYPEOF(CHAIN) == RAWSXP)
+			{
+				pChain = makeChainFromRaw(pData, CHAIN, period);
+			}
+			else
+			{
+				pChain = makeChainFromList(pData, CHAIN, period);
+			}
+			pModel->chainStore(pChain, periodFromStart);
 
 			periodFromStart++;
 		}
@@ -107,11 +107,17 @@ SEXP setupModelOptions(SEXP DATAPTR, SEXP MODELPTR, SEXP MAXDEGREE,
 	SEXP MODELTYPE, SEXP BEHMODELTYPE, SEXP SIMPLERATES, SEXP NORMSETRATES);
 
 /**
- *  Gets target values relative to the input data
+ *  sets up the auxiliary statistics calculated at the end of each simulated
+ *  period for the goodness of fit
+ */
+SEXP setAuxiliaryStatistics(SEXP DATAPTR, SEXP MODELPTR, SEXP SPECIFICATIONS);
+
+/**
+ *  Gets target values relative to the input data, on THREADS threads
  */
 SEXP getTargets(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
 		SEXP PARALLELRUN, SEXP RETURNACTORSTATISTICS,
-		SEXP RETURNSTATICCHANGECONTRIBUTIONS);
+		SEXP RETURNSTATICCHANGECONTRIBUTIONS, SEXP THREADS);
 
 /**
  * Sets up a minimal chain and does pre burnin and burnin.  Processes a
@@ -120,7 +126,8 @@ SEXP getTargets(SEXP DATAPTR, SEXP MODELPTR, SEXP EFFECTSLIST,
  */
 SEXP mlMakeChains(SEXP DATAPTR, SEXP MODELPTR,
 		SEXP PROBS, SEXP PRMIN, SEXP PRMIB, SEXP MINIMUMPERM,
-		SEXP MAXIMUMPERM, SEXP INITIALPERM, SEXP LOCALML);
+		SEXP MAXIMUMPERM, SEXP INITIALPERM, SEXP LOCALML,
+		SEXP BINARYCHAINS);
 
 /**
  *
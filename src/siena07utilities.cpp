@@ -20,6 +20,8 @@
  *
  *  5) getChainList: create a list format SEXP from a chain
  *
+ *  6) getChainRaw: create a raw vector SEXP holding a chain in binary format
+ *
  *  SEXP's can be printed within C using Rf_PrintValue(SEXP x)
  *****************************************************************************/
 /**
@@ -27,11 +29,13 @@
  * Dump data out for profiling.
  * Convert ministeps and chains to R format objects.
  */
+#include <cstdio>
 #include <stdexcept>
 #include <vector>
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include "siena07utilities.h"
 #include "siena07internals.h"
 #include "data/Data.h"
@@ -123,6 +127,45 @@ void Rterminate()
 }
 
 
+/**
+ * Returns the result of body(), a function running the engine for an entry
+ * point. The errors of the engine are thrown as exceptions while body()
+ * runs, on any thread. A C++ exception thrown by body() is raised as an R
+ * error, and a user interrupt is checked for, only after body() has
+ * returned, so that neither jumps over the destruction of its objects.
+ */
+SEXP callEngine(const std::function<SEXP()> & body)
+{
+	bool failed = false;
+	char message[1024];
+	SEXP ans = R_NilValue;
+	bool throwErrors = throwEngineErrors();
+
+	throwEngineErrors(true);
+
+	try
+	{
+		ans = body();
+	}
+	catch (const exception & rException)
+	{
+		failed = true;
+		snprintf(message, sizeof(message), "%s", rException.what());
+	}
+
+	throwEngineErrors(throwErrors);
+
+	if (failed)
+	{
+		Rf_error("%s", message);
+	}
+
+	PROTECT(ans);
+	R_CheckUserInterrupt();
+	UNPROTECT(1);
+	return ans;
+}
+
 /**
  * print out the data for profiling with gprof
  *
@@ -1101,6 +1144,45 @@ MiniStep * makeMiniStepFromList(Data * pData, SEXP MINISTEP)
 	}
 }
 
+/**
+ * Create a raw vector holding the chain in the binary format of
+ * Chain::write. Much more compact than getChainList.
+ */
+SEXP getChainRaw(const Chain & chain)
+{
+	ostringstream stream;
+	chain.write(stream);
+	const string & bytes = stream.str();
+
+	SEXP ans = PROTECT(Rf_allocVector(RAWSXP, bytes.size()));
+	memcpy(RAW(ans), bytes.data(), bytes.size());
+	UNPROTECT(1);
+	return ans;
+}
+
+/**
+ * Create a chain from a raw vector created by getChainRaw.
+ */
+Chain * makeChainFromRaw(Data * pData, SEXP CHAIN, int period)
+{
+	Chain * pChain;
+
+	// The stream must be gone before Rf_error jumps out of this frame.
+	{
+		istringstream stream(
+			string((const char *) RAW(CHAIN), Rf_length(CHAIN)));
+		pChain = Chain::read(pData, stream);
+	}
+
+	if (!pChain)
+	{
+		Rf_error("Invalid binary chain");
+	}
+
+	pChain->period(period);
+	return pChain;
+}
+
 /**
  * Create a chain from a single chain stored as a list (not dataframe).
  */
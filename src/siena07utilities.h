@@ -12,6 +12,7 @@
 #ifndef SIENA07UTILITIES_H_
 #define SIENA07UTILITIES_H_
 
+#include <functional>
 #include <Rinternals.h>
 
 #include "network/Network.h"
@@ -50,6 +51,12 @@ int totalPeriods(std::vector<Data *> & pGroupData);
  */
 void Rterminate();
 
+/**
+ * Runs the engine for an .Call entry point, raising its errors as R errors
+ * only after it has returned.
+ */
+SEXP callEngine(const std::function<SEXP()> & body);
+
 /**
  * print out the data for profiling with gprof
  *
@@ -75,9 +82,11 @@ namespace siena
 	SEXP getDFFromVector(const std::vector<MiniStep *> & rMiniSteps, bool sort=true);
 	SEXP getMiniStepList(const MiniStep & miniStep, int period);
 	SEXP getChainList(const Chain & chain);
+	SEXP getChainRaw(const Chain & chain);
 	SEXP getChangeContributionsList(const Chain & chain, SEXP EFFECTSLIST);
 	SEXP createRObjectAttributes(SEXP EFFECTSLIST, SEXP & stats);
 	Chain * makeChainFromList(Data * pData, SEXP CHAIN, int period);
+	Chain * makeChainFromRaw(Data * pData, SEXP CHAIN, int period);
 	MiniStep * makeMiniStepFromList(Data * pData, SEXP MINISTEP);
 	Chain * createMissingChain(int period, Data * data, const State& initialState);
 }
@@ -0,0 +1,273 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: RShim.cpp
+ *
+ * Description: A minimal replacement of the parts of the R runtime that the
+ * simulation engine (everything listed in sources.list except the
+ * siena07*.cpp interface files) refers to. The R headers are still needed
+ * at compile time, but the resulting program does not link against libR,
+ * so it can be run and profiled without an R interpreter.
+ *
+ * Random numbers come from a fixed-seed Mersenne twister, so runs are
+ * reproducible between builds of the harness but do not reproduce the
+ * random streams of an R session.
+ *****************************************************************************/
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <R_ext/Print.h>
+#include <R_ext/Error.h>
+#include <R_ext/Arith.h>
+#include <R_ext/Random.h>
+#include <Rmath.h>
+#include <Rinternals.h>
+#include "RShim.h"
+
+namespace
+{
+
+std::mt19937 generator(1);
+bool quiet = false;
+
+}
+
+namespace siena
+{
+
+/**
+ * Restarts the random number stream of the shim with the given seed.
+ */
+void shimSeed(unsigned long seed)
+{
+	generator.seed(seed);
+}
+
+/**
+ * Suppresses the diagnostic output the engine writes through Rprintf.
+ */
+void shimQuiet(bool flag)
+{
+	quiet = flag;
+}
+
+}
+
+extern "C"
+{
+
+// ----------------------------------------------------------------------------
+// Section: Global constants
+// ----------------------------------------------------------------------------
+
+double R_NaN = std::numeric_limits<double>::quiet_NaN();
+double R_PosInf = std::numeric_limits<double>::infinity();
+double R_NegInf = -std::numeric_limits<double>::infinity();
+double R_NaReal = std::numeric_limits<double>::quiet_NaN();
+int R_NaInt = std::numeric_limits<int>::min();
+SEXP R_NilValue = 0;
+SEXP R_GlobalEnv = 0;
+
+int R_IsNA(double x)
+{
+	return std::isnan(x);
+}
+
+int R_IsNaN(double x)
+{
+	return std::isnan(x);
+}
+
+int R_finite(double x)
+{
+	return std::isfinite(x);
+}
+
+// ----------------------------------------------------------------------------
+// Section: Printing and errors
+// ----------------------------------------------------------------------------
+
+void Rprintf(const char * format, ...)
+{
+	if (!quiet)
+	{
+		va_list args;
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+	}
+}
+
+void REprintf(const char * format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+}
+
+void Rf_error(const char * format, ...)
+{
+	char buffer[8192];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	throw siena::RError(buffer);
+}
+
+void Rf_warning(const char * format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	fprintf(stderr, "Warning: ");
+	vfprintf(stderr, format, args);
+	fprintf(stderr, "\n");
+	va_end(args);
+}
+
+void Rf_PrintValue(SEXP)
+{
+}
+
+// ----------------------------------------------------------------------------
+// Section: Random numbers
+// ----------------------------------------------------------------------------
+
+void GetRNGstate(void)
+{
+}
+
+void PutRNGstate(void)
+{
+}
+
+/**
+ * Uniform variate on the open interval (0,1), as R guarantees.
+ */
+double unif_rand(void)
+{
+	double value;
+
+	do
+	{
+		value = std::generate_canonical<double, 53>(generator);
+	}
+	while (value <= 0 || value >= 1);
+
+	return value;
+}
+
+double exp_rand(void)
+{
+	return -std::log(unif_rand());
+}
+
+double norm_rand(void)
+{
+	std::normal_distribution<double> distribution(0, 1);
+	return distribution(generator);
+}
+
+double Rf_rexp(double scale)
+{
+	return scale * exp_rand();
+}
+
+double Rf_rgamma(double shape, double scale)
+{
+	std::gamma_distribution<double> distribution(shape, scale);
+	return distribution(generator);
+}
+
+double Rf_rnorm(double mean, double sd)
+{
+	return mean + sd * norm_rand();
+}
+
+double Rf_dnorm4(double x, double mean, double sd, int giveLog)
+{
+	double z = (x - mean) / sd;
+	double logDensity = -0.5 * z * z - std::log(sd * std::sqrt(2 * M_PI));
+	return giveLog ? logDensity : std::exp(logDensity);
+}
+
+
+/**
+ * Normal quantile by algorithm AS 241 of Wichura (1988), as R computes it;
+ * only lower tail probabilities on the natural scale are supported.
+ */
+double Rf_qnorm5(double p, double mean, double sd, int, int)
+{
+	if (p <= 0 || p >= 1)
+	{
+		return p == 0 ? -INFINITY : (p == 1 ? INFINITY : NAN);
+	}
+
+	double q = p - 0.5;
+	double value;
+
+	if (std::fabs(q) <= 0.425)
+	{
+		double r = 0.180625 - q * q;
+		value = q * (((((((r * 2509.0809287301226727 +
+			33430.575583588128105) * r + 67265.770927008700853) * r +
+			45921.953931549871457) * r + 13731.693765509461125) * r +
+			1971.5909503065514427) * r + 133.14166789178437745) * r +
+			3.387132872796366608) /
+			(((((((r * 5226.495278852545925 +
+			28729.085735721942674) * r + 39307.89580009271061) * r +
+			21213.794301586595867) * r + 5394.1960214247511077) * r +
+			687.1870074920579083) * r + 42.313330701600911252) * r + 1.);
+	}
+	else
+	{
+		double r = std::sqrt(-std::log(q < 0 ? p : 1 - p));
+
+		if (r <= 5)
+		{
+			r -= 1.6;
+			value = (((((((r * 7.7454501427834140764e-4 +
+				.0227238449892691845833) * r + .24178072517745061177) *
+				r + 1.27045825245236838258) * r +
+				3.64784832476320460504) * r + 5.7694972214606914055) *
+				r + 4.6303378461565452959) * r +
+				1.42343711074968357734) /
+				(((((((r * 1.05075007164441684324e-9 +
+				5.475938084995344946e-4) * r + .0151986665636164571966) *
+				r + .14810397642748007459) * r + .68976733498510000455) *
+				r + 1.6763848301838038494) * r +
+				2.05319162663775882187) * r + 1.);
+		}
+		else
+		{
+			r -= 5;
+			value = (((((((r * 2.01033439929228813265e-7 +
+				2.71155556874348757815e-5) * r +
+				.0012426609473880784386) * r + .026532189526576123093) *
+				r + .29656057182850489123) * r +
+				1.7848265399172913358) * r + 5.4637849111641143699) *
+				r + 6.6579046435011037772) /
+				(((((((r * 2.04426310338993978564e-15 +
+				1.4215117583164458887e-7)* r +
+				1.8463183175100546818e-5) * r +
+				7.868691311456132591e-4) * r + .0148753612908506148525)
+				* r + .13692988092273580531) * r +
+				.59983220655588793769) * r + 1.);
+		}
+
+		if (q < 0)
+		{
+			value = -value;
+		}
+	}
+
+	return mean + sd * value;
+}
+
+}
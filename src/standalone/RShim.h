@@ -0,0 +1,40 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: RShim.h
+ *
+ * Description: This module declares the controls of the minimal replacement
+ * of the R runtime used when the simulation engine is linked into the
+ * standalone benchmark harness instead of the RSiena shared library.
+ *****************************************************************************/
+
+#ifndef RSHIM_H_
+#define RSHIM_H_
+
+#include <stdexcept>
+#include <string>
+
+namespace siena
+{
+
+/**
+ * Thrown in place of a longjmp back to the R prompt when the engine calls
+ * Rf_error outside of R.
+ */
+class RError : public std::runtime_error
+{
+public:
+	explicit RError(const std::string & message) :
+		std::runtime_error(message)
+	{
+	}
+};
+
+void shimSeed(unsigned long seed);
+void shimQuiet(bool flag);
+
+}
+
+#endif /*RSHIM_H_*/
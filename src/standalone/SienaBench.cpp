@@ -0,0 +1,1487 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: SienaBench.cpp
+ *
+ * Description: Standalone benchmark and profiling driver for the simulation
+ * engine. It builds Data and Model objects directly (from adjacency
+ * matrix files such as tests/s50-network*.dat, or from a synthetic
+ * panel of configurable size), runs fixed-seed workloads and writes the
+ * timings as a single JSON object to standard output.
+ *
+ * Usage: sienabench [options]
+ *   --networks f1,f2,...   one adjacency matrix file per wave; the codes
+ *                          9 (missing), 10 and 11 (structural 0 and 1)
+ *                          follow the s50 test data
+ *   --synthetic n          synthetic one-mode panel with n actors
+ *   --receivers m          make the synthetic panel two-mode, with m
+ *                          receivers such as events; the default
+ *                          effects are then density, inPop and outAct
+ *   --sparse-two-mode      draw the alters of two-mode networks from a
+ *                          tree of receiver weights where the effects
+ *                          allow it, as with x$sparseTwoMode in R
+ *   --model-type t         make the one-mode networks symmetric and
+ *                          simulate them with the model type t of
+ *                          sienaAlgorithmCreate (2-3 AFORCE, AAGREE,
+ *                          4-6 BFORCE, BAGREE, BJOINT); the default
+ *                          effects are then density, transTriads and
+ *                          degPlus
+ *   --degree d             average out-degree of synthetic waves (4)
+ *   --waves w              number of synthetic waves (3)
+ *   --change f             fraction of ties toggled between waves (0.2)
+ *   --behavior             add a synthetic behavior variable on 1..5
+ *   --effects e[=v],...    evaluation effects of the network, with
+ *                          optional parameters; an entry a*b[*c][=v]
+ *                          adds the interaction of the effects a, b (and
+ *                          c) listed before it
+ *   --behavior-effects ... evaluation effects of the behavior variable
+ *   --covariate-effects ...
+ *                          add a synthetic changing covariate on 1..5
+ *                          and the given evaluation effects of the
+ *                          network on it (e.g. egoX,altX,simX)
+ *   --multiplex e[=v],...  add a second synthetic network with the given
+ *                          evaluation effects, which can refer to the
+ *                          first network (e.g. to, cl.XWX)
+ *   --constraint c         constrain the changes of the first network
+ *                          by the second one: higher, disjoint or
+ *                          atleastone
+ *   --rate r               basic rate parameter of every variable (5)
+ *   --workload w           epoch, targets, ml, all (all) or contributions,
+ *                          the static change contributions for sienaRI,
+ *                          which is not part of all
+ *   --runs k               number of simulated epochs per period (10)
+ *   --no-scores            simulate the epochs without scores, as in
+ *                          phase 2 of siena07
+ *   --ml-steps k           Metropolis-Hastings steps per period (1000)
+ *   --chain-budget mb      in the ml workload, store a copy of the chain
+ *                          after each of --runs rounds of steps per
+ *                          period in a chain store with a budget of mb
+ *                          megabytes (0 for no budget), and read all
+ *                          stored chains back at the end
+ *   --seed s               random number seed (1)
+ *   --threads t            run the epoch workload as independent
+ *                          replications on t threads, each with a random
+ *                          number stream of its own, and evaluate the
+ *                          target statistics of the evaluation effects
+ *                          and the change contributions of the egos on
+ *                          t threads (1); ignored with --profile
+ *   --profile              enable the engine instrumentation and add its
+ *                          counters to the output
+ *   --allocations          count the heap allocations in each phase and
+ *                          add them, also per simulated ministep or
+ *                          Metropolis-Hastings step, to the output
+ *   --verbose              do not suppress engine diagnostics
+ *
+ * Example:
+ *   sienabench --networks ../../tests/s50-network1.dat,\
+ *     ../../tests/s50-network2.dat,../../tests/s50-network3.dat
+ *****************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <Rmath.h>
+#include "RShim.h"
+#include "data/ActorSet.h"
+#include "data/Data.h"
+#include "data/OneModeNetworkLongitudinalData.h"
+#include "data/BehaviorLongitudinalData.h"
+#include "data/ChangingCovariate.h"
+#include "data/NetworkLongitudinalData.h"
+#include "data/NetworkConstraint.h"
+#include "model/EffectInfo.h"
+#include "model/Model.h"
+#include "model/State.h"
+#include "model/StatisticCalculator.h"
+#include "model/EpochSimulation.h"
+#include "model/ml/MLSimulation.h"
+#include "model/ml/Chain.h"
+#include "model/ml/ChainStore.h"
+#include "utils/Utils.h"
+#include "utils/Instrumentation.h"
+#include "utils/ParallelFor.h"
+#include "utils/Random.h"
+
+using namespace std;
+using namespace siena;
+
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// Section: Options
+// ----------------------------------------------------------------------------
+
+struct Options
+{
+	vector<string> networkFiles;
+	int syntheticActors {};
+	int receivers {};
+	bool sparseTwoMode {};
+	int modelType {};
+	double degree {4};
+	int waves {3};
+	double change {0.2};
+	bool behavior {};
+	string effects {"density=-2,recip=2,transTrip=0.3,cycle3=-0.2,inPop=0.1,outAct=-0.1"};
+	string behaviorEffects {"linear=0.2,quad=-0.1,avAlt=0.5"};
+	string covariateEffects;
+	string multiplexEffects;
+	string constraint;
+	double rate {5};
+	string workload {"all"};
+	int runs {10};
+	bool scores {true};
+	int mlSteps {1000};
+	double chainBudget {-1};
+	unsigned long seed {1};
+	int threads {1};
+	bool profile {};
+	bool allocations {};
+	bool verbose {};
+};
+
+const char * NETWORK = "network";
+const char * SECOND_NETWORK = "network2";
+const char * BEHAVIOR = "behavior";
+const char * COVARIATE = "covariate";
+
+vector<string> split(const string & text, char separator)
+{
+	vector<string> parts;
+	stringstream stream(text);
+	string part;
+
+	while (getline(stream, part, separator))
+	{
+		if (!part.empty())
+		{
+			parts.push_back(part);
+		}
+	}
+
+	return parts;
+}
+
+void usage()
+{
+	cerr << "usage: sienabench [--networks f1,f2,... | --synthetic n"
+		<< " [--receivers m] [--degree d] [--waves w] [--change f]]"
+		<< " [--sparse-two-mode]"
+		<< " [--model-type t]"
+		<< " [--behavior]"
+		<< " [--effects e[=v],...] [--behavior-effects e[=v],...]"
+		<< " [--covariate-effects e[=v],...]"
+		<< " [--multiplex e[=v],... [--constraint higher|disjoint|atleastone]]"
+		<< " [--rate r] [--workload epoch|targets|ml|all|contributions] [--runs k]"
+		<< " [--no-scores]"
+		<< " [--ml-steps k] [--chain-budget mb] [--seed s] [--threads t] [--profile] [--allocations] [--verbose]"
+		<< endl;
+	exit(2);
+}
+
+Options parseOptions(int argc, char ** argv)
+{
+	Options options;
+	bool effectsGiven = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string option = argv[i];
+
+		if (option == "--behavior")
+		{
+			options.behavior = true;
+			continue;
+		}
+		if (option == "--profile")
+		{
+			options.profile = true;
+			continue;
+		}
+		if (option == "--allocations")
+		{
+			options.allocations = true;
+			continue;
+		}
+		if (option == "--verbose")
+		{
+			options.verbose = true;
+			continue;
+		}
+		if (option == "--no-scores")
+		{
+			options.scores = false;
+			continue;
+		}
+		if (option == "--sparse-two-mode")
+		{
+			options.sparseTwoMode = true;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			usage();
+		}
+
+		string value = argv[++i];
+
+		if (option == "--networks")
+		{
+			options.networkFiles = split(value, ',');
+		}
+		else if (option == "--synthetic")
+		{
+			options.syntheticActors = atoi(value.c_str());
+		}
+		else if (option == "--receivers")
+		{
+			options.receivers = atoi(value.c_str());
+		}
+		else if (option == "--model-type")
+		{
+			options.modelType = atoi(value.c_str());
+		}
+		else if (option == "--degree")
+		{
+			options.degree = atof(value.c_str());
+		}
+		else if (option == "--waves")
+		{
+			options.waves = atoi(value.c_str());
+		}
+		else if (option == "--change")
+		{
+			options.change = atof(value.c_str());
+		}
+		else if (option == "--effects")
+		{
+			options.effects = value;
+			effectsGiven = true;
+		}
+		else if (option == "--behavior-effects")
+		{
+			options.behaviorEffects = value;
+		}
+		else if (option == "--covariate-effects")
+		{
+			options.covariateEffects = value;
+		}
+		else if (option == "--multiplex")
+		{
+			options.multiplexEffects = value;
+		}
+		else if (option == "--constraint")
+		{
+			options.constraint = value;
+		}
+		else if (option == "--rate")
+		{
+			options.rate = atof(value.c_str());
+		}
+		else if (option == "--workload")
+		{
+			options.workload = value;
+		}
+		else if (option == "--runs")
+		{
+			options.runs = atoi(value.c_str());
+		}
+		else if (option == "--ml-steps")
+		{
+			options.mlSteps = atoi(value.c_str());
+		}
+		else if (option == "--chain-budget")
+		{
+			options.chainBudget = atof(value.c_str());
+		}
+		else if (option == "--seed")
+		{
+			options.seed = strtoul(value.c_str(), 0, 10);
+		}
+		else if (option == "--threads")
+		{
+			options.threads = atoi(value.c_str());
+		}
+		else
+		{
+			usage();
+		}
+	}
+
+	if (options.networkFiles.empty() && options.syntheticActors <= 0)
+	{
+		usage();
+	}
+
+	if (!options.constraint.empty() &&
+		(options.multiplexEffects.empty() ||
+			(options.constraint != "higher" &&
+				options.constraint != "disjoint" &&
+				options.constraint != "atleastone")))
+	{
+		usage();
+	}
+
+	if (options.receivers > 0)
+	{
+		if (!options.networkFiles.empty() || !options.multiplexEffects.empty())
+		{
+			usage();
+		}
+
+		if (!effectsGiven)
+		{
+			options.effects = "density=-2,inPop=0.1,outAct=-0.1";
+		}
+	}
+
+	if (options.modelType > 1)
+	{
+		if (options.receivers > 0 || options.modelType > 6)
+		{
+			usage();
+		}
+
+		if (!effectsGiven)
+		{
+			options.effects = "density=-2,transTriads=0.3,degPlus=-0.05";
+		}
+	}
+
+	// The instrumentation counters are not shared between threads
+	if (options.profile)
+	{
+		options.threads = 1;
+	}
+
+	return options;
+}
+
+// ----------------------------------------------------------------------------
+// Section: Timing and allocation counting
+// ----------------------------------------------------------------------------
+
+typedef chrono::steady_clock Clock;
+
+// The number of calls of operator new while counting is switched on, from
+// all threads. The replacement operator new below keeps this up to date.
+atomic<long> allocationCount(0);
+atomic<bool> countingAllocations(false);
+
+/**
+ * Accumulates wall-clock seconds and heap allocations per named phase, in
+ * order of first use. A phase is timed from start() to add(); phases are
+ * not nested.
+ */
+class PhaseTimer
+{
+public:
+	Clock::time_point start()
+	{
+		this->lstartAllocations = allocationCount.load(memory_order_relaxed);
+		return Clock::now();
+	}
+
+	void add(const string & phase, Clock::time_point start)
+	{
+		if (this->lseconds.find(phase) == this->lseconds.end())
+		{
+			this->lorder.push_back(phase);
+		}
+
+		this->lseconds[phase] +=
+			chrono::duration<double>(Clock::now() - start).count();
+		this->lallocations[phase] +=
+			allocationCount.load(memory_order_relaxed) -
+				this->lstartAllocations;
+	}
+
+	double seconds(const string & phase) const
+	{
+		map<string, double>::const_iterator iter = this->lseconds.find(phase);
+		return iter == this->lseconds.end() ? 0 : iter->second;
+	}
+
+	long allocations(const string & phase) const
+	{
+		map<string, long>::const_iterator iter =
+			this->lallocations.find(phase);
+		return iter == this->lallocations.end() ? 0 : iter->second;
+	}
+
+	const vector<string> & rPhases() const
+	{
+		return this->lorder;
+	}
+
+private:
+	vector<string> lorder;
+	map<string, double> lseconds;
+	map<string, long> lallocations;
+	long lstartAllocations {};
+};
+
+long peakResidentKilobytes()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+// ----------------------------------------------------------------------------
+// Section: Data construction
+// ----------------------------------------------------------------------------
+
+/**
+ * Reads a square adjacency matrix with the coding of the s50 test files.
+ */
+vector<vector<int> > readMatrix(const string & fileName)
+{
+	ifstream file(fileName.c_str());
+
+	if (!file.is_open())
+	{
+		throw runtime_error("cannot open " + fileName);
+	}
+
+	vector<vector<int> > matrix;
+	string line;
+
+	while (getline(file, line))
+	{
+		istringstream stream(line);
+		vector<int> row;
+		int value;
+
+		while (stream >> value)
+		{
+			row.push_back(value);
+		}
+
+		if (!row.empty())
+		{
+			matrix.push_back(row);
+		}
+	}
+
+	for (unsigned i = 0; i < matrix.size(); i++)
+	{
+		if (matrix[i].size() != matrix.size())
+		{
+			throw runtime_error(fileName + " is not a square matrix");
+		}
+	}
+
+	return matrix;
+}
+
+/**
+ * Generates a panel of directed networks: a random first wave with the
+ * requested average out-degree, followed by waves in which the given
+ * fraction of ties is dropped and replaced by new random ties.
+ */
+vector<vector<vector<int> > > syntheticPanel(const Options & options)
+{
+	int n = options.syntheticActors;
+	mt19937 generator(options.seed);
+	uniform_int_distribution<int> actor(0, n - 1);
+	uniform_real_distribution<double> uniform(0, 1);
+	vector<vector<vector<int> > > waves(options.waves,
+		vector<vector<int> >(n, vector<int>(n, 0)));
+	long ties = (long) (options.degree * n);
+
+	for (long t = 0; t < ties; t++)
+	{
+		int i = actor(generator);
+		int j = actor(generator);
+
+		if (i != j)
+		{
+			waves[0][i][j] = 1;
+		}
+	}
+
+	for (int wave = 1; wave < options.waves; wave++)
+	{
+		waves[wave] = waves[wave - 1];
+
+		for (int i = 0; i < n; i++)
+		{
+			for (int j = 0; j < n; j++)
+			{
+				if (waves[wave][i][j] && uniform(generator) < options.change)
+				{
+					waves[wave][i][j] = 0;
+					int k = actor(generator);
+
+					if (k != i)
+					{
+						waves[wave][i][k] = 1;
+					}
+				}
+			}
+		}
+	}
+
+	return waves;
+}
+
+/**
+ * Generates a panel of two-mode networks from the synthetic actors to the
+ * given number of receivers in the same way as syntheticPanel. The ties
+ * are kept as sets of receivers per actor, as dense matrices of large
+ * affiliation networks would not fit into memory.
+ */
+vector<vector<set<int> > > syntheticTwoModePanel(const Options & options)
+{
+	int n = options.syntheticActors;
+	mt19937 generator(options.seed);
+	uniform_int_distribution<int> actor(0, n - 1);
+	uniform_int_distribution<int> receiver(0, options.receivers - 1);
+	uniform_real_distribution<double> uniform(0, 1);
+	vector<vector<set<int> > > waves(options.waves, vector<set<int> >(n));
+	long ties = (long) (options.degree * n);
+
+	for (long t = 0; t < ties; t++)
+	{
+		int i = actor(generator);
+		waves[0][i].insert(receiver(generator));
+	}
+
+	for (int wave = 1; wave < options.waves; wave++)
+	{
+		waves[wave] = waves[wave - 1];
+
+		for (int i = 0; i < n; i++)
+		{
+			for (int j : waves[wave - 1][i])
+			{
+				if (uniform(generator) < options.change)
+				{
+					waves[wave][i].erase(j);
+					waves[wave][i].insert(receiver(generator));
+				}
+			}
+		}
+	}
+
+	return waves;
+}
+
+void addTwoModeNetwork(Data * pData, const ActorSet * pSenders,
+	const ActorSet * pReceivers, const vector<vector<set<int> > > & waves,
+	const string & name)
+{
+	NetworkLongitudinalData * pNetworkData =
+		pData->createNetworkData(name, pSenders, pReceivers);
+
+	for (unsigned observation = 0; observation < waves.size(); observation++)
+	{
+		for (unsigned i = 0; i < waves[observation].size(); i++)
+		{
+			for (int j : waves[observation][i])
+			{
+				pNetworkData->tieValue(i, j, observation, 1);
+			}
+		}
+	}
+
+	pNetworkData->calculateProperties();
+}
+
+/**
+ * Makes each wave symmetric, keeping the larger code of the two tie
+ * variables of each dyad.
+ */
+void symmetrize(vector<vector<vector<int> > > & waves)
+{
+	for (unsigned observation = 0; observation < waves.size(); observation++)
+	{
+		vector<vector<int> > & rWave = waves[observation];
+
+		for (unsigned i = 0; i < rWave.size(); i++)
+		{
+			for (unsigned j = i + 1; j < rWave.size(); j++)
+			{
+				rWave[i][j] = rWave[j][i] = max(rWave[i][j], rWave[j][i]);
+			}
+		}
+	}
+}
+
+OneModeNetworkLongitudinalData * addNetwork(Data * pData,
+	const ActorSet * pActors, const vector<vector<vector<int> > > & waves,
+	const string & name)
+{
+	OneModeNetworkLongitudinalData * pNetworkData =
+		pData->createOneModeNetworkData(name, pActors);
+	int n = pActors->n();
+
+	for (unsigned observation = 0; observation < waves.size(); observation++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			for (int j = 0; j < n; j++)
+			{
+				int value = waves[observation][i][j];
+
+				if (i == j || value == 0)
+				{
+					continue;
+				}
+				if (value == 9)
+				{
+					pNetworkData->missing(i, j, observation, true);
+				}
+				else if (value == 10 || value == 11)
+				{
+					pNetworkData->structural(i, j, observation, true);
+					pNetworkData->tieValue(i, j, observation, value - 10);
+				}
+				else
+				{
+					pNetworkData->tieValue(i, j, observation, 1);
+				}
+			}
+		}
+	}
+
+	pNetworkData->calculateProperties();
+	return pNetworkData;
+}
+
+void addBehavior(Data * pData, const ActorSet * pActors,
+	unsigned long seed)
+{
+	BehaviorLongitudinalData * pBehaviorData =
+		pData->createBehaviorData(BEHAVIOR, pActors);
+	mt19937 generator(seed + 1);
+	uniform_int_distribution<int> level(1, 5);
+	uniform_int_distribution<int> step(-1, 1);
+	int n = pActors->n();
+	vector<int> values(n);
+
+	for (int i = 0; i < n; i++)
+	{
+		values[i] = level(generator);
+	}
+
+	for (int observation = 0; observation < pData->observationCount();
+		observation++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			if (observation > 0)
+			{
+				values[i] = min(5, max(1, values[i] + step(generator)));
+			}
+			pBehaviorData->value(observation, i, values[i]);
+			pBehaviorData->missing(observation, i, false);
+		}
+	}
+
+	// The similarity mean over all observed pairs, as computed in R
+
+	double similaritySum = 0;
+	double pairs = 0;
+
+	for (int observation = 0; observation < pData->observationCount();
+		observation++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			for (int j = 0; j < n; j++)
+			{
+				if (i != j)
+				{
+					similaritySum += 1 - abs(pBehaviorData->value(observation, i)
+						- pBehaviorData->value(observation, j)) / 4.0;
+					pairs++;
+				}
+			}
+		}
+	}
+
+	pBehaviorData->similarityMean(similaritySum / pairs);
+	pBehaviorData->similarityMeans(similaritySum / pairs, NETWORK);
+	pBehaviorData->calculateProperties();
+}
+
+void addCovariate(Data * pData, const ActorSet * pActors,
+	unsigned long seed)
+{
+	ChangingCovariate * pCovariate =
+		pData->createChangingCovariate(COVARIATE, pActors);
+	mt19937 generator(seed + 3);
+	uniform_int_distribution<int> level(1, 5);
+	uniform_int_distribution<int> step(-1, 1);
+	int n = pActors->n();
+	int periods = pData->observationCount() - 1;
+	vector<vector<int> > values(periods, vector<int>(n));
+	double sum = 0;
+
+	for (int period = 0; period < periods; period++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			values[period][i] = period == 0 ? level(generator) :
+				min(5, max(1, values[period - 1][i] + step(generator)));
+			sum += values[period][i];
+		}
+	}
+
+	// Centered as in R, with the similarity mean over all observed pairs
+
+	double mean = sum / (periods * n);
+	double similaritySum = 0;
+	double pairs = 0;
+
+	for (int period = 0; period < periods; period++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			pCovariate->value(i, period, values[period][i] - mean);
+			pCovariate->missing(i, period, false);
+
+			for (int j = 0; j < n; j++)
+			{
+				if (i != j)
+				{
+					similaritySum +=
+						1 - abs(values[period][i] - values[period][j]) / 4.0;
+					pairs++;
+				}
+			}
+		}
+	}
+
+	pCovariate->mean(mean);
+	pCovariate->range(4);
+	pCovariate->similarityMean(similaritySum / pairs);
+	pCovariate->similarityMeans(similaritySum / pairs, NETWORK);
+}
+
+Data * createData(const Options & options)
+{
+	vector<vector<vector<int> > > waves;
+
+	if (options.receivers > 0)
+	{
+		Data * pData = new Data(options.waves);
+		const ActorSet * pActors = pData->createActorSet("Actors",
+			options.syntheticActors);
+		const ActorSet * pReceivers = pData->createActorSet("Receivers",
+			options.receivers);
+		addTwoModeNetwork(pData, pActors, pReceivers,
+			syntheticTwoModePanel(options), NETWORK);
+
+		if (options.behavior)
+		{
+			addBehavior(pData, pActors, options.seed);
+		}
+
+		if (!options.covariateEffects.empty())
+		{
+			addCovariate(pData, pActors, options.seed);
+		}
+
+		return pData;
+	}
+
+	if (!options.networkFiles.empty())
+	{
+		for (unsigned i = 0; i < options.networkFiles.size(); i++)
+		{
+			waves.push_back(readMatrix(options.networkFiles[i]));
+		}
+	}
+	else
+	{
+		waves = syntheticPanel(options);
+	}
+
+	if (waves.size() < 2)
+	{
+		throw runtime_error("at least two waves are needed");
+	}
+
+	if (options.modelType > 1)
+	{
+		symmetrize(waves);
+	}
+
+	Data * pData = new Data(waves.size());
+	const ActorSet * pActors = pData->createActorSet("Actors",
+		waves[0].size());
+	OneModeNetworkLongitudinalData * pNetworkData =
+		addNetwork(pData, pActors, waves, NETWORK);
+
+	if (options.modelType > 1)
+	{
+		pNetworkData->symmetric(true);
+		pNetworkData->modelType(options.modelType);
+	}
+
+	if (!options.multiplexEffects.empty())
+	{
+		// A second synthetic panel of the same size, independent of the
+		// first network
+
+		Options secondOptions = options;
+		secondOptions.syntheticActors = waves[0].size();
+		secondOptions.waves = waves.size();
+		secondOptions.seed = options.seed + 2;
+		addNetwork(pData, pActors, syntheticPanel(secondOptions),
+			SECOND_NETWORK);
+
+		if (!options.constraint.empty())
+		{
+			NetworkConstraintType type = AT_LEAST_ONE;
+
+			if (options.constraint == "higher")
+			{
+				type = HIGHER;
+			}
+			else if (options.constraint == "disjoint")
+			{
+				type = DISJOINT;
+			}
+
+			pData->addNetworkConstraint(NETWORK, SECOND_NETWORK, type);
+		}
+	}
+
+	if (options.behavior)
+	{
+		addBehavior(pData, pActors, options.seed);
+	}
+
+	if (!options.covariateEffects.empty())
+	{
+		addCovariate(pData, pActors, options.seed);
+	}
+
+	return pData;
+}
+
+void addEffects(Model * pModel, const string & variableName,
+	const string & effects, const string & interactionName = "")
+{
+	vector<string> list = split(effects, ',');
+	map<string, EffectInfo *> infos;
+
+	for (unsigned i = 0; i < list.size(); i++)
+	{
+		vector<string> nameValue = split(list[i], '=');
+		double parameter = nameValue.size() > 1 ?
+			atof(nameValue[1].c_str()) : 0.1;
+		vector<string> components = split(nameValue[0], '*');
+
+		if (components.size() > 1)
+		{
+			EffectInfo * pInfos[3] = {0, 0, 0};
+
+			for (unsigned k = 0; k < components.size() && k < 3; k++)
+			{
+				if (!infos.count(components[k]))
+				{
+					throw runtime_error("interaction of unknown effect " +
+						components[k]);
+				}
+
+				pInfos[k] = infos[components[k]];
+			}
+
+			pModel->addInteractionEffect(variableName,
+				variableName == BEHAVIOR ? "behUnspInt" : "unspInt",
+				"eval", parameter, pInfos[0], pInfos[1], pInfos[2]);
+		}
+		else
+		{
+			infos[nameValue[0]] = pModel->addEffect(variableName,
+				nameValue[0], "eval", parameter, 0, interactionName);
+		}
+	}
+}
+
+Model * createModel(const Options & options, Data * pData)
+{
+	Model * pModel = new Model();
+	int periods = pData->observationCount() - 1;
+	pModel->numberOfPeriods(periods);
+
+	for (int period = 0; period < periods; period++)
+	{
+		for (unsigned i = 0; i < pData->rDependentVariableData().size(); i++)
+		{
+			pModel->basicRateParameter(pData->rDependentVariableData()[i],
+				period, options.rate);
+		}
+	}
+
+	addEffects(pModel, NETWORK, options.effects);
+	addEffects(pModel, NETWORK, options.covariateEffects, COVARIATE);
+
+	if (!options.multiplexEffects.empty())
+	{
+		addEffects(pModel, SECOND_NETWORK, "density=-2,recip=2", NETWORK);
+		addEffects(pModel, SECOND_NETWORK, options.multiplexEffects, NETWORK);
+	}
+
+	if (options.behavior)
+	{
+		// The network dependent behavior effects refer to the network;
+		// the others ignore the interaction name.
+
+		addEffects(pModel, BEHAVIOR, options.behaviorEffects, NETWORK);
+	}
+
+	// The default Metropolis-Hastings settings of sienaAlgorithmCreate
+
+	pModel->sparseTwoMode(options.sparseTwoMode);
+	pModel->setupChainStore(periods);
+
+	if (options.chainBudget > 0)
+	{
+		pModel->pChainStore()->memoryBudget(
+			(size_t) (options.chainBudget * 1024 * 1024));
+	}
+	pModel->maximumPermutationLength(40);
+	pModel->minimumPermutationLength(2);
+	pModel->initialPermutationLength(20);
+	pModel->initializeCurrentPermutationLength();
+	pModel->insertDiagonalProbability(0.05);
+	pModel->cancelDiagonalProbability(0.05);
+	pModel->permuteProbability(0.2);
+	pModel->insertPermuteProbability(0.3);
+	pModel->deletePermuteProbability(0.3);
+	pModel->insertRandomMissingProbability(0.05);
+	pModel->deleteRandomMissingProbability(0.05);
+
+	return pModel;
+}
+
+vector<EffectInfo *> statisticEffects(const Model * pModel,
+	const Data * pData)
+{
+	vector<EffectInfo *> effects;
+
+	for (unsigned i = 0; i < pData->rDependentVariableData().size(); i++)
+	{
+		const vector<EffectInfo *> & rEffects = pModel->rEvaluationEffects(
+			pData->rDependentVariableData()[i]->name());
+		effects.insert(effects.end(), rEffects.begin(), rEffects.end());
+	}
+
+	return effects;
+}
+
+// ----------------------------------------------------------------------------
+// Section: Workloads
+// ----------------------------------------------------------------------------
+
+/**
+ * Forward simulation of all periods, followed by the calculation of the
+ * statistics of the simulated state, as in phases 1-3 of siena07.
+ */
+long runEpochs(const Options & options, Data * pData, Model * pModel,
+	PhaseTimer & timer, double & checksum)
+{
+	pModel->needScores(options.scores);
+	pModel->needDerivatives(false);
+	pModel->needChain(false);
+	vector<EffectInfo *> effects = statisticEffects(pModel, pData);
+	long steps = 0;
+
+	Clock::time_point start = timer.start();
+	EpochSimulation simulation(pData, pModel);
+	timer.add("epoch.setup", start);
+
+	for (int run = 0; run < options.runs; run++)
+	{
+		for (int period = 0; period < pData->observationCount() - 1; period++)
+		{
+			start = timer.start();
+			simulation.runEpoch(period);
+			timer.add("epoch.simulate", start);
+			steps += simulation.stepCount();
+
+			start = timer.start();
+			State state(&simulation);
+			StatisticCalculator calculator(pData, pModel, &state, period);
+
+			for (unsigned i = 0; i < effects.size(); i++)
+			{
+				checksum += calculator.statistic(effects[i]);
+			}
+			timer.add("epoch.statistics", start);
+		}
+	}
+
+	return steps;
+}
+
+/**
+ * The epoch workload as independent replications on several threads, as in
+ * phase 3 of siena07 with simulateReplications. Each replication has its
+ * own simulation and random number stream, and the checksums are added in
+ * the order of the replications, so the result does not depend on the
+ * number of threads.
+ */
+long runParallelEpochs(const Options & options, Data * pData, Model * pModel,
+	PhaseTimer & timer, double & checksum)
+{
+	pModel->needScores(options.scores);
+	pModel->needDerivatives(false);
+	pModel->needChain(false);
+	vector<EffectInfo *> effects = statisticEffects(pModel, pData);
+	vector<unsigned long long> seeds(options.runs);
+	vector<double> checksums(options.runs);
+	vector<long> steps(options.runs);
+
+	for (int run = 0; run < options.runs; run++)
+	{
+		unsigned long long high = unif_rand() * 4294967296.0;
+		unsigned long long low = unif_rand() * 4294967296.0;
+		seeds[run] = (high << 32) | low;
+	}
+
+	Clock::time_point start = timer.start();
+
+	parallelFor(options.runs, options.threads, [&](int run)
+	{
+		RandomStream stream(seeds[run]);
+		currentRandomStream(&stream);
+		EpochSimulation simulation(pData, pModel);
+
+		for (int period = 0; period < pData->observationCount() - 1; period++)
+		{
+			simulation.runEpoch(period);
+			steps[run] += simulation.stepCount();
+
+			State state(&simulation);
+			StatisticCalculator calculator(pData, pModel, &state, period);
+
+			for (unsigned i = 0; i < effects.size(); i++)
+			{
+				checksums[run] += calculator.statistic(effects[i]);
+			}
+		}
+
+		currentRandomStream(0);
+	});
+
+	timer.add("epoch.simulate", start);
+	long totalSteps = 0;
+
+	for (int run = 0; run < options.runs; run++)
+	{
+		checksum += checksums[run];
+		totalSteps += steps[run];
+	}
+
+	return totalSteps;
+}
+
+/**
+ * Calculation of the observed target statistics, as done by getTargets
+ * for a single group with fewer periods than threads.
+ */
+long runTargets(const Options & options, Data * pData, Model * pModel,
+	PhaseTimer & timer, double & checksum)
+{
+	vector<EffectInfo *> effects = statisticEffects(pModel, pData);
+	long calculations = 0;
+
+	for (int run = 0; run < options.runs; run++)
+	{
+		for (int period = 0; period < pData->observationCount() - 1; period++)
+		{
+			Clock::time_point start = timer.start();
+			State state(pData, period + 1);
+			StatisticCalculator calculator(pData, pModel, &state, period,
+				false, false, options.threads);
+
+			for (unsigned i = 0; i < effects.size(); i++)
+			{
+				checksum += calculator.statistic(effects[i]);
+			}
+			timer.add("targets.statistics", start);
+			calculations++;
+		}
+	}
+
+	return calculations;
+}
+
+/**
+ * Calculation of the static change contributions of the evaluation effects
+ * for the observations, as done by getTargets for sienaRI, with one array
+ * per effect. The contributions of the choices that are not permitted are
+ * not added to the checksum.
+ */
+long runContributions(const Options & options, Data * pData, Model * pModel,
+	PhaseTimer & timer, double & checksum)
+{
+	vector<EffectInfo *> effects = statisticEffects(pModel, pData);
+	vector<int> choices(effects.size());
+	vector<vector<double> > contributions(effects.size());
+	map<EffectInfo *, double *> storage;
+	long calculations = 0;
+
+	for (unsigned i = 0; i < effects.size(); i++)
+	{
+		BehaviorLongitudinalData * pBehaviorData =
+			pData->pBehaviorData(effects[i]->variableName());
+
+		if (pBehaviorData)
+		{
+			choices[i] = 3;
+			contributions[i].resize(pBehaviorData->n() * 3);
+		}
+		else
+		{
+			choices[i] = pData->pNetworkData(effects[i]->variableName())->n();
+			contributions[i].resize(choices[i] * choices[i]);
+		}
+
+		storage[effects[i]] = &contributions[i][0];
+	}
+
+	for (int run = 0; run < options.runs; run++)
+	{
+		for (int period = 0; period < pData->observationCount() - 1; period++)
+		{
+			Clock::time_point start = timer.start();
+			State state(pData, period);
+			StatisticCalculator calculator(pData, pModel, &state, period,
+				storage, options.threads);
+			timer.add("contributions", start);
+
+			for (unsigned i = 0; i < effects.size(); i++)
+			{
+				for (unsigned j = 0; j < contributions[i].size(); j++)
+				{
+					if (!std::isnan(contributions[i][j]))
+					{
+						checksum += contributions[i][j] *
+							(1 + (j / choices[i] * 7 + j % choices[i]) % 13);
+					}
+				}
+			}
+			calculations++;
+		}
+	}
+
+	return calculations;
+}
+
+/**
+ * Chain initialization and Metropolis-Hastings steps, as done by
+ * mlMakeChains and mlPeriod.
+ */
+long runML(const Options & options, Data * pData, Model * pModel,
+	PhaseTimer & timer, double & checksum)
+{
+	pModel->needScores(false);
+	pModel->needDerivatives(false);
+	pModel->needChain(true);
+	long steps = 0;
+
+	Clock::time_point start = timer.start();
+	MLSimulation simulation(pData, pModel);
+	simulation.simpleRates(pModel->simpleRates());
+	timer.add("ml.setup", start);
+
+	for (int period = 0; period < pData->observationCount() - 1; period++)
+	{
+		start = timer.start();
+		simulation.missingNetworkProbability(0);
+		simulation.missingBehaviorProbability(0);
+		simulation.currentPermutationLength(
+			pModel->currentPermutationLength(period));
+		simulation.pChain()->clear();
+		simulation.connect(period);
+		simulation.preburnin();
+		simulation.setUpProbabilityArray();
+		timer.add("ml.burnin", start);
+
+		int rounds = options.chainBudget >= 0 ? options.runs : 1;
+
+		for (int round = 0; round < rounds; round++)
+		{
+			start = timer.start();
+			for (int i = 0; i < options.mlSteps; i++)
+			{
+				simulation.MLStep();
+			}
+			timer.add("ml.steps", start);
+			steps += options.mlSteps;
+			checksum += simulation.pChain()->ministepCount();
+
+			if (options.chainBudget >= 0)
+			{
+				// As mlPeriod with addChainToStore
+				start = timer.start();
+				pModel->chainStore(*simulation.pChain(), period);
+				timer.add("ml.store", start);
+			}
+		}
+	}
+
+	if (options.chainBudget >= 0)
+	{
+		// Read all stored chains back, as getChainProbabilities does,
+		// oldest first.
+
+		ChainStore * pChainStore = pModel->pChainStore();
+		start = timer.start();
+
+		for (int period = 0; period < pChainStore->periods(); period++)
+		{
+			for (int i = 0; i < pChainStore->size(period); i++)
+			{
+				checksum += pChainStore->pChain(period, i)->ministepCount();
+			}
+		}
+
+		timer.add("ml.store.read", start);
+
+		if (options.verbose)
+		{
+			cerr << "sienabench: " << pChainStore->spilledChainCount()
+				<< " stored chains spilled, "
+				<< pChainStore->residentBytes() / (1024 * 1024)
+				<< " MB in memory" << endl;
+		}
+	}
+
+	return steps;
+}
+
+void printJson(const Options & options, const Data * pData,
+	const PhaseTimer & timer, const map<string, long> & counts,
+	double checksum)
+{
+	const LongitudinalData * pVariable = pData->rDependentVariableData()[0];
+	cout.precision(6);
+	cout << "{" << endl;
+	cout << "  \"actors\": " << pVariable->n() << "," << endl;
+	cout << "  \"observations\": " << pData->observationCount() << "," << endl;
+	cout << "  \"seed\": " << options.seed << "," << endl;
+	cout << "  \"runs\": " << options.runs << "," << endl;
+	cout << "  \"phases\": {";
+
+	for (unsigned i = 0; i < timer.rPhases().size(); i++)
+	{
+		cout << (i ? "," : "") << endl << "    \"" << timer.rPhases()[i]
+			<< "\": " << timer.seconds(timer.rPhases()[i]);
+	}
+
+	cout << endl << "  }," << endl;
+	cout << "  \"rates\": {";
+	bool first = true;
+
+	for (map<string, long>::const_iterator iter = counts.begin();
+		iter != counts.end();
+		iter++)
+	{
+		double seconds = timer.seconds(iter->first);
+		cout << (first ? "" : ",") << endl << "    \"" << iter->first
+			<< "\": {\"count\": " << iter->second << ", \"per_second\": "
+			<< (seconds > 0 ? iter->second / seconds : 0) << "}";
+		first = false;
+	}
+
+	cout << endl << "  }," << endl;
+
+	if (options.allocations)
+	{
+		// Allocations per phase, and per step of the phases with a rate
+
+		cout << "  \"allocations\": {";
+
+		for (unsigned i = 0; i < timer.rPhases().size(); i++)
+		{
+			const string & phase = timer.rPhases()[i];
+			cout << (i ? "," : "") << endl << "    \"" << phase << "\": {"
+				<< "\"count\": " << timer.allocations(phase);
+			map<string, long>::const_iterator iter = counts.find(phase);
+
+			if (iter != counts.end() && iter->second > 0)
+			{
+				cout << ", \"per_step\": "
+					<< double(timer.allocations(phase)) / iter->second;
+			}
+
+			cout << "}";
+		}
+
+		cout << endl << "  }," << endl;
+	}
+
+	// All digits, so that runs agree only if they give the same results
+	cout << "  \"checksum\": " << setprecision(17) << checksum <<
+		setprecision(6) << "," << endl;
+
+	if (options.profile)
+	{
+		cout << "  \"profile\": [";
+		first = true;
+
+		for (int i = 0; i < Instrumentation::slotCount(); i++)
+		{
+			if (Instrumentation::calls(i) > 0)
+			{
+				cout << (first ? "" : ",") << endl << "    {\"category\": \""
+					<< Instrumentation::category(i) << "\", \"name\": \""
+					<< Instrumentation::name(i) << "\", \"calls\": "
+					<< Instrumentation::calls(i) << ", \"seconds\": "
+					<< Instrumentation::seconds(i) << "}";
+				first = false;
+			}
+		}
+
+		cout << endl << "  ]," << endl;
+	}
+
+	cout << "  \"peak_rss_kb\": " << peakResidentKilobytes() << endl;
+	cout << "}" << endl;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+// Section: Replacement allocation functions
+// ----------------------------------------------------------------------------
+
+// Counting the allocations of the engine takes replacing the global
+// operator new of the program; the nothrow forms of the library call it,
+// and the aligned forms are not used by the engine.
+
+// Frees memory of the replacement operator new. It is kept out of line, so
+// that the compiler does not see free() in place of operator delete where
+// the operators are inlined, and warn of a mismatch (-Wmismatched-new-delete).
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void release(void * pointer)
+{
+	free(pointer);
+}
+
+void * operator new(size_t size)
+{
+	if (countingAllocations.load(memory_order_relaxed))
+	{
+		allocationCount.fetch_add(1, memory_order_relaxed);
+	}
+
+	void * pointer = malloc(size ? size : 1);
+
+	if (!pointer)
+	{
+		throw bad_alloc();
+	}
+
+	return pointer;
+}
+
+void * operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void * pointer) noexcept
+{
+	release(pointer);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+	release(pointer);
+}
+
+void operator delete(void * pointer, size_t) noexcept
+{
+	release(pointer);
+}
+
+void operator delete[](void * pointer, size_t) noexcept
+{
+	release(pointer);
+}
+
+int main(int argc, char ** argv)
+{
+	Options options = parseOptions(argc, argv);
+	shimSeed(options.seed);
+	shimQuiet(!options.verbose);
+	Instrumentation::enabled(options.profile);
+	countingAllocations = options.allocations;
+
+	PhaseTimer timer;
+	map<string, long> counts;
+	double checksum = 0;
+
+	try
+	{
+		Clock::time_point start = timer.start();
+		Data * pData = createData(options);
+		Model * pModel = createModel(options, pData);
+		timer.add("setup", start);
+
+		bool all = options.workload == "all";
+
+		if (all || options.workload == "targets")
+		{
+			counts["targets.statistics"] =
+				runTargets(options, pData, pModel, timer, checksum);
+		}
+		if (all || options.workload == "epoch")
+		{
+			counts["epoch.simulate"] = options.threads > 1 ?
+				runParallelEpochs(options, pData, pModel, timer, checksum) :
+				runEpochs(options, pData, pModel, timer, checksum);
+		}
+		if (options.workload == "contributions")
+		{
+			counts["contributions"] =
+				runContributions(options, pData, pModel, timer, checksum);
+		}
+		if (all || options.workload == "ml")
+		{
+			counts["ml.steps"] =
+				runML(options, pData, pModel, timer, checksum);
+		}
+
+		printJson(options, pData, timer, counts, checksum);
+
+		delete pModel;
+		delete pData;
+	}
+	catch (exception & e)
+	{
+		cerr << "sienabench: " << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
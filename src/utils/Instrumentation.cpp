@@ -0,0 +1,291 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: Instrumentation.cpp
+ *
+ * Description: This file contains the implementation of the
+ * Instrumentation and InstrumentationTimer classes.
+ *****************************************************************************/
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Instrumentation.h"
+#include "model/EffectInfo.h"
+#include "model/effects/Effect.h"
+
+using namespace std;
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Instrumentation categories
+// ----------------------------------------------------------------------------
+
+const string PHASE = "phase";
+const string EFFECT = "effect";
+const string STATISTIC = "statistic";
+const string TABLE = "table";
+const string MHSTEP = "mhstep";
+
+
+// ----------------------------------------------------------------------------
+// Section: Counter storage
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/**
+ * A single counter of the instrumentation table.
+ */
+struct Counter
+{
+	string category;
+	string name;
+	long long calls;
+	long long nanoseconds;
+};
+
+// The counters, indexed by slot. Slots are never removed, as instrumented
+// code keeps their indices in static variables.
+
+vector<Counter> & counters()
+{
+	static vector<Counter> lcounters;
+	return lcounters;
+}
+
+// The slot of each pair of category and name
+
+map<pair<string, string>, int> & slots()
+{
+	static map<pair<string, string>, int> lslots;
+	return lslots;
+}
+
+// Serializes the creation of slots, which can happen while simulations
+// run on several threads. The counters themselves are only updated while
+// the instrumentation is enabled, which restricts simulations to a single
+// thread.
+
+mutex & slotMutex()
+{
+	static mutex lmutex;
+	return lmutex;
+}
+
+
+/**
+ * Returns the name of the given effect for the instrumentation table,
+ * consisting of the effect name and any interaction variables, and for
+ * user-defined interactions the names of the interacting effects.
+ */
+string effectLabel(const EffectInfo * pEffectInfo)
+{
+	string label = pEffectInfo->effectName();
+
+	if (pEffectInfo->pEffectInfo1())
+	{
+		label += "(" + effectLabel(pEffectInfo->pEffectInfo1()) + " x " +
+			effectLabel(pEffectInfo->pEffectInfo2());
+
+		if (pEffectInfo->pEffectInfo3())
+		{
+			label += " x " + effectLabel(pEffectInfo->pEffectInfo3());
+		}
+
+		label += ")";
+	}
+	else if (pEffectInfo->interactionName1() != "")
+	{
+		label += "(" + pEffectInfo->interactionName1();
+
+		if (pEffectInfo->interactionName2() != "")
+		{
+			label += "," + pEffectInfo->interactionName2();
+		}
+
+		label += ")";
+	}
+
+	return label;
+}
+
+}
+
+
+// Recording is off unless requested
+
+bool Instrumentation::lenabled = false;
+
+
+// ----------------------------------------------------------------------------
+// Section: Control
+// ----------------------------------------------------------------------------
+
+/**
+ * Switches the recording on or off. The counters keep their values.
+ */
+void Instrumentation::enabled(bool flag)
+{
+	Instrumentation::lenabled = flag;
+}
+
+
+/**
+ * Sets all counters to zero.
+ */
+void Instrumentation::reset()
+{
+	vector<Counter> & rCounters = counters();
+
+	for (unsigned i = 0; i < rCounters.size(); i++)
+	{
+		rCounters[i].calls = 0;
+		rCounters[i].nanoseconds = 0;
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Counters
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns the slot of the counter with the given category and name,
+ * creating the counter if it does not exist yet.
+ */
+int Instrumentation::slot(const string & category, const string & name)
+{
+	lock_guard<mutex> lock(slotMutex());
+	pair<string, string> key(category, name);
+	map<pair<string, string>, int>::iterator iter = slots().find(key);
+
+	if (iter != slots().end())
+	{
+		return iter->second;
+	}
+
+	Counter counter = {category, name, 0, 0};
+	counters().push_back(counter);
+	int slot = counters().size() - 1;
+	slots()[key] = slot;
+
+	return slot;
+}
+
+
+/**
+ * Returns the slot of the counter of the given effect in the given category.
+ * Effects of the same specification share their counter, also between
+ * groups and simulation objects.
+ */
+int Instrumentation::effectSlot(const string & category,
+	const EffectInfo * pEffectInfo)
+{
+	return Instrumentation::slot(category,
+		pEffectInfo->variableName() + " " + effectLabel(pEffectInfo) + " " +
+			pEffectInfo->effectType());
+}
+
+
+/**
+ * Adds a call of the given duration to the counter in the given slot.
+ */
+void Instrumentation::record(int slot, long long nanoseconds)
+{
+	Counter & rCounter = counters()[slot];
+	rCounter.calls++;
+	rCounter.nanoseconds += nanoseconds;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Accessors
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns the number of counters.
+ */
+int Instrumentation::slotCount()
+{
+	return counters().size();
+}
+
+
+/**
+ * Returns the category of the counter in the given slot.
+ */
+const string & Instrumentation::category(int slot)
+{
+	return counters()[slot].category;
+}
+
+
+/**
+ * Returns the name of the counter in the given slot.
+ */
+const string & Instrumentation::name(int slot)
+{
+	return counters()[slot].name;
+}
+
+
+/**
+ * Returns the number of calls recorded in the given slot.
+ */
+long long Instrumentation::calls(int slot)
+{
+	return counters()[slot].calls;
+}
+
+
+/**
+ * Returns the total time in seconds recorded in the given slot.
+ */
+double Instrumentation::seconds(int slot)
+{
+	return counters()[slot].nanoseconds * 1e-9;
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: InstrumentationTimer
+// ----------------------------------------------------------------------------
+
+/**
+ * Starts timing for the counter in the given slot.
+ */
+void InstrumentationTimer::start(int slot)
+{
+	this->lslot = slot;
+	this->lstart = chrono::steady_clock::now();
+}
+
+
+/**
+ * Starts timing for the counter of the change contributions of the given
+ * effect.
+ */
+void InstrumentationTimer::start(Effect * pEffect)
+{
+	this->start(pEffect->instrumentationSlot());
+}
+
+
+/**
+ * Starts timing for the counter of the given effect in the given category.
+ */
+void InstrumentationTimer::start(const string & category,
+	const EffectInfo * pEffectInfo)
+{
+	this->start(Instrumentation::effectSlot(category, pEffectInfo));
+}
+
+}
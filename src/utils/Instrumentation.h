@@ -0,0 +1,188 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: Instrumentation.h
+ *
+ * Description: This file defines the classes Instrumentation and
+ * InstrumentationTimer, which count the calls and accumulate the time spent
+ * in the hot parts of the simulation.
+ *****************************************************************************/
+
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <chrono>
+#include <string>
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Forward declarations
+// ----------------------------------------------------------------------------
+
+class Effect;
+class EffectInfo;
+
+
+// ----------------------------------------------------------------------------
+// Section: Instrumentation categories
+// ----------------------------------------------------------------------------
+
+// Simulation phases, such as a whole ministep or the calculation of rates
+extern const std::string PHASE;
+
+// Change contributions of individual effects during the simulation
+extern const std::string EFFECT;
+
+// Statistics of individual effects
+extern const std::string STATISTIC;
+
+// Recalculations of configuration tables, by table type
+extern const std::string TABLE;
+
+// Metropolis-Hastings steps of the maximum likelihood estimation, by type
+extern const std::string MHSTEP;
+
+
+// ----------------------------------------------------------------------------
+// Section: Class description
+// ----------------------------------------------------------------------------
+
+/**
+ * This class keeps a table of counters, each identified by a category and
+ * a name, recording the number of calls and the total time spent in an
+ * instrumented part of the code. The instrumentation is always compiled in
+ * but only records anything while it is enabled, so the cost of a disabled
+ * counter is a single test of a flag.
+ *
+ * Instrumented code obtains the index of its counter (a slot) once and
+ * then times a block by creating an InstrumentationTimer on the stack:
+ *
+ * static const int slot = Instrumentation::slot(PHASE, "runStep");
+ * InstrumentationTimer timer(slot);
+ *
+ * Times of nested blocks are inclusive, so the time of a phase includes the
+ * times of the effects and tables evaluated within it.
+ */
+class Instrumentation
+{
+public:
+	static inline bool enabled();
+	static void enabled(bool flag);
+	static void reset();
+
+	static int slot(const std::string & category, const std::string & name);
+	static int effectSlot(const std::string & category,
+		const EffectInfo * pEffectInfo);
+	static void record(int slot, long long nanoseconds);
+
+	static int slotCount();
+	static const std::string & category(int slot);
+	static const std::string & name(int slot);
+	static long long calls(int slot);
+	static double seconds(int slot);
+
+private:
+	// Indicates if the counters are updated
+	static bool lenabled;
+};
+
+
+/**
+ * Adds the time between its construction and destruction to a counter of
+ * the Instrumentation class, provided that the instrumentation is enabled
+ * at construction.
+ */
+class InstrumentationTimer
+{
+public:
+	inline explicit InstrumentationTimer(int slot);
+	inline explicit InstrumentationTimer(Effect * pEffect);
+	inline InstrumentationTimer(const std::string & category,
+		const EffectInfo * pEffectInfo);
+	inline ~InstrumentationTimer();
+
+private:
+	void start(int slot);
+	void start(Effect * pEffect);
+	void start(const std::string & category, const EffectInfo * pEffectInfo);
+
+	// The counter to be updated, or -1 if nothing is recorded
+	int lslot {-1};
+
+	// The time of construction
+	std::chrono::steady_clock::time_point lstart {};
+};
+
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns if the instrumentation is currently recording.
+ */
+bool Instrumentation::enabled()
+{
+	return Instrumentation::lenabled;
+}
+
+
+/**
+ * Starts timing for the given counter.
+ */
+InstrumentationTimer::InstrumentationTimer(int slot)
+{
+	if (Instrumentation::enabled())
+	{
+		this->start(slot);
+	}
+}
+
+
+/**
+ * Starts timing for the counter of the change contributions of the given
+ * effect.
+ */
+InstrumentationTimer::InstrumentationTimer(Effect * pEffect)
+{
+	if (Instrumentation::enabled())
+	{
+		this->start(pEffect);
+	}
+}
+
+
+/**
+ * Starts timing for the counter of the given effect in the given category.
+ * The counter is only looked up if the instrumentation is enabled.
+ */
+InstrumentationTimer::InstrumentationTimer(const std::string & category,
+	const EffectInfo * pEffectInfo)
+{
+	if (Instrumentation::enabled())
+	{
+		this->start(category, pEffectInfo);
+	}
+}
+
+
+/**
+ * Adds the elapsed time and one call to the counter.
+ */
+InstrumentationTimer::~InstrumentationTimer()
+{
+	if (this->lslot >= 0)
+	{
+		Instrumentation::record(this->lslot,
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - this->lstart).count());
+	}
+}
+
+}
+
+#endif /*INSTRUMENTATION_H_*/
@@ -21,24 +21,15 @@ namespace siena
 const int LIMIT = 1000;
 
 
-// Nullify the pointer to the single instance so we can allocate it
-// on demand.
-
-LogTable * LogTable::lpInstance = 0;
-
-
 /**
  * Returns the only instance of the LogTable class. The instance
- * is allocated on demand.
+ * is allocated on demand; the initialization of the local static variable
+ * is thread-safe.
  */
 LogTable * LogTable::instance()
 {
-	if (!LogTable::lpInstance)
-	{
-		LogTable::lpInstance = new LogTable();
-	}
-
-	return LogTable::lpInstance;
+	static LogTable * pInstance = new LogTable();
+	return pInstance;
 }
 
 
@@ -49,13 +40,11 @@ LogTable::LogTable()
 {
 	this->ltable = new double[LIMIT];
 
-	// Leave the entries undefined, so they can be computed on demand.
-
 	this->ltable[0] = 0.0;
 
 	for (int i = 1; i < LIMIT; i++)
 	{
-		this->ltable[i] = -1;
+		this->ltable[i] = std::log((double) i);
 	}
 }
 
@@ -78,11 +67,6 @@ double LogTable::log(int i)
 
 	if (i < LIMIT)
 	{
-		if (this->ltable[i] < 0)
-		{
-			this->ltable[i] = std::log((double) i);
-		}
-
 		log = this->ltable[i];
 	}
 	else
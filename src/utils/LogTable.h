@@ -6,8 +6,8 @@ namespace siena
 
 /**
  * A singleton class that provides an efficient computation of square roots
- * of integers. Once a root is calculated, it is stored in a table for
- * subsequent reuse.
+ * of integers. The logarithms of small integers are stored in a table
+ * when the instance is created.
  *
  * Usage example:
  * LogTable * pTable = LogTable::instance();
@@ -26,10 +26,9 @@ private:
 	LogTable();
 	virtual ~LogTable();
 
-	// The single instance of this class
-	static LogTable * lpInstance;
-	// A table storing the logs that have been calculated before;
-	// (ltable[i] = -1 if the log has not been calculated for the number i)
+	// A table storing the logs of the numbers up to its size. It is filled
+	// on construction and read only afterwards, so that it can be shared by
+	// simulations on several threads.
 
 	double * ltable {};
 };
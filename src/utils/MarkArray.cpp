@@ -0,0 +1,50 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: MarkArray.cpp
+ *
+ * Description: This file contains the implementation of the
+ * MarkArray class.
+ *****************************************************************************/
+
+#include "MarkArray.h"
+
+namespace siena
+{
+
+/**
+ * Creates an empty array.
+ */
+MarkArray::MarkArray()
+{
+	this->lgeneration = 1;
+}
+
+
+/**
+ * Clears all marks and counters, and makes sure that the entries
+ * 0, ..., n - 1 can be used. Only the first call for a given size and
+ * the rare wrap-around of the generation take time proportional to n.
+ */
+void MarkArray::reset(int n)
+{
+	if ((int) this->lstamps.size() < n)
+	{
+		this->lstamps.resize(n, 0);
+		this->lcounts.resize(n, 0);
+	}
+
+	this->lgeneration++;
+
+	if (this->lgeneration == 0)
+	{
+		// The generations wrapped around; old stamps could look current.
+
+		this->lstamps.assign(this->lstamps.size(), 0);
+		this->lgeneration = 1;
+	}
+}
+
+}
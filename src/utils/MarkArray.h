@@ -0,0 +1,131 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: MarkArray.h
+ *
+ * Description: This file defines the class MarkArray.
+ *****************************************************************************/
+
+#ifndef MARKARRAY_H_
+#define MARKARRAY_H_
+
+#include <vector>
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Class description
+// ----------------------------------------------------------------------------
+
+/**
+ * An array of marks and counters for actors, used as scratch space by the
+ * effects and configuration tables, for instance to count the two-paths
+ * from an ego to each actor. Each entry carries the generation in which it
+ * was last written, and the method reset starts a new generation, so that
+ * all entries are cleared in constant time instead of by a loop over all
+ * actors. The array only grows, so it can be reused across periods.
+ */
+class MarkArray
+{
+public:
+	MarkArray();
+
+	void reset(int n);
+
+	inline bool marked(int i) const;
+	inline void mark(int i);
+	inline void unmark(int i);
+	inline int count(int i) const;
+	inline int increment(int i);
+	inline void count(int i, int value);
+
+private:
+	// The generation in which each entry was last written
+	std::vector<unsigned> lstamps;
+
+	// The counter of each entry, valid if the stamp is current
+	std::vector<int> lcounts;
+
+	// The current generation, never 0
+	unsigned lgeneration {};
+};
+
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns if the given entry has been marked, or counted, since the last
+ * reset.
+ */
+bool MarkArray::marked(int i) const
+{
+	return this->lstamps[i] == this->lgeneration;
+}
+
+
+/**
+ * Marks the given entry, setting its counter to 1.
+ */
+void MarkArray::mark(int i)
+{
+	this->lstamps[i] = this->lgeneration;
+	this->lcounts[i] = 1;
+}
+
+
+/**
+ * Clears the mark and the counter of the given entry.
+ */
+void MarkArray::unmark(int i)
+{
+	this->lstamps[i] = 0;
+}
+
+
+/**
+ * Returns the counter of the given entry, which is 0 for entries not
+ * written since the last reset.
+ */
+int MarkArray::count(int i) const
+{
+	if (this->lstamps[i] != this->lgeneration)
+	{
+		return 0;
+	}
+
+	return this->lcounts[i];
+}
+
+
+/**
+ * Increments the counter of the given entry and returns the new value.
+ */
+int MarkArray::increment(int i)
+{
+	if (this->lstamps[i] != this->lgeneration)
+	{
+		this->lstamps[i] = this->lgeneration;
+		this->lcounts[i] = 0;
+	}
+
+	return ++this->lcounts[i];
+}
+
+
+/**
+ * Stores the counter of the given entry.
+ */
+void MarkArray::count(int i, int value)
+{
+	this->lstamps[i] = this->lgeneration;
+	this->lcounts[i] = value;
+}
+
+}
+
+#endif /*MARKARRAY_H_*/
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: ParallelFor.cpp
+ *
+ * Description: This file contains the implementation of the parallelFor
+ * utility.
+ *****************************************************************************/
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ParallelFor.h"
+#include "Utils.h"
+
+using namespace std;
+
+namespace siena
+{
+
+/**
+ * Calls body(i) for i = 0, ..., count - 1 on the given number of threads,
+ * each thread taking the next index as soon as it is done with its previous
+ * one. The calls must be independent and must not use the R API. If
+ * threadCount is 1 or less, all calls are made on the calling thread, in
+ * increasing order.
+ *
+ * If a call throws an exception, the remaining indices are skipped and the
+ * first exception is thrown again on the calling thread after all threads
+ * have finished. With several threads, the errors of the simulation engine
+ * are thrown as exceptions on all threads, including the calling thread.
+ */
+void parallelFor(int count, int threadCount,
+	const function<void(int)> & body)
+{
+	if (threadCount > count)
+	{
+		threadCount = count;
+	}
+
+	if (threadCount <= 1)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			body(i);
+		}
+
+		return;
+	}
+
+	atomic<int> next(0);
+	atomic<bool> failed(false);
+	exception_ptr pException;
+	mutex exceptionMutex;
+
+	auto work = [&]()
+	{
+		int i;
+
+		throwEngineErrors(true);
+
+		while (!failed && (i = next++) < count)
+		{
+			try
+			{
+				body(i);
+			}
+			catch (...)
+			{
+				lock_guard<mutex> lock(exceptionMutex);
+
+				if (!pException)
+				{
+					pException = current_exception();
+				}
+
+				failed = true;
+			}
+		}
+	};
+
+	// The calling thread takes part in the work as well.
+
+	vector<thread> threads;
+	bool throwErrors = throwEngineErrors();
+
+	for (int t = 1; t < threadCount; t++)
+	{
+		threads.push_back(thread(work));
+	}
+
+	work();
+
+	for (unsigned t = 0; t < threads.size(); t++)
+	{
+		threads[t].join();
+	}
+
+	throwEngineErrors(throwErrors);
+
+	if (pException)
+	{
+		rethrow_exception(pException);
+	}
+}
+
+}
@@ -0,0 +1,25 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: ParallelFor.h
+ *
+ * Description: This module defines a utility for running independent
+ * pieces of work on several threads.
+ *****************************************************************************/
+
+#ifndef PARALLELFOR_H_
+#define PARALLELFOR_H_
+
+#include <functional>
+
+namespace siena
+{
+
+void parallelFor(int count, int threadCount,
+	const std::function<void(int)> & body);
+
+}
+
+#endif /*PARALLELFOR_H_*/
@@ -19,6 +19,64 @@
 namespace siena
 {
 
+// ----------------------------------------------------------------------------
+// Section: Local declarations
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// The stream used by the calling thread, or 0 if the random number
+// generator of R is used
+
+thread_local RandomStream * lpCurrentStream = 0;
+
+}
+
+
+// ----------------------------------------------------------------------------
+// Section: Random number streams
+// ----------------------------------------------------------------------------
+
+/**
+ * Creates a stream of random numbers starting from the given seed.
+ */
+RandomStream::RandomStream(unsigned long long seed) : lengine(seed)
+{
+}
+
+
+/**
+ * Draws a uniformly distributed random double from the interval (0,1)
+ * from this stream, using the upper 53 bits of the next number.
+ */
+double RandomStream::nextDouble()
+{
+	return ((this->lengine() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+
+/**
+ * Selects the stream the calling thread draws its random numbers from.
+ * The value 0 selects the random number generator of R, which may only be
+ * used on the main thread.
+ */
+void currentRandomStream(RandomStream * pStream)
+{
+	lpCurrentStream = pStream;
+}
+
+
+/**
+ * Returns the stream the calling thread draws its random numbers from, or
+ * 0 if it uses the random number generator of R.
+ */
+RandomStream * currentRandomStream()
+{
+	return lpCurrentStream;
+}
+
+
 // ----------------------------------------------------------------------------
 // Section: Methods for drawing random numbers
 // ----------------------------------------------------------------------------
@@ -28,13 +86,18 @@ namespace siena
  */
 double nextDouble()
 {
+	if (lpCurrentStream)
+	{
+		return lpCurrentStream->nextDouble();
+	}
+
     return unif_rand();
 }
 
 
 /**
  * Returns an exponential variate for the given rate parameter.
- * QAD for comparison with Delphi or for SienaProfile.exe
+ * QAD for comparison with Delphi and for parallel runs.
  */
 double nextExponentialQAD(double lambda)
 {
@@ -48,9 +111,12 @@ double nextExponentialQAD(double lambda)
  */
 double nextExponential(double lambda)
 {
-#ifndef STANDALONE
+	if (lpCurrentStream)
+	{
+		return -log(lpCurrentStream->nextDouble()) / lambda;
+	}
+
 	return rexp(1/lambda);
-#endif
 }
 
 /**
@@ -59,9 +125,46 @@ double nextExponential(double lambda)
 
 double nextGamma(double shape, double scale)
 {
-#ifndef STANDALONE
+	if (lpCurrentStream)
+	{
+		// The method of Marsaglia and Tsang (2000), with the normal variates
+		// of nextNormal, so that the variates only depend on the stream.
+		// Shapes below 1 are raised by 1 and the variate scaled back.
+
+		double boost = 1;
+
+		if (shape < 1)
+		{
+			boost = pow(lpCurrentStream->nextDouble(), 1 / shape);
+			shape += 1;
+		}
+
+		double d = shape - 1.0 / 3;
+		double c = 1 / sqrt(9 * d);
+
+		for (;;)
+		{
+			double x;
+			double v;
+
+			do
+			{
+				x = nextNormal(0, 1);
+				v = 1 + c * x;
+			}
+			while (v <= 0);
+
+			v = v * v * v;
+
+			if (log(lpCurrentStream->nextDouble()) <
+				0.5 * x * x + d - d * v + d * log(v))
+			{
+				return scale * d * v * boost;
+			}
+		}
+	}
+
 	return rgamma(shape, scale);
-#endif
 }
 
 /**
@@ -71,9 +174,18 @@ double nextGamma(double shape, double scale)
 
 double nextNormal(double mean, double standardDeviation)
 {
-#ifndef STANDALONE
+	if (lpCurrentStream)
+	{
+		// Inversion, as the default normal generator of R, which adds the
+		// bits of a second uniform variate to those of the first.
+
+		const double big = 134217728;
+		double u = lpCurrentStream->nextDouble();
+		u = (int) (big * u) + lpCurrentStream->nextDouble();
+		return qnorm(u / big, mean, standardDeviation, 1, 0);
+	}
+
 	return rnorm(mean, standardDeviation);
-#endif
 }
 
 /**
@@ -84,16 +196,14 @@ double nextNormal(double mean, double standardDeviation)
 double normalDensity(double value, double mean, double standardDeviation,
 	 int log)
 {
-#ifndef STANDALONE
 	return dnorm(value, mean, standardDeviation, log);
-#endif
 }
 /**
  * Draws a uniformly distributed random integer from the interval [0,n).
  */
 int nextInt(int n)
 {
-    return (int) (n * unif_rand());
+    return (int) (n * nextDouble());
 }
 
 
@@ -12,11 +12,38 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include <random>
 #include <vector>
 
 namespace siena
 {
 
+// ----------------------------------------------------------------------------
+// Section: Random number streams
+// ----------------------------------------------------------------------------
+
+/**
+ * An independent stream of random numbers, used instead of the random
+ * number generator of R by simulations running on other threads than the
+ * main thread of R. The stream is selected for the calling thread by the
+ * function currentRandomStream, after which all the functions below draw
+ * from it.
+ */
+class RandomStream
+{
+public:
+	explicit RandomStream(unsigned long long seed);
+
+	double nextDouble();
+
+private:
+	// The generator of this stream
+	std::mt19937_64 lengine;
+};
+
+void currentRandomStream(RandomStream * pStream);
+RandomStream * currentRandomStream();
+
 // Drawing random number from various distributions
 
 double nextDouble();
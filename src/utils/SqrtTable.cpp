@@ -22,24 +22,15 @@ namespace siena
 const int LIMIT = 1000;
 
 
-// Nullify the pointer to the single instance so we can allocate it
-// on demand.
-
-SqrtTable * SqrtTable::lpInstance = 0;
-
-
 /**
  * Returns the only instance of the SqrtTable class. The instance
- * is allocated on demand.
+ * is allocated on demand; the initialization of the local static variable
+ * is thread-safe.
  */
 SqrtTable * SqrtTable::instance()
 {
-	if (!SqrtTable::lpInstance)
-	{
-		SqrtTable::lpInstance = new SqrtTable();
-	}
-
-	return SqrtTable::lpInstance;
+	static SqrtTable * pInstance = new SqrtTable();
+	return pInstance;
 }
 
 
@@ -50,11 +41,9 @@ SqrtTable::SqrtTable()
 {
 	this->ltable = new double[LIMIT];
 
-	// Leave the entries undefined, so they can be computed on demand.
-
 	for (int i = 0; i < LIMIT; i++)
 	{
-		this->ltable[i] = -1;
+		this->ltable[i] = std::sqrt((double) i);
 	}
 }
 
@@ -77,11 +66,6 @@ double SqrtTable::sqrt(int i)
 
 	if (i < LIMIT)
 	{
-		if (this->ltable[i] < 0)
-		{
-			this->ltable[i] = std::sqrt((double) i);
-		}
-
 		root = this->ltable[i];
 	}
 	else
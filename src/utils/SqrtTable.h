@@ -6,8 +6,8 @@ namespace siena
 
 /**
  * A singleton class that provides an efficient computation of square roots
- * of integers. Once a root is calculated, it is stored in a table for
- * subsequent reuse.
+ * of integers. The square roots of small integers are stored in a table
+ * when the instance is created.
  *
  * Usage example:
  * SqrtTable * pTable = SqrtTable::instance();
@@ -26,11 +26,9 @@ private:
 	SqrtTable();
 	virtual ~SqrtTable();
 
-	// The single instance of this class
-	static SqrtTable * lpInstance;
-
-	// A table storing the square roots that have been calculated before
-	// (ltable[i] = -1 if the root has not been calculated for the number i)
+	// A table storing the square roots of the numbers up to its size.
+	// It is filled on construction and read only afterwards, so that it
+	// can be shared by simulations on several threads.
 
 	double * ltable {};
 };
@@ -9,12 +9,30 @@
  *****************************************************************************/
 
 #include "Utils.h"
+#include <cstdarg>
+#include <cstdio>
+#include <R_ext/Error.h>
 #include <Rmath.h>
 #include <sstream>
 
 namespace siena
 {
 
+// ----------------------------------------------------------------------------
+// Section: Local declarations
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Indicates if engineError throws an exception on the calling thread
+// instead of raising an R error
+
+thread_local bool lthrowEngineErrors = false;
+
+}
+
+
 /**
  * Returns a string representing the given integer.
  */
@@ -52,6 +70,51 @@ double logarithmer(int x)
 }
 
 
+
+/**
+ * Sets if the errors of the simulation engine on the calling thread are
+ * thrown as an EngineException instead of being raised as R errors. This
+ * is required on any thread other than the main thread of R, as the R API
+ * must not be used there.
+ */
+void throwEngineErrors(bool throwErrors)
+{
+	lthrowEngineErrors = throwErrors;
+}
+
+
+/**
+ * Returns if the errors of the simulation engine on the calling thread are
+ * thrown as an EngineException.
+ */
+bool throwEngineErrors()
+{
+	return lthrowEngineErrors;
+}
+
+
+/**
+ * Reports an error of the simulation engine with a message formatted as by
+ * printf: throws an EngineException if the calling thread is set to do so
+ * by throwEngineErrors, and raises an R error otherwise.
+ */
+void engineError(const char * format, ...)
+{
+	char message[1024];
+	va_list arguments;
+	va_start(arguments, format);
+	vsnprintf(message, sizeof(message), format, arguments);
+	va_end(arguments);
+
+	if (lthrowEngineErrors)
+	{
+		throw EngineException(message);
+	}
+
+	Rf_error("%s", message);
+}
+
+
 /**
  * Creates an exception signaling about the use of an invalid iterator.
  */
@@ -60,4 +123,13 @@ InvalidIteratorException::InvalidIteratorException() :
 {
 }
 
+
+/**
+ * Creates an exception signaling about an error of the simulation engine.
+ */
+EngineException::EngineException(const std::string & rMessage) :
+	std::runtime_error(rMessage)
+{
+}
+
 }
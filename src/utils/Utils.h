@@ -35,6 +35,10 @@ double identity(int x);
 double invertor(int x);
 double logarithmer(int x);
 
+void throwEngineErrors(bool throwErrors);
+bool throwEngineErrors();
+[[noreturn]] void engineError(const char * format, ...);
+
 /**
  * This method tests if the given element belongs to the given container.
  */
@@ -119,6 +123,17 @@ public:
 	InvalidIteratorException();
 };
 
+
+/**
+ * This class defines an exception signaling about an error of the
+ * simulation engine on a thread that must not report it to R directly.
+ */
+class EngineException : public std::runtime_error
+{
+public:
+	EngineException(const std::string & rMessage);
+};
+
 }
 
 #endif /*UTILS_H_*/
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: WeightTree.cpp
+ *
+ * Description: This file contains the implementation of the
+ * WeightTree class.
+ *****************************************************************************/
+
+#include "WeightTree.h"
+
+namespace siena
+{
+
+/**
+ * Makes the tree hold the elements 0, ..., n - 1, all with weight 0.
+ */
+void WeightTree::reset(int n)
+{
+	this->lleafCount = 1;
+
+	while (this->lleafCount < n)
+	{
+		this->lleafCount *= 2;
+	}
+
+	this->lnodes.assign(2 * this->lleafCount, 0);
+}
+
+
+/**
+ * Sets up the tree for the elements 0, ..., n - 1 with the given weights,
+ * summing the inner nodes bottom up in time linear in n.
+ */
+void WeightTree::reset(int n, const double * pWeights)
+{
+	this->reset(n);
+
+	for (int i = 0; i < n; i++)
+	{
+		this->lnodes[this->lleafCount + i] = pWeights[i];
+	}
+
+	for (int node = this->lleafCount - 1; node > 0; node--)
+	{
+		this->lnodes[node] = this->lnodes[2 * node] + this->lnodes[2 * node + 1];
+	}
+}
+
+
+/**
+ * Changes the weight of the given element.
+ */
+void WeightTree::weight(int i, double value)
+{
+	int node = this->lleafCount + i;
+	this->lnodes[node] = value;
+
+	for (node /= 2; node > 0; node /= 2)
+	{
+		this->lnodes[node] = this->lnodes[2 * node] + this->lnodes[2 * node + 1];
+	}
+}
+
+
+/**
+ * Returns the first element such that the sum of the weights up to and
+ * including this element is not less than the given value, which should
+ * be in (0, total()]. Elements of weight 0 are never returned, even if
+ * rounding errors make the value exceed the total.
+ */
+int WeightTree::find(double value) const
+{
+	int node = 1;
+
+	while (node < this->lleafCount)
+	{
+		double leftSum = this->lnodes[2 * node];
+
+		if (this->lnodes[2 * node + 1] > 0 &&
+			(value > leftSum || leftSum <= 0))
+		{
+			value -= leftSum;
+			node = 2 * node + 1;
+		}
+		else
+		{
+			node = 2 * node;
+		}
+	}
+
+	return node - this->lleafCount;
+}
+
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * SIENA: Simulation Investigation for Empirical Network Analysis
+ *
+ * Web: http://www.stats.ox.ac.uk/~snijders/siena/
+ *
+ * File: WeightTree.h
+ *
+ * Description: This file defines the class WeightTree.
+ *****************************************************************************/
+
+#ifndef WEIGHTTREE_H_
+#define WEIGHTTREE_H_
+
+#include <vector>
+
+namespace siena
+{
+
+// ----------------------------------------------------------------------------
+// Section: Class description
+// ----------------------------------------------------------------------------
+
+/**
+ * A complete binary tree over non-negative weights of the elements
+ * 0, ..., n - 1, where each inner node stores the sum of the weights below
+ * it. A weight can be changed, and an element drawn with probability
+ * proportional to its weight, in time logarithmic in n. The sums are
+ * recalculated from the children on each change rather than adjusted by
+ * differences, so that they do not drift under repeated changes.
+ */
+class WeightTree
+{
+public:
+	void reset(int n);
+	void reset(int n, const double * pWeights);
+
+	inline double weight(int i) const;
+	void weight(int i, double value);
+	inline double total() const;
+	int find(double value) const;
+
+private:
+	// The number of leaves, a power of 2 not less than the number of
+	// elements
+	int lleafCount {};
+
+	// The nodes in heap order: the root is at 1, the children of node k
+	// at 2k and 2k + 1, and the weight of element i at lleafCount + i.
+	std::vector<double> lnodes;
+};
+
+
+// ----------------------------------------------------------------------------
+// Section: Inline methods
+// ----------------------------------------------------------------------------
+
+/**
+ * Returns the weight of the given element.
+ */
+double WeightTree::weight(int i) const
+{
+	return this->lnodes[this->lleafCount + i];
+}
+
+
+/**
+ * Returns the sum of all weights.
+ */
+double WeightTree::total() const
+{
+	return this->lnodes[1];
+}
+
+}
+
+#endif /*WEIGHTTREE_H_*/